@@ -0,0 +1,195 @@
+#include "Buffer.h"
+
+#include <algorithm>
+
+#include "Logging.h"
+
+namespace tinyRPC {
+
+namespace {
+
+// Block owning a `std::string`, used by `MakeForeignBuffer`.
+class StringBlock final : public BufferBlock {
+ public:
+  explicit StringBlock(std::string s) : s_(std::move(s)) {}
+
+  char* mutable_data() noexcept override { return s_.data(); }
+  const char* data() const noexcept override { return s_.data(); }
+  std::size_t size() const noexcept override { return s_.size(); }
+  void Destroy() noexcept override { delete this; }
+
+ private:
+  std::string s_;
+};
+
+}  // namespace
+
+NoncontiguousBuffer::NoncontiguousBuffer(const NoncontiguousBuffer& other)
+    : byte_size_(other.byte_size_) {
+  for (auto&& e : other) {
+    buffers_.push_back(NewNode(e));
+  }
+}
+
+NoncontiguousBuffer& NoncontiguousBuffer::operator=(
+    const NoncontiguousBuffer& other) {
+  if (this != &other) {
+    Clear();
+    for (auto&& e : other) {
+      buffers_.push_back(NewNode(e));
+    }
+    byte_size_ = other.byte_size_;
+  }
+  return *this;
+}
+
+NoncontiguousBuffer NoncontiguousBuffer::Cut(std::size_t bytes) {
+  FLARE_CHECK_LE(bytes, byte_size_);
+  NoncontiguousBuffer result;
+  while (bytes) {
+    auto&& first = buffers_.front();
+    if (bytes < first.size()) {
+      // Split the first slice, both parts reference the same block.
+      auto part = NewNode(first);
+      part->set_size(bytes);
+      first.Skip(bytes);
+      result.buffers_.push_back(part);
+      result.byte_size_ += bytes;
+      byte_size_ -= bytes;
+      break;
+    }
+    auto node = buffers_.pop_front();
+    bytes -= node->size();
+    byte_size_ -= node->size();
+    result.byte_size_ += node->size();
+    result.buffers_.push_back(node);
+  }
+  return result;
+}
+
+void NoncontiguousBuffer::Append(PolymorphicBuffer buffer) {
+  if (!buffer.size()) {
+    return;
+  }
+  byte_size_ += buffer.size();
+  buffers_.push_back(NewNode(std::move(buffer)));
+}
+
+void NoncontiguousBuffer::Append(NoncontiguousBuffer buffer) {
+  byte_size_ += std::exchange(buffer.byte_size_, 0);
+  buffers_.splice(std::move(buffer.buffers_));
+}
+
+void NoncontiguousBuffer::Clear() noexcept {
+  while (auto node = buffers_.pop_front()) {
+    FreeNode(node);
+  }
+  byte_size_ = 0;
+}
+
+void NoncontiguousBuffer::SkipSlow(std::size_t bytes) noexcept {
+  FLARE_CHECK_LE(bytes, byte_size_);
+  byte_size_ -= bytes;
+  while (bytes) {
+    auto&& first = buffers_.front();
+    if (bytes < first.size()) {
+      first.Skip(bytes);
+      break;
+    }
+    bytes -= first.size();
+    FreeNode(buffers_.pop_front());
+  }
+}
+
+PolymorphicBuffer* NoncontiguousBuffer::NewNode(PolymorphicBuffer buffer) {
+  auto node = object_pool::Get<PolymorphicBuffer>();
+  *node = std::move(buffer);
+  return node;
+}
+
+void NoncontiguousBuffer::FreeNode(PolymorphicBuffer* node) noexcept {
+  object_pool::Put(node);
+}
+
+char* NoncontiguousBufferBuilder::Reserve(std::size_t bytes) {
+  FLARE_CHECK_LE(bytes, kBufferBlockSize);
+  if (SizeAvailable() < bytes) {
+    FlushCurrentBlock();
+    InitializeNextBlock();
+  }
+  auto result = data();
+  MarkWritten(bytes);
+  return result;
+}
+
+void NoncontiguousBufferBuilder::Append(NoncontiguousBuffer buffer) {
+  FlushCurrentBlock();  // Keep the bytes in order.
+  nb_.Append(std::move(buffer));
+}
+
+void NoncontiguousBufferBuilder::AppendSlow(const void* ptr,
+                                            std::size_t length) {
+  auto p = static_cast<const char*>(ptr);
+  while (length) {
+    auto copying = std::min(length, SizeAvailable());
+    memcpy(data(), p, copying);
+    MarkWritten(copying);
+    p += copying;
+    length -= copying;
+  }
+}
+
+void NoncontiguousBufferBuilder::FlushCurrentBlock() {
+  if (used_ == flushed_) {
+    return;
+  }
+  nb_.Append(PolymorphicBuffer(current_, flushed_, used_ - flushed_));
+  flushed_ = used_;
+}
+
+void NoncontiguousBufferBuilder::InitializeNextBlock() {
+  current_ = MakeNativeBufferBlock();
+  used_ = flushed_ = 0;
+}
+
+NoncontiguousBuffer CreateBufferSlow(const void* ptr, std::size_t size) {
+  NoncontiguousBufferBuilder builder;
+  builder.Append(ptr, size);
+  return builder.DestructiveGet();
+}
+
+NoncontiguousBuffer CreateBufferSlow(std::string_view s) {
+  return CreateBufferSlow(s.data(), s.size());
+}
+
+PolymorphicBuffer MakeForeignBuffer(std::string s) {
+  auto size = s.size();
+  return PolymorphicBuffer(
+      RefPtr<BufferBlock>(adopt_ptr, new StringBlock(std::move(s))), 0, size);
+}
+
+std::string FlattenSlow(const NoncontiguousBuffer& nb, std::size_t max_bytes) {
+  max_bytes = std::min(max_bytes, nb.ByteSize());
+  std::string result;
+  result.reserve(max_bytes);
+  for (auto iter = nb.begin(); iter != nb.end() && result.size() != max_bytes;
+       ++iter) {
+    result.append(iter->data(),
+                  std::min(iter->size(), max_bytes - result.size()));
+  }
+  return result;
+}
+
+void FlattenToSlow(const NoncontiguousBuffer& nb, void* buffer,
+                   std::size_t size) {
+  FLARE_CHECK_LE(size, nb.ByteSize());
+  auto p = static_cast<char*>(buffer);
+  for (auto iter = nb.begin(); size; ++iter) {
+    auto copying = std::min(size, iter->size());
+    memcpy(p, iter->data(), copying);
+    p += copying;
+    size -= copying;
+  }
+}
+
+}  // namespace tinyRPC
@@ -0,0 +1,312 @@
+#ifndef _SRC_BASE_BUFFER_H_
+#define _SRC_BASE_BUFFER_H_
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "DoublyLinkedList.h"
+#include "Likely.h"
+#include "ObjectPool.h"
+#include "RefPtr.h"
+
+// Simplified from flare's `NoncontiguousBuffer`.
+//
+// Bytes are stored in a chain of reference-counted blocks. Cutting bytes off
+// from the head of a buffer, or appending one buffer to another, only moves
+// references to these blocks around, the bytes themselves are never copied.
+//
+// This is what we use on the I/O path. Bytes read from the socket are stored in
+// native blocks, and (slices of) these blocks are passed all the way up to the
+// protocol object (and Protocol Buffers, via `ZeroCopyStream.h`.)
+
+namespace tinyRPC {
+
+// A chunk of bytes. Reference counted.
+class BufferBlock : public RefCounted<BufferBlock> {
+ public:
+  virtual ~BufferBlock() = default;
+
+  virtual char* mutable_data() noexcept = 0;
+  virtual const char* data() const noexcept = 0;
+  virtual std::size_t size() const noexcept = 0;
+
+  // Called when the last reference to this block is gone.
+  virtual void Destroy() noexcept = 0;
+};
+
+template <>
+struct RefTraits<BufferBlock> {
+  static void Destroy(BufferBlock* ptr) { ptr->Destroy(); }
+};
+
+// Size of blocks allocated by us.
+inline constexpr std::size_t kBufferBlockSize = 4096;
+
+// Fixed-size block recycled via object pool.
+class NativeBufferBlock final : public BufferBlock {
+ public:
+  char* mutable_data() noexcept override { return buffer_; }
+  const char* data() const noexcept override { return buffer_; }
+  std::size_t size() const noexcept override { return kBufferBlockSize; }
+  void Destroy() noexcept override { object_pool::Put(this); }
+
+ private:
+  friend struct object_pool::PoolTraits<NativeBufferBlock>;
+
+  char buffer_[kBufferBlockSize];
+};
+
+// Allocate a new (uninitialized) block.
+inline RefPtr<NativeBufferBlock> MakeNativeBufferBlock() {
+  return RefPtr<NativeBufferBlock>(adopt_ptr,
+                                   object_pool::Get<NativeBufferBlock>());
+}
+
+// A slice of a `BufferBlock`.
+class PolymorphicBuffer {
+ public:
+  PolymorphicBuffer() = default;
+
+  // Slice [`start`, `start` + `size`) of `data`.
+  PolymorphicBuffer(RefPtr<BufferBlock> data, std::size_t start,
+                    std::size_t size)
+      : ptr_(data->data() + start), size_(size), ref_(std::move(data)) {}
+
+  // Not linked into the original buffer's list.
+  PolymorphicBuffer(const PolymorphicBuffer& other)
+      : ptr_(other.ptr_), size_(other.size_), ref_(other.ref_) {}
+  PolymorphicBuffer& operator=(const PolymorphicBuffer& other) {
+    ptr_ = other.ptr_;
+    size_ = other.size_;
+    ref_ = other.ref_;
+    return *this;
+  }
+  PolymorphicBuffer(PolymorphicBuffer&& other) noexcept
+      : ptr_(other.ptr_), size_(other.size_), ref_(std::move(other.ref_)) {}
+  PolymorphicBuffer& operator=(PolymorphicBuffer&& other) noexcept {
+    ptr_ = other.ptr_;
+    size_ = other.size_;
+    ref_ = std::move(other.ref_);
+    return *this;
+  }
+
+  const char* data() const noexcept { return ptr_; }
+  std::size_t size() const noexcept { return size_; }
+
+  // Drop first `bytes` bytes.
+  void Skip(std::size_t bytes) noexcept {
+    ptr_ += bytes;
+    size_ -= bytes;
+  }
+
+  // Shrink the slice to `size` bytes.
+  void set_size(std::size_t size) noexcept { size_ = size; }
+
+  void Reset() noexcept {
+    ptr_ = nullptr;
+    size_ = 0;
+    ref_ = nullptr;
+  }
+
+ private:
+  friend class NoncontiguousBuffer;
+
+  DoublyLinkedListEntry chain_;  // Used by `NoncontiguousBuffer`.
+  const char* ptr_ = nullptr;
+  std::size_t size_ = 0;
+  RefPtr<BufferBlock> ref_;
+};
+
+// A buffer consisting of non-contiguous slices of blocks.
+class NoncontiguousBuffer {
+  using LinkedBuffers =
+      DoublyLinkedList<PolymorphicBuffer, &PolymorphicBuffer::chain_>;
+
+ public:
+  using iterator = LinkedBuffers::iterator;
+  using const_iterator = LinkedBuffers::const_iterator;
+
+  static constexpr auto npos = std::numeric_limits<std::size_t>::max();
+
+  NoncontiguousBuffer() = default;
+  ~NoncontiguousBuffer() { Clear(); }
+
+  // Copying a buffer only copies the references to the underlying blocks.
+  NoncontiguousBuffer(const NoncontiguousBuffer& other);
+  NoncontiguousBuffer& operator=(const NoncontiguousBuffer& other);
+
+  NoncontiguousBuffer(NoncontiguousBuffer&& other) noexcept
+      : byte_size_(std::exchange(other.byte_size_, 0)) {
+    buffers_.swap(other.buffers_);
+  }
+  NoncontiguousBuffer& operator=(NoncontiguousBuffer&& other) noexcept {
+    if (this != &other) {
+      Clear();
+      std::swap(byte_size_, other.byte_size_);
+      buffers_.swap(other.buffers_);
+    }
+    return *this;
+  }
+
+  // Total number of bytes in this buffer.
+  std::size_t ByteSize() const noexcept { return byte_size_; }
+  bool Empty() const noexcept { return !byte_size_; }
+
+  // First contiguous part of the buffer.
+  //
+  // Precondition: `!Empty()`.
+  std::string_view FirstContiguous() const noexcept {
+    auto&& first = buffers_.front();
+    return std::string_view(first.data(), first.size());
+  }
+
+  // Drop first `bytes` bytes.
+  //
+  // Precondition: `bytes <= ByteSize()`.
+  void Skip(std::size_t bytes) noexcept {
+    if (FLARE_LIKELY(bytes && bytes < buffers_.front().size())) {
+      buffers_.front().Skip(bytes);
+      byte_size_ -= bytes;
+    } else {
+      SkipSlow(bytes);
+    }
+  }
+
+  // Cut first `bytes` bytes off and return them.
+  //
+  // Precondition: `bytes <= ByteSize()`.
+  NoncontiguousBuffer Cut(std::size_t bytes);
+
+  void Append(PolymorphicBuffer buffer);
+  void Append(NoncontiguousBuffer buffer);
+
+  void Clear() noexcept;
+
+  iterator begin() noexcept { return buffers_.begin(); }
+  iterator end() noexcept { return buffers_.end(); }
+  const_iterator begin() const noexcept { return buffers_.begin(); }
+  const_iterator end() const noexcept { return buffers_.end(); }
+
+ private:
+  void SkipSlow(std::size_t bytes) noexcept;
+
+  static PolymorphicBuffer* NewNode(PolymorphicBuffer buffer);
+  static void FreeNode(PolymorphicBuffer* node) noexcept;
+
+ private:
+  std::size_t byte_size_ = 0;
+  LinkedBuffers buffers_;
+};
+
+// Helper for building a `NoncontiguousBuffer`. Bytes are written into native
+// blocks allocated by us.
+class NoncontiguousBufferBuilder {
+ public:
+  NoncontiguousBufferBuilder() { InitializeNextBlock(); }
+
+  // Writable part of the current block.
+  char* data() const noexcept { return current_->mutable_data() + used_; }
+  std::size_t SizeAvailable() const noexcept { return kBufferBlockSize - used_; }
+
+  // Mark `bytes` bytes starting from `data()` as written.
+  //
+  // Precondition: `bytes <= SizeAvailable()`.
+  void MarkWritten(std::size_t bytes) {
+    used_ += bytes;
+    if (FLARE_UNLIKELY(used_ == kBufferBlockSize)) {
+      FlushCurrentBlock();
+      InitializeNextBlock();
+    }
+  }
+
+  // Reserve `bytes` contiguous bytes and return a pointer to them. The bytes
+  // can be filled later, before `DestructiveGet()` is called.
+  //
+  // Precondition: `bytes <= kBufferBlockSize`.
+  char* Reserve(std::size_t bytes);
+
+  void Append(const void* ptr, std::size_t length) {
+    if (FLARE_LIKELY(length <= SizeAvailable())) {
+      memcpy(data(), ptr, length);
+      MarkWritten(length);
+    } else {
+      AppendSlow(ptr, length);
+    }
+  }
+  void Append(std::string_view s) { Append(s.data(), s.size()); }
+  void Append(char c) { Append(&c, 1); }
+
+  // Bytes in `buffer` are not copied.
+  void Append(NoncontiguousBuffer buffer);
+
+  // Total number of bytes written.
+  std::size_t ByteSize() const noexcept {
+    return nb_.ByteSize() + used_ - flushed_;
+  }
+
+  // The builder should not be used after this call.
+  NoncontiguousBuffer DestructiveGet() {
+    FlushCurrentBlock();
+    return std::move(nb_);
+  }
+
+ private:
+  void AppendSlow(const void* ptr, std::size_t length);
+
+  // Move bytes written into the current block to `nb_`.
+  void FlushCurrentBlock();
+  void InitializeNextBlock();
+
+  NoncontiguousBuffer nb_;
+  RefPtr<NativeBufferBlock> current_;
+  std::size_t used_ = 0;     // Bytes used in `current_`.
+  std::size_t flushed_ = 0;  // Bytes in `current_` that have been moved to
+                             // `nb_`.
+};
+
+// Copy `size` bytes into a new buffer.
+NoncontiguousBuffer CreateBufferSlow(const void* ptr, std::size_t size);
+NoncontiguousBuffer CreateBufferSlow(std::string_view s);
+
+// Make a buffer referencing `s`. No copy is made.
+PolymorphicBuffer MakeForeignBuffer(std::string s);
+
+// Copy at most `max_bytes` bytes out.
+std::string FlattenSlow(const NoncontiguousBuffer& nb,
+                        std::size_t max_bytes = NoncontiguousBuffer::npos);
+
+// Copy first `size` bytes into `buffer`.
+//
+// Precondition: `nb.ByteSize() >= size`.
+void FlattenToSlow(const NoncontiguousBuffer& nb, void* buffer,
+                   std::size_t size);
+
+namespace object_pool {
+
+template <>
+struct PoolTraits<NativeBufferBlock> {
+  static constexpr std::size_t kLocalCacheSize = 1024;  // 4M per thread.
+  static constexpr std::size_t kTransferCacheSize = 16384;
+  static constexpr std::size_t kTransferBatchSize = 256;
+
+  static void OnPut(NativeBufferBlock* ptr) { ptr->ResetRefCount(); }
+};
+
+template <>
+struct PoolTraits<PolymorphicBuffer> {
+  static constexpr std::size_t kLocalCacheSize = 4096;
+  static constexpr std::size_t kTransferCacheSize = 65536;
+  static constexpr std::size_t kTransferBatchSize = 1024;
+
+  static void OnPut(PolymorphicBuffer* ptr) { ptr->Reset(); }
+};
+
+}  // namespace object_pool
+
+}  // namespace tinyRPC
+
+#endif
@@ -0,0 +1,101 @@
+#include "../../include/gtest/gtest.h"
+#include "Buffer.h"
+
+#include <string>
+
+namespace tinyRPC {
+
+namespace {
+
+NoncontiguousBuffer MakeFragmented(const std::string& s, std::size_t piece) {
+  NoncontiguousBuffer nb;
+  for (std::size_t i = 0; i < s.size(); i += piece) {
+    nb.Append(CreateBufferSlow(s.substr(i, piece)));
+  }
+  return nb;
+}
+
+}  // namespace
+
+TEST(NoncontiguousBuffer, Cut) {
+  auto nb = MakeFragmented("abcdefghijklmnopqrstuvwxyz", 3);
+  ASSERT_EQ(26, nb.ByteSize());
+
+  auto cut = nb.Cut(5);
+  EXPECT_EQ("abcde", FlattenSlow(cut));
+  EXPECT_EQ(21, nb.ByteSize());
+  EXPECT_EQ("fghijklmnopqrstuvwxyz", FlattenSlow(nb));
+
+  cut = nb.Cut(0);
+  EXPECT_TRUE(cut.Empty());
+
+  cut = nb.Cut(21);
+  EXPECT_TRUE(nb.Empty());
+  EXPECT_EQ("fghijklmnopqrstuvwxyz", FlattenSlow(cut));
+}
+
+TEST(NoncontiguousBuffer, Skip) {
+  auto nb = MakeFragmented("abcdefghijklmnopqrstuvwxyz", 4);
+  nb.Skip(1);
+  EXPECT_EQ("bcd", nb.FirstContiguous());
+  nb.Skip(3);
+  EXPECT_EQ("efgh", nb.FirstContiguous());
+  nb.Skip(10);
+  EXPECT_EQ("opqrstuvwxyz", FlattenSlow(nb));
+  nb.Skip(0);
+  EXPECT_EQ(12, nb.ByteSize());
+  nb.Skip(12);
+  EXPECT_TRUE(nb.Empty());
+}
+
+TEST(NoncontiguousBuffer, CopyAndAppend) {
+  auto nb = MakeFragmented("hello", 2);
+  auto copy = nb;
+  nb.Skip(2);
+  EXPECT_EQ("llo", FlattenSlow(nb));
+  EXPECT_EQ("hello", FlattenSlow(copy));
+
+  copy.Append(std::move(nb));
+  EXPECT_TRUE(nb.Empty());
+  EXPECT_EQ("hellollo", FlattenSlow(copy));
+  EXPECT_EQ(8, copy.ByteSize());
+
+  copy.Append(MakeForeignBuffer(" world"));
+  EXPECT_EQ("hellollo world", FlattenSlow(copy));
+  EXPECT_EQ("hell", FlattenSlow(copy, 4));
+
+  char buffer[6];
+  FlattenToSlow(copy, buffer, sizeof(buffer));
+  EXPECT_EQ("hellol", std::string(buffer, sizeof(buffer)));
+}
+
+TEST(NoncontiguousBufferBuilder, Append) {
+  std::string expected;
+  NoncontiguousBufferBuilder builder;
+  auto header = builder.Reserve(4);
+  for (int i = 0; i != 10000; ++i) {
+    auto s = std::to_string(i);
+    builder.Append(s);
+    expected += s;
+  }
+  builder.Append('x');
+  builder.Append(CreateBufferSlow("yz"));
+  expected += "xyz";
+  memcpy(header, "head", 4);
+
+  EXPECT_EQ(expected.size() + 4, builder.ByteSize());
+  auto nb = builder.DestructiveGet();
+  EXPECT_EQ("head" + expected, FlattenSlow(nb));
+}
+
+TEST(NoncontiguousBufferBuilder, LargeAppend) {
+  std::string large(kBufferBlockSize * 3 + 1, 'a');
+  NoncontiguousBufferBuilder builder;
+  builder.Append("1");
+  builder.Append(large);
+  builder.Append(builder.data(), 0);
+  auto nb = builder.DestructiveGet();
+  EXPECT_EQ("1" + large, FlattenSlow(nb));
+}
+
+}  // namespace tinyRPC
@@ -1,12 +1,13 @@
 #ifndef _SRC_BASE_DEPENDENCY_REGISTRY_H_
 #define _SRC_BASE_DEPENDENCY_REGISTRY_H_
 
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
 #include <utility>
-#include <unordered_map>
 
 #include "Demangle.h"
 #include "Function.h"
@@ -188,11 +189,10 @@ class ClassRegistry {
   //
   // An empty factory is returned if no class with the requested name is found.
   Factory TryGetFactory(std::string_view name) const noexcept {
-    if(factories_.find(name) != factories_.end()){
-      auto ptr = &factories_.at(name);
+    if (auto iter = factories_.find(name); iter != factories_.end()) {
       // We don't support deregistration, therefore holding a pointer to the
       // factory should be safe.
-      return [ptr = ptr->get()]<class... Args>(Args&&... args) {
+      return [ptr = iter->second.get()]<class... Args>(Args&&... args) {
         return (*ptr)(std::forward<Args>(args)...);
       };
     }
@@ -215,9 +215,8 @@ class ClassRegistry {
   // `nullptr` is returned if the name given is not recognized.
   std::unique_ptr<Interface> TryNew(std::string_view name,
                                     FactoryArgs... args) const {
-    if(factories_.find(name) != factories_.end()){
-      auto ptr =  &factories_.at(name);
-      return (**ptr)(std::forward<FactoryArgs>(args)...);
+    if (auto iter = factories_.find(name); iter != factories_.end()) {
+      return (*iter->second)(std::forward<FactoryArgs>(args)...);
     }
     return nullptr;
   }
@@ -249,7 +248,9 @@ class ClassRegistry {
   }
 
  private:
-  std::unordered_map<std::string_view, std::unique_ptr<Factory>> factories_;
+  // Keys are owned by us, names passed to `Register` are usually temporaries.
+  // `std::less<>` allows us to look them up by `std::string_view`.
+  std::map<std::string, std::unique_ptr<Factory>, std::less<>> factories_;
 };
 
 // Registry holding different objects implementing the same interface.
@@ -258,9 +259,8 @@ class ObjectRegistry {
  public:
   // Get object with the specified name.
   Interface* TryGet(std::string_view name) const {
-    if(objects_.find(name) != objects_.end()){
-      auto ptr = &objects_.at(name);
-      auto&& e = **ptr;
+    if (auto iter = objects_.find(name); iter != objects_.end()) {
+      auto&& e = *iter->second;
       std::call_once(e.flag, [&] { e.object = e.initializer(); });
       return e.object.Get();
     }
@@ -283,7 +283,8 @@ class ObjectRegistry {
   friend void AddToRegistry(T* registry, Args&&... args);
 
   void Register(const std::string& name, Interface* object) {
-    FLARE_CHECK(!objects_.contains(name));
+    FLARE_CHECK(objects_.find(name) == objects_.end(),
+                "Double registration of object dependency [{}].", name);
     auto&& e = objects_[name];
     e = std::make_unique<LazilyInstantiatedObject>();
     std::call_once(e->flag, [&] {
@@ -308,7 +309,8 @@ class ObjectRegistry {
     UniqueFunction<MaybeOwning<Interface>()> initializer;
   };
 
-  std::unordered_map<std::string_view, std::unique_ptr<LazilyInstantiatedObject>>
+  // @sa: `ClassRegistry::factories_`.
+  std::map<std::string, std::unique_ptr<LazilyInstantiatedObject>, std::less<>>
       objects_;
 };
 
@@ -120,11 +120,14 @@ class DoublyLinkedList<T, kEntry>::iterator {
   }
   constexpr T* operator->() const noexcept { return object_cast(current_); }
   constexpr T& operator*() const noexcept { return *object_cast(current_); }
+  constexpr bool operator==(const iterator& iter) const noexcept {
+    return current_ == iter.current_;
+  }
   constexpr bool operator!=(const iterator& iter) const noexcept {
     return current_ != iter.current_;
   }
 
-  // TODO(luobogao): Post-increment / decrement / operator ==.
+  // TODO(luobogao): Post-increment / decrement.
  private:
   friend class DoublyLinkedList<T, kEntry>;
   constexpr explicit iterator(DoublyLinkedListEntry* start) noexcept
@@ -151,11 +154,14 @@ class DoublyLinkedList<T, kEntry>::const_iterator {
   constexpr const T& operator*() const noexcept {
     return *object_cast(current_);
   }
+  constexpr bool operator==(const const_iterator& iter) const noexcept {
+    return current_ == iter.current_;
+  }
   constexpr bool operator!=(const const_iterator& iter) const noexcept {
     return current_ != iter.current_;
   }
 
-  // TODO(luobogao): Post-increment / decrement / operator ==.
+  // TODO(luobogao): Post-increment / decrement.
  private:
   friend class DoublyLinkedList<T, kEntry>;
   constexpr explicit const_iterator(const DoublyLinkedListEntry* start) noexcept
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "Logging.h"
+#include "ScopedDeferred.h"
 
 using namespace std::literals;
 
@@ -127,7 +128,8 @@ std::string Endpoint::ToString() const {
 }
 
 bool operator==(const Endpoint& left, const Endpoint& right) {
-  return memcmp(left.Get(), right.Get(), left.Length()) == 0;
+  return left.Length() == right.Length() &&
+         memcmp(left.Get(), right.Get(), left.Length()) == 0;
 }
 
 Endpoint EndpointFromIpv4(const std::string& ip, std::uint16_t port) {
@@ -190,6 +192,35 @@ std::uint16_t EndpointGetPort(const Endpoint& endpoint) {
   FLARE_UNREACHABLE();
 }
 
+std::vector<Endpoint> GetInterfaceAddresses() {
+  ifaddrs* addrs;
+  if (getifaddrs(&addrs) != 0) {
+    FLARE_LOG_WARNING("Failed to enumerate interface addresses.");
+    return {};
+  }
+  ScopedDeferred _([&] { freeifaddrs(addrs); });
+
+  std::vector<Endpoint> result;
+  for (auto p = addrs; p; p = p->ifa_next) {
+    if (!p->ifa_addr) {
+      continue;
+    }
+    socklen_t length;
+    if (p->ifa_addr->sa_family == AF_INET) {
+      length = sizeof(sockaddr_in);
+    } else if (p->ifa_addr->sa_family == AF_INET6) {
+      length = sizeof(sockaddr_in6);
+    } else {
+      continue;  // `AF_PACKET`, etc.
+    }
+    EndpointRetriever er;
+    memcpy(er.RetrieveAddr(), p->ifa_addr, length);
+    *er.RetrieveLength() = length;
+    result.push_back(er.Build());
+  }
+  return result;
+}
+
 
 bool IsPrivateIpv4AddressRfc(const Endpoint& addr) {
   constexpr std::pair<std::uint32_t, std::uint32_t> kRanges[] = {
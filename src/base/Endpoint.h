@@ -8,6 +8,7 @@
 #include <optional>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "String.h"
@@ -223,4 +224,18 @@ struct TryParseTraits<Endpoint, void> {
 
 }  // namespace tinyRPC
 
+namespace std {
+
+// Allows `Endpoint` to be used as key of unordered containers.
+template <>
+struct hash<tinyRPC::Endpoint> {
+  std::size_t operator()(const tinyRPC::Endpoint& endpoint) const noexcept {
+    return std::hash<std::string_view>()(
+        std::string_view(reinterpret_cast<const char*>(endpoint.Get()),
+                         endpoint.Length()));
+  }
+};
+
+}  // namespace std
+
 #endif  
@@ -4,6 +4,7 @@
 #include <atomic>
 
 #include "Likely.h"
+#include "Logging.h"
 
 // To allocate (non-contiguous non-duplicate) IDs, the implementation here
 // performs well.
@@ -0,0 +1,203 @@
+#ifndef _SRC_BASE_OBJECT_POOL_H_
+#define _SRC_BASE_OBJECT_POOL_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Likely.h"
+
+// Object pool for frequently allocated / freed objects.
+//
+// Freed objects are cached in a thread-local free list. Once it overflows, a
+// batch of objects is moved to a global transfer cache, from which other
+// threads refill their own free lists. This way objects allocated by one
+// thread and freed by another (quite common for us, e.g., timers are created
+// by fiber workers and freed by timer worker) still get reused.
+//
+// Objects in the pool are NOT destroyed, they're recycled as-is. Use
+// `OnPut` to reset them if necessary.
+//
+// To use the pool, specialize `PoolTraits<T>`:
+//
+// template <>
+// struct PoolTraits<T> {
+//   // Maximum number of objects cached by each thread.
+//   static constexpr std::size_t kLocalCacheSize = ...;
+//
+//   // Maximum number of objects cached globally.
+//   static constexpr std::size_t kTransferCacheSize = ...;
+//
+//   // Objects are moved between thread-local caches and the transfer cache in
+//   // batches of this size. Must not be greater than `kLocalCacheSize`.
+//   static constexpr std::size_t kTransferBatchSize = ...;
+//
+//   // Optional. Called before the object is returned to the pool.
+//   static void OnPut(T* ptr);
+// };
+
+namespace tinyRPC::object_pool {
+
+template <class T>
+struct PoolTraits;
+
+// Get an object from the pool, a new one is created (default constructed) if
+// there's none in the pool.
+template <class T>
+T* Get();
+
+// Return an object to the pool.
+template <class T>
+void Put(T* ptr);
+
+// Deleter for use with `std::unique_ptr`.
+template <class T>
+struct Deleter {
+  void operator()(T* ptr) const noexcept { Put(ptr); }
+};
+
+template <class T>
+using PooledPtr = std::unique_ptr<T, Deleter<T>>;
+
+// Shorthand for `PooledPtr<T>(Get<T>())`.
+template <class T>
+PooledPtr<T> GetPooled() {
+  return PooledPtr<T>(Get<T>());
+}
+
+//////////////////////////////////////////
+// Implementation goes below.           //
+//////////////////////////////////////////
+
+namespace detail {
+
+template <class T, class = void>
+struct HasOnPut : std::false_type {};
+
+template <class T>
+struct HasOnPut<T, std::void_t<decltype(PoolTraits<T>::OnPut(
+                       std::declval<T*>()))>> : std::true_type {};
+
+template <class T>
+class TransferCache {
+ public:
+  // Returns false if the cache is full.
+  bool Put(std::vector<T*>* objects) {
+    std::scoped_lock _(lock_);
+    if (objects_.size() + objects->size() > PoolTraits<T>::kTransferCacheSize) {
+      return false;
+    }
+    objects_.insert(objects_.end(), objects->begin(), objects->end());
+    objects->clear();
+    return true;
+  }
+
+  void Get(std::vector<T*>* objects, std::size_t count) {
+    std::scoped_lock _(lock_);
+    auto n = std::min(count, objects_.size());
+    objects->insert(objects->end(), objects_.end() - n, objects_.end());
+    objects_.resize(objects_.size() - n);
+  }
+
+  static TransferCache* Instance() {
+    // Never destroyed, threads may still be returning objects on exit.
+    static auto cache = new TransferCache();
+    return cache;
+  }
+
+ private:
+  std::mutex lock_;
+  std::vector<T*> objects_;
+};
+
+template <class T>
+class LocalCache {
+  static_assert(PoolTraits<T>::kTransferBatchSize <=
+                PoolTraits<T>::kLocalCacheSize);
+
+ public:
+  ~LocalCache() {
+    while (!objects_.empty()) {
+      Flush();
+    }
+    destroyed_ = true;
+  }
+
+  T* Get() {
+    if (FLARE_UNLIKELY(objects_.empty())) {
+      TransferCache<T>::Instance()->Get(&objects_,
+                                        PoolTraits<T>::kTransferBatchSize);
+      if (objects_.empty()) {
+        return new T();
+      }
+    }
+    auto rc = objects_.back();
+    objects_.pop_back();
+    return rc;
+  }
+
+  void Put(T* ptr) {
+    objects_.push_back(ptr);
+    if (FLARE_UNLIKELY(objects_.size() > PoolTraits<T>::kLocalCacheSize)) {
+      Flush();
+    }
+  }
+
+  // Returns `nullptr` if the thread is exiting and the cache has been
+  // destroyed. Objects held by other thread-local objects may still be
+  // returned to us at that time.
+  static LocalCache* Instance() {
+    if (FLARE_UNLIKELY(destroyed_)) {
+      return nullptr;
+    }
+    thread_local LocalCache cache;
+    return &cache;
+  }
+
+ private:
+  // Move a batch of objects to the transfer cache (or free them, if the
+  // transfer cache is full).
+  void Flush() {
+    auto n = std::min(PoolTraits<T>::kTransferBatchSize, objects_.size());
+    std::vector<T*> batch(objects_.end() - n, objects_.end());
+    objects_.resize(objects_.size() - n);
+    if (!TransferCache<T>::Instance()->Put(&batch)) {
+      for (auto&& e : batch) {
+        delete e;
+      }
+    }
+  }
+
+  std::vector<T*> objects_;
+  inline static thread_local bool destroyed_ = false;
+};
+
+}  // namespace detail
+
+template <class T>
+T* Get() {
+  if (auto cache = detail::LocalCache<T>::Instance(); FLARE_LIKELY(cache)) {
+    return cache->Get();
+  }
+  return new T();
+}
+
+template <class T>
+void Put(T* ptr) {
+  if constexpr (detail::HasOnPut<T>::value) {
+    PoolTraits<T>::OnPut(ptr);
+  }
+  if (auto cache = detail::LocalCache<T>::Instance(); FLARE_LIKELY(cache)) {
+    cache->Put(ptr);
+  } else {
+    delete ptr;
+  }
+}
+
+}  // namespace tinyRPC::object_pool
+
+#endif
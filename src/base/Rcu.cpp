@@ -0,0 +1,156 @@
+#include "Rcu.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Logging.h"
+
+namespace tinyRPC {
+
+namespace detail::rcu {
+
+namespace {
+
+std::atomic<Reader*> readers{nullptr};
+
+struct RetiredObject {
+  // Readers reading with this epoch (or later ones) can't see it.
+  std::uint64_t epoch;
+  ErasedPtr ptr;
+};
+
+// Leaked intentionally, objects still retired at exit are not freed. Freeing
+// them here could race with static destructors they depend on.
+std::mutex* retired_lock = new std::mutex();
+std::vector<RetiredObject>* retired = new std::vector<RetiredObject>();
+
+// Returns the reader to the pool on thread exit.
+struct ReaderReleaser {
+  Reader* reader = nullptr;
+
+  ~ReaderReleaser() {
+    if (reader) {
+      FLARE_CHECK_EQ(reader->nesting, 0);
+      reader->in_use.store(false, std::memory_order_release);
+    }
+  }
+};
+
+}  // namespace
+
+Reader* GetCurrentThreadReaderSlow() {
+  thread_local ReaderReleaser releaser;
+
+  // Reuse one left by an exited thread if possible.
+  for (auto p = readers.load(std::memory_order_acquire); p; p = p->next) {
+    if (!p->in_use.load(std::memory_order_relaxed) &&
+        !p->in_use.exchange(true, std::memory_order_acquire)) {
+      releaser.reader = p;
+      return p;
+    }
+  }
+
+  auto reader = new Reader();
+  reader->in_use.store(true, std::memory_order_relaxed);
+  reader->next = readers.load(std::memory_order_relaxed);
+  while (!readers.compare_exchange_weak(reader->next, reader,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+  }
+  releaser.reader = reader;
+  return reader;
+}
+
+namespace {
+
+// Returns the minimum epoch of readers in read-side critical sections, without
+// waiting for them.
+std::uint64_t GetMinimumReadingEpoch() {
+  auto result = std::numeric_limits<std::uint64_t>::max();
+  for (auto p = readers.load(std::memory_order_acquire); p; p = p->next) {
+    auto epoch = p->epoch.load(std::memory_order_acquire);
+    if (epoch != 0 && epoch < result) {
+      result = epoch;
+    }
+  }
+  return result;
+}
+
+// Frees objects retired no later than `target` and not visible to readers
+// reading with `min_epoch` or later ones.
+//
+// `target` must be the epoch the caller itself advanced `global_epoch` to.
+// Readers not yet seen by the caller may still be entering with an epoch older
+// than what others have advanced `global_epoch` to since then.
+void Reclaim(std::uint64_t target, std::uint64_t min_epoch) {
+  auto bound = std::min(target, min_epoch);
+  std::vector<RetiredObject> freeing;
+  {
+    std::scoped_lock _(*retired_lock);
+    auto iter = std::partition(
+        retired->begin(), retired->end(),
+        [&](auto&& e) { return e.epoch > bound; });
+    freeing.assign(std::make_move_iterator(iter),
+                   std::make_move_iterator(retired->end()));
+    retired->erase(iter, retired->end());
+  }
+  // Freed outside the lock.
+}
+
+}  // namespace
+
+void Retire(ErasedPtr ptr) {
+  // Readers entering after this point read with (at least) this epoch, and
+  // they don't see `ptr`.
+  auto target = global_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  {
+    std::scoped_lock _(*retired_lock);
+    retired->push_back(RetiredObject{target, std::move(ptr)});
+  }
+  Reclaim(target, GetMinimumReadingEpoch());
+}
+
+}  // namespace detail::rcu
+
+void RcuSynchronize() {
+  using namespace detail::rcu;
+
+  FLARE_CHECK_EQ(GetCurrentThreadReader()->nesting, 0,
+                 "`RcuSynchronize` may not be called inside `RcuReadLock`.");
+
+  // Readers entering after this point are reading with (at least) this epoch,
+  // and they see what has been published before us.
+  auto target = global_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  for (auto p = readers.load(std::memory_order_acquire); p; p = p->next) {
+    int spins = 0;
+    while (true) {
+      auto epoch = p->epoch.load(std::memory_order_acquire);
+      if (epoch == 0 || epoch >= target) {
+        break;
+      }
+      // The reader may have been preempted. Don't keep it from running for
+      // long.
+      if (++spins < 64) {
+        asm volatile("pause" ::: "memory");
+      } else if (spins < 128) {
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+    }
+  }
+
+  // All readers have caught up.
+  Reclaim(target, std::numeric_limits<std::uint64_t>::max());
+}
+
+}  // namespace tinyRPC
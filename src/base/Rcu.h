@@ -0,0 +1,142 @@
+#ifndef _SRC_BASE_RCU_H_
+#define _SRC_BASE_RCU_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include "ErasedPtr.h"
+
+// A minimal epoch-based RCU (read-copy-update).
+//
+// Readers enter a read-side critical section (`RcuReadLock`) and read objects
+// published via `RcuPtr<T>`. This never blocks, nor does it touch memory shared
+// with other readers, so it scales with number of threads.
+//
+// Writers never modify the object readers see. Instead, they publish a new
+// (immutable) object, and retire the old one. Retired objects are freed once
+// readers that may still be reading them have left. Writers don't wait for
+// that, so they can be called from fibers, or with locks held.
+//
+// Read-side critical sections are expected to be short, and MUST NOT block or
+// yield fiber (as the fiber may be resumed in another thread.).
+//
+// Usage:
+//
+// RcuPtr<const std::vector<int>> values{std::make_unique<std::vector<int>>()};
+//
+// // Reader.
+// {
+//   RcuReadLock _;
+//   for (auto&& e : *values.Get()) {
+//     // ...
+//   }
+// }
+//
+// // Writer.
+// values.Reset(std::make_unique<std::vector<int>>(...));
+
+namespace tinyRPC {
+
+namespace detail::rcu {
+
+// Each thread has one.
+struct alignas(64) Reader {
+  // Epoch at the time the (outermost) read-side critical section is entered,
+  // or 0 if the thread is not in one.
+  std::atomic<std::uint64_t> epoch{0};
+  std::size_t nesting = 0;  // Accessed by the owning thread only.
+
+  std::atomic<bool> in_use{false};
+  Reader* next = nullptr;  // Readers are never freed, only reused.
+};
+
+inline std::atomic<std::uint64_t> global_epoch{1};
+
+Reader* GetCurrentThreadReaderSlow();
+
+// Frees `ptr` once read-side critical sections entered before this call have
+// ended. Never blocks. It may be freed before returning, or by a later call to
+// `Retire` / `RcuSynchronize` (from any thread).
+void Retire(ErasedPtr ptr);
+
+inline Reader* GetCurrentThreadReader() noexcept {
+  thread_local Reader* reader = GetCurrentThreadReaderSlow();
+  return reader;
+}
+
+}  // namespace detail::rcu
+
+// Marks a read-side critical section of current thread. Objects read from
+// `RcuPtr` stay alive until it ends. It may be nested.
+class RcuReadLock {
+ public:
+  RcuReadLock() noexcept : reader_(detail::rcu::GetCurrentThreadReader()) {
+    if (reader_->nesting++ == 0) {
+      reader_->epoch.store(
+          detail::rcu::global_epoch.load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+      // Pairs with the fence in `RcuSynchronize`. Either the writer sees us
+      // reading, or we see what it has published.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+  }
+
+  ~RcuReadLock() {
+    if (--reader_->nesting == 0) {
+      reader_->epoch.store(0, std::memory_order_release);
+    }
+  }
+
+  RcuReadLock(const RcuReadLock&) = delete;
+  RcuReadLock& operator=(const RcuReadLock&) = delete;
+
+ private:
+  detail::rcu::Reader* reader_;
+};
+
+// Waits until all read-side critical sections entered before this call have
+// ended, and frees objects retired before this call. It must not be called
+// inside a read-side critical section.
+void RcuSynchronize();
+
+// A pointer whose pointee is read under `RcuReadLock`, and replaced as a whole.
+//
+// `T` is usually `const`-qualified: Objects published should not be modified.
+template <class T>
+class RcuPtr {
+ public:
+  RcuPtr() = default;
+  explicit RcuPtr(std::unique_ptr<T> ptr) : ptr_(ptr.release()) {}
+  ~RcuPtr() { delete ptr_.load(std::memory_order_relaxed); }
+
+  // Must be called inside `RcuReadLock`. The object returned stays valid until
+  // the read-side critical section ends.
+  //
+  // As an exception, the only thread that may call `Reset` can call this
+  // method without `RcuReadLock`.
+  T* Get() const noexcept { return ptr_.load(std::memory_order_acquire); }
+
+  // Publishes `ptr`. The previous object is destroyed once no reader may see
+  // it, which is likely after this method returns. This method never blocks.
+  //
+  // It may be called concurrently, and inside `RcuReadLock`.
+  void Reset(std::unique_ptr<T> ptr) {
+    auto old = ptr_.exchange(ptr.release(), std::memory_order_seq_cst);
+    if (old) {
+      detail::rcu::Retire(ErasedPtr(const_cast<std::remove_const_t<T>*>(old)));
+    }
+  }
+
+  RcuPtr(const RcuPtr&) = delete;
+  RcuPtr& operator=(const RcuPtr&) = delete;
+
+ private:
+  std::atomic<T*> ptr_{nullptr};
+};
+
+}  // namespace tinyRPC
+
+#endif
@@ -0,0 +1,133 @@
+#include "Rcu.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std::literals;
+
+namespace tinyRPC {
+
+namespace {
+
+struct Value {
+  explicit Value(int v) : value(v) { ++alive; }
+  ~Value() {
+    value = -1;
+    --alive;
+  }
+
+  int value;
+  static inline std::atomic<int> alive{0};
+};
+
+}  // namespace
+
+TEST(Rcu, Basic) {
+  {
+    RcuPtr<const Value> ptr(std::make_unique<Value>(1));
+    {
+      RcuReadLock _;
+      EXPECT_EQ(1, ptr.Get()->value);
+    }
+    ptr.Reset(std::make_unique<Value>(2));
+    EXPECT_EQ(1, Value::alive);
+    RcuReadLock _;
+    EXPECT_EQ(2, ptr.Get()->value);
+  }
+  EXPECT_EQ(0, Value::alive);
+}
+
+TEST(Rcu, Nested) {
+  RcuPtr<const Value> ptr(std::make_unique<Value>(1));
+  RcuReadLock outer;
+  {
+    RcuReadLock inner;
+    EXPECT_EQ(1, ptr.Get()->value);
+  }
+  EXPECT_EQ(1, ptr.Get()->value);
+}
+
+TEST(Rcu, ResetWithoutWaitingForReaders) {
+  RcuPtr<const Value> ptr(std::make_unique<Value>(1));
+  std::atomic<bool> reading{false}, done{false};
+  std::thread reader([&] {
+    RcuReadLock _;
+    auto p = ptr.Get();
+    reading = true;
+    std::this_thread::sleep_for(100ms);
+    EXPECT_EQ(1, p->value);  // Not freed yet.
+    done = true;
+  });
+  while (!reading) {
+  }
+  ptr.Reset(std::make_unique<Value>(2));
+  EXPECT_FALSE(done);
+  EXPECT_EQ(2, Value::alive);  // Retired, but still being read.
+  reader.join();
+  RcuSynchronize();
+  EXPECT_EQ(1, Value::alive);
+}
+
+TEST(Rcu, ResetInsideReadLock) {
+  RcuPtr<const Value> ptr(std::make_unique<Value>(1));
+  {
+    RcuReadLock _;
+    auto p = ptr.Get();
+    ptr.Reset(std::make_unique<Value>(2));
+    EXPECT_EQ(1, p->value);  // We're still reading it.
+    EXPECT_EQ(2, ptr.Get()->value);
+  }
+  // Freed by whoever comes next.
+  ptr.Reset(std::make_unique<Value>(3));
+  EXPECT_EQ(1, Value::alive);
+}
+
+TEST(Rcu, Torture) {
+  RcuPtr<const Value> ptr(std::make_unique<Value>(0));
+  std::atomic<bool> leaving{false};
+  std::vector<std::thread> readers;
+  for (int i = 0; i != 8; ++i) {
+    readers.emplace_back([&] {
+      int last = 0;
+      while (!leaving.load(std::memory_order_relaxed)) {
+        {
+          RcuReadLock _;
+          auto value = ptr.Get()->value;
+          ASSERT_GE(value, last);  // Never see a freed (or older) one.
+          last = value;
+        }
+        // Let writers run, in case we're running on a single core.
+        std::this_thread::yield();
+      }
+    });
+  }
+  std::vector<std::thread> writers;
+  std::atomic<int> next{1};
+  for (int i = 0; i != 2; ++i) {
+    writers.emplace_back([&] {
+      for (int j = 0; j != 10000; ++j) {
+        // Serialized so that values published are increasing.
+        static std::mutex lock;
+        std::scoped_lock _(lock);
+        ptr.Reset(std::make_unique<Value>(next++));
+      }
+    });
+  }
+  for (auto&& e : writers) {
+    e.join();
+  }
+  leaving = true;
+  for (auto&& e : readers) {
+    e.join();
+  }
+  RcuSynchronize();
+  EXPECT_EQ(1, Value::alive);
+}
+
+}  // namespace tinyRPC
@@ -0,0 +1,161 @@
+#ifndef _SRC_BASE_REF_PTR_H_
+#define _SRC_BASE_REF_PTR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "Likely.h"
+
+// Intrusively reference counted pointer.
+//
+// Compared to `std::shared_ptr`, no separate control block is allocated, and
+// the object decides how it should be freed (e.g., returned to an object pool)
+// by specializing `RefTraits<T>`.
+
+namespace tinyRPC {
+
+// Tags for constructing `RefPtr`.
+//
+// `ref_ptr`: Increment the reference count.
+// `adopt_ptr`: Take over the reference the caller holds.
+inline constexpr struct ref_ptr_t {
+  constexpr explicit ref_ptr_t() = default;
+} ref_ptr;
+inline constexpr struct adopt_ptr_t {
+  constexpr explicit adopt_ptr_t() = default;
+} adopt_ptr;
+
+// Called when reference count of `T` reaches zero. Specialize it if `delete`
+// is not what you want.
+template <class T>
+struct RefTraits {
+  static void Destroy(T* ptr) { delete ptr; }
+};
+
+// Inherit from this class to make `T` reference counted. The reference count
+// is initialized to 1.
+template <class T>
+class RefCounted {
+ public:
+  void Ref() noexcept { refs_.fetch_add(1, std::memory_order_relaxed); }
+
+  void Deref() noexcept {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      RefTraits<T>::Destroy(static_cast<T*>(this));
+    }
+  }
+
+  std::uint32_t UnsafeRefCount() const noexcept {
+    return refs_.load(std::memory_order_relaxed);
+  }
+
+ protected:
+  RefCounted() = default;
+  ~RefCounted() = default;
+
+  // For objects recycled by object pools.
+  void ResetRefCount() noexcept { refs_.store(1, std::memory_order_relaxed); }
+
+ private:
+  std::atomic<std::uint32_t> refs_{1};
+};
+
+template <class T>
+class RefPtr {
+ public:
+  constexpr RefPtr() noexcept = default;
+  /* implicit */ constexpr RefPtr(std::nullptr_t) noexcept {}
+  RefPtr(ref_ptr_t, T* ptr) noexcept : ptr_(ptr) {
+    if (ptr_) {
+      ptr_->Ref();
+    }
+  }
+  RefPtr(adopt_ptr_t, T* ptr) noexcept : ptr_(ptr) {}
+  ~RefPtr() { Reset(); }
+
+  RefPtr(const RefPtr& other) noexcept : RefPtr(ref_ptr, other.ptr_) {}
+  RefPtr(RefPtr&& other) noexcept : ptr_(std::exchange(other.ptr_, nullptr)) {}
+
+  // Conversion from `RefPtr<Derived>`.
+  template <class U,
+            class = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+  /* implicit */ RefPtr(RefPtr<U> other) noexcept : ptr_(other.Leak()) {}
+  RefPtr& operator=(const RefPtr& other) noexcept {
+    if (this != &other) {
+      Reset(ref_ptr, other.ptr_);
+    }
+    return *this;
+  }
+  RefPtr& operator=(RefPtr&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      ptr_ = std::exchange(other.ptr_, nullptr);
+    }
+    return *this;
+  }
+  RefPtr& operator=(std::nullptr_t) noexcept {
+    Reset();
+    return *this;
+  }
+
+  T* Get() const noexcept { return ptr_; }
+  T* operator->() const noexcept { return ptr_; }
+  T& operator*() const noexcept { return *ptr_; }
+  explicit operator bool() const noexcept { return !!ptr_; }
+
+  void Reset() noexcept {
+    if (auto p = std::exchange(ptr_, nullptr)) {
+      p->Deref();
+    }
+  }
+  void Reset(ref_ptr_t, T* ptr) noexcept {
+    if (ptr) {
+      ptr->Ref();
+    }
+    Reset();
+    ptr_ = ptr;
+  }
+  void Reset(adopt_ptr_t, T* ptr) noexcept {
+    Reset();
+    ptr_ = ptr;
+  }
+
+  // Release the pointer without decrementing its reference count.
+  [[nodiscard]] T* Leak() noexcept { return std::exchange(ptr_, nullptr); }
+
+ private:
+  T* ptr_ = nullptr;
+};
+
+template <class T>
+bool operator==(const RefPtr<T>& left, const RefPtr<T>& right) noexcept {
+  return left.Get() == right.Get();
+}
+
+template <class T>
+bool operator!=(const RefPtr<T>& left, const RefPtr<T>& right) noexcept {
+  return left.Get() != right.Get();
+}
+
+template <class T>
+bool operator==(const RefPtr<T>& ptr, std::nullptr_t) noexcept {
+  return !ptr;
+}
+
+template <class T>
+bool operator!=(const RefPtr<T>& ptr, std::nullptr_t) noexcept {
+  return !!ptr;
+}
+
+// Shorthand for `RefPtr<T>(adopt_ptr, new T(...))`.
+template <class T, class... Args>
+RefPtr<T> MakeRefCounted(Args&&... args) {
+  return RefPtr<T>(adopt_ptr, new T(std::forward<Args>(args)...));
+}
+
+}  // namespace tinyRPC
+
+#endif
@@ -0,0 +1,82 @@
+#include "ZeroCopyStream.h"
+
+#include <algorithm>
+
+#include "Logging.h"
+
+namespace tinyRPC {
+
+NoncontiguousBufferInputStream::NoncontiguousBufferInputStream(
+    const NoncontiguousBuffer* ref)
+    : current_(ref->begin()), end_(ref->end()) {}
+
+bool NoncontiguousBufferInputStream::Next(const void** data, int* size) {
+  while (current_ != end_ && offset_ == current_->size()) {
+    ++current_;
+    offset_ = 0;
+  }
+  if (current_ == end_) {
+    return false;
+  }
+  *data = current_->data() + offset_;
+  *size = current_->size() - offset_;
+  read_ += *size;
+  offset_ = current_->size();
+  return true;
+}
+
+void NoncontiguousBufferInputStream::BackUp(int count) {
+  // Only bytes returned by the last `Next` may be backed up.
+  FLARE_CHECK_LE(count, offset_);
+  offset_ -= count;
+  read_ -= count;
+}
+
+bool NoncontiguousBufferInputStream::Skip(int count) {
+  while (count) {
+    if (current_ == end_) {
+      return false;
+    }
+    auto skipping = std::min<std::size_t>(count, current_->size() - offset_);
+    offset_ += skipping;
+    read_ += skipping;
+    count -= skipping;
+    if (offset_ == current_->size()) {
+      ++current_;
+      offset_ = 0;
+    }
+  }
+  return true;
+}
+
+google::protobuf::int64 NoncontiguousBufferInputStream::ByteCount() const {
+  return read_;
+}
+
+void NoncontiguousBufferOutputStream::Flush() {
+  if (pending_) {
+    builder_->MarkWritten(std::exchange(pending_, 0));
+  }
+}
+
+bool NoncontiguousBufferOutputStream::Next(void** data, int* size) {
+  Flush();
+  *data = builder_->data();
+  *size = builder_->SizeAvailable();
+  pending_ = *size;
+  written_ += *size;
+  return true;
+}
+
+void NoncontiguousBufferOutputStream::BackUp(int count) {
+  FLARE_CHECK_LE(count, pending_);
+  pending_ -= count;
+  written_ -= count;
+  Flush();
+}
+
+google::protobuf::int64 NoncontiguousBufferOutputStream::ByteCount() const {
+  return written_;
+}
+
+}  // namespace tinyRPC
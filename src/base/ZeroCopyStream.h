@@ -0,0 +1,58 @@
+#ifndef _SRC_BASE_ZERO_COPY_STREAM_H_
+#define _SRC_BASE_ZERO_COPY_STREAM_H_
+
+#include <cstddef>
+
+#include "google/protobuf/io/zero_copy_stream.h"
+
+#include "Buffer.h"
+
+// Adaptors for parsing / serializing Protocol Buffers messages from / into
+// `NoncontiguousBuffer` without flattening it first.
+
+namespace tinyRPC {
+
+// Reads bytes from a `NoncontiguousBuffer`. The buffer itself is not
+// consumed, and must outlive this object.
+class NoncontiguousBufferInputStream
+    : public google::protobuf::io::ZeroCopyInputStream {
+ public:
+  explicit NoncontiguousBufferInputStream(const NoncontiguousBuffer* ref);
+
+  bool Next(const void** data, int* size) override;
+  void BackUp(int count) override;
+  bool Skip(int count) override;
+  google::protobuf::int64 ByteCount() const override;
+
+ private:
+  NoncontiguousBuffer::const_iterator current_, end_;
+  std::size_t offset_ = 0;  // Bytes consumed in `*current_`.
+  std::size_t read_ = 0;
+};
+
+// Writes bytes into a `NoncontiguousBufferBuilder`, which must outlive this
+// object.
+class NoncontiguousBufferOutputStream
+    : public google::protobuf::io::ZeroCopyOutputStream {
+ public:
+  explicit NoncontiguousBufferOutputStream(NoncontiguousBufferBuilder* builder)
+      : builder_(builder) {}
+  ~NoncontiguousBufferOutputStream() override { Flush(); }
+
+  // Commit bytes written into the builder. Called automatically on
+  // destruction.
+  void Flush();
+
+  bool Next(void** data, int* size) override;
+  void BackUp(int count) override;
+  google::protobuf::int64 ByteCount() const override;
+
+ private:
+  NoncontiguousBufferBuilder* builder_;
+  std::size_t pending_ = 0;  // Returned by last `Next` but not committed.
+  std::size_t written_ = 0;
+};
+
+}  // namespace tinyRPC
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef _SRC_BASE_COMPRESSION_BUILTIN_H_
+#define _SRC_BASE_COMPRESSION_BUILTIN_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "Compression.h"
+
+// Implementation detail of `Compression.cpp`.
+//
+// Built-in compressors are registered in `Compression.cpp` rather than in
+// their own translation units, otherwise the linker is free to drop them as
+// nobody references them.
+
+namespace tinyRPC::compression::detail {
+
+std::unique_ptr<Compressor> NewGzipCompressor();
+std::unique_ptr<Decompressor> NewGzipDecompressor();
+
+// Only defined if the corresponding library is found at build time.
+std::unique_ptr<Compressor> NewLz4FrameCompressor();
+std::unique_ptr<Decompressor> NewLz4FrameDecompressor();
+std::unique_ptr<Compressor> NewZstdCompressor();
+std::unique_ptr<Decompressor> NewZstdDecompressor();
+
+// Copies `size` bytes at `src` to `out`. For codecs that can't write into
+// `out` directly.
+bool CopyTo(const void* src, std::size_t size, CompressionOutputStream* out);
+
+}  // namespace tinyRPC::compression::detail
+
+#endif
@@ -0,0 +1,137 @@
+#include "Compression.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "../ZeroCopyStream.h"
+#include "Builtin.h"
+
+namespace tinyRPC {
+
+FLARE_DEFINE_CLASS_DEPENDENCY_REGISTRY(compressor_registry, Compressor);
+FLARE_DEFINE_CLASS_DEPENDENCY_REGISTRY(decompressor_registry, Decompressor);
+
+FLARE_REGISTER_CLASS_DEPENDENCY_FACTORY(compressor_registry, "gzip",
+                                        compression::detail::NewGzipCompressor);
+FLARE_REGISTER_CLASS_DEPENDENCY_FACTORY(
+    decompressor_registry, "gzip", compression::detail::NewGzipDecompressor);
+
+#ifdef TINYRPC_WITH_LZ4
+FLARE_REGISTER_CLASS_DEPENDENCY_FACTORY(
+    compressor_registry, "lz4-frame",
+    compression::detail::NewLz4FrameCompressor);
+FLARE_REGISTER_CLASS_DEPENDENCY_FACTORY(
+    decompressor_registry, "lz4-frame",
+    compression::detail::NewLz4FrameDecompressor);
+#endif
+
+#ifdef TINYRPC_WITH_ZSTD
+FLARE_REGISTER_CLASS_DEPENDENCY_FACTORY(compressor_registry, "zstd",
+                                        compression::detail::NewZstdCompressor);
+FLARE_REGISTER_CLASS_DEPENDENCY_FACTORY(
+    decompressor_registry, "zstd", compression::detail::NewZstdDecompressor);
+#endif
+
+namespace {
+
+// Refuses to hand out more buffer once `limit` bytes have been written.
+class SizeLimitedOutputStream : public CompressionOutputStream {
+ public:
+  SizeLimitedOutputStream(CompressionOutputStream* out, std::size_t limit)
+      : out_(out), limit_(limit) {}
+
+  bool Next(void** data, int* size) override {
+    // Output of exactly `limit_` bytes is allowed, so the decompressor may
+    // still ask for (and leave unused) a buffer when we're at the limit.
+    if (out_->ByteCount() > limit_) {
+      return false;
+    }
+    return out_->Next(data, size);
+  }
+  void BackUp(int count) override { out_->BackUp(count); }
+  google::protobuf::int64 ByteCount() const override {
+    return out_->ByteCount();
+  }
+
+  bool Exceeded() const { return out_->ByteCount() > limit_; }
+
+ private:
+  CompressionOutputStream* out_;
+  std::size_t limit_;
+};
+
+}  // namespace
+
+std::unique_ptr<Compressor> MakeCompressor(std::string_view name) {
+  return compressor_registry.TryNew(name);
+}
+
+std::unique_ptr<Decompressor> MakeDecompressor(std::string_view name) {
+  return decompressor_registry.TryNew(name);
+}
+
+bool Compress(Compressor* compressor, const NoncontiguousBuffer& buffer,
+              NoncontiguousBufferBuilder* builder) {
+  NoncontiguousBufferOutputStream out(builder);
+  for (auto&& e : buffer) {
+    if (!compressor->Append(e.data(), e.size(), &out)) {
+      return false;
+    }
+  }
+  return compressor->Flush(&out);
+}
+
+bool Decompress(Decompressor* decompressor, const NoncontiguousBuffer& buffer,
+                NoncontiguousBufferBuilder* builder, std::size_t max_size) {
+  NoncontiguousBufferOutputStream nb_out(builder);
+  SizeLimitedOutputStream out(&nb_out, max_size);
+  for (auto&& e : buffer) {
+    if (!decompressor->Append(e.data(), e.size(), &out)) {
+      return false;
+    }
+  }
+  return decompressor->Flush(&out) && !out.Exceeded();
+}
+
+std::optional<NoncontiguousBuffer> Compress(Compressor* compressor,
+                                            const NoncontiguousBuffer& buffer) {
+  NoncontiguousBufferBuilder builder;
+  if (!Compress(compressor, buffer, &builder)) {
+    return std::nullopt;
+  }
+  return builder.DestructiveGet();
+}
+
+std::optional<NoncontiguousBuffer> Decompress(
+    Decompressor* decompressor, const NoncontiguousBuffer& buffer,
+    std::size_t max_size) {
+  NoncontiguousBufferBuilder builder;
+  if (!Decompress(decompressor, buffer, &builder, max_size)) {
+    return std::nullopt;
+  }
+  return builder.DestructiveGet();
+}
+
+namespace compression::detail {
+
+bool CopyTo(const void* src, std::size_t size, CompressionOutputStream* out) {
+  auto p = static_cast<const char*>(src);
+  while (size) {
+    void* data;
+    int avail;
+    if (!out->Next(&data, &avail)) {
+      return false;
+    }
+    auto copying = std::min<std::size_t>(size, avail);
+    memcpy(data, p, copying);
+    out->BackUp(avail - copying);
+    p += copying;
+    size -= copying;
+  }
+  return true;
+}
+
+}  // namespace compression::detail
+
+}  // namespace tinyRPC
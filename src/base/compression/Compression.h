@@ -0,0 +1,82 @@
+#ifndef _SRC_BASE_COMPRESSION_COMPRESSION_H_
+#define _SRC_BASE_COMPRESSION_COMPRESSION_H_
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "google/protobuf/io/zero_copy_stream.h"
+
+#include "../Buffer.h"
+#include "../DependencyRegistry.h"
+
+// Streaming compressors / decompressors. Both of them consume input piece by
+// piece (e.g., block by block of a `NoncontiguousBuffer`), and write their
+// output into a `ZeroCopyOutputStream`, so that neither the input nor the
+// output has to be contiguous.
+
+namespace tinyRPC {
+
+// Where the compressed / decompressed bytes go. Usually it's a
+// `NoncontiguousBufferOutputStream`.
+using CompressionOutputStream = google::protobuf::io::ZeroCopyOutputStream;
+
+class Compressor {
+ public:
+  virtual ~Compressor() = default;
+
+  // Compresses `size` bytes at `src`. Output may be buffered internally until
+  // `Flush` is called.
+  virtual bool Append(const void* src, std::size_t size,
+                      CompressionOutputStream* out) = 0;
+
+  // Finishes the stream. The compressor can't be used afterwards.
+  virtual bool Flush(CompressionOutputStream* out) = 0;
+};
+
+class Decompressor {
+ public:
+  virtual ~Decompressor() = default;
+
+  // Decompresses `size` bytes at `src`, which needn't be a complete frame.
+  virtual bool Append(const void* src, std::size_t size,
+                      CompressionOutputStream* out) = 0;
+
+  // Finishes the stream. Fails if the input seen so far is truncated.
+  virtual bool Flush(CompressionOutputStream* out) = 0;
+};
+
+// Built-in ones are "gzip", and, depending on what's available at build time,
+// "lz4-frame" and "zstd".
+FLARE_DECLARE_CLASS_DEPENDENCY_REGISTRY(compressor_registry, Compressor);
+FLARE_DECLARE_CLASS_DEPENDENCY_REGISTRY(decompressor_registry, Decompressor);
+
+// Returns `nullptr` if `name` is not known.
+std::unique_ptr<Compressor> MakeCompressor(std::string_view name);
+std::unique_ptr<Decompressor> MakeDecompressor(std::string_view name);
+
+// Feed `buffer` to `compressor` / `decompressor` block by block, and finish the
+// stream. Output is appended to `builder`.
+//
+// Decompression fails once more than `max_size` bytes are produced, so that a
+// small input can't blow up our memory. At most one block more than that is
+// allocated before we stop.
+bool Compress(Compressor* compressor, const NoncontiguousBuffer& buffer,
+              NoncontiguousBufferBuilder* builder);
+bool Decompress(
+    Decompressor* decompressor, const NoncontiguousBuffer& buffer,
+    NoncontiguousBufferBuilder* builder,
+    std::size_t max_size = std::numeric_limits<std::size_t>::max());
+
+// Shorthands for the above ones.
+std::optional<NoncontiguousBuffer> Compress(Compressor* compressor,
+                                            const NoncontiguousBuffer& buffer);
+std::optional<NoncontiguousBuffer> Decompress(
+    Decompressor* decompressor, const NoncontiguousBuffer& buffer,
+    std::size_t max_size = std::numeric_limits<std::size_t>::max());
+
+}  // namespace tinyRPC
+
+#endif
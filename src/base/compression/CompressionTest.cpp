@@ -0,0 +1,131 @@
+#include "Compression.h"
+
+#include <string>
+
+#include "../../../include/gtest/gtest.h"
+
+#include "../Random.h"
+
+namespace tinyRPC {
+
+namespace {
+
+NoncontiguousBuffer MakeFragmented(const std::string& s, std::size_t piece) {
+  NoncontiguousBuffer nb;
+  for (std::size_t i = 0; i < s.size(); i += piece) {
+    nb.Append(CreateBufferSlow(s.substr(i, piece)));
+  }
+  return nb;
+}
+
+// Compressible, yet not trivially.
+std::string MakeText(std::size_t size) {
+  std::string s;
+  while (s.size() < size) {
+    s += std::to_string(Random(100)) + " bottles of beer on the wall. ";
+  }
+  s.resize(size);
+  return s;
+}
+
+std::string RoundTrip(const std::string& name, const std::string& s,
+                      std::size_t piece) {
+  auto c = MakeCompressor(name);
+  auto compressed = Compress(c.get(), MakeFragmented(s, piece));
+  EXPECT_TRUE(compressed);
+  if (s.size() > 1000) {  // Framing overhead dominates otherwise.
+    EXPECT_LT(compressed->ByteSize(), s.size());
+  }
+
+  // Decompress it piece by piece as well.
+  auto d = MakeDecompressor(name);
+  auto decompressed = Decompress(
+      d.get(), MakeFragmented(FlattenSlow(*compressed), piece / 3 + 1));
+  EXPECT_TRUE(decompressed);
+  return decompressed ? FlattenSlow(*decompressed) : "";
+}
+
+const char* kBuiltinCompressors[] = {"gzip", "lz4-frame", "zstd"};
+
+}  // namespace
+
+TEST(Compression, Unknown) {
+  EXPECT_FALSE(MakeCompressor("never-heard-of-it"));
+  EXPECT_FALSE(MakeDecompressor("never-heard-of-it"));
+}
+
+TEST(Compression, RoundTrip) {
+  ASSERT_TRUE(MakeCompressor("gzip"));  // Always available.
+
+  for (auto&& name : kBuiltinCompressors) {
+    if (!MakeCompressor(name)) {
+      continue;  // Not built in.
+    }
+    for (auto size : {0, 1, 100, 4096, 1000000}) {
+      for (auto piece : {1, 7, 4096, 100000}) {
+        if (size / piece > 10000) {
+          continue;  // Too slow.
+        }
+        auto s = MakeText(size);
+        EXPECT_EQ(s, RoundTrip(name, s, piece)) << name;
+      }
+    }
+  }
+}
+
+TEST(Compression, Gzip) {
+  auto compressed =
+      Compress(MakeCompressor("gzip").get(), CreateBufferSlow(MakeText(100)));
+  ASSERT_TRUE(compressed);
+  auto flatten = FlattenSlow(*compressed);
+  ASSERT_GE(flatten.size(), 2);
+  EXPECT_EQ('\x1f', flatten[0]);  // gzip magic.
+  EXPECT_EQ('\x8b', flatten[1]);
+}
+
+TEST(Compression, Corrupted) {
+  for (auto&& name : kBuiltinCompressors) {
+    auto c = MakeCompressor(name);
+    if (!c) {
+      continue;
+    }
+    auto compressed = FlattenSlow(*Compress(c.get(), CreateBufferSlow(
+                                                         MakeText(10000))));
+
+    // Truncated.
+    EXPECT_FALSE(Decompress(MakeDecompressor(name).get(),
+                            CreateBufferSlow(compressed.substr(
+                                0, compressed.size() / 2))))
+        << name;
+
+    // Garbage.
+    EXPECT_FALSE(Decompress(MakeDecompressor(name).get(),
+                            CreateBufferSlow(std::string(100, 'x'))))
+        << name;
+  }
+}
+
+TEST(Compression, MaxSize) {
+  for (auto&& name : kBuiltinCompressors) {
+    auto c = MakeCompressor(name);
+    if (!c) {
+      continue;
+    }
+    // Highly compressible, as a decompression bomb would be.
+    auto s = std::string(1000000, 'x');
+    auto compressed = *Compress(c.get(), CreateBufferSlow(s));
+
+    auto decompressed =
+        Decompress(MakeDecompressor(name).get(), compressed, s.size());
+    ASSERT_TRUE(decompressed) << name;
+    EXPECT_EQ(s, FlattenSlow(*decompressed)) << name;
+
+    EXPECT_FALSE(
+        Decompress(MakeDecompressor(name).get(), compressed, s.size() - 1))
+        << name;
+    EXPECT_FALSE(Decompress(MakeDecompressor(name).get(), compressed, 1000))
+        << name;
+  }
+}
+
+}  // namespace tinyRPC
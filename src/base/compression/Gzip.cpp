@@ -0,0 +1,126 @@
+#include <cstring>
+
+#include "zlib.h"
+
+#include "../Logging.h"
+#include "Builtin.h"
+
+namespace tinyRPC::compression::detail {
+
+namespace {
+
+// Let zlib write in gzip format (rather than raw deflate or zlib format).
+constexpr auto kGzipWindowBits = 15 + 16;
+
+// When decompressing, both zlib and gzip format are recognized.
+constexpr auto kAutoDetectWindowBits = 15 + 32;
+
+class GzipCompressor : public Compressor {
+ public:
+  GzipCompressor() {
+    memset(&stream_, 0, sizeof(stream_));
+    FLARE_CHECK_EQ(Z_OK, deflateInit2(&stream_, Z_DEFAULT_COMPRESSION,
+                                      Z_DEFLATED, kGzipWindowBits, 8,
+                                      Z_DEFAULT_STRATEGY));
+  }
+  ~GzipCompressor() override { deflateEnd(&stream_); }
+
+  bool Append(const void* src, std::size_t size,
+              CompressionOutputStream* out) override {
+    return Deflate(src, size, Z_NO_FLUSH, out);
+  }
+
+  bool Flush(CompressionOutputStream* out) override {
+    return Deflate(nullptr, 0, Z_FINISH, out);
+  }
+
+ private:
+  bool Deflate(const void* src, std::size_t size, int flush,
+               CompressionOutputStream* out) {
+    stream_.next_in = static_cast<Bytef*>(const_cast<void*>(src));
+    stream_.avail_in = size;
+    while (true) {
+      void* data;
+      int avail;
+      if (!out->Next(&data, &avail)) {
+        return false;
+      }
+      stream_.next_out = static_cast<Bytef*>(data);
+      stream_.avail_out = avail;
+      auto rc = deflate(&stream_, flush);
+      out->BackUp(stream_.avail_out);
+      if (rc == Z_STREAM_ERROR) {
+        return false;
+      }
+      if (flush == Z_FINISH) {
+        if (rc == Z_STREAM_END) {
+          return true;
+        }
+      } else if (!stream_.avail_in && stream_.avail_out) {
+        return true;  // Everything consumed, and nothing pending.
+      }
+    }
+  }
+
+ private:
+  z_stream stream_;
+};
+
+class GzipDecompressor : public Decompressor {
+ public:
+  GzipDecompressor() {
+    memset(&stream_, 0, sizeof(stream_));
+    FLARE_CHECK_EQ(Z_OK, inflateInit2(&stream_, kAutoDetectWindowBits));
+  }
+  ~GzipDecompressor() override { inflateEnd(&stream_); }
+
+  bool Append(const void* src, std::size_t size,
+              CompressionOutputStream* out) override {
+    if (finished_) {
+      return !size;  // Trailing garbage otherwise.
+    }
+    stream_.next_in = static_cast<Bytef*>(const_cast<void*>(src));
+    stream_.avail_in = size;
+    do {
+      void* data;
+      int avail;
+      if (!out->Next(&data, &avail)) {
+        return false;
+      }
+      stream_.next_out = static_cast<Bytef*>(data);
+      stream_.avail_out = avail;
+      auto rc = inflate(&stream_, Z_NO_FLUSH);
+      out->BackUp(stream_.avail_out);
+      if (rc == Z_STREAM_END) {
+        finished_ = true;
+        return !stream_.avail_in;
+      } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+        return false;
+      }
+      // Keep going if the output buffer was filled up, there might be more
+      // bytes pending.
+    } while (stream_.avail_in || !stream_.avail_out);
+    return true;
+  }
+
+  bool Flush(CompressionOutputStream* out) override {
+    // Everything has been written out by `Append`.
+    return finished_;
+  }
+
+ private:
+  z_stream stream_;
+  bool finished_ = false;
+};
+
+}  // namespace
+
+std::unique_ptr<Compressor> NewGzipCompressor() {
+  return std::make_unique<GzipCompressor>();
+}
+
+std::unique_ptr<Decompressor> NewGzipDecompressor() {
+  return std::make_unique<GzipDecompressor>();
+}
+
+}  // namespace tinyRPC::compression::detail
@@ -0,0 +1,130 @@
+#ifdef TINYRPC_WITH_LZ4
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "lz4frame.h"
+
+#include "../Logging.h"
+#include "Builtin.h"
+
+namespace tinyRPC::compression::detail {
+
+namespace {
+
+// Input is fed to LZ4 in chunks of this size, so that the size of our scratch
+// buffer is bounded.
+constexpr std::size_t kChunkSize = 64 * 1024;
+
+class Lz4FrameCompressor : public Compressor {
+ public:
+  Lz4FrameCompressor() {
+    FLARE_CHECK(!LZ4F_isError(
+        LZ4F_createCompressionContext(&ctx_, LZ4F_VERSION)));
+  }
+  ~Lz4FrameCompressor() override { LZ4F_freeCompressionContext(ctx_); }
+
+  bool Append(const void* src, std::size_t size,
+              CompressionOutputStream* out) override {
+    if (!Begin(out)) {
+      return false;
+    }
+    auto p = static_cast<const char*>(src);
+    while (size) {
+      auto chunk = std::min(size, kChunkSize);
+      // LZ4 requires the output buffer to be large enough for the worst case.
+      buffer_.resize(LZ4F_compressBound(chunk, nullptr));
+      auto rc = LZ4F_compressUpdate(ctx_, buffer_.data(), buffer_.size(), p,
+                                    chunk, nullptr);
+      if (LZ4F_isError(rc) || !CopyTo(buffer_.data(), rc, out)) {
+        return false;
+      }
+      p += chunk;
+      size -= chunk;
+    }
+    return true;
+  }
+
+  bool Flush(CompressionOutputStream* out) override {
+    if (!Begin(out)) {
+      return false;
+    }
+    buffer_.resize(LZ4F_compressBound(0, nullptr));
+    auto rc = LZ4F_compressEnd(ctx_, buffer_.data(), buffer_.size(), nullptr);
+    return !LZ4F_isError(rc) && CopyTo(buffer_.data(), rc, out);
+  }
+
+ private:
+  // Writes frame header, if not yet.
+  bool Begin(CompressionOutputStream* out) {
+    if (std::exchange(begun_, true)) {
+      return true;
+    }
+    buffer_.resize(LZ4F_HEADER_SIZE_MAX);
+    auto rc =
+        LZ4F_compressBegin(ctx_, buffer_.data(), buffer_.size(), nullptr);
+    return !LZ4F_isError(rc) && CopyTo(buffer_.data(), rc, out);
+  }
+
+ private:
+  LZ4F_cctx* ctx_;
+  bool begun_ = false;
+  std::string buffer_;
+};
+
+class Lz4FrameDecompressor : public Decompressor {
+ public:
+  Lz4FrameDecompressor() {
+    FLARE_CHECK(!LZ4F_isError(
+        LZ4F_createDecompressionContext(&ctx_, LZ4F_VERSION)));
+  }
+  ~Lz4FrameDecompressor() override { LZ4F_freeDecompressionContext(ctx_); }
+
+  bool Append(const void* src, std::size_t size,
+              CompressionOutputStream* out) override {
+    auto p = static_cast<const char*>(src);
+    bool output_full;
+    do {
+      if (finished_) {
+        return !size;  // Trailing garbage otherwise.
+      }
+      void* data;
+      int avail;
+      if (!out->Next(&data, &avail)) {
+        return false;
+      }
+      std::size_t written = avail, consumed = size;
+      auto rc = LZ4F_decompress(ctx_, data, &written, p, &consumed, nullptr);
+      out->BackUp(avail - written);
+      if (LZ4F_isError(rc)) {
+        return false;
+      }
+      finished_ = rc == 0;  // The frame is fully decoded.
+      p += consumed;
+      size -= consumed;
+      output_full = written == static_cast<std::size_t>(avail);
+    } while (size || output_full);
+    return true;
+  }
+
+  bool Flush(CompressionOutputStream* out) override { return finished_; }
+
+ private:
+  LZ4F_dctx* ctx_;
+  bool finished_ = false;
+};
+
+}  // namespace
+
+std::unique_ptr<Compressor> NewLz4FrameCompressor() {
+  return std::make_unique<Lz4FrameCompressor>();
+}
+
+std::unique_ptr<Decompressor> NewLz4FrameDecompressor() {
+  return std::make_unique<Lz4FrameDecompressor>();
+}
+
+}  // namespace tinyRPC::compression::detail
+
+#endif
@@ -0,0 +1,100 @@
+#ifdef TINYRPC_WITH_ZSTD
+
+#include "zstd.h"
+
+#include "../Logging.h"
+#include "Builtin.h"
+
+namespace tinyRPC::compression::detail {
+
+namespace {
+
+class ZstdCompressor : public Compressor {
+ public:
+  ZstdCompressor() : ctx_(ZSTD_createCCtx()) { FLARE_CHECK(ctx_); }
+  ~ZstdCompressor() override { ZSTD_freeCCtx(ctx_); }
+
+  bool Append(const void* src, std::size_t size,
+              CompressionOutputStream* out) override {
+    return Compress(src, size, ZSTD_e_continue, out);
+  }
+
+  bool Flush(CompressionOutputStream* out) override {
+    return Compress(nullptr, 0, ZSTD_e_end, out);
+  }
+
+ private:
+  bool Compress(const void* src, std::size_t size, ZSTD_EndDirective mode,
+                CompressionOutputStream* out) {
+    ZSTD_inBuffer input = {src, size, 0};
+    while (true) {
+      void* data;
+      int avail;
+      if (!out->Next(&data, &avail)) {
+        return false;
+      }
+      ZSTD_outBuffer output = {data, static_cast<std::size_t>(avail), 0};
+      auto rc = ZSTD_compressStream2(ctx_, &output, &input, mode);
+      out->BackUp(avail - output.pos);
+      if (ZSTD_isError(rc)) {
+        return false;
+      }
+      if (mode == ZSTD_e_end ? rc == 0 : input.pos == input.size) {
+        return true;
+      }
+    }
+  }
+
+ private:
+  ZSTD_CCtx* ctx_;
+};
+
+class ZstdDecompressor : public Decompressor {
+ public:
+  ZstdDecompressor() : ctx_(ZSTD_createDCtx()) { FLARE_CHECK(ctx_); }
+  ~ZstdDecompressor() override { ZSTD_freeDCtx(ctx_); }
+
+  bool Append(const void* src, std::size_t size,
+              CompressionOutputStream* out) override {
+    ZSTD_inBuffer input = {src, size, 0};
+    bool output_full;
+    do {
+      void* data;
+      int avail;
+      if (!out->Next(&data, &avail)) {
+        return false;
+      }
+      ZSTD_outBuffer output = {data, static_cast<std::size_t>(avail), 0};
+      auto rc = ZSTD_decompressStream(ctx_, &output, &input);
+      out->BackUp(avail - output.pos);
+      if (ZSTD_isError(rc)) {
+        return false;
+      }
+      finished_ = rc == 0;  // A frame is fully decoded.
+      output_full = output.pos == output.size;
+      // Once the frame is done, calling it again with no input starts a new
+      // (empty) frame, which we'd then take as being truncated.
+    } while (input.pos != input.size || (output_full && !finished_));
+    return true;
+  }
+
+  bool Flush(CompressionOutputStream* out) override { return finished_; }
+
+ private:
+  ZSTD_DCtx* ctx_;
+  bool finished_ = false;
+};
+
+}  // namespace
+
+std::unique_ptr<Compressor> NewZstdCompressor() {
+  return std::make_unique<ZstdCompressor>();
+}
+
+std::unique_ptr<Decompressor> NewZstdDecompressor() {
+  return std::make_unique<ZstdDecompressor>();
+}
+
+}  // namespace tinyRPC::compression::detail
+
+#endif
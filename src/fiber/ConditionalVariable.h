@@ -40,13 +40,15 @@ class ConditionVariable {
   detail::ConditionVariable impl_;
 };
 
+// Qualified, as `detail::ConditionVariable` may be visible here via
+// using-directives of headers included before us.
 template <class Predicate>
-void ConditionVariable::wait(std::unique_lock<Mutex>& lock, Predicate pred) {
+void fiber::ConditionVariable::wait(std::unique_lock<Mutex>& lock, Predicate pred) {
   impl_.wait(lock, pred);
 }
 
 template <class Rep, class Period>
-bool ConditionVariable::wait_for(
+bool fiber::ConditionVariable::wait_for(
     std::unique_lock<Mutex>& lock,
     std::chrono::duration<Rep, Period> expires_in) {
   auto steady_timeout = std::chrono::steady_clock::now() + expires_in;
@@ -54,7 +56,7 @@ bool ConditionVariable::wait_for(
 }
 
 template <class Rep, class Period, class Predicate>
-bool ConditionVariable::wait_for(std::unique_lock<Mutex>& lock,
+bool fiber::ConditionVariable::wait_for(std::unique_lock<Mutex>& lock,
                                  std::chrono::duration<Rep, Period> expires_in,
                                  Predicate pred) {
   auto steady_timeout = std::chrono::steady_clock::now() + expires_in;
@@ -62,7 +64,7 @@ bool ConditionVariable::wait_for(std::unique_lock<Mutex>& lock,
 }
 
 template <class Clock, class Duration>
-bool ConditionVariable::wait_until(
+bool fiber::ConditionVariable::wait_until(
     std::unique_lock<Mutex>& lock,
     std::chrono::time_point<Clock, Duration> expires_at) {
   auto steady_timeout = std::chrono::steady_clock::now() + (expires_at - Clock::now());
@@ -70,7 +72,7 @@ bool ConditionVariable::wait_until(
 }
 
 template <class Clock, class Duration, class Pred>
-bool ConditionVariable::wait_until(
+bool fiber::ConditionVariable::wait_until(
     std::unique_lock<Mutex>& lock,
     std::chrono::time_point<Clock, Duration> expires_at, Pred pred) {
   auto steady_timeout = std::chrono::steady_clock::now() + (expires_at - Clock::now());
@@ -50,23 +50,66 @@ thread_local std::size_t SchedulingGroup::workerIndex_ = kUninitializedWorkerInd
 SchedulingGroup::SchedulingGroup(std::size_t size)
     : groupSize_(size) {
     waitSlots_ = std::make_unique<WaitSlot[]>(groupSize_);
+    localQueues_ = std::make_unique<
+        std::unique_ptr<WorkStealingQueue<FiberEntity*>>[]>(groupSize_);
+    for (std::size_t index = 0; index != groupSize_; ++index) {
+      localQueues_[index] = std::make_unique<WorkStealingQueue<FiberEntity*>>(
+          kLocalRunQueueCapacity);
+    }
 }
 
 SchedulingGroup::~SchedulingGroup() = default;
 
 FiberEntity* SchedulingGroup::AcquireFiber() noexcept {
-  std::scoped_lock lk(lock_);
-  if (!readyFiberQueue_.empty()) {
-    auto rc = readyFiberQueue_.front();
-    readyFiberQueue_.pop();
-    std::scoped_lock _(rc->schedulerLock_);
+  thread_local std::size_t acquired = 0;
+  FiberEntity* rc = nullptr;
+  bool is_worker = current_ == this && workerIndex_ < groupSize_;
+
+  if (++acquired % kSharedQueueCheckInterval == 0 || !is_worker) {
+    rc = AcquireFiberFromSharedQueue();
+  }
+  if (!rc && is_worker) {
+    rc = localQueues_[workerIndex_]->Steal();
+  }
+  if (!rc) {
+    rc = AcquireFiberFromSharedQueue();
+  }
+  if (!rc) {
+    rc = StealFiberFromLocalQueues(is_worker ? workerIndex_ + 1 : 0);
+  }
+  if (!rc) {
+    return stopped_ ? kSchedulingGroupShuttingDown : nullptr;
+  }
 
-    CHECK(rc->state_ == FiberState::READY);
-    rc->state_ = FiberState::RUNNING;
+  std::scoped_lock _(rc->schedulerLock_);
+  CHECK(rc->state_ == FiberState::READY);
+  rc->state_ = FiberState::RUNNING;
+  return rc;
+}
+
+FiberEntity* SchedulingGroup::AcquireFiberFromSharedQueue() noexcept {
+  // Pairs with `QueueRunnableEntity`, see comments in `WaitForFiber`.
+  if (readyFiberQueueSize_.load(std::memory_order_seq_cst) == 0) {
+    return nullptr;
+  }
+  std::scoped_lock lk(lock_);
+  if (readyFiberQueue_.empty()) {
+    return nullptr;
+  }
+  auto rc = readyFiberQueue_.front();
+  readyFiberQueue_.pop();
+  readyFiberQueueSize_.fetch_sub(1, std::memory_order_relaxed);
+  return rc;
+}
 
-    return rc;
+FiberEntity* SchedulingGroup::StealFiberFromLocalQueues(
+    std::size_t start) noexcept {
+  for (std::size_t i = 0; i != groupSize_; ++i) {
+    if (auto rc = localQueues_[(start + i) % groupSize_]->Steal()) {
+      return rc;
+    }
   }
-  return stopped_ ? kSchedulingGroupShuttingDown : nullptr;
+  return nullptr;
 }
 
 FiberEntity* SchedulingGroup::WaitForFiber() noexcept {
@@ -79,8 +122,12 @@ FiberEntity* SchedulingGroup::WaitForFiber() noexcept {
         sleepingWorkers_.fetch_and(~mask);
     });
 
+    // We must mark ourselves as sleeping before checking the run queues. Either
+    // we see the fiber being queued, or `QueueRunnableEntity` sees us sleeping
+    // (and wakes us up).
     CHECK_EQ(sleepingWorkers_.fetch_or(mask) & mask, 0);
-    
+
+
     if (auto f = AcquireFiber()) {
         if ((sleepingWorkers_.fetch_and(~mask) &mask) == 0) {
             WakeUpOneWorker();
@@ -97,22 +144,43 @@ FiberEntity* SchedulingGroup::WaitForFiber() noexcept {
 }
 
 FiberEntity* SchedulingGroup::RemoteAcquireFiber() noexcept {
-  std::scoped_lock lk(lock_);
-  if(!readyFiberQueue_.empty()){
-    auto rc = readyFiberQueue_.front();
-    if(rc->local_){
+  FiberEntity* rc = nullptr;
+  if (readyFiberQueueSize_.load(std::memory_order_seq_cst)) {
+    std::scoped_lock lk(lock_);
+    if (!readyFiberQueue_.empty()) {
+      rc = readyFiberQueue_.front();
+      if (rc->local_) {
+        return nullptr;
+      }
+      readyFiberQueue_.pop();
+      readyFiberQueueSize_.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  if (!rc) {
+    thread_local std::size_t next_victim = 0;
+    rc = StealFiberFromLocalQueues(next_victim++);
+    if (!rc) {
       return nullptr;
     }
-    readyFiberQueue_.pop();
-    std::scoped_lock _(rc->schedulerLock_);
+    if (rc->local_) {
+      // It's not allowed to leave its scheduling group, put it back.
+      {
+        std::scoped_lock lk(lock_);
+        readyFiberQueue_.push(rc);
+        readyFiberQueueSize_.fetch_add(1, std::memory_order_seq_cst);
+      }
+      WakeUpOneWorker();
+      return nullptr;
+    }
+  }
 
-    CHECK(rc->state_ == FiberState::READY);
-    rc->state_ = FiberState::RUNNING;
+  std::scoped_lock _(rc->schedulerLock_);
+  CHECK(rc->state_ == FiberState::READY);
+  rc->state_ = FiberState::RUNNING;
 
-    rc->sg_ = Current();
-    return rc;
-  }
-  return nullptr;
+  rc->sg_ = Current();
+  return rc;
 }
 
 void SchedulingGroup::StartFiber(FiberEntity* fiberEntity) noexcept {
@@ -233,10 +301,19 @@ bool SchedulingGroup::WakeUpOneDeepSleepingWorker() noexcept {
 }
 
 void SchedulingGroup::QueueRunnableEntity(FiberEntity* entity) noexcept {
-  std::scoped_lock lk(lock_);
   CHECK(!stopped_) << "The scheduling group has been stopped.";
 
-  readyFiberQueue_.push(entity);
+  if (current_ == this && workerIndex_ < groupSize_ &&
+      localQueues_[workerIndex_]->Push(entity)) {
+    // Make sure the push above is visible before we check for sleeping
+    // workers.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  } else {
+    // Readied from outside of this group, or the local run queue is full.
+    std::scoped_lock lk(lock_);
+    readyFiberQueue_.push(entity);
+    readyFiberQueueSize_.fetch_add(1, std::memory_order_seq_cst);
+  }
 
   WakeUpOneWorker();
 }
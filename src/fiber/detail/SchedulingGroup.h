@@ -10,6 +10,7 @@
 #include "../../base/Function.h"
 
 #include "TimerWorker.h"
+#include "WorkStealingQueue.h"
 
 namespace tinyRPC::fiber::detail{
 
@@ -33,6 +34,8 @@ class SchedulingGroup {
     return TimerWorker::GetTimerOwner(timer)->GetSchedulingGroup();
   }
 
+  // Acquire a ready fiber. The caller's local run queue is tried first, then
+  // the shared queue, and then its siblings' local run queues.
   FiberEntity* AcquireFiber() noexcept;
 
   FiberEntity* WaitForFiber() noexcept;
@@ -102,9 +105,27 @@ class SchedulingGroup {
   
   bool WakeUpOneDeepSleepingWorker() noexcept;
 
+  // If called by a worker of this group, `fiberEntity` is pushed into its
+  // local run queue. Otherwise (or if the local run queue is full) the shared
+  // queue is used.
   void QueueRunnableEntity(FiberEntity* fiberEntity) noexcept;
 
+  // Pops a fiber from the shared queue, `nullptr` if it's empty.
+  FiberEntity* AcquireFiberFromSharedQueue() noexcept;
+
+  // Steals a fiber from local run queues of workers in this group (the
+  // caller's own queue included), starting from `start`.
+  FiberEntity* StealFiberFromLocalQueues(std::size_t start) noexcept;
+
  private:
+  // Capacity of each worker's local run queue. Fibers overflow to the shared
+  // queue once it's full.
+  static constexpr std::size_t kLocalRunQueueCapacity = 1024;
+
+  // Every so many acquisitions, the shared queue is checked before the local
+  // run queue. This prevents fibers in the shared queue from being starved.
+  static constexpr std::size_t kSharedQueueCheckInterval = 61;
+
   static constexpr auto kUninitializedWorkerIndex =
       std::numeric_limits<std::size_t>::max();
   static thread_local SchedulingGroup* current_;
@@ -116,9 +137,15 @@ class SchedulingGroup {
   std::size_t groupSize_;
   TimerWorker* timerWorker_ = nullptr;
 
-  SpinLock lock_;
+  // Per-worker local run queues, indexed by worker index.
+  std::unique_ptr<std::unique_ptr<WorkStealingQueue<FiberEntity*>>[]>
+      localQueues_;
 
+  // Overflow of local run queues, and fibers readied from outside of this
+  // group.
+  SpinLock lock_;
   std::queue<FiberEntity*> readyFiberQueue_;
+  std::atomic<std::size_t> readyFiberQueueSize_{0};
 
   // Fiber workers sleep on this.
   std::unique_ptr<WaitSlot[]> waitSlots_;
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../../../include/benchmark/benchmark.h"
+#include "FiberEntity.h"
+#include "SchedulingGroup.h"
+#include "TimerWorker.h"
+#include "Waitable.h"
+
+// Measures spawn / yield throughput of a single scheduling group with 1..N
+// workers.
+//
+// Benchmark_SpawnFromOutside: Fibers are started by a non-worker thread, so
+//                             they go through the shared queue.
+// Benchmark_SpawnFromFiber:   Fibers are started by a fiber in the group, so
+//                             they go through the local run queue (and are
+//                             stolen by siblings).
+// Benchmark_Yield:            Each fiber yields repeatedly.
+
+namespace tinyRPC::fiber::detail {
+
+namespace {
+
+constexpr std::size_t kFibersPerIteration = 1000;
+constexpr std::size_t kYieldsPerFiber = 100;
+
+class GroupRunner {
+ public:
+  explicit GroupRunner(std::size_t workers)
+      : sg_(std::make_unique<SchedulingGroup>(workers)),
+        timer_worker_(sg_.get()) {
+    sg_->SetTimerWorker(&timer_worker_);
+    for (std::size_t i = 0; i != workers; ++i) {
+      workers_.emplace_back([this, i] { WorkerProc(i); });
+    }
+  }
+
+  ~GroupRunner() {
+    sg_->Stop();
+    for (auto&& t : workers_) {
+      t.join();
+    }
+  }
+
+  SchedulingGroup* Get() const { return sg_.get(); }
+
+  template <class F>
+  void StartFiber(F&& f) {
+    sg_->StartFiber(CreateFiberEntity(sg_.get(), std::forward<F>(f),
+                                      std::make_shared<ExitBarrier>()));
+  }
+
+ private:
+  void WorkerProc(std::size_t index) {
+    sg_->EnterGroup(index);
+    while (true) {
+      auto fiber = sg_->AcquireFiber();
+      if (!fiber) {
+        fiber = sg_->WaitForFiber();
+      }
+      if (fiber == SchedulingGroup::kSchedulingGroupShuttingDown) {
+        break;
+      }
+      fiber->Resume();
+    }
+    sg_->LeaveGroup();
+  }
+
+  std::unique_ptr<SchedulingGroup> sg_;
+  TimerWorker timer_worker_;
+  std::vector<std::thread> workers_;
+};
+
+void WaitUntil(const std::atomic<std::size_t>& counter, std::size_t expected) {
+  while (counter.load(std::memory_order_acquire) != expected) {
+    std::this_thread::yield();
+  }
+}
+
+void Benchmark_SpawnFromOutside(benchmark::State& state) {
+  GroupRunner runner(state.range(0));
+  std::atomic<std::size_t> finished;
+
+  while (state.KeepRunning()) {
+    finished = 0;
+    for (std::size_t i = 0; i != kFibersPerIteration; ++i) {
+      runner.StartFiber([&] { finished.fetch_add(1); });
+    }
+    WaitUntil(finished, kFibersPerIteration);
+  }
+  state.SetItemsProcessed(state.iterations() * kFibersPerIteration);
+}
+
+void Benchmark_SpawnFromFiber(benchmark::State& state) {
+  GroupRunner runner(state.range(0));
+  std::atomic<std::size_t> finished;
+
+  while (state.KeepRunning()) {
+    finished = 0;
+    runner.StartFiber([&] {
+      for (std::size_t i = 0; i != kFibersPerIteration; ++i) {
+        runner.StartFiber([&] { finished.fetch_add(1); });
+      }
+    });
+    WaitUntil(finished, kFibersPerIteration);
+  }
+  state.SetItemsProcessed(state.iterations() * kFibersPerIteration);
+}
+
+void Benchmark_Yield(benchmark::State& state) {
+  GroupRunner runner(state.range(0));
+  std::atomic<std::size_t> finished;
+
+  while (state.KeepRunning()) {
+    finished = 0;
+    for (std::size_t i = 0; i != kFibersPerIteration; ++i) {
+      runner.StartFiber([&] {
+        auto sg = SchedulingGroup::Current();
+        for (std::size_t j = 0; j != kYieldsPerFiber; ++j) {
+          sg->Yield(GetCurrentFiberEntity());
+        }
+        finished.fetch_add(1);
+      });
+    }
+    WaitUntil(finished, kFibersPerIteration);
+  }
+  state.SetItemsProcessed(state.iterations() * kFibersPerIteration *
+                          kYieldsPerFiber);
+}
+
+// Scheduling groups are limited to 64 workers.
+const int kMaxWorkers = std::clamp<int>(std::thread::hardware_concurrency(), 1, 64);
+
+}  // namespace
+
+BENCHMARK(Benchmark_SpawnFromOutside)
+    ->RangeMultiplier(2)
+    ->Range(1, kMaxWorkers)
+    ->UseRealTime();
+BENCHMARK(Benchmark_SpawnFromFiber)
+    ->RangeMultiplier(2)
+    ->Range(1, kMaxWorkers)
+    ->UseRealTime();
+BENCHMARK(Benchmark_Yield)
+    ->RangeMultiplier(2)
+    ->Range(1, kMaxWorkers)
+    ->UseRealTime();
+
+}  // namespace tinyRPC::fiber::detail
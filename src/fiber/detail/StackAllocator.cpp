@@ -1,21 +1,156 @@
 #include <unistd.h>
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "../../../include/gflags/gflags.h"
 #include "../../../include/glog/logging.h"
+#include "../../base/Likely.h"
 #include "StackAllocator.h"
 
+DEFINE_int32(flare_fiber_stack_thread_cache_size, 64,
+             "Maximum number of fiber stacks cached by each thread. Setting it "
+             "to 0 disables stack caching.");
+DEFINE_int32(flare_fiber_stack_transfer_cache_size, 1024,
+             "Maximum number of fiber stacks cached globally (i.e., shared "
+             "by all threads). Physical memory of stacks cached here is "
+             "released to the OS. Stacks overflowing this limit are unmapped.");
+
 namespace tinyRPC::fiber::detail{
 
-void* CreateStack(){
+namespace {
+
+// Stacks are moved between thread-local caches and the transfer cache in
+// batches of (at most) this size.
+constexpr std::size_t kTransferBatchSize = 16;
+
+void* CreateStackSlow(){
     auto p = mmap(nullptr, kStackSize, PROT_READ | PROT_WRITE, 
         MAP_ANONYMOUS | MAP_PRIVATE | MAP_STACK, 0, 0);
-    CHECK(p) << "Mmap failed : out-of-memory error\n";
+    CHECK(p != MAP_FAILED) << "Mmap failed : out-of-memory error\n";
     CHECK_EQ(reinterpret_cast<std::uint64_t>(p) % kPageSize, 0) 
             << "Mmap error : addr not aligned with page size\n";
     CHECK_EQ(mprotect(p, kPageSize, PROT_NONE), 0) 
             << "Mprotect error : out-of-memory error\n";   
+    return p;
+}
+
+void DestroyStackSlow(void* ptr){
+    CHECK_EQ(munmap(ptr, kStackSize), 0) << "Munmap error\n";
+}
+
+// Release physical memory of an idle stack. The mapping (as well as the guard
+// page) is kept, accessing it later on yields zero-filled pages.
+void TrimStack(void* ptr){
+    CHECK_EQ(madvise(reinterpret_cast<char*>(ptr) + kPageSize,
+                     kStackSize - kPageSize, MADV_DONTNEED), 0)
+            << "Madvise error\n";
+}
+
+class TransferCache {
+ public:
+  // Returns false if the cache is full, in which case the caller should unmap
+  // the stacks itself.
+  bool Put(std::vector<void*>* stacks) {
+    // Trimming is done without lock held.
+    for (auto&& e : *stacks) {
+      TrimStack(e);
+    }
+    std::scoped_lock _(lock_);
+    auto limit = static_cast<std::size_t>(
+        std::max(FLAGS_flare_fiber_stack_transfer_cache_size, 0));
+    if (stacks_.size() + stacks->size() > limit) {
+      return false;
+    }
+    stacks_.insert(stacks_.end(), stacks->begin(), stacks->end());
+    stacks->clear();
+    return true;
+  }
+
+  // Move at most `count` stacks to `stacks`.
+  void Get(std::vector<void*>* stacks, std::size_t count) {
+    std::scoped_lock _(lock_);
+    auto n = std::min(count, stacks_.size());
+    stacks->insert(stacks->end(), stacks_.end() - n, stacks_.end());
+    stacks_.resize(stacks_.size() - n);
+  }
+
+  std::size_t Size() {
+    std::scoped_lock _(lock_);
+    return stacks_.size();
+  }
+
+ private:
+  std::mutex lock_;
+  std::vector<void*> stacks_;
+};
 
-    auto stack = reinterpret_cast<char*>(p);
+TransferCache* GetTransferCache() {
+  // Never destroyed, threads may still be returning stacks on exit.
+  static auto cache = new TransferCache();
+  return cache;
+}
+
+class ThreadCache {
+ public:
+  ~ThreadCache() {
+    Flush(stacks_.size());
+  }
+
+  void* Get() {
+    if (stacks_.empty()) {
+      GetTransferCache()->Get(&stacks_, kTransferBatchSize);
+      if (stacks_.empty()) {
+        return CreateStackSlow();
+      }
+    }
+    auto rc = stacks_.back();
+    stacks_.pop_back();
+    return rc;
+  }
+
+  void Put(void* ptr) {
+    auto limit = static_cast<std::size_t>(
+        std::max(FLAGS_flare_fiber_stack_thread_cache_size, 0));
+    if (FLARE_UNLIKELY(limit == 0)) {
+      DestroyStackSlow(ptr);
+      return;
+    }
+    stacks_.push_back(ptr);
+    if (stacks_.size() > limit) {
+      // Least recently used stacks (at the front) are moved out. They're the
+      // least likely to be still in CPU cache / TLB.
+      Flush(std::min(kTransferBatchSize, stacks_.size()));
+    }
+  }
+
+ private:
+  // Move `count` least recently used stacks to the transfer cache.
+  void Flush(std::size_t count) {
+    std::vector<void*> batch(stacks_.begin(), stacks_.begin() + count);
+    stacks_.erase(stacks_.begin(), stacks_.begin() + count);
+    if (!GetTransferCache()->Put(&batch)) {
+      for (auto&& e : batch) {
+        DestroyStackSlow(e);
+      }
+    }
+  }
+
+  std::vector<void*> stacks_;  // Most recently used at the back.
+};
+
+ThreadCache* GetThreadCache() {
+  thread_local ThreadCache cache;
+  return &cache;
+}
+
+}  // namespace
+
+void* CreateStack(){
+    auto stack = reinterpret_cast<char*>(GetThreadCache()->Get());
     stack += kPageSize;
 
     return reinterpret_cast<void*>(stack);
@@ -23,7 +158,11 @@ void* CreateStack(){
 
 
 void DestroyStack(void* ptr){
-    CHECK_EQ(munmap(ptr, kStackSize), 0) << "Munmap error\n";
+    GetThreadCache()->Put(ptr);
+}
+
+std::size_t GetTransferCachedStackCount(){
+    return GetTransferCache()->Size();
 }
 
-} // namespace tinyRPC::fiber::detail
\ No newline at end of file
+} // namespace tinyRPC::fiber::detail
@@ -1,6 +1,7 @@
 #ifndef _SRC_FIBER_DETAIL_STACK_ALLOCATOR_H_
 #define _SRC_FIBER_DETAIL_STACK_ALLOCATOR_H_
 
+#include <cstddef>
 #include <cstdint>
 
 namespace tinyRPC::fiber::detail{
@@ -9,10 +10,25 @@ constexpr uint32_t kStackSize = 1024 * 128;
 
 constexpr uint64_t kPageSize = 4 * 1024;
 
+// Stacks are cached, so as to avoid `mmap` / `mprotect` / `munmap` on each
+// fiber creation / destruction.
+//
+// Freed stacks are firstly kept in a thread-local cache. Once it overflows, a
+// batch of stacks is moved to a global transfer cache, where other threads can
+// grab them. Physical memory of stacks in the transfer cache is returned to
+// the OS via `madvise(MADV_DONTNEED)`. Stacks overflowing the transfer cache
+// are unmapped.
+//
+// Returns pointer to the usable part of the stack (guard page excluded).
 void* CreateStack();
 
+// `ptr` is the beginning of the mapping (guard page included).
 void DestroyStack(void* ptr);
 
+// Number of stacks currently in the global transfer cache. For testing
+// purpose.
+std::size_t GetTransferCachedStackCount();
+
 } // namespace tinyRPC::fiber::detail
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,71 @@
+#include <utility>
+#include <vector>
+
+#include "../../../include/benchmark/benchmark.h"
+#include "../../../include/gflags/gflags.h"
+#include "FiberEntity.h"
+#include "StackAllocator.h"
+
+DECLARE_int32(flare_fiber_stack_thread_cache_size);
+DECLARE_int32(flare_fiber_stack_transfer_cache_size);
+
+// Compares fiber creation / destruction throughput with stack caching enabled
+// (the default) and disabled (i.e., `mmap` + `mprotect` + `munmap` for each
+// fiber).
+
+namespace tinyRPC::fiber::detail {
+
+namespace {
+
+// Keeps `state.range(0)` fibers alive at the same time, so as to exercise the
+// cache beyond a single hot stack.
+void CreateDestroyFiberEntities(benchmark::State& state) {
+  std::vector<FiberEntity*> fibers(state.range(0));
+  while (state.KeepRunning()) {
+    for (auto&& e : fibers) {
+      e = CreateFiberEntity(nullptr, [] {});
+    }
+    for (auto&& e : fibers) {
+      FreeFiberEntity(e);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * fibers.size());
+}
+
+}  // namespace
+
+void Benchmark_CreateFiberEntityCached(benchmark::State& state) {
+  CreateDestroyFiberEntities(state);
+}
+
+BENCHMARK(Benchmark_CreateFiberEntityCached)
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(1024)
+    ->ThreadRange(1, 8);
+
+void Benchmark_CreateFiberEntityUncached(benchmark::State& state) {
+  // Threads are synchronized on entering / leaving the benchmark loop, so it's
+  // safe to change the flags here.
+  static int thread_cache, transfer_cache;
+  if (state.thread_index() == 0) {
+    thread_cache = std::exchange(FLAGS_flare_fiber_stack_thread_cache_size, 0);
+    transfer_cache =
+        std::exchange(FLAGS_flare_fiber_stack_transfer_cache_size, 0);
+  }
+
+  CreateDestroyFiberEntities(state);
+
+  if (state.thread_index() == 0) {
+    FLAGS_flare_fiber_stack_thread_cache_size = thread_cache;
+    FLAGS_flare_fiber_stack_transfer_cache_size = transfer_cache;
+  }
+}
+
+BENCHMARK(Benchmark_CreateFiberEntityUncached)
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(1024)
+    ->ThreadRange(1, 8);
+
+}  // namespace tinyRPC::fiber::detail
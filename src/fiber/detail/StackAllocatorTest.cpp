@@ -0,0 +1,53 @@
+#include "StackAllocator.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "../../../include/gflags/gflags.h"
+#include "../../../include/gtest/gtest.h"
+
+DECLARE_int32(flare_fiber_stack_thread_cache_size);
+
+namespace tinyRPC::fiber::detail {
+
+// `DestroyStack` expects the beginning of the mapping.
+void* GetMappingOf(void* stack) {
+  return reinterpret_cast<char*>(stack) - kPageSize;
+}
+
+TEST(StackAllocator, Reuse) {
+  auto p = CreateStack();
+  memset(p, 1, kStackSize - kPageSize);  // Usable.
+  DestroyStack(GetMappingOf(p));
+  ASSERT_EQ(p, CreateStack());  // Served from thread-local cache.
+  DestroyStack(GetMappingOf(p));
+}
+
+TEST(StackAllocator, TransferCache) {
+  std::vector<void*> stacks;
+  for (int i = 0; i != FLAGS_flare_fiber_stack_thread_cache_size * 2; ++i) {
+    stacks.push_back(CreateStack());
+    memset(stacks.back(), 1, kStackSize - kPageSize);
+  }
+
+  // Stacks freed by this thread overflows to the transfer cache.
+  std::thread([&] {
+    for (auto&& e : stacks) {
+      DestroyStack(GetMappingOf(e));
+    }
+  }).join();
+  ASSERT_GE(GetTransferCachedStackCount(),
+            FLAGS_flare_fiber_stack_thread_cache_size);
+
+  // Stacks in the transfer cache have been trimmed.
+  std::thread([&] {
+    auto p = reinterpret_cast<char*>(CreateStack());
+    for (std::size_t i = 0; i != kStackSize - kPageSize; ++i) {
+      ASSERT_EQ(0, p[i]);
+    }
+    DestroyStack(GetMappingOf(p));
+  }).join();
+}
+
+}  // namespace tinyRPC::fiber::detail
@@ -26,7 +26,10 @@ std::chrono::steady_clock::time_point GetSleepTimeout(
 }
 
 TimerWorker::TimerWorker(SchedulingGroup* sg)
-    : sg_(sg), localQueues_(sg->GroupSize() + 1), latch_(sg->GroupSize() + 1) {}
+    : sg_(sg),
+      timers_(std::chrono::steady_clock::now()),
+      localQueues_(sg->GroupSize() + 1),
+      latch_(sg->GroupSize() + 1) {}
 
 TimerWorker::~TimerWorker() = default;
 
@@ -39,14 +42,11 @@ TimerPtr TimerWorker::CreateTimer(
     UniqueFunction<void(TimerPtr&)>&& cb) {
   CHECK(cb) << "No callback for the timer?";
 
-  auto timer = std::make_shared<Timer>();
+  // Recycled timers have been reset by `Timer::Reset()`.
+  TimerPtr timer(adopt_ptr, object_pool::Get<Timer>());
   timer->owner_ = this;
-  timer->cancelled_ = false;
   timer->cb_ = std::move(cb);
   timer->expiresAt_ = expires_at;
-  timer->periodic_ = false;
-
-  CHECK_EQ(timer.use_count(), 1);
   return timer;
 }
 
@@ -60,15 +60,12 @@ TimerPtr TimerWorker::CreateTimer(
     initial_expires_at = std::chrono::steady_clock::now();
   }
 
-  auto timer = std::make_shared<Timer>();
+  TimerPtr timer(adopt_ptr, object_pool::Get<Timer>());
   timer->owner_ = this;
-  timer->cancelled_ = false;
   timer->cb_ = std::move(cb);
   timer->expiresAt_ = initial_expires_at;
   timer->periodic_ = true;
   timer->interval_ = interval;
-
-  CHECK_EQ(timer.use_count(), 1);
   return timer;
 }
 
@@ -86,6 +83,17 @@ void TimerWorker::RemoveTimer(TimerPtr& timer) {
     timer->cancelled_.store(true);
     cb = std::move(timer->cb_);
   }
+
+  // Let the timer worker remove it from the wheel eagerly, so that cancelled
+  // timers (most timers are, e.g., RPC timeouts) won't pile up there. For
+  // threads without a thread-local queue, the timer is dropped when it
+  // expires. The same is true if the caller is from another scheduling group,
+  // the wheel holding the timer is not accessible to its timer worker.
+  auto&& tls_queue = GetThreadLocalQueue();
+  if (threadLocalQueueInitialized && tls_queue->owner_ == this) {
+    std::scoped_lock _(tls_queue->lock_);
+    tls_queue->cancelled_.push_back(timer);
+  }
 }
 
 SchedulingGroup* TimerWorker::GetSchedulingGroup() { return sg_; }
@@ -98,6 +106,7 @@ void TimerWorker::InitializeLocalQueue(std::size_t worker_index) {
   CHECK(localQueues_[worker_index] == nullptr)
               << "Someone else has registered itself as worker "<< worker_index << std::endl;
   localQueues_[worker_index] = GetThreadLocalQueue();
+  localQueues_[worker_index]->owner_ = this;
   threadLocalQueueInitialized = true;
   latch_.count_down();
 }
@@ -122,20 +131,28 @@ void TimerWorker::WorkerProc() {
   WaitForWorkers();  // Wait for other workers to come in.
 
   while (!stopped_) {
-    // TODO: Figure out why we need reset nextExpireAt to max().
-    // Collect thread-local timer queues into our central heap.
+    // Collect thread-local timer queues into the wheel.
     ReapThreadLocalQueues();
 
     // And fire those who has expired.
     FireTimers();
 
-    // TODO: Why wake again?
-
     // Sleep until next time fires.
     std::unique_lock lk(lock_);
-    auto expected = nextExpireAt;
+    auto next = timers_.GetNextExpiration();
+    nextExpireAt_.store(next.time_since_epoch(), std::memory_order_relaxed);
+
+    // Timers added after we reaped the queues above might have seen a
+    // (possibly later) `nextExpireAt_` and not woken us up, recheck them.
+    //
+    // Timers added from now on see the value we just stored.
+    if (HasEarlierLocalTimers(next)) {
+      continue;
+    }
+    auto expected = nextExpireAt_.load(std::memory_order_relaxed);
     cv_.wait_until(lk, GetSleepTimeout(expected), [&] {
-      return nextExpireAt != expected || stopped_;
+      return nextExpireAt_.load(std::memory_order_relaxed) != expected ||
+             stopped_;
     });
   }
   sg_->LeaveGroup();
@@ -144,9 +161,11 @@ void TimerWorker::WorkerProc() {
 void TimerWorker::AddTimer(TimerPtr timer) {
   CHECK(threadLocalQueueInitialized) << "You must initialize your thread-local queue (done as part of "
               "`SchedulingGroup::EnterGroup()` before calling `AddTimer`." << std::endl;
-  CHECK_EQ(timer.use_count(), 2);  // One is caller, one is us.
 
   auto&& tls_queue = GetThreadLocalQueue();
+  // Otherwise the timer would end up in another worker's wheel.
+  CHECK_EQ(tls_queue->owner_, this)
+      << "Timers can only be enabled in the scheduling group owning them.";
   std::unique_lock lk(tls_queue->lock_);  // This is cheap (relatively, I mean).
   auto expires_at = timer->expiresAt_;
   tls_queue->timers_.push_back(std::move(timer));
@@ -162,10 +181,11 @@ void TimerWorker::WaitForWorkers() { latch_.wait(); }
 
 void TimerWorker::ReapThreadLocalQueues() {
   for (auto&& p : localQueues_) {
-    std::vector<TimerPtr> t;
+    std::vector<TimerPtr> t, cancelled;
     {
       std::scoped_lock _(p->lock_);
       t.swap(p->timers_);
+      cancelled.swap(p->cancelled_);
       // Reset.
       p->expiresAt_ = std::chrono::steady_clock::time_point::max();
     }
@@ -173,58 +193,64 @@ void TimerWorker::ReapThreadLocalQueues() {
       if (e->cancelled_ == true) {
         continue;
       }
-      timers_.push(std::move(e));
+      timers_.Add(std::move(e));
+    }
+    // Not in the wheel if it's cancelled before being reaped, or has fired.
+    for (auto&& e : cancelled) {
+      timers_.Remove(e.Get());
     }
   }
 }
 
 void TimerWorker::FireTimers() {
-  auto now = std::chrono::steady_clock::now();
-  while (!timers_.empty()) {
-    TimerPtr e =  const_cast<TimerPtr&>(timers_.top());
+  timers_.Expire(std::chrono::steady_clock::now(), [&](TimerPtr e) {
     if (e->cancelled_ == true) {
-      timers_.pop();
-      continue;
-    }
-    if (e->expiresAt_ > now) {
-      break;
+      return;
     }
 
     std::unique_lock lk(e->lock_);
     auto cb = std::move(e->cb_);
     lk.unlock();
-    
-    if(cb){
+
+    if (cb) {
       cb(e);
     }
 
     // If it's a periodic timer, add a new pending timer.
     if (e->periodic_) {
-        std::unique_lock lk(e->lock_);
-        if (!e->cancelled_) {
-            e->expiresAt_ = e->expiresAt_ + e->interval_;
-            e->cb_ = std::move(cb);  // Move user's callback back.
-            lk.unlock();
-            timers_.push(std::move(e));
-        }
+      std::unique_lock lk(e->lock_);
+      if (!e->cancelled_) {
+        e->expiresAt_ = e->expiresAt_ + e->interval_;
+        e->cb_ = std::move(cb);  // Move user's callback back.
+        lk.unlock();
+        timers_.Add(std::move(e));
+      }
+    }
+  });
+}
+
+bool TimerWorker::HasEarlierLocalTimers(
+    std::chrono::steady_clock::time_point expires_at) {
+  for (auto&& p : localQueues_) {
+    std::scoped_lock _(p->lock_);
+    if (p->expiresAt_ < expires_at) {
+      return true;
     }
-    timers_.pop();
   }
+  return false;
 }
 
 void TimerWorker::WakeWorkerIfNeeded(
     std::chrono::steady_clock::time_point local_expires_at) {
   auto expires_at = local_expires_at.time_since_epoch();
+  if (nextExpireAt_.load(std::memory_order_relaxed) <= expires_at) {
+    return;  // Nothing to do then.
+  }
 
-  while (true) {
-    if (nextExpireAt <= expires_at) {  // Nothing to do then.
-      return;
-    }
-
-    std::scoped_lock _(lock_);
-    nextExpireAt = expires_at;
+  std::scoped_lock _(lock_);
+  if (nextExpireAt_.load(std::memory_order_relaxed) > expires_at) {
+    nextExpireAt_.store(expires_at, std::memory_order_relaxed);
     cv_.notify_one();
-    return;
   }
 }
 
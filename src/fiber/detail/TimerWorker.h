@@ -7,7 +7,6 @@
 #include <atomic>
 #include <functional>
 #include <vector>
-#include <queue>
 #include <thread>
 #include <condition_variable>
 // #include <latch>
@@ -15,33 +14,19 @@
 #include "../../base/SpinLock.h"
 #include "../../base/Function.h"
 #include "../../base/Latch.h"
+#include "TimingWheel.h"
 
 namespace tinyRPC::fiber::detail{
 
-class TimerWorker;
 class SchedulingGroup;
-struct Timer;
-using TimerPtr = std::shared_ptr<Timer>;
-
-struct Timer{
-    SpinLock lock_;
-    std::atomic<bool> cancelled_ {false};
-    bool periodic_ = false;
-    TimerWorker* owner_ {nullptr};
-    UniqueFunction<void(TimerPtr& )> cb_;
-    std::chrono::steady_clock::time_point expiresAt_;
-    std::chrono::nanoseconds interval_;
-};
-
-struct TimerCmp{
-    bool operator()(const TimerPtr& a, const TimerPtr& b){
-        return a->expiresAt_ > b->expiresAt_;
-    }
-};
+class TimerWorker;
 
 struct ThreadLocalQueue{
     SpinLock lock_;
+    TimerWorker* owner_ = nullptr;
     std::vector<TimerPtr> timers_;
+    // Timers cancelled by this thread, removed from the wheel on next reap.
+    std::vector<TimerPtr> cancelled_;
     std::chrono::steady_clock::time_point expiresAt_ = 
         std::chrono::steady_clock::time_point::max();
 };
@@ -93,13 +78,18 @@ private:
 
     void ReapThreadLocalQueues();
     void FireTimers();
+    // Returns true if timers earlier than `expires_at` were added after we
+    // reaped thread-local queues.
+    bool HasEarlierLocalTimers(std::chrono::steady_clock::time_point expires_at);
     void WakeWorkerIfNeeded(std::chrono::steady_clock::time_point local_expires_at);
 
     SchedulingGroup* sg_;
 
-    std::priority_queue<TimerPtr, std::vector<TimerPtr>, TimerCmp> timers_;
+    TimingWheel timers_;
     std::vector<ThreadLocalQueue*> localQueues_;
-    std::chrono::steady_clock::duration nextExpireAt = std::chrono::steady_clock::duration::max();
+    // Time the worker sleeps until. Only updated with `lock_` held.
+    std::atomic<std::chrono::steady_clock::duration> nextExpireAt_ {
+        std::chrono::steady_clock::duration::max()};
     std::atomic<bool> stopped_ {false};
     tinyRPC::Latch latch_;
     std::thread worker_;
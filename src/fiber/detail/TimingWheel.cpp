@@ -0,0 +1,143 @@
+#include "TimingWheel.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace tinyRPC::fiber::detail {
+
+void Timer::Reset() noexcept {
+  cb_ = nullptr;
+  cancelled_.store(false, std::memory_order_relaxed);
+  periodic_ = false;
+  owner_ = nullptr;
+  slot_ = nullptr;
+  ResetRefCount();
+}
+
+TimingWheel::TimingWheel(std::chrono::steady_clock::time_point now)
+    : current_(ToTickRoundDown(now)) {}
+
+TimingWheel::~TimingWheel() {
+  auto release = [this](TimerList& list) {
+    while (auto timer = list.pop_front()) {
+      timer->slot_ = nullptr;
+      timer->Deref();
+      --size_;
+    }
+  };
+  for (auto&& e : level0_) {
+    release(e);
+  }
+  for (auto&& level : levels_) {
+    for (auto&& e : level) {
+      release(e);
+    }
+  }
+  CHECK_EQ(size_, 0);
+}
+
+void TimingWheel::Add(TimerPtr timer) {
+  CHECK(!timer->slot_) << "The timer has already been added.";
+  ++size_;
+  Link(timer.Leak());
+}
+
+bool TimingWheel::Remove(Timer* timer) {
+  auto slot = timer->slot_;
+  if (!slot) {
+    return false;
+  }
+  if (slot < level0_.data() || slot >= level0_.data() + level0_.size()) {
+    --upper_levels_size_;
+  }
+  CHECK(slot->erase(timer));
+  timer->slot_ = nullptr;
+  --size_;
+  timer->Deref();  // Drop the reference we hold.
+  return true;
+}
+
+std::chrono::steady_clock::time_point TimingWheel::GetNextExpiration() const {
+  if (size_ == 0) {
+    return std::chrono::steady_clock::time_point::max();
+  }
+  auto next_cascade = std::numeric_limits<std::uint64_t>::max();
+  if (upper_levels_size_) {
+    next_cascade = (current_ | (kLevel0Size - 1)) + 1;
+  }
+  if (size_ != upper_levels_size_) {
+    for (std::size_t i = 0; i != kLevel0Size; ++i) {
+      auto tick = current_ + i;
+      if (tick >= next_cascade) {
+        break;
+      }
+      if (!level0_[tick & (kLevel0Size - 1)].empty()) {
+        return FromTick(tick);
+      }
+    }
+  }
+  // Timers in level 0 (if any) expire after the next cascade.
+  return FromTick(next_cascade);
+}
+
+std::uint64_t TimingWheel::ToTickRoundUp(
+    std::chrono::steady_clock::time_point t) {
+  auto ns = t.time_since_epoch();
+  if (ns <= std::chrono::steady_clock::duration::zero()) {
+    return 0;
+  }
+  if (ns >= std::chrono::steady_clock::duration::max() - kTick) {
+    return std::numeric_limits<std::uint64_t>::max() / 2;  // Never expires.
+  }
+  return (ns + kTick - std::chrono::nanoseconds(1)) / kTick;
+}
+
+std::uint64_t TimingWheel::ToTickRoundDown(
+    std::chrono::steady_clock::time_point t) {
+  return std::max(t.time_since_epoch(),
+                  std::chrono::steady_clock::duration::zero()) /
+         kTick;
+}
+
+std::chrono::steady_clock::time_point TimingWheel::FromTick(
+    std::uint64_t tick) {
+  if (tick >= static_cast<std::uint64_t>(
+                  std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::duration::max())
+                      .count())) {
+    return std::chrono::steady_clock::time_point::max();
+  }
+  return std::chrono::steady_clock::time_point(kTick * tick);
+}
+
+void TimingWheel::Link(Timer* timer) {
+  // Timers already expired are fired on next tick.
+  auto expires = std::max(ToTickRoundUp(timer->expiresAt_), current_);
+  auto delta = expires - current_;
+  std::size_t level = 0;
+  while (level != kLevels - 1 && delta >= RangeOf(level)) {
+    ++level;
+  }
+  if (delta >= RangeOf(kLevels - 1)) {
+    // Too far away. Park it in the farthest slot, it will be re-linked once
+    // cascaded.
+    expires = current_ + RangeOf(kLevels - 1) - 1;
+  }
+  if (level) {
+    ++upper_levels_size_;
+  }
+  auto&& slot = SlotOf(level, expires);
+  slot.push_back(timer);
+  timer->slot_ = &slot;
+}
+
+void TimingWheel::Cascade(std::size_t level) {
+  TimerList timers;
+  timers.swap(SlotOf(level, current_));
+  upper_levels_size_ -= timers.size();
+  while (auto timer = timers.pop_front()) {
+    Link(timer);
+  }
+}
+
+}  // namespace tinyRPC::fiber::detail
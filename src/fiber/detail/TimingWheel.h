@@ -0,0 +1,194 @@
+#ifndef _SRC_FIBER_DETAIL_TIMING_WHEEL_H_
+#define _SRC_FIBER_DETAIL_TIMING_WHEEL_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "../../base/DoublyLinkedList.h"
+#include "../../base/Function.h"
+#include "../../base/ObjectPool.h"
+#include "../../base/RefPtr.h"
+#include "../../base/SpinLock.h"
+
+namespace tinyRPC::fiber::detail {
+
+class TimerWorker;
+struct Timer;
+using TimerPtr = RefPtr<Timer>;
+
+// Timers are intrusively reference counted and allocated from object pool.
+struct Timer : RefCounted<Timer> {
+  SpinLock lock_;
+  std::atomic<bool> cancelled_ {false};
+  bool periodic_ = false;
+  TimerWorker* owner_ {nullptr};
+  UniqueFunction<void(TimerPtr& )> cb_;
+  std::chrono::steady_clock::time_point expiresAt_;
+  std::chrono::nanoseconds interval_;
+
+  // Below are owned by `TimingWheel`.
+  DoublyLinkedListEntry chain_;
+  DoublyLinkedList<Timer, &Timer::chain_>* slot_ = nullptr;
+
+  // Called when the timer is recycled by object pool.
+  void Reset() noexcept;
+};
+
+// Hierarchical timing wheel (4 levels, 1ms tick), as the one in Linux kernel.
+//
+// Level 0 has 256 slots, one per tick. Each of level 1~3 has 64 slots, each
+// covering all slots in its lower level. Timers are placed into the lowest
+// level whose range covers their expiration, and are moved down
+// ("cascaded") as time goes by. Timers that expire further than the wheel
+// covers (~18.6 hours) are parked in the last slot of level 3 and re-inserted
+// once cascaded.
+//
+// Both insertion and removal are O(1).
+//
+// Thread-compatible. It's owned by the timer worker.
+class TimingWheel {
+ public:
+  static constexpr auto kTick = std::chrono::milliseconds(1);
+
+  explicit TimingWheel(std::chrono::steady_clock::time_point now);
+  ~TimingWheel();
+
+  // The wheel holds a reference to `timer` until it's fired or removed.
+  //
+  // Timers already expired are fired by next call to `Expire`.
+  void Add(TimerPtr timer);
+
+  // Returns false if `timer` is not in the wheel.
+  bool Remove(Timer* timer);
+
+  // Remove all timers expired at `now`. `f` is called with each of them.
+  //
+  // It's safe to call `Add` / `Remove` in `f`.
+  template <class F>
+  void Expire(std::chrono::steady_clock::time_point now, F&& f);
+
+  // Time the next timer expires, or `time_point::max()` if there's none.
+  //
+  // This is not exact. For timers not in level 0, time of the next cascade is
+  // returned.
+  std::chrono::steady_clock::time_point GetNextExpiration() const;
+
+  std::size_t size() const noexcept { return size_; }
+
+  TimingWheel(const TimingWheel&) = delete;
+  TimingWheel& operator=(const TimingWheel&) = delete;
+
+ private:
+  using TimerList = DoublyLinkedList<Timer, &Timer::chain_>;
+
+  static constexpr std::size_t kLevels = 4;
+  static constexpr std::size_t kLevel0Bits = 8;
+  static constexpr std::size_t kLevelNBits = 6;
+  static constexpr std::size_t kLevel0Size = 1 << kLevel0Bits;
+  static constexpr std::size_t kLevelNSize = 1 << kLevelNBits;
+
+  // Ticks covered by level 0..`level`.
+  static constexpr std::uint64_t RangeOf(std::size_t level) {
+    return 1ull << (kLevel0Bits + level * kLevelNBits);
+  }
+
+  // Shift of tick to get slot index at `level`.
+  static constexpr std::size_t ShiftOf(std::size_t level) {
+    return level == 0 ? 0 : kLevel0Bits + (level - 1) * kLevelNBits;
+  }
+
+  static std::uint64_t ToTickRoundUp(std::chrono::steady_clock::time_point t);
+  static std::uint64_t ToTickRoundDown(std::chrono::steady_clock::time_point t);
+  static std::chrono::steady_clock::time_point FromTick(std::uint64_t tick);
+
+  TimerList& SlotOf(std::size_t level, std::uint64_t tick) {
+    return level == 0 ? level0_[tick & (kLevel0Size - 1)]
+                      : levels_[level - 1][(tick >> ShiftOf(level)) &
+                                           (kLevelNSize - 1)];
+  }
+
+  // Link `timer` into its slot. The caller's reference is transferred to the
+  // wheel.
+  void Link(Timer* timer);
+
+  // Move timers in `level`'s slot for `current_` to lower levels.
+  void Cascade(std::size_t level);
+
+ private:
+  // Next tick to be processed. All timers expired before this tick have been
+  // fired.
+  std::uint64_t current_;
+  std::size_t size_ = 0;
+
+  // Number of timers in levels other than level 0.
+  std::size_t upper_levels_size_ = 0;
+
+  std::array<TimerList, kLevel0Size> level0_;
+  std::array<std::array<TimerList, kLevelNSize>, kLevels - 1> levels_;
+};
+
+template <class F>
+void TimingWheel::Expire(std::chrono::steady_clock::time_point now, F&& f) {
+  auto now_tick = ToTickRoundDown(now);
+  while (current_ <= now_tick) {
+    if (size_ == upper_levels_size_) {  // Nothing in level 0.
+      if (size_ == 0) {
+        current_ = now_tick + 1;
+        break;
+      }
+      // Skip to the next cascade.
+      if (current_ & (kLevel0Size - 1)) {
+        current_ = std::min((current_ | (kLevel0Size - 1)) + 1, now_tick + 1);
+        continue;
+      }
+    }
+
+    // Move timers in upper levels down if we're at their boundary.
+    for (std::size_t level = 1;
+         level != kLevels && (current_ & (RangeOf(level - 1) - 1)) == 0;
+         ++level) {
+      Cascade(level);
+    }
+
+    // Timers added by `f` won't be put into this slot as `current_` has been
+    // advanced.
+    auto&& slot = SlotOf(0, current_++);
+    while (auto timer = slot.pop_front()) {
+      timer->slot_ = nullptr;
+      --size_;
+      f(TimerPtr(adopt_ptr, timer));
+    }
+  }
+}
+
+}  // namespace tinyRPC::fiber::detail
+
+namespace tinyRPC {
+
+template <>
+struct RefTraits<fiber::detail::Timer> {
+  static void Destroy(fiber::detail::Timer* ptr) {
+    object_pool::Put(ptr);
+  }
+};
+
+namespace object_pool {
+
+template <>
+struct PoolTraits<fiber::detail::Timer> {
+  static constexpr std::size_t kLocalCacheSize = 4096;
+  static constexpr std::size_t kTransferCacheSize = 65536;
+  static constexpr std::size_t kTransferBatchSize = 1024;
+
+  static void OnPut(fiber::detail::Timer* ptr) { ptr->Reset(); }
+};
+
+}  // namespace object_pool
+
+}  // namespace tinyRPC
+
+#endif
@@ -0,0 +1,108 @@
+#include <chrono>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "../../../include/benchmark/benchmark.h"
+#include "TimingWheel.h"
+
+using namespace std::literals;
+
+// 1M timers with random timeouts (up to 10s) are added, and 99% of them are
+// cancelled before they expire (as most RPC timeout timers are). Time is then
+// advanced until all remaining timers fire.
+//
+// Benchmark_TimingWheel:   What `TimerWorker` uses.
+// Benchmark_PriorityQueue: What `TimerWorker` used to use. Cancelled timers
+//                          are left in the heap until they reach the top.
+
+namespace tinyRPC::fiber::detail {
+
+namespace {
+
+constexpr std::size_t kTimers = 1'000'000;
+constexpr std::size_t kCancelOneIn = 100;  // The rest are cancelled.
+
+const auto kStart = std::chrono::steady_clock::time_point(1h);
+
+std::vector<std::chrono::steady_clock::time_point> GenerateTimeouts() {
+  std::mt19937_64 engine(12345);
+  std::uniform_int_distribution<int> dist(1, 10'000);
+  std::vector<std::chrono::steady_clock::time_point> result;
+  for (std::size_t i = 0; i != kTimers; ++i) {
+    result.push_back(kStart + dist(engine) * 1ms);
+  }
+  return result;
+}
+
+const auto kTimeouts = GenerateTimeouts();
+
+TimerPtr MakeTimer(std::chrono::steady_clock::time_point expires_at) {
+  TimerPtr timer(adopt_ptr, object_pool::Get<Timer>());
+  timer->expiresAt_ = expires_at;
+  return timer;
+}
+
+void Benchmark_TimingWheel(benchmark::State& state) {
+  std::vector<TimerPtr> timers(kTimers);
+  while (state.KeepRunning()) {
+    TimingWheel wheel(kStart);
+    std::size_t fired = 0;
+    for (std::size_t i = 0; i != kTimers; ++i) {
+      timers[i] = MakeTimer(kTimeouts[i]);
+      wheel.Add(timers[i]);
+    }
+    for (std::size_t i = 0; i != kTimers; ++i) {
+      if (i % kCancelOneIn) {
+        timers[i]->cancelled_ = true;
+        wheel.Remove(timers[i].Get());
+      }
+      timers[i] = nullptr;
+    }
+    for (auto now = kStart; wheel.size(); now += 1ms) {
+      wheel.Expire(now, [&](auto&&) { ++fired; });
+    }
+    benchmark::DoNotOptimize(fired);
+  }
+  state.SetItemsProcessed(state.iterations() * kTimers);
+}
+
+void Benchmark_PriorityQueue(benchmark::State& state) {
+  struct TimerCmp {
+    bool operator()(const TimerPtr& a, const TimerPtr& b) {
+      return a->expiresAt_ > b->expiresAt_;
+    }
+  };
+  std::vector<TimerPtr> timers(kTimers);
+  while (state.KeepRunning()) {
+    std::priority_queue<TimerPtr, std::vector<TimerPtr>, TimerCmp> queue;
+    std::size_t fired = 0;
+    for (std::size_t i = 0; i != kTimers; ++i) {
+      timers[i] = MakeTimer(kTimeouts[i]);
+      queue.push(timers[i]);
+    }
+    for (std::size_t i = 0; i != kTimers; ++i) {
+      if (i % kCancelOneIn) {
+        timers[i]->cancelled_ = true;
+      }
+      timers[i] = nullptr;
+    }
+    for (auto now = kStart; !queue.empty(); now += 1ms) {
+      while (!queue.empty() && queue.top()->expiresAt_ <= now) {
+        if (!queue.top()->cancelled_) {
+          ++fired;
+        }
+        queue.pop();
+      }
+    }
+    benchmark::DoNotOptimize(fired);
+  }
+  state.SetItemsProcessed(state.iterations() * kTimers);
+}
+
+}  // namespace
+
+BENCHMARK(Benchmark_TimingWheel)->Unit(benchmark::kMillisecond);
+BENCHMARK(Benchmark_PriorityQueue)->Unit(benchmark::kMillisecond);
+
+}  // namespace tinyRPC::fiber::detail
@@ -0,0 +1,108 @@
+#include "TimingWheel.h"
+
+#include <chrono>
+#include <vector>
+
+#include "../../../include/gtest/gtest.h"
+
+using namespace std::literals;
+
+namespace tinyRPC::fiber::detail {
+
+namespace {
+
+// Arbitrary, not aligned to any level's boundary.
+const auto kStart = std::chrono::steady_clock::time_point(12345678ms + 100us);
+
+TimerPtr MakeTimer(std::chrono::steady_clock::time_point expires_at) {
+  TimerPtr timer(adopt_ptr, object_pool::Get<Timer>());
+  timer->expiresAt_ = expires_at;
+  return timer;
+}
+
+}  // namespace
+
+TEST(TimingWheel, Expire) {
+  TimingWheel wheel(kStart);
+  std::vector<TimerPtr> timers;
+  // Cover each level, and beyond what the wheel covers.
+  for (std::chrono::milliseconds delay :
+       {0ms, 1ms, 255ms, 256ms, 1000ms, 17000ms, 60000ms, 3600000ms,
+        108000000ms}) {
+    timers.push_back(MakeTimer(kStart + delay));
+    wheel.Add(timers.back());
+  }
+  ASSERT_EQ(timers.size(), wheel.size());
+
+  std::vector<Timer*> fired;
+  auto now = kStart;
+  while (wheel.size()) {
+    auto next = wheel.GetNextExpiration();
+    ASSERT_GT(next, now);  // Making progress.
+    now = next;
+    wheel.Expire(now, [&](TimerPtr timer) {
+      // Never too early, and at most a tick late.
+      EXPECT_LE(timer->expiresAt_, now);
+      EXPECT_GT(timer->expiresAt_ + TimingWheel::kTick, now);
+      fired.push_back(timer.Get());
+    });
+  }
+  ASSERT_EQ(timers.size(), fired.size());
+  for (std::size_t i = 0; i != timers.size(); ++i) {
+    EXPECT_EQ(timers[i].Get(), fired[i]);
+    EXPECT_EQ(1, timers[i]->UnsafeRefCount());  // Released by the wheel.
+  }
+}
+
+TEST(TimingWheel, Remove) {
+  TimingWheel wheel(kStart);
+  auto t1 = MakeTimer(kStart + 10ms), t2 = MakeTimer(kStart + 10s);
+  wheel.Add(t1);
+  wheel.Add(t2);
+  ASSERT_EQ(2, t1->UnsafeRefCount());
+
+  ASSERT_TRUE(wheel.Remove(t1.Get()));
+  ASSERT_FALSE(wheel.Remove(t1.Get()));
+  ASSERT_EQ(1, t1->UnsafeRefCount());
+  ASSERT_EQ(1, wheel.size());
+
+  ASSERT_TRUE(wheel.Remove(t2.Get()));
+  ASSERT_EQ(0, wheel.size());
+  ASSERT_EQ(std::chrono::steady_clock::time_point::max(),
+            wheel.GetNextExpiration());
+
+  int fired = 0;
+  wheel.Expire(kStart + 1min, [&](auto&&) { ++fired; });
+  ASSERT_EQ(0, fired);
+}
+
+TEST(TimingWheel, AddInCallback) {
+  TimingWheel wheel(kStart);
+  auto timer = MakeTimer(kStart);
+  wheel.Add(timer);
+
+  // Periodic timer, as done by `TimerWorker`.
+  int fired = 0;
+  for (int i = 0; i != 1000; ++i) {
+    wheel.Expire(kStart + i * 10ms + TimingWheel::kTick, [&](TimerPtr timer) {
+      ++fired;
+      timer->expiresAt_ += 10ms;
+      wheel.Add(std::move(timer));
+    });
+  }
+  ASSERT_EQ(1000, fired);
+  ASSERT_EQ(1, wheel.size());
+}
+
+TEST(TimingWheel, ExpiredTimer) {
+  TimingWheel wheel(kStart);
+  wheel.Expire(kStart + 1s, [](auto&&) {});
+  wheel.Add(MakeTimer(kStart));  // Already expired.
+  ASSERT_LE(wheel.GetNextExpiration(), kStart + 1s + TimingWheel::kTick);
+
+  int fired = 0;
+  wheel.Expire(kStart + 1s + TimingWheel::kTick, [&](auto&&) { ++fired; });
+  ASSERT_EQ(1, fired);
+}
+
+}  // namespace tinyRPC::fiber::detail
@@ -1,3 +1,4 @@
+#include <iterator>
 #include <memory>
 #include <mutex>
 
@@ -148,7 +149,7 @@ class AsyncWaker {
       : sg_(sg), self_(self), wb_(wb) {}
 
   // The destructor does some sanity checks.
-  ~AsyncWaker() { CHECK_EQ(timer_, nullptr) <<"Have you called `Cleanup()`?"; }
+  ~AsyncWaker() { CHECK(!timer_) <<"Have you called `Cleanup()`?"; }
 
   // Set a timer to awake `self` once `expires_at` is reached.
   void SetTimer(std::chrono::steady_clock::time_point expires_at) {
@@ -194,7 +195,7 @@ class AsyncWaker {
       wait_cb_->awake = true;
     }  // `wait_cb_->awake` has been set, so other fields of us won't be touched
        // by `timer_cb`. we're safe to destruct from now on.
-    timer_.reset();
+    timer_ = nullptr;
   } 
 
  private:
@@ -275,6 +276,11 @@ void ConditionVariable::notify_all() noexcept {
   // We must move all fibers out and then schedule them.
   // If you call `notify_one()` in a loop, it is likely
   // some will immediately wait again and be notified again. 
+  //
+  // There's usually only a few waiters (e.g., a single one waiting on a
+  // `Latch`), so we don't allocate memory unless there are many.
+  FiberEntity* inlined[16];
+  std::size_t inlined_size = 0;
   std::vector<FiberEntity*> fibers;
 
   while (true) {
@@ -282,12 +288,22 @@ void ConditionVariable::notify_all() noexcept {
     if (!fiber) {
       break;
     }
+    if (inlined_size != std::size(inlined)) {
+      inlined[inlined_size++] = fiber;
+    } else {
       fibers.push_back(fiber);
+    }
   }
 
   // Schedule the waiters.
-  for (auto&& e : fibers) {
+  auto ready = [](FiberEntity* e) {
     e->sg_->ReadyFiber(e, std::unique_lock(e->schedulerLock_));
+  };
+  for (std::size_t i = 0; i != inlined_size; ++i) {
+    ready(inlined[i]);
+  }
+  for (auto&& e : fibers) {
+    ready(e);
   }
 }
 
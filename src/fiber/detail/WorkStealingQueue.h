@@ -0,0 +1,95 @@
+#ifndef _SRC_FIBER_DETAIL_WORK_STEALING_QUEUE_H_
+#define _SRC_FIBER_DETAIL_WORK_STEALING_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include "../../../glog/logging.h"
+
+namespace tinyRPC::fiber::detail {
+
+// Bounded lock-free run queue, in the style of Chase-Lev deque.
+//
+// Only the owner may `Push` into the queue, while anyone (the owner included)
+// may `Steal` from it. Note that unlike the classic Chase-Lev deque, the owner
+// consumes from the same end as thieves do (i.e., this queue is FIFO). Fibers
+// yielding repeatedly would starve others in the queue otherwise.
+//
+// `T` must be a pointer type.
+template <class T>
+class WorkStealingQueue {
+  static_assert(std::is_pointer_v<T>);
+
+ public:
+  // `capacity` must be a power of 2.
+  explicit WorkStealingQueue(std::size_t capacity)
+      : capacity_(capacity),
+        mask_(capacity - 1),
+        slots_(std::make_unique<std::atomic<T>[]>(capacity)) {
+    CHECK(capacity && (capacity & (capacity - 1)) == 0)
+        << "Capacity must be a power of 2.";
+  }
+
+  // Returns false if the queue is full.
+  //
+  // Only the owner may call this method.
+  bool Push(T value) noexcept {
+    auto b = bottom_.load(std::memory_order_relaxed);
+    auto t = top_.load(std::memory_order_acquire);
+    if (b - t >= capacity_) {
+      return false;
+    }
+    slots_[b & mask_].store(value, std::memory_order_relaxed);
+    bottom_.store(b + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Returns `nullptr` if the queue is empty.
+  //
+  // Thread-safe.
+  T Steal() noexcept {
+    auto t = top_.load(std::memory_order_acquire);
+    while (true) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      auto b = bottom_.load(std::memory_order_acquire);
+      if (t >= b) {
+        return nullptr;
+      }
+      // The slot may be overwritten by the owner once someone else has taken
+      // it, in which case the CAS below fails and we retry.
+      auto value = slots_[t & mask_].load(std::memory_order_relaxed);
+      if (top_.compare_exchange_weak(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_acquire)) {
+        return value;
+      }
+      // `t` is reloaded by the failed CAS.
+    }
+  }
+
+  // Not accurate if there are concurrent `Push` / `Steal`.
+  std::size_t UnsafeSize() const noexcept {
+    auto b = bottom_.load(std::memory_order_relaxed);
+    auto t = top_.load(std::memory_order_relaxed);
+    return b >= t ? b - t : 0;
+  }
+
+  bool UnsafeEmpty() const noexcept { return UnsafeSize() == 0; }
+
+ private:
+  const std::size_t capacity_;
+  const std::size_t mask_;
+  std::unique_ptr<std::atomic<T>[]> slots_;
+
+  // Consumers (thieves, and the owner) take from `top_`, and the owner pushes
+  // to `bottom_`. They're placed in different cache lines to avoid false
+  // sharing.
+  alignas(64) std::atomic<std::size_t> top_{0};
+  alignas(64) std::atomic<std::size_t> bottom_{0};
+};
+
+}  // namespace tinyRPC::fiber::detail
+
+#endif
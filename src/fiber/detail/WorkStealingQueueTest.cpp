@@ -0,0 +1,80 @@
+#include "WorkStealingQueue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "../../../include/gtest/gtest.h"
+
+namespace tinyRPC::fiber::detail {
+
+TEST(WorkStealingQueue, PushSteal) {
+  WorkStealingQueue<int*> queue(4);
+  int values[5];
+
+  ASSERT_EQ(nullptr, queue.Steal());
+  for (int i = 0; i != 4; ++i) {
+    ASSERT_TRUE(queue.Push(&values[i]));
+  }
+  ASSERT_FALSE(queue.Push(&values[4]));  // Full.
+  ASSERT_EQ(4, queue.UnsafeSize());
+
+  // FIFO.
+  for (int i = 0; i != 4; ++i) {
+    ASSERT_EQ(&values[i], queue.Steal());
+  }
+  ASSERT_EQ(nullptr, queue.Steal());
+  ASSERT_TRUE(queue.UnsafeEmpty());
+
+  // Wrap around.
+  ASSERT_TRUE(queue.Push(&values[4]));
+  ASSERT_EQ(&values[4], queue.Steal());
+}
+
+TEST(WorkStealingQueue, Torture) {
+  constexpr auto kValues = 1'000'000;
+  constexpr auto kThieves = 8;
+  WorkStealingQueue<std::uintptr_t*> queue(1024);
+  std::atomic<bool> done{false};
+  std::atomic<std::uint64_t> sum{0}, count{0};
+
+  auto consume = [&](std::uintptr_t* p) {
+    sum.fetch_add(reinterpret_cast<std::uintptr_t>(p));
+    count.fetch_add(1);
+  };
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i != kThieves; ++i) {
+    thieves.emplace_back([&] {
+      while (!done.load()) {
+        if (auto p = queue.Steal()) {
+          consume(p);
+        }
+      }
+    });
+  }
+
+  std::uint64_t expected = 0;
+  for (std::uintptr_t i = 1; i <= kValues; ++i) {
+    auto p = reinterpret_cast<std::uintptr_t*>(i);
+    while (!queue.Push(p)) {
+      if (auto p = queue.Steal()) {  // The owner consumes as well.
+        consume(p);
+      }
+    }
+    expected += i;
+  }
+  while (auto p = queue.Steal()) {
+    consume(p);
+  }
+  done = true;
+  for (auto&& t : thieves) {
+    t.join();
+  }
+
+  ASSERT_EQ(kValues, count.load());
+  ASSERT_EQ(expected, sum.load());
+}
+
+}  // namespace tinyRPC::fiber::detail
@@ -1,6 +1,5 @@
 #include "EventLoop.h"
 
-#include <fcntl.h>
 #include <sys/epoll.h>
 
 #include <memory>
@@ -17,7 +16,6 @@
 #include "../fiber/Runtime.h"
 #include "../fiber/ThisFiber.h"
 #include "Descriptor.h"
-#include "detail/EintrSafe.h"
 #include "detail/WatchDog.h"
 #include "util/Socket.h"
 
@@ -47,39 +45,18 @@ io::detail::Watchdog watchdog;
 
 }  // namespace
 
-EventLoop::EventLoop() {
-  // @sa: https://linux.die.net/man/2/epoll_create1
-  //
-  // > Since Linux 2.6.8, the size argument is ignored, but must be greater than
-  // > zero; see NOTES below.
-  //
-  // > epoll_create1() was added to the kernel in version 2.6.27. Library
-  // > support is provided in glibc starting with version 2.9.
-  //
-  // We use `epoll_create` here since `epoll_create1` is not available on
-  // CentOS 6. `epoll_create` does not support `EPOLL_CLOEXEC` though.
-  epfd_.Reset(epoll_create(1));
-  FLARE_PCHECK(epfd_.Get() != -1);
-  auto oldflags = fcntl(epfd_.Get(), F_GETFD);
-  FLARE_PCHECK(oldflags != -1);
-  FLARE_PCHECK(fcntl(epfd_.Get(), F_SETFD, oldflags | FD_CLOEXEC) == 0);
-
+EventLoop::EventLoop() : poller_(io::detail::MakePoller()) {
   // `EventLoopNotifier` is different in that its `OnReadable` must be called
   // synchronously (to avoid wake-up loss), and hence must be handled
   // individually.
-  epoll_event ee;
-  ee.events = EPOLLIN | EPOLLERR;
-  ee.data.ptr = static_cast<void*>(&notifier_);
-  FLARE_CHECK(epoll_ctl(epfd_.Get(), EPOLL_CTL_ADD, notifier_.fd(), &ee) == 0,
-              "Failed to add notifier to event loop.");
+  poller_->Add(notifier_.fd(), EPOLLIN | EPOLLERR,
+               static_cast<void*>(&notifier_));
 }
 
 EventLoop::~EventLoop() {
-  // Does not makes much sense as both `notifier_.fd()` and `epfd_` it self is
-  // going to be closed anyway.
-  FLARE_PCHECK(
-      epoll_ctl(epfd_.Get(), EPOLL_CTL_DEL, notifier_.fd(), nullptr) == 0,
-      "Failed to remove notifier from event loop.");
+  // Does not makes much sense as both `notifier_.fd()` and the poller it self
+  // is going to be closed anyway.
+  poller_->Remove(notifier_.fd());
 }
 
 void EventLoop::AttachDescriptor(DescriptorPtr desc, bool enabled) {
@@ -101,27 +78,21 @@ void EventLoop::AttachDescriptor(DescriptorPtr desc, bool enabled) {
 
 void EventLoop::EnableDescriptor(Descriptor* desc) {
   FLARE_CHECK(!desc->Enabled(), "The descriptor has already been enabled.");
-  epoll_event ee;
+  auto events = desc->GetEventMask();
 
   desc->SetEnabled(true);
-  ee.events = desc->GetEventMask();
-  ee.data.ptr = static_cast<void*>(desc);
-  FLARE_PCHECK(epoll_ctl(epfd_.Get(), EPOLL_CTL_ADD, desc->fd(), &ee) == 0,
-               "Failed to add fd #{} to epoll.", desc->fd());
+  poller_->Add(desc->fd(), events, static_cast<void*>(desc));
   FLARE_VLOG(20, "Added descriptor [{}] with event mask [{}].", desc->GetName(),
-             ee.events);
+             events);
 }
 
 void EventLoop::RearmDescriptor(Descriptor* desc) {
   FLARE_CHECK(desc->Enabled(), "The descriptor is not enabled.");
-  epoll_event ee;
+  auto events = desc->GetEventMask() | kEpollError | kExtraEpollFlags;
 
-  ee.events = desc->GetEventMask() | kEpollError | kExtraEpollFlags;
-  ee.data.ptr = static_cast<void*>(desc);
   FLARE_VLOG(20, "Rearming descriptor [{}] with event mask [{}].",
-             desc->GetName(), ee.events);
-  FLARE_PCHECK(epoll_ctl(epfd_.Get(), EPOLL_CTL_MOD, desc->fd(), &ee) == 0,
-               "Failed to modify fd #{} in epoll.", desc->fd());
+             desc->GetName(), events);
+  poller_->Modify(desc->fd(), events, static_cast<void*>(desc));
 }
 
 void EventLoop::DisableDescriptor(Descriptor* desc) {
@@ -129,12 +100,7 @@ void EventLoop::DisableDescriptor(Descriptor* desc) {
   FLARE_CHECK_EQ(EventLoop::Current(), this,
                  "This method must be called in event loop's context.");
   FLARE_CHECK(desc->Enabled(), "The descriptor is not enabled.");
-  // http://man7.org/linux/man-pages/man2/epoll_ctl.2.html
-  //
-  // > In kernel versions before 2.6.9, the EPOLL_CTL_DEL operation required
-  // > a non - null pointer in event, even though this argument is ignored.
-  FLARE_PCHECK(epoll_ctl(epfd_.Get(), EPOLL_CTL_DEL, desc->fd(), nullptr) == 0,
-               "Failed to remove fd #{} from epoll.", desc->fd());
+  poller_->Remove(desc->fd());
   FLARE_VLOG(20, "Removed descriptor [{}].", desc->GetName());
   desc->SetEnabled(false);
 }
@@ -216,16 +182,12 @@ void EventLoop::Join() {
 EventLoop* EventLoop::Current() { return *current_event_loop; }
 
 void EventLoop::WaitAndRunEvents(std::chrono::milliseconds wait_for) {
-  // FIXME: Need we use `epoll_pwait` instead to handle signal more
-  // gracefully? (I'd say code using signal is fundamentally broken anyway.)
   constexpr auto kDescriptorsPerLoop = 128;
-  epoll_event evs[kDescriptorsPerLoop];
-  auto nfds = io::detail::EIntrSafeEpollWait(epfd_.Get(), evs, std::size(evs),
-                                             wait_for / 1ms);
-  FLARE_PCHECK(nfds >= 0, "Unexpected: epoll_wait failed.");
+  io::detail::PollerEvent evs[kDescriptorsPerLoop];
+  auto nevs = poller_->Wait(evs, std::size(evs), wait_for);
 
   // Run event handlers.
-  RunEventHandlers(evs, evs + nfds); 
+  RunEventHandlers(evs, evs + nevs);
 }
 
 void EventLoop::RunUserTasks() {
@@ -245,7 +207,8 @@ void EventLoop::RunUserTasks() {
   }
 }
 
-void EventLoop::RunEventHandlers(epoll_event* begin, epoll_event* end) {
+void EventLoop::RunEventHandlers(io::detail::PollerEvent* begin,
+                                 io::detail::PollerEvent* end) {
   static_assert(static_cast<int>(Descriptor::Event::Read) == EPOLLIN,
                 "We're using `EPOLLIN` and `Descriptor::Event::Read` "
                 "interchangably.");
@@ -255,7 +218,7 @@ void EventLoop::RunEventHandlers(epoll_event* begin, epoll_event* end) {
 
   while (begin != end) {
     // FIXME: This `if` is ugly.
-    if (FLARE_UNLIKELY(begin->data.ptr == static_cast<void*>(&notifier_))) {
+    if (FLARE_UNLIKELY(begin->data == static_cast<void*>(&notifier_))) {
       FLARE_CHECK((begin->events & EPOLLERR) == 0,
                   "Unexpected error on event loop notifier.");
       notifier_.Reset();
@@ -263,7 +226,7 @@ void EventLoop::RunEventHandlers(epoll_event* begin, epoll_event* end) {
       continue;
     }
 
-    auto desc = reinterpret_cast<Descriptor*>(begin->data.ptr);
+    auto desc = reinterpret_cast<Descriptor*>(begin->data);
     FLARE_CHECK(desc);
     desc->FireEvents(begin->events);
     ++begin;
@@ -1,8 +1,6 @@
 #ifndef _SRC_IO_EVENT_LOOP_H_
 #define _SRC_IO_EVENT_LOOP_H_
 
-#include <sys/epoll.h>
-
 #include <atomic>
 #include <chrono>
 #include <list>
@@ -11,11 +9,9 @@
 #include <set>
 
 #include "../base/Function.h"
-#include "../base/Handle.h"
 #include "Descriptor.h"
 #include "detail/EventLoopNotifier.h"
-
-struct epoll_event;
+#include "detail/Poller.h"
 
 namespace tinyRPC {
 
@@ -100,11 +96,13 @@ class EventLoop {
  private:
   void WaitAndRunEvents(std::chrono::milliseconds wait_for);
   void RunUserTasks();
-  void RunEventHandlers(epoll_event* begin, epoll_event* end);
+  void RunEventHandlers(io::detail::PollerEvent* begin,
+                        io::detail::PollerEvent* end);
 
  private:
   std::atomic<bool> exiting_{false};
-  Handle epfd_;
+  // Epoll by default, @sa: `--flare_io_poller`.
+  std::unique_ptr<io::detail::Poller> poller_;
 
   // `notifier_` is used for waking the worker. (e.g. in the case there's a new
   // task for running.)
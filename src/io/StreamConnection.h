@@ -5,6 +5,8 @@
 #include <memory>
 #include <string>
 
+#include "../base/Buffer.h"
+
 namespace tinyRPC {
 
 class StreamConnection;
@@ -57,7 +59,7 @@ class StreamConnectionHandler: public std::enable_shared_from_this<StreamConnect
   //
   // 3. If `SuppressRead` is returned, it's user's responsibility to reenable
   //    read when appropriate by calling `StreamConnection::RestartRead`.
-  virtual DataConsumptionStatus OnDataArrival(std::string& buffer) = 0;
+  virtual DataConsumptionStatus OnDataArrival(NoncontiguousBuffer& buffer) = 0;
 
   // The remote side has closed the connection.
   //
@@ -107,7 +109,7 @@ class StreamConnection {
   //          in the future) at all. In this case the user may safely resend the
   //          `buffer` (presumably via a different connection) without worrying
   //          about multiple copied being sent.
-  virtual bool Write(const std::string& buffer, std::uintptr_t ctx) = 0;
+  virtual bool Write(NoncontiguousBuffer buffer, std::uintptr_t ctx) = 0;
 
   // Restart reading data.
   //
@@ -6,6 +6,12 @@ int EIntrSafeAccept(int sockfd, sockaddr* addr, socklen_t* addrlen) {
   return EIntrSafeCall([&] { return accept(sockfd, addr, addrlen); });
 }
 
+int EIntrSafeAccept4(int sockfd, sockaddr* addr, socklen_t* addrlen,
+                     int flags) {
+  return EIntrSafeCall(
+      [&] { return accept4(sockfd, addr, addrlen, flags); });
+}
+
 int EIntrSafeEpollWait(int epfd, epoll_event* events, int maxevents,
                        int timeout) {
   return EIntrSafeCall(
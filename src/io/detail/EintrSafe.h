@@ -49,6 +49,8 @@ inline ssize_t EIntrSafeWriteV(int fd, const iovec* iov, int iovcnt) {
 }
 
 int EIntrSafeAccept(int sockfd, sockaddr* addr, socklen_t* addrlen);
+int EIntrSafeAccept4(int sockfd, sockaddr* addr, socklen_t* addrlen,
+                     int flags);
 int EIntrSafeEpollWait(int epfd, epoll_event* events, int maxevents,
                        int timeout);
 ssize_t EIntrSafeRecvFrom(int sockfd, void* buf, size_t len, int flags,
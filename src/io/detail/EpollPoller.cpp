@@ -0,0 +1,78 @@
+#include "EpollPoller.h"
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+
+#include <algorithm>
+
+#include "../../base/Logging.h"
+#include "EintrSafe.h"
+
+using namespace std::literals;
+
+namespace tinyRPC::io::detail {
+
+EpollPoller::EpollPoller() {
+  // @sa: https://linux.die.net/man/2/epoll_create1
+  //
+  // > Since Linux 2.6.8, the size argument is ignored, but must be greater than
+  // > zero; see NOTES below.
+  //
+  // > epoll_create1() was added to the kernel in version 2.6.27. Library
+  // > support is provided in glibc starting with version 2.9.
+  //
+  // We use `epoll_create` here since `epoll_create1` is not available on
+  // CentOS 6. `epoll_create` does not support `EPOLL_CLOEXEC` though.
+  epfd_.Reset(epoll_create(1));
+  FLARE_PCHECK(epfd_.Get() != -1);
+  auto oldflags = fcntl(epfd_.Get(), F_GETFD);
+  FLARE_PCHECK(oldflags != -1);
+  FLARE_PCHECK(fcntl(epfd_.Get(), F_SETFD, oldflags | FD_CLOEXEC) == 0);
+}
+
+void EpollPoller::Add(int fd, std::uint32_t events, void* data) {
+  epoll_event ee;
+  ee.events = events;
+  ee.data.ptr = data;
+  syscalls_.fetch_add(1, std::memory_order_relaxed);
+  FLARE_PCHECK(epoll_ctl(epfd_.Get(), EPOLL_CTL_ADD, fd, &ee) == 0,
+               "Failed to add fd #{} to epoll.", fd);
+}
+
+void EpollPoller::Modify(int fd, std::uint32_t events, void* data) {
+  epoll_event ee;
+  ee.events = events;
+  ee.data.ptr = data;
+  syscalls_.fetch_add(1, std::memory_order_relaxed);
+  FLARE_PCHECK(epoll_ctl(epfd_.Get(), EPOLL_CTL_MOD, fd, &ee) == 0,
+               "Failed to modify fd #{} in epoll.", fd);
+}
+
+void EpollPoller::Remove(int fd) {
+  // http://man7.org/linux/man-pages/man2/epoll_ctl.2.html
+  //
+  // > In kernel versions before 2.6.9, the EPOLL_CTL_DEL operation required
+  // > a non - null pointer in event, even though this argument is ignored.
+  syscalls_.fetch_add(1, std::memory_order_relaxed);
+  FLARE_PCHECK(epoll_ctl(epfd_.Get(), EPOLL_CTL_DEL, fd, nullptr) == 0,
+               "Failed to remove fd #{} from epoll.", fd);
+}
+
+std::size_t EpollPoller::Wait(PollerEvent* events, std::size_t max_events,
+                              std::chrono::milliseconds timeout) {
+  // FIXME: Need we use `epoll_pwait` instead to handle signal more
+  // gracefully? (I'd say code using signal is fundamentally broken anyway.)
+  constexpr auto kEventsPerWait = 128;
+  epoll_event evs[kEventsPerWait];
+  syscalls_.fetch_add(1, std::memory_order_relaxed);
+  auto nfds = EIntrSafeEpollWait(
+      epfd_.Get(), evs, std::min<std::size_t>(max_events, kEventsPerWait),
+      timeout / 1ms);
+  FLARE_PCHECK(nfds >= 0, "Unexpected: epoll_wait failed.");
+  for (int i = 0; i != nfds; ++i) {
+    events[i] = {.data = evs[i].data.ptr, .events = evs[i].events};
+  }
+  return nfds;
+}
+
+}  // namespace tinyRPC::io::detail
@@ -0,0 +1,33 @@
+#ifndef _SRC_IO_DETAIL_EPOLL_POLLER_H_
+#define _SRC_IO_DETAIL_EPOLL_POLLER_H_
+
+#include <atomic>
+
+#include "../../base/Handle.h"
+#include "Poller.h"
+
+namespace tinyRPC::io::detail {
+
+// The default one.
+class EpollPoller final : public Poller {
+ public:
+  EpollPoller();
+
+  void Add(int fd, std::uint32_t events, void* data) override;
+  void Modify(int fd, std::uint32_t events, void* data) override;
+  void Remove(int fd) override;
+  std::size_t Wait(PollerEvent* events, std::size_t max_events,
+                   std::chrono::milliseconds timeout) override;
+
+  std::uint64_t GetSyscallCount() const noexcept override {
+    return syscalls_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  Handle epfd_;
+  std::atomic<std::uint64_t> syscalls_{0};
+};
+
+}  // namespace tinyRPC::io::detail
+
+#endif
@@ -0,0 +1,281 @@
+#include "IoUringPoller.h"
+
+#ifdef TINYRPC_IO_HAS_IO_URING
+
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "../../base/Logging.h"
+
+using namespace std::literals;
+
+namespace tinyRPC::io::detail {
+
+namespace {
+
+constexpr unsigned kRingEntries = 1024;
+
+int IoUringSetup(unsigned entries, io_uring_params* p) {
+  return syscall(__NR_io_uring_setup, entries, p);
+}
+
+int IoUringEnter(int fd, unsigned to_submit, unsigned min_complete,
+                 unsigned flags, const void* arg, std::size_t argsz) {
+  return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg,
+                 argsz);
+}
+
+template <class T>
+T* Offset(void* base, std::size_t offset) {
+  return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+unsigned LoadAcquire(const unsigned* p) {
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+void StoreRelease(unsigned* p, unsigned v) {
+  __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+}  // namespace
+
+std::unique_ptr<IoUringPoller> IoUringPoller::TryCreate() {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = kRingEntries * 4;  // Multishot polls post a lot.
+  Handle fd(IoUringSetup(kRingEntries, &params));
+  if (!fd) {
+    FLARE_LOG_WARNING("Failed to create io_uring: {}.", strerror(errno));
+    return nullptr;
+  }
+  // Multishot poll (5.13) is not advertised by a feature flag of its own.
+  // `IORING_FEAT_RSRC_TAGS` was added in the same release.
+  if (!(params.features & IORING_FEAT_EXT_ARG) ||
+      !(params.features & IORING_FEAT_NODROP) ||
+      !(params.features & IORING_FEAT_RSRC_TAGS)) {
+    FLARE_LOG_WARNING("io_uring is not new enough (features: {:#x}).",
+                      params.features);
+    return nullptr;
+  }
+
+  std::unique_ptr<IoUringPoller> poller{new IoUringPoller()};
+  poller->ring_fd_ = std::move(fd);
+  auto ring_fd = poller->ring_fd_.Get();
+
+  auto map = [&](std::size_t size, off_t offset) -> void* {
+    auto p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+    FLARE_PCHECK(p != MAP_FAILED, "Failed to map io_uring.");
+    return p;
+  };
+  poller->sq_ring_size_ =
+      params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  poller->cq_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    poller->sq_ring_size_ = poller->cq_ring_size_ =
+        std::max(poller->sq_ring_size_, poller->cq_ring_size_);
+  }
+  poller->sq_ring_ = map(poller->sq_ring_size_, IORING_OFF_SQ_RING);
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    poller->cq_ring_ = poller->sq_ring_;
+  } else {
+    poller->cq_ring_ = map(poller->cq_ring_size_, IORING_OFF_CQ_RING);
+  }
+  poller->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  poller->sqes_ = static_cast<io_uring_sqe*>(
+      map(poller->sqes_size_, IORING_OFF_SQES));
+
+  auto sq = poller->sq_ring_;
+  poller->sq_head_ = Offset<unsigned>(sq, params.sq_off.head);
+  poller->sq_tail_ = Offset<unsigned>(sq, params.sq_off.tail);
+  poller->sq_mask_ = *Offset<unsigned>(sq, params.sq_off.ring_mask);
+  poller->sq_entries_ = *Offset<unsigned>(sq, params.sq_off.ring_entries);
+  poller->sq_array_ = Offset<unsigned>(sq, params.sq_off.array);
+  auto cq = poller->cq_ring_;
+  poller->cq_head_ = Offset<unsigned>(cq, params.cq_off.head);
+  poller->cq_tail_ = Offset<unsigned>(cq, params.cq_off.tail);
+  poller->cq_mask_ = *Offset<unsigned>(cq, params.cq_off.ring_mask);
+  poller->cqes_ = Offset<io_uring_cqe>(cq, params.cq_off.cqes);
+  return poller;
+}
+
+IoUringPoller::~IoUringPoller() {
+  munmap(sqes_, sqes_size_);
+  if (cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  munmap(sq_ring_, sq_ring_size_);
+}
+
+void IoUringPoller::Add(int fd, std::uint32_t events, void* data) {
+  std::scoped_lock _(lock_);
+  auto reg = GetRegistration(fd);
+  FLARE_CHECK(!reg->active, "Fd #{} has already been added.", fd);
+  ++reg->generation;
+  reg->data = data;
+  reg->events = events;
+  reg->active = true;
+  PrepPollAdd(fd, *reg);
+  SubmitLocked();
+}
+
+void IoUringPoller::Modify(int fd, std::uint32_t events, void* data) {
+  std::scoped_lock _(lock_);
+  auto reg = GetRegistration(fd);
+  FLARE_CHECK(reg->active, "Fd #{} has not been added.", fd);
+  // Cancel the old poll and arm a new one. The kernel evaluates readiness
+  // when the new poll is armed, same as `EPOLL_CTL_MOD`.
+  PrepPollRemove(fd, *reg);
+  ++reg->generation;
+  reg->data = data;
+  reg->events = events;
+  PrepPollAdd(fd, *reg);
+  SubmitLocked();
+}
+
+void IoUringPoller::Remove(int fd) {
+  std::scoped_lock _(lock_);
+  auto reg = GetRegistration(fd);
+  FLARE_CHECK(reg->active, "Fd #{} has not been added.", fd);
+  PrepPollRemove(fd, *reg);
+  ++reg->generation;  // Completions already posted are dropped.
+  reg->active = false;
+  reg->data = nullptr;
+  SubmitLocked();
+}
+
+std::size_t IoUringPoller::Wait(PollerEvent* events, std::size_t max_events,
+                                std::chrono::milliseconds timeout) {
+  // One `io_uring_enter` for both submitting pending re-arms and waiting for
+  // completions. If there are completions already, don't wait.
+  {
+    std::unique_lock lk(lock_);
+    auto to_submit = *sq_tail_ - LoadAcquire(sq_head_);
+    auto ready = LoadAcquire(cq_tail_) != *cq_head_;
+    if (to_submit || !ready) {
+      lk.unlock();  // Other threads may submit while we're waiting.
+      __kernel_timespec ts = {.tv_sec = timeout / 1s,
+                              .tv_nsec = (timeout % 1s) / 1ns};
+      io_uring_getevents_arg arg = {.sigmask = 0,
+                                    .sigmask_sz = 0,
+                                    .pad = 0,
+                                    .ts = reinterpret_cast<std::uint64_t>(&ts)};
+      syscalls_.fetch_add(1, std::memory_order_relaxed);
+      auto rc = IoUringEnter(ring_fd_.Get(), to_submit, ready ? 0 : 1,
+                             IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                             &arg, sizeof(arg));
+      FLARE_PCHECK(rc >= 0 || errno == ETIME || errno == EINTR ||
+                       errno == EBUSY,
+                   "Unexpected: io_uring_enter failed.");
+    }
+  }
+
+  // Reap completions.
+  std::size_t nevents = 0;
+  std::scoped_lock _(lock_);
+  auto head = *cq_head_;
+  auto tail = LoadAcquire(cq_tail_);
+  for (; head != tail && nevents != max_events; ++head) {
+    auto&& cqe = cqes_[head & cq_mask_];
+    if (!cqe.user_data) {
+      continue;  // Completion of `IORING_OP_POLL_REMOVE`.
+    }
+    auto fd = static_cast<int>(cqe.user_data & 0xffffffff);
+    auto generation = static_cast<std::uint32_t>(cqe.user_data >> 32);
+    auto reg = GetRegistration(fd);
+    if (!reg->active || reg->generation != generation) {
+      continue;  // Stale.
+    }
+    if (FLARE_UNLIKELY(cqe.res < 0)) {
+      // Not re-armed, otherwise we'd likely keep failing. Let the owner know
+      // the way epoll would.
+      FLARE_LOG_ERROR_ONCE("Failed to poll fd #{}: {}.", fd,
+                           strerror(-cqe.res));
+      events[nevents++] = {.data = reg->data, .events = EPOLLERR};
+      continue;
+    }
+    if (cqe.res) {
+      events[nevents++] = {.data = reg->data,
+                           .events = static_cast<std::uint32_t>(cqe.res)};
+    }
+    if (!(cqe.flags & IORING_CQE_F_MORE)) {
+      // Either a one-shot (level-triggered) poll has fired, or the kernel
+      // terminated a multishot one (e.g. on CQ overflow). Re-arm it, it will
+      // be submitted by next `Wait`.
+      PrepPollAdd(fd, *reg);
+    }
+  }
+  StoreRelease(cq_head_, head);
+  return nevents;
+}
+
+IoUringPoller::Registration* IoUringPoller::GetRegistration(int fd) {
+  FLARE_CHECK_GE(fd, 0);
+  if (registrations_.size() <= static_cast<std::size_t>(fd)) {
+    registrations_.resize(std::max<std::size_t>(fd + 1, registrations_.size() * 2));
+  }
+  return &registrations_[fd];
+}
+
+io_uring_sqe* IoUringPoller::GetSqe() {
+  while (*sq_tail_ - LoadAcquire(sq_head_) == sq_entries_) {
+    SubmitLocked();  // Full. Let the kernel consume some.
+  }
+  auto tail = *sq_tail_;
+  auto index = tail & sq_mask_;
+  auto sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  // Published once filled, see `PrepXxx`.
+  return sqe;
+}
+
+void IoUringPoller::PrepPollAdd(int fd, const Registration& reg) {
+  auto sqe = GetSqe();
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+  if (reg.events & EPOLLET) {
+    sqe->len = IORING_POLL_ADD_MULTI;  // Edge-triggered by nature.
+  } else {
+    // Multishot polls can't be level-triggered. A one-shot poll re-armed each
+    // time it fires behaves the same: It fires again immediately if the fd is
+    // still ready.
+    sqe->len = 0;
+  }
+  sqe->poll32_events = reg.events & ~EPOLLET;
+  sqe->user_data = UserDataOf(fd, reg);
+  StoreRelease(sq_tail_, *sq_tail_ + 1);
+}
+
+void IoUringPoller::PrepPollRemove(int fd, const Registration& reg) {
+  auto sqe = GetSqe();
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = UserDataOf(fd, reg);
+  sqe->user_data = 0;
+  StoreRelease(sq_tail_, *sq_tail_ + 1);
+}
+
+void IoUringPoller::SubmitLocked() {
+  auto to_submit = *sq_tail_ - LoadAcquire(sq_head_);
+  if (!to_submit) {
+    return;
+  }
+  syscalls_.fetch_add(1, std::memory_order_relaxed);
+  auto rc = IoUringEnter(ring_fd_.Get(), to_submit, 0, 0, nullptr, 0);
+  FLARE_PCHECK(rc >= 0 || errno == EINTR || errno == EBUSY ||
+                   errno == EAGAIN,
+               "Unexpected: io_uring_enter failed.");
+}
+
+}  // namespace tinyRPC::io::detail
+
+#endif  // TINYRPC_IO_HAS_IO_URING
@@ -0,0 +1,106 @@
+#ifndef _SRC_IO_DETAIL_IO_URING_POLLER_H_
+#define _SRC_IO_DETAIL_IO_URING_POLLER_H_
+
+#if __has_include(<linux/io_uring.h>)
+#define TINYRPC_IO_HAS_IO_URING 1
+#endif
+
+#ifdef TINYRPC_IO_HAS_IO_URING
+
+#include <linux/io_uring.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../../base/Handle.h"
+#include "Poller.h"
+
+namespace tinyRPC::io::detail {
+
+// Poller built on io_uring (w/o liburing, we talk to the kernel directly).
+//
+// Each edge-triggered fd is watched by a multishot `IORING_OP_POLL_ADD`, so,
+// as with `EPOLLET`, it's armed once and keeps posting completions. Level-
+// triggered ones use one-shot polls re-armed on completion. Changes to the
+// watch list are submitted immediately. Re-arming polls terminated by the
+// kernel is batched into the `io_uring_enter` that `Wait` does anyway, which
+// is the only system call made per `Wait`.
+//
+// Requires Linux 5.13+ (`IORING_FEAT_EXT_ARG`, multishot poll).
+class IoUringPoller final : public Poller {
+ public:
+  // Returns `nullptr` if io_uring is not usable.
+  static std::unique_ptr<IoUringPoller> TryCreate();
+
+  ~IoUringPoller();
+
+  void Add(int fd, std::uint32_t events, void* data) override;
+  void Modify(int fd, std::uint32_t events, void* data) override;
+  void Remove(int fd) override;
+  std::size_t Wait(PollerEvent* events, std::size_t max_events,
+                   std::chrono::milliseconds timeout) override;
+
+  std::uint64_t GetSyscallCount() const noexcept override {
+    return syscalls_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  IoUringPoller() = default;
+
+  struct Registration {
+    void* data = nullptr;
+    std::uint32_t events = 0;
+    // Incremented each time the registration changes. Completions of stale
+    // polls are recognized (and dropped) by this.
+    std::uint32_t generation = 0;
+    bool active = false;
+  };
+
+  // Below are called with `lock_` held.
+  Registration* GetRegistration(int fd);
+  io_uring_sqe* GetSqe();
+  void PrepPollAdd(int fd, const Registration& reg);
+  void PrepPollRemove(int fd, const Registration& reg);
+  void SubmitLocked();
+
+  static std::uint64_t UserDataOf(int fd, const Registration& reg) {
+    return static_cast<std::uint64_t>(reg.generation) << 32 |
+           static_cast<std::uint32_t>(fd);
+  }
+
+ private:
+  Handle ring_fd_;
+  std::atomic<std::uint64_t> syscalls_{0};
+
+  // Mapped rings.
+  void* sq_ring_ = nullptr;
+  std::size_t sq_ring_size_ = 0;
+  void* cq_ring_ = nullptr;
+  std::size_t cq_ring_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  std::size_t sqes_size_ = 0;
+
+  // Submission queue. We're the only producer (with `lock_` held).
+  unsigned* sq_head_;
+  unsigned* sq_tail_;
+  unsigned sq_mask_;
+  unsigned sq_entries_;
+  unsigned* sq_array_;
+
+  // Completion queue. Only accessed by `Wait`.
+  unsigned* cq_head_;
+  unsigned* cq_tail_;
+  unsigned cq_mask_;
+  io_uring_cqe* cqes_;
+
+  std::mutex lock_;
+  std::vector<Registration> registrations_;  // Indexed by fd.
+};
+
+}  // namespace tinyRPC::io::detail
+
+#endif  // TINYRPC_IO_HAS_IO_URING
+
+#endif
@@ -0,0 +1,32 @@
+#include "Poller.h"
+
+#include "../../include/gflags/gflags.h"
+
+#include "../../base/Logging.h"
+#include "EpollPoller.h"
+#include "IoUringPoller.h"
+
+DEFINE_string(flare_io_poller, "epoll",
+              "Backend used by event loops for readiness notification. Either "
+              "`epoll` or `io_uring`. If `io_uring` is not supported by the "
+              "system, `epoll` is used instead.");
+
+namespace tinyRPC::io::detail {
+
+std::unique_ptr<Poller> MakePoller(const std::string& kind) {
+  if (kind == "io_uring") {
+#ifdef TINYRPC_IO_HAS_IO_URING
+    if (auto p = IoUringPoller::TryCreate()) {
+      return p;
+    }
+#endif
+    FLARE_LOG_WARNING_ONCE("io_uring is not available, using epoll instead.");
+  } else {
+    FLARE_CHECK_EQ(kind, "epoll", "Unrecognized poller [{}].", kind);
+  }
+  return std::make_unique<EpollPoller>();
+}
+
+std::unique_ptr<Poller> MakePoller() { return MakePoller(FLAGS_flare_io_poller); }
+
+}  // namespace tinyRPC::io::detail
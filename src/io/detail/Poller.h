@@ -0,0 +1,57 @@
+#ifndef _SRC_IO_DETAIL_POLLER_H_
+#define _SRC_IO_DETAIL_POLLER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace tinyRPC::io::detail {
+
+struct PollerEvent {
+  void* data;
+  std::uint32_t events;  // `EPOLLxxx`.
+};
+
+// Readiness notification backend used by `EventLoop`.
+//
+// Events are described by `EPOLLxxx` flags, regardless of the backend in use.
+// `EPOLLET` is honored, so is its absence.
+//
+// `Add` / `Modify` / `Remove` may be called from any thread, `Wait` is only
+// called by the event loop.
+class Poller {
+ public:
+  virtual ~Poller() = default;
+
+  // Start watching `fd`. `data` is reported back in `PollerEvent`.
+  virtual void Add(int fd, std::uint32_t events, void* data) = 0;
+
+  // Change events watched on `fd`.
+  virtual void Modify(int fd, std::uint32_t events, void* data) = 0;
+
+  // Stop watching `fd`. Once this method returns, `Wait` won't report events
+  // of `fd` any more, but events already returned may still be being handled
+  // by the caller of `Wait`.
+  virtual void Remove(int fd) = 0;
+
+  // Wait for at most `timeout` and fill `events` with at most `max_events`
+  // events. Number of events filled is returned.
+  virtual std::size_t Wait(PollerEvent* events, std::size_t max_events,
+                           std::chrono::milliseconds timeout) = 0;
+
+  // Number of system calls made so far. For diagnostic purpose only.
+  virtual std::uint64_t GetSyscallCount() const noexcept = 0;
+};
+
+// Create a poller of the given kind ("epoll" or "io_uring"). If it's not
+// supported by the system, we fall back to epoll.
+std::unique_ptr<Poller> MakePoller(const std::string& kind);
+
+// Create a poller of kind specified by `--flare_io_poller`.
+std::unique_ptr<Poller> MakePoller();
+
+}  // namespace tinyRPC::io::detail
+
+#endif
@@ -0,0 +1,146 @@
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../../include/benchmark/benchmark.h"
+#include "../../base/Handle.h"
+#include "../../base/Logging.h"
+#include "Poller.h"
+
+// Ping-pong over several socket pairs. The echoing side is driven by the
+// poller under test, the same way `EventLoop` drives descriptors (edge-
+// triggered, drained until `EAGAIN`).
+//
+// Reported counters:
+//
+// - poller_syscalls/req: System calls made by the poller per request.
+// - io_syscalls/req:     `read` / `write` made by the echoing side per request.
+// - p50_us / p99_us:     Round-trip latency.
+
+using namespace std::literals;
+
+namespace tinyRPC::io::detail {
+
+namespace {
+
+constexpr auto kConnections = 16;
+constexpr auto kMessageSize = 64;
+
+class EchoServer {
+ public:
+  explicit EchoServer(const std::string& poller) : poller_(MakePoller(poller)) {
+    for (int i = 0; i != kConnections; ++i) {
+      int fds[2];
+      PCHECK(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == 0);
+      clients_.emplace_back(fds[0]);
+      servers_.emplace_back(fds[1]);
+      PCHECK(fcntl(fds[1], F_SETFL, O_NONBLOCK) == 0);
+    }
+    for (auto&& e : servers_) {
+      poller_->Add(e.Get(), EPOLLIN | EPOLLET, &e);
+    }
+    worker_ = std::thread([this] { WorkerProc(); });
+  }
+
+  ~EchoServer() {
+    exiting_ = true;
+    worker_.join();
+    for (auto&& e : servers_) {
+      poller_->Remove(e.Get());
+    }
+  }
+
+  int GetClientFd(std::size_t index) const { return clients_[index].Get(); }
+  std::uint64_t GetPollerSyscalls() const {
+    return poller_->GetSyscallCount();
+  }
+  std::uint64_t GetIoSyscalls() const { return io_syscalls_; }
+
+ private:
+  void WorkerProc() {
+    PollerEvent evs[kConnections];
+    char buffer[65536];
+
+    while (!exiting_) {
+      auto n = poller_->Wait(evs, std::size(evs), 10ms);
+      for (std::size_t i = 0; i != n; ++i) {
+        auto fd = static_cast<Handle*>(evs[i].data)->Get();
+        while (true) {
+          io_syscalls_.fetch_add(1, std::memory_order_relaxed);
+          auto bytes = read(fd, buffer, sizeof(buffer));
+          if (bytes <= 0) {
+            PCHECK(bytes == 0 || errno == EAGAIN);
+            break;
+          }
+          io_syscalls_.fetch_add(1, std::memory_order_relaxed);
+          PCHECK(write(fd, buffer, bytes) == bytes);
+        }
+      }
+    }
+  }
+
+ private:
+  std::unique_ptr<Poller> poller_;
+  std::vector<Handle> clients_, servers_;
+  std::atomic<bool> exiting_{false};
+  std::atomic<std::uint64_t> io_syscalls_{0};
+  std::thread worker_;
+};
+
+void Benchmark_PingPong(benchmark::State& state, const std::string& poller) {
+  EchoServer server(poller);
+  char buffer[kMessageSize] = {};
+  std::vector<std::chrono::nanoseconds> latencies;
+  std::size_t requests = 0;
+
+  auto poller_syscalls_before = server.GetPollerSyscalls();
+  auto io_syscalls_before = server.GetIoSyscalls();
+  for (auto _ : state) {
+    auto fd = server.GetClientFd(requests++ % kConnections);
+    auto start = std::chrono::steady_clock::now();
+    PCHECK(write(fd, buffer, sizeof(buffer)) == sizeof(buffer));
+    std::size_t read_bytes = 0;
+    while (read_bytes != sizeof(buffer)) {
+      auto rc = read(fd, buffer + read_bytes, sizeof(buffer) - read_bytes);
+      PCHECK(rc > 0);
+      read_bytes += rc;
+    }
+    latencies.push_back(std::chrono::steady_clock::now() - start);
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&](double p) {
+    return latencies[latencies.size() * p].count() / 1000.0;
+  };
+  state.counters["poller_syscalls/req"] =
+      static_cast<double>(server.GetPollerSyscalls() - poller_syscalls_before) /
+      requests;
+  state.counters["io_syscalls/req"] =
+      static_cast<double>(server.GetIoSyscalls() - io_syscalls_before) /
+      requests;
+  state.counters["p50_us"] = percentile(0.5);
+  state.counters["p99_us"] = percentile(0.99);
+}
+
+void Benchmark_Epoll(benchmark::State& state) {
+  Benchmark_PingPong(state, "epoll");
+}
+
+void Benchmark_IoUring(benchmark::State& state) {
+  Benchmark_PingPong(state, "io_uring");
+}
+
+}  // namespace
+
+BENCHMARK(Benchmark_Epoll);
+BENCHMARK(Benchmark_IoUring);
+
+}  // namespace tinyRPC::io::detail
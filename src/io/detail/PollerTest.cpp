@@ -0,0 +1,154 @@
+#include "Poller.h"
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../include/gtest/gtest.h"
+
+#include "../../base/Handle.h"
+#include "EintrSafe.h"
+
+using namespace std::literals;
+
+namespace tinyRPC::io::detail {
+
+class PollerTest : public ::testing::TestWithParam<std::string> {};
+
+void Signal(int fd) {
+  std::uint64_t v = 1;
+  ASSERT_EQ(sizeof(v), EIntrSafeWrite(fd, &v, sizeof(v)));
+}
+
+void Drain(int fd) {
+  std::uint64_t v;
+  ASSERT_EQ(sizeof(v), EIntrSafeRead(fd, &v, sizeof(v)));
+}
+
+TEST_P(PollerTest, LevelTriggered) {
+  auto poller = MakePoller(GetParam());
+  Handle fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+  int tag;
+  PollerEvent evs[16];
+
+  poller->Add(fd.Get(), EPOLLIN, &tag);
+  EXPECT_EQ(0, poller->Wait(evs, std::size(evs), 10ms));
+  Signal(fd.Get());
+  // Reported until drained.
+  for (int i = 0; i != 3; ++i) {
+    ASSERT_EQ(1, poller->Wait(evs, std::size(evs), 1s));
+    EXPECT_EQ(&tag, evs[0].data);
+    EXPECT_TRUE(evs[0].events & EPOLLIN);
+  }
+  Drain(fd.Get());
+  EXPECT_EQ(0, poller->Wait(evs, std::size(evs), 10ms));
+  poller->Remove(fd.Get());
+}
+
+TEST_P(PollerTest, EdgeTriggered) {
+  auto poller = MakePoller(GetParam());
+  Handle fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+  int tag;
+  PollerEvent evs[16];
+
+  poller->Add(fd.Get(), EPOLLIN | EPOLLET, &tag);
+  for (int i = 0; i != 3; ++i) {
+    Signal(fd.Get());
+    ASSERT_EQ(1, poller->Wait(evs, std::size(evs), 1s));
+    EXPECT_EQ(&tag, evs[0].data);
+    // Reported only once per edge, even if not drained.
+    EXPECT_EQ(0, poller->Wait(evs, std::size(evs), 10ms));
+  }
+  poller->Remove(fd.Get());
+}
+
+TEST_P(PollerTest, Modify) {
+  auto poller = MakePoller(GetParam());
+  int fds[2];
+  ASSERT_EQ(0, pipe2(fds, O_NONBLOCK | O_CLOEXEC));
+  Handle rfd(fds[0]), wfd(fds[1]);
+  int tag1, tag2;
+  PollerEvent evs[16];
+
+  poller->Add(wfd.Get(), EPOLLIN | EPOLLET, &tag1);
+  EXPECT_EQ(0, poller->Wait(evs, std::size(evs), 10ms));
+  // Pipe is writable, so it's reported on (re-)arming.
+  poller->Modify(wfd.Get(), EPOLLOUT | EPOLLET, &tag2);
+  ASSERT_EQ(1, poller->Wait(evs, std::size(evs), 1s));
+  EXPECT_EQ(&tag2, evs[0].data);
+  EXPECT_TRUE(evs[0].events & EPOLLOUT);
+  poller->Modify(wfd.Get(), EPOLLOUT | EPOLLET, &tag1);
+  ASSERT_EQ(1, poller->Wait(evs, std::size(evs), 1s));
+  EXPECT_EQ(&tag1, evs[0].data);
+  poller->Remove(wfd.Get());
+}
+
+TEST_P(PollerTest, Remove) {
+  auto poller = MakePoller(GetParam());
+  Handle fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+  int tag;
+  PollerEvent evs[16];
+
+  poller->Add(fd.Get(), EPOLLIN, &tag);
+  Signal(fd.Get());
+  poller->Remove(fd.Get());
+  EXPECT_EQ(0, poller->Wait(evs, std::size(evs), 10ms));
+
+  // Fd can be added again after removal.
+  poller->Add(fd.Get(), EPOLLIN, &tag);
+  ASSERT_EQ(1, poller->Wait(evs, std::size(evs), 1s));
+  poller->Remove(fd.Get());
+}
+
+TEST_P(PollerTest, WakeUpFromOtherThread) {
+  auto poller = MakePoller(GetParam());
+  Handle fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+  int tag;
+  PollerEvent evs[16];
+
+  poller->Add(fd.Get(), EPOLLIN | EPOLLET, &tag);
+  auto start = std::chrono::steady_clock::now();
+  std::thread t([&] {
+    std::this_thread::sleep_for(100ms);
+    Signal(fd.Get());
+  });
+  ASSERT_EQ(1, poller->Wait(evs, std::size(evs), 5s));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 2s);
+  t.join();
+  poller->Remove(fd.Get());
+}
+
+TEST_P(PollerTest, ManyFds) {
+  constexpr auto kFds = 200;
+  auto poller = MakePoller(GetParam());
+  std::vector<Handle> fds;
+  int tag;
+  PollerEvent evs[kFds];
+
+  for (int i = 0; i != kFds; ++i) {
+    fds.emplace_back(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+    poller->Add(fds.back().Get(), EPOLLIN | EPOLLET, &tag);
+    Signal(fds.back().Get());
+  }
+  std::size_t total = 0;
+  while (total != kFds) {
+    auto n = poller->Wait(evs, std::size(evs), 1s);
+    ASSERT_NE(0, n);
+    total += n;
+  }
+  EXPECT_EQ(0, poller->Wait(evs, std::size(evs), 10ms));
+  for (auto&& e : fds) {
+    poller->Remove(e.Get());
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Poller, PollerTest,
+                         ::testing::Values("epoll", "io_uring"));
+
+}  // namespace tinyRPC::io::detail
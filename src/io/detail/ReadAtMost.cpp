@@ -2,37 +2,95 @@
 
 #include "ReadAtMost.h"
 
+#include <algorithm>
+#include <utility>
+
 namespace tinyRPC::io::detail{
 
-ssize_t ReadAtMostPartial(std::size_t max_bytes, AbstractStreamIo* io,
-                          std::string& to, bool* short_read) {
-  CHECK_LE(max_bytes, 4 * 1024 * 1024);
-  // No static array here, must be reentrant.
-  char* buf = new char[4 * 1024 * 1024];
+ssize_t AdaptiveReadBuffer::Read(AbstractStreamIo* io, std::size_t max_bytes,
+                                 NoncontiguousBuffer& to, bool* short_read) {
+  // The partially filled block (if any), followed by `blocks_` new ones.
+  RefPtr<NativeBufferBlock> blocks[kMaxBlocks + 1];
+  std::size_t offsets[kMaxBlocks + 1];
+  iovec iov[kMaxBlocks + 1];
+  std::size_t nv = 0, capacity = 0;
+  // Bytes we'd read had `max_bytes` not been a limit.
+  auto nominal_capacity = blocks_ * kBufferBlockSize;
+
+  auto add_block = [&](RefPtr<NativeBufferBlock> block, std::size_t offset) {
+    auto size = std::min(block->size() - offset, max_bytes - capacity);
+    iov[nv] = {block->mutable_data() + offset, size};
+    offsets[nv] = offset;
+    blocks[nv++] = std::move(block);
+    capacity += size;
+  };
+  if (tail_) {
+    nominal_capacity += tail_->size() - tail_used_;
+    add_block(std::move(tail_), tail_used_);
+  }
+  for (std::size_t i = 0; i != blocks_ && capacity != max_bytes; ++i) {
+    add_block(MakeNativeBufferBlock(), 0);
+  }
 
-  auto readBytes = io->Read(buf, max_bytes);
-  if (readBytes <= 0) {
+  auto readBytes = io->ReadV(iov, nv);
+  if (readBytes < 0) {
+    // Keep the partially filled block for the next read.
+    if (nv && offsets[0]) {
+      tail_ = std::move(blocks[0]);
+    }
     return readBytes;
   }
+  CHECK_LE(readBytes, capacity);
+  *short_read = readBytes != capacity;
 
-  CHECK_LE(readBytes, max_bytes);
-  *short_read = readBytes != max_bytes;
-  
-  if(readBytes){
-      to.append(buf, readBytes);
+  // Move bytes read to `to`, and keep the last block if it has room left.
+  std::size_t left = readBytes;
+  for (std::size_t i = 0; i != nv; ++i) {
+    auto&& block = blocks[i];
+    auto used = std::min(left, iov[i].iov_len);
+    if (used) {
+      to.Append(PolymorphicBuffer(block, offsets[i], used));
+      left -= used;
+    }
+    if (offsets[i] + used != block->size()) {
+      tail_used_ = offsets[i] + used;
+      tail_ = std::move(block);
+      break;
+    }
   }
 
+  // If we were limited by `max_bytes`, a full read says nothing about how
+  // much more we could have read.
+  if (*short_read || capacity == nominal_capacity) {
+    Adapt(readBytes, nominal_capacity);
+  }
   return readBytes;
 }
 
+void AdaptiveReadBuffer::Adapt(std::size_t bytes_read, std::size_t capacity) {
+  if (bytes_read == capacity) {
+    blocks_ = std::min(blocks_ * 2, kMaxBlocks);
+    shrink_pending_ = false;
+  } else if (blocks_ > 1 &&
+             bytes_read + (blocks_ - blocks_ / 2) * kBufferBlockSize <=
+                 capacity) {  // Would have fit in half as many blocks.
+    if (std::exchange(shrink_pending_, !shrink_pending_)) {
+      blocks_ /= 2;
+    }
+  } else {
+    shrink_pending_ = false;
+  }
+}
+
 ReadStatus ReadAtMost(std::size_t max_bytes, AbstractStreamIo* io,
-                      std::string& to, std::size_t* bytes_read) {
+                      AdaptiveReadBuffer* reader, NoncontiguousBuffer& to,
+                      std::size_t* bytes_read) {
   auto bytes_left = max_bytes;
   *bytes_read = 0;
   while (bytes_left) {
     bool short_read = false;  
     auto bytes_to_read = bytes_left;
-    auto read = ReadAtMostPartial(bytes_to_read, io, to, &short_read);
+    auto read = reader->Read(io, bytes_to_read, to, &short_read);
     if (read == 0) {  
       return ReadStatus::PeerClosing;
     }
@@ -50,7 +108,6 @@ ReadStatus ReadAtMost(std::size_t max_bytes, AbstractStreamIo* io,
     bytes_left -= read;
 
     if (short_read) {
-      CHECK_LT(read, bytes_to_read);
       return ReadStatus::Drained;
     }
   }
@@ -58,4 +115,4 @@ ReadStatus ReadAtMost(std::size_t max_bytes, AbstractStreamIo* io,
   return ReadStatus::MaxBytesRead;
 }
 
-} // namespace tinyRPC::io::detail
\ No newline at end of file
+} // namespace tinyRPC::io::detail
@@ -3,6 +3,7 @@
 
 #include <string>
 
+#include "../../base/Buffer.h"
 #include "../util/StreamIO.h"
 
 namespace tinyRPC::io::detail {
@@ -22,13 +23,45 @@ enum class ReadStatus {
   Error
 };
 
-// Reads at most `max_bytes` into `to`.
+// Per-connection state for reading bytes into pooled buffer blocks.
 //
-// Returns whatever returned by `io->Read`.
+// The block last read into is kept as long as it has room left, so small
+// reads share a block instead of wasting one each. The number of blocks given
+// to each `readv` adapts to how much we were able to read recently: it's
+// doubled each time `readv` fills all of them, and halved after two
+// consecutive reads that would have fit in half as many.
 //
-// `to` is an empty string.
+// Thread-compatible.
+class AdaptiveReadBuffer {
+ public:
+  static constexpr std::size_t kMaxBlocks = 16;
+
+  // Reads at most `max_bytes` and appends them to `to`. Returns whatever
+  // `io->ReadV` returns. `short_read` is set if fewer bytes than requested
+  // were read.
+  ssize_t Read(AbstractStreamIo* io, std::size_t max_bytes,
+               NoncontiguousBuffer& to, bool* short_read);
+
+  // Number of new blocks the next read will use (not counting the partially
+  // filled one). Exposed for testing purpose.
+  std::size_t GetBlocksPerRead() const noexcept { return blocks_; }
+
+ private:
+  void Adapt(std::size_t bytes_read, std::size_t capacity);
+
+  RefPtr<NativeBufferBlock> tail_;
+  std::size_t tail_used_ = 0;
+  std::size_t blocks_ = 1;
+  bool shrink_pending_ = false;
+};
+
+// Reads at most `max_bytes` and appends them to `to`.
+//
+// Bytes are read into buffer blocks directly, which are then appended to `to`
+// without copying.
 ReadStatus ReadAtMost(std::size_t max_bytes, AbstractStreamIo* io,
-                      std::string& to, std::size_t* bytes_read);
+                      AdaptiveReadBuffer* reader, NoncontiguousBuffer& to,
+                      std::size_t* bytes_read);
 
 }  // namespace tinyRPC::io::detail
 
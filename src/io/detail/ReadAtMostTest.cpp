@@ -26,7 +26,7 @@ class ReadAtMostTest : public ::testing::Test {
     util::SetNonBlocking(fd_[0]);
     util::SetNonBlocking(fd_[1]);
     io_ = std::make_unique<SystemStreamIo>(fd_[0]);
-    buffer_.clear();
+    buffer_.Clear();
   }
   void TearDown() override {
     // Failure is ignored. If the testcase itself closed the socket, call(s)
@@ -38,51 +38,89 @@ class ReadAtMostTest : public ::testing::Test {
  protected:
   int fd_[2];  // read fd, write fd.
   std::unique_ptr<SystemStreamIo> io_;
-  std::string buffer_;
+  AdaptiveReadBuffer reader_;
+  NoncontiguousBuffer buffer_;
   std::size_t bytes_read_;
 };
 
 TEST_F(ReadAtMostTest, Drained) {
   ASSERT_EQ(ReadStatus::Drained,
-            ReadAtMost(8, io_.get(), buffer_, &bytes_read_));
-  EXPECT_EQ(std::string("1234567"), buffer_);
+            ReadAtMost(8, io_.get(), &reader_, buffer_, &bytes_read_));
+  EXPECT_EQ(std::string("1234567"), FlattenSlow(buffer_));
   EXPECT_EQ(7, bytes_read_);
 }
 
 TEST_F(ReadAtMostTest, Drained2) {
-  buffer_ = "0000";
+  buffer_ = CreateBufferSlow("0000");
   ASSERT_EQ(ReadStatus::Drained,
-            ReadAtMost(8, io_.get(), buffer_, &bytes_read_));
-  EXPECT_EQ(std::string("00001234567"), buffer_);
+            ReadAtMost(8, io_.get(), &reader_, buffer_, &bytes_read_));
+  EXPECT_EQ(std::string("00001234567"), FlattenSlow(buffer_));
   EXPECT_EQ(7, bytes_read_);
 }
 
 TEST_F(ReadAtMostTest, MaxBytesRead) {
   ASSERT_EQ(ReadStatus::MaxBytesRead,
-            ReadAtMost(7, io_.get(), buffer_, &bytes_read_));
-  EXPECT_EQ(std::string("1234567"), buffer_);
+            ReadAtMost(7, io_.get(), &reader_, buffer_, &bytes_read_));
+  EXPECT_EQ(std::string("1234567"), FlattenSlow(buffer_));
   EXPECT_EQ(7, bytes_read_);
 }
 
 TEST_F(ReadAtMostTest, MaxBytesRead2) {
   ASSERT_EQ(ReadStatus::MaxBytesRead,
-            ReadAtMost(5, io_.get(), buffer_, &bytes_read_));
-  EXPECT_EQ(std::string("12345"), buffer_);
+            ReadAtMost(5, io_.get(), &reader_, buffer_, &bytes_read_));
+  EXPECT_EQ(std::string("12345"), FlattenSlow(buffer_));
   EXPECT_EQ(5, bytes_read_);
 }
 
 TEST_F(ReadAtMostTest, PeerClosing) {
   FLARE_PCHECK(close(fd_[1]) == 0);
   ASSERT_EQ(ReadStatus::Drained,
-            ReadAtMost(8, io_.get(), buffer_, &bytes_read_));
+            ReadAtMost(8, io_.get(), &reader_, buffer_, &bytes_read_));
   EXPECT_EQ(7, bytes_read_);
   // This is weird. The first call always succeeds even if it can tell the
   // remote side has closed the socket, yet we still need to issue another call
   // to `read` to see the situation.
   ASSERT_EQ(ReadStatus::PeerClosing,
-            ReadAtMost(1, io_.get(), buffer_, &bytes_read_));
+            ReadAtMost(1, io_.get(), &reader_, buffer_, &bytes_read_));
   EXPECT_EQ(0, bytes_read_);
-  EXPECT_EQ(std::string("1234567"), buffer_);
+  EXPECT_EQ(std::string("1234567"), FlattenSlow(buffer_));
+}
+
+TEST_F(ReadAtMostTest, SmallReadsShareBlock) {
+  ASSERT_EQ(ReadStatus::Drained,
+            ReadAtMost(8, io_.get(), &reader_, buffer_, &bytes_read_));
+  PCHECK(write(fd_[1], "89", 2) == 2);
+  ASSERT_EQ(ReadStatus::Drained,
+            ReadAtMost(8, io_.get(), &reader_, buffer_, &bytes_read_));
+  EXPECT_EQ(2, bytes_read_);
+  EXPECT_EQ(std::string("123456789"), FlattenSlow(buffer_));
+
+  // The second read continued right after the first one, in the same block.
+  auto first = buffer_.begin();
+  auto second = buffer_.begin();
+  ++second;
+  EXPECT_EQ(first->data() + first->size(), second->data());
+}
+
+TEST_F(ReadAtMostTest, AdaptiveBlocksPerRead) {
+  const std::string data(kBufferBlockSize * 4, 'x');
+  ASSERT_EQ(1, reader_.GetBlocksPerRead());
+
+  // Reads filling all blocks given make the following ones larger.
+  PCHECK(write(fd_[1], data.data(), data.size()) == data.size());
+  ASSERT_EQ(ReadStatus::Drained,
+            ReadAtMost(data.size() * 2, io_.get(), &reader_, buffer_,
+                       &bytes_read_));
+  EXPECT_EQ(data.size() + 7, bytes_read_);
+  EXPECT_EQ(4, reader_.GetBlocksPerRead());
+
+  // And small reads make them smaller again.
+  for (int i = 0; i != 4; ++i) {
+    PCHECK(write(fd_[1], "1", 1) == 1);
+    ASSERT_EQ(ReadStatus::Drained,
+              ReadAtMost(100, io_.get(), &reader_, buffer_, &bytes_read_));
+  }
+  EXPECT_EQ(1, reader_.GetBlocksPerRead());
 }
 
 TEST(ReadAtMost, LargeChunk) {
@@ -100,6 +138,7 @@ TEST(ReadAtMost, LargeChunk) {
   util::SetNonBlocking(fd[1]);
   auto io = std::make_unique<SystemStreamIo>(fd[0]);
 
+  AdaptiveReadBuffer reader;
   std::srand(time(NULL));
   std::string source;
   for (int i = 0; i != kMaxBytes; ++i) {
@@ -111,20 +150,20 @@ TEST(ReadAtMost, LargeChunk) {
 
     FLARE_PCHECK(write(fd[1], source.data(), i) == i);
 
-    std::string buffer;
+    NoncontiguousBuffer buffer;
     std::size_t bytes_read;
 
     if (rand() % 2 == 0) {
       ASSERT_EQ(ReadStatus::Drained,
-                ReadAtMost(i + 1, io.get(), buffer, &bytes_read));
+                ReadAtMost(i + 1, io.get(), &reader, buffer, &bytes_read));
     } else {
       ASSERT_EQ(ReadStatus::MaxBytesRead,
-                ReadAtMost(i, io.get(), buffer, &bytes_read));
+                ReadAtMost(i, io.get(), &reader, buffer, &bytes_read));
     }
     EXPECT_EQ(i, bytes_read);
     // Not using `EXPECT_EQ` as diagnostics on error is potentially large, so we
     // want to bail out on error ASAP.
-    ASSERT_EQ(buffer, source.substr(0, i));
+    ASSERT_EQ(FlattenSlow(buffer), source.substr(0, i));
   }
 }
 
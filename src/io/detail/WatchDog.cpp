@@ -69,10 +69,9 @@ void Watchdog::WorkerProc() {
       bool responsive = acked[index]->wait_until(wait_until) ||
                         exiting_;
       if (!responsive) {
-          FLARE_LOG_FATAL(
-              "Event loop {} is likely unresponsive. Crashing the program.",
-              fmt::ptr(watched_[index]));
-        }
+        FLARE_LOG_FATAL(
+            "Event loop {} is likely unresponsive. Crashing the program.",
+            fmt::ptr(watched_[index]));
       }
     }
     VLOG(10) << "Watchdog: Life is good.";
@@ -81,4 +80,6 @@ void Watchdog::WorkerProc() {
     next_try += FLAGS_watchdog_check_interval * 1ms;
     latch_.wait_until(next_try);
   }
+}
+
 }  // namespace tinyRPC::io::detail
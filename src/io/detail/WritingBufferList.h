@@ -3,42 +3,75 @@
 
 #include <vector>
 #include <atomic>
-#include <string>
-#include <list>
 
 #include "../../include/gtest/gtest_prod.h"
 
-#include "../../fiber/Mutex.h"
+#include "../../base/Buffer.h"
+#include "../../base/ObjectPool.h"
 #include "../util/StreamIO.h"
 
 namespace tinyRPC::io::detail {
 
+struct WritingBufferNode {
+  std::atomic<WritingBufferNode*> next;
+  NoncontiguousBuffer buffer;
+  std::uintptr_t ctx;
+};
+
 // An MPSC writing buffer queue.
+//
+// Producers (`Append`) are wait-free: a single `exchange` on `tail_`
+// publishes the node, it's linked to its predecessor right after. The
+// consumer (`FlushTo`) never takes a lock either. It only spins in the rare
+// case that it has caught up with a producer which has exchanged `tail_` but
+// not linked its node yet.
+//
+// Only the caller whose `Append` returned `true` (i.e., the list was empty)
+// may call `FlushTo`, until `FlushTo` reports the list has been emptied.
 class WritingBufferList {
  public:
   WritingBufferList();
   ~WritingBufferList();
 
+  // Write at most `max_bytes` bytes to `io`. Contexts of buffers that have been
+  // completely written are appended to `flushed_ctxs`.
   ssize_t FlushTo(tinyRPC::AbstractStreamIo* io, std::size_t max_bytes,
                   std::vector<std::uintptr_t>* flushed_ctxs, bool* emptied,
                   bool* short_write);
-  bool Append(std::string buffer, std::uintptr_t ctx);
+
+  // Returns `true` if the list was empty before this call. The caller is
+  // responsible for flushing the list then.
+  bool Append(NoncontiguousBuffer buffer, std::uintptr_t ctx);
 
  private:
-//   FRIEND_TEST(WritingBufferList, Torture);
-
-  struct Node {
-    Node(std::string buf, std::uintptr_t ctx): buffer(buf), ctx(ctx){}
-    std::string buffer;
-    std::uintptr_t ctx;
-  };
-
-  std::list<Node*> buffers_;
-  // TODO: to pass test, use std::mutex temporarily.
-  std::mutex lock_;
-  // tinyRPC::fiber::Mutex lock_;
+  FRIEND_TEST(WritingBufferList, Torture);
+
+  using Node = WritingBufferNode;
+
+  // Wait until `node->next` is linked by its producer.
+  static Node* WaitForNext(Node* node);
+
+  // Owned by the consumer. Only updated by the producer which finds the list
+  // empty, before it becomes the consumer.
+  std::atomic<Node*> head_{nullptr};
+  std::atomic<Node*> tail_{nullptr};
 };
 
 }  // namespace tinyRPC::io::detail
 
+namespace tinyRPC::object_pool {
+
+template <>
+struct PoolTraits<io::detail::WritingBufferNode> {
+  static constexpr std::size_t kLocalCacheSize = 1024;
+  static constexpr std::size_t kTransferCacheSize = 16384;
+  static constexpr std::size_t kTransferBatchSize = 256;
+
+  static void OnPut(io::detail::WritingBufferNode* ptr) {
+    ptr->buffer.Clear();
+  }
+};
+
+}  // namespace tinyRPC::object_pool
+
 #endif  
@@ -0,0 +1,114 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../../include/benchmark/benchmark.h"
+#include "../../base/Buffer.h"
+#include "../../testing/Endpoint.h"
+#include "../util/Socket.h"
+#include "WritingBufferList.h"
+
+// Measures how fast many small responses queued in `WritingBufferList` can be
+// flushed to a loopback TCP socket.
+//
+// Benchmark_Gathered: What we did before: copy all pending buffers into a
+//                     single string and `write` it.
+// Benchmark_FlushTo:  `WritingBufferList::FlushTo`, which `writev`s the
+//                     buffers in place.
+
+namespace tinyRPC::io::detail {
+
+namespace {
+
+constexpr std::size_t kBuffersPerIteration = 256;
+
+// A loopback connection whose receiving side is drained by a dedicated thread.
+class LoopbackConnection {
+ public:
+  LoopbackConnection() {
+    auto addr = testing::PickAvailableEndpoint();
+    auto listener = util::CreateListener(addr, 1);
+    CHECK(listener);
+    writer_ = util::CreateStreamSocket(addr.Family());
+    PCHECK(connect(writer_.Get(), addr.Get(), addr.Length()) == 0);
+    reader_ = Handle(accept(listener.Get(), nullptr, nullptr));
+    CHECK(reader_);
+    util::SetTcpNoDelay(writer_.Get());
+    drainer_ = std::thread([this] {
+      char buffer[65536];
+      while (read(reader_.Get(), buffer, sizeof(buffer)) > 0) {
+      }
+    });
+  }
+
+  ~LoopbackConnection() {
+    shutdown(writer_.Get(), SHUT_WR);
+    drainer_.join();
+  }
+
+  int GetFd() const { return writer_.Get(); }
+
+ private:
+  Handle writer_, reader_;
+  std::thread drainer_;
+};
+
+void Benchmark_Gathered(benchmark::State& state) {
+  LoopbackConnection conn;
+  std::string payload(state.range(0), 'x');
+  std::vector<NoncontiguousBuffer> pending;
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i != kBuffersPerIteration; ++i) {
+      pending.push_back(CreateBufferSlow(payload));
+    }
+    std::string gathered;
+    for (auto&& e : pending) {
+      gathered += FlattenSlow(e);
+    }
+    std::size_t written = 0;
+    while (written != gathered.size()) {
+      auto rc = write(conn.GetFd(), gathered.data() + written,
+                      gathered.size() - written);
+      PCHECK(rc > 0);
+      written += rc;
+    }
+    pending.clear();
+  }
+  state.SetBytesProcessed(state.iterations() * kBuffersPerIteration *
+                          state.range(0));
+}
+
+BENCHMARK(Benchmark_Gathered)->Arg(64)->Arg(512)->Arg(4096);
+
+void Benchmark_FlushTo(benchmark::State& state) {
+  LoopbackConnection conn;
+  SystemStreamIo io(conn.GetFd());
+  std::string payload(state.range(0), 'x');
+  WritingBufferList wbl;
+  std::vector<std::uintptr_t> ctxs;
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i != kBuffersPerIteration; ++i) {
+      wbl.Append(CreateBufferSlow(payload), i);
+    }
+    bool emptied = false, short_write;
+    while (!emptied) {
+      PCHECK(wbl.FlushTo(&io, std::numeric_limits<std::size_t>::max(), &ctxs,
+                         &emptied, &short_write) > 0);
+    }
+    ctxs.clear();
+  }
+  state.SetBytesProcessed(state.iterations() * kBuffersPerIteration *
+                          state.range(0));
+}
+
+BENCHMARK(Benchmark_FlushTo)->Arg(64)->Arg(512)->Arg(4096);
+
+}  // namespace
+
+}  // namespace tinyRPC::io::detail
@@ -1,81 +1,127 @@
-#include <mutex>
+#include <algorithm>
+#include <thread>
 
 #include "WritingBufferList.h"
 
 namespace tinyRPC::io::detail{
 
+namespace {
+
+// Maximum number of slices written out in a single call to `FlushTo`. The
+// array lives on the (fiber) stack, so it's kept far below `IOV_MAX`. Slices
+// beyond it are left to the next call.
+constexpr int kMaxIovecs = 64;
+
+}  // namespace
+
 WritingBufferList::WritingBufferList() {}
 
 WritingBufferList::~WritingBufferList() {
-    for(auto&& node : buffers_){
-        delete node;
+    auto current = head_.load(std::memory_order_acquire);
+    while (current) {
+        auto next = current->next.load(std::memory_order_acquire);
+        object_pool::Put(current);
+        current = next;
     }
 }
 
-// Tremendous performance hurt.
 ssize_t WritingBufferList::FlushTo(tinyRPC::AbstractStreamIo* io, std::size_t max_bytes,
                 std::vector<std::uintptr_t>* flushed_ctxs, bool* emptied,
                 bool* short_write){
-    std::unique_lock lk(lock_);
-    std::string gatheredBuffer;
+    auto head = head_.load(std::memory_order_acquire);
+    FLARE_CHECK(head, "Calling `FlushTo` on an empty list.");
+
+    // Slices are written out in place. Bytes already written out of the head
+    // node have been `Skip`-ped from it, so no offset need to be kept here.
+    iovec iov[kMaxIovecs];
+    int nv = 0;
     std::size_t flushing = 0;
-    
-    auto iter = buffers_.begin();
-
-    while(flushing < max_bytes && iter != buffers_.end()){
-        auto&& s = (*iter)->buffer;
-
-        std::size_t writeSize = s.size();
-        if(writeSize + flushing > max_bytes){
-            // exceeded size = s.size() + flushing - max_bytes
-            // pos = s.size() - exceed size = max_bytes - flusing
-            writeSize -= s.size() + flushing - max_bytes;
-            auto writeBuffer = s.substr(0, writeSize);
-            gatheredBuffer += writeBuffer;            
-        }else{
-            gatheredBuffer += s;
+
+    // Nodes not linked yet are left to the next call.
+    for (auto current = head;
+         current && nv != kMaxIovecs && flushing != max_bytes;
+         current = current->next.load(std::memory_order_acquire)) {
+        for (auto&& slice : current->buffer) {
+            if (nv == kMaxIovecs || flushing == max_bytes) {
+                break;
+            }
+            auto size = std::min(slice.size(), max_bytes - flushing);
+            iov[nv++] = {const_cast<char*>(slice.data()), size};
+            flushing += size;
         }
-        flushing += writeSize;
-        iter++;
     }
 
-
-    ssize_t rc = io->Write(gatheredBuffer);
+    ssize_t rc = io->WriteV(iov, nv);
     if (rc <= 0) {
         return rc;  // Nothing is really flushed then.
     }
     CHECK_LE(rc, flushing);
 
-
     // Drain written out bytes.
-    std::size_t cnt = 0;
-    iter = buffers_.begin();
-
-    while(cnt < rc && iter != buffers_.end()){
-        auto&& s = (*iter)->buffer;
-
-        std::size_t writeSize = s.size();
-        if(writeSize + cnt > rc){
-            writeSize -= rc - cnt;
-            (*iter)->buffer = s.substr(rc - cnt);
-            iter++;
-        }else{
-            auto iter2 = iter++;
-            flushed_ctxs->push_back((*iter2)->ctx);
-            buffers_.erase(iter2);
+    std::size_t left = rc;
+    *emptied = false;
+    while (true) {
+        auto&& nb = head->buffer;
+        if (left < nb.ByteSize()) {
+            nb.Skip(left);
+            break;
+        }
+        left -= nb.ByteSize();
+        flushed_ctxs->push_back(head->ctx);
+
+        auto next = head->next.load(std::memory_order_acquire);
+        if (!next) {
+            // Try to mark the list as empty. If someone else appended a node
+            // in the meantime, wait for it to be linked.
+            //
+            // `head_` must be cleared before `tail_`: Once `tail_` is cleared,
+            // the next `Append` takes over `head_`.
+            head_.store(nullptr, std::memory_order_relaxed);
+            auto expected = head;
+            if (tail_.compare_exchange_strong(expected, nullptr,
+                                              std::memory_order_acq_rel)) {
+                object_pool::Put(head);
+                *emptied = true;
+                break;
+            }
+            next = WaitForNext(head);
         }
-        cnt += writeSize;
+        object_pool::Put(head);
+        head = next;
+    }
+    if (!*emptied) {
+        head_.store(head, std::memory_order_relaxed);
     }
 
-    *emptied = buffers_.empty();
     *short_write = rc != flushing;
     return rc;
 }
 
 
-bool WritingBufferList::Append(std::string buffer, std::uintptr_t ctx){
-    std::unique_lock _(lock_);
-    buffers_.emplace_back(new WritingBufferList::Node(buffer, ctx));
-    return buffers_.size() == 1;
+bool WritingBufferList::Append(NoncontiguousBuffer buffer, std::uintptr_t ctx){
+    auto node = object_pool::Get<Node>();
+    node->next.store(nullptr, std::memory_order_relaxed);
+    node->buffer = std::move(buffer);
+    node->ctx = ctx;
+
+    auto prev = tail_.exchange(node, std::memory_order_acq_rel);
+    if (!prev) {
+        // The list was empty, we're the consumer now.
+        head_.store(node, std::memory_order_release);
+        return true;
+    }
+    prev->next.store(node, std::memory_order_release);
+    return false;
+}
+
+WritingBufferList::Node* WritingBufferList::WaitForNext(Node* node) {
+    // The producer is between its `exchange` and linking its node, which is
+    // only a few instructions away.
+    while (true) {
+        if (auto next = node->next.load(std::memory_order_acquire)) {
+            return next;
+        }
+        std::this_thread::yield();
+    }
 }
-} // namespace tinyRPC::io::detail
\ No newline at end of file
+} // namespace tinyRPC::io::detail
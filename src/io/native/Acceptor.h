@@ -16,8 +16,9 @@ class NativeAcceptor final : public Descriptor, public Acceptor {
   struct Options {
     // Called when new connection is accepted.
     //
-    // The handler is responsible for setting `FD_CLOEXEC` / `O_NONBLOCK` and
-    // whatever it sees need.
+    // `FD_CLOEXEC` / `O_NONBLOCK` have already been set on the new fd. Options
+    // inherited from the listener (e.g., `TCP_NODELAY`) needn't to be set
+    // again either. The handler is responsible for whatever else it sees need.
     //
     // CAVEAT: Due to technical limitations, it's likely that
     // `connection_handler` is not called in a balanced fashion if same `fd`
@@ -1,5 +1,7 @@
 #include "Acceptor.h"
 
+#include <fcntl.h>
+
 #include <thread>
 #include <utility>
 
@@ -50,6 +52,72 @@ TEST(NativeAcceptor, All) {
   acceptor->Join();
 }
 
+TEST(NativeAcceptor, NonBlockingCloseOnExec) {
+  std::atomic<bool> checked = false;
+  auto addr = testing::PickAvailableEndpoint();
+  auto listen_fd = io::util::CreateListener(addr, 16);
+  CHECK(listen_fd);
+  NativeAcceptor::Options opts;
+  opts.connection_handler = [&](Handle fd, const Endpoint& peer) {
+    EXPECT_TRUE(fcntl(fd.Get(), F_GETFL) & O_NONBLOCK);
+    EXPECT_TRUE(fcntl(fd.Get(), F_GETFD) & FD_CLOEXEC);
+    checked = true;
+  };
+  io::util::SetNonBlocking(listen_fd.Get());
+  auto acceptor =
+      std::make_shared<NativeAcceptor>(std::move(listen_fd), std::move(opts));
+  GetGlobalEventLoop(0)->AttachDescriptor(acceptor);
+
+  auto client = io::util::CreateStreamSocket(addr.Get()->sa_family);
+  io::util::SetNonBlocking(client.Get());
+  io::util::StartConnect(client.Get(), addr);
+  while (!checked) {
+    std::this_thread::sleep_for(1ms);
+  }
+  acceptor->Stop();
+  acceptor->Join();
+}
+
+TEST(NativeAcceptor, ReusePort) {
+  constexpr auto kListeners = 2;
+  constexpr auto kConnectAttempts = 128;
+
+  std::atomic<int> conns[kListeners] = {};
+  auto addr = testing::PickAvailableEndpoint();
+  std::shared_ptr<NativeAcceptor> acceptors[kListeners];
+  for (int i = 0; i != kListeners; ++i) {
+    // Several listeners on the same address.
+    auto listen_fd = io::util::CreateListener(addr, kConnectAttempts, true);
+    CHECK(listen_fd);
+    NativeAcceptor::Options opts;
+    opts.connection_handler = [&, i](Handle fd, const Endpoint& peer) {
+      ++conns[i];
+    };
+    io::util::SetNonBlocking(listen_fd.Get());
+    acceptors[i] =
+        std::make_shared<NativeAcceptor>(std::move(listen_fd), std::move(opts));
+    GetGlobalEventLoop(i)->AttachDescriptor(acceptors[i]);
+  }
+
+  Handle clients[kConnectAttempts];
+  for (int i = 0; i != kConnectAttempts; ++i) {
+    clients[i] = io::util::CreateStreamSocket(addr.Get()->sa_family);
+    io::util::SetNonBlocking(clients[i].Get());
+    io::util::StartConnect(clients[i].Get(), addr);
+  }
+  while (conns[0] + conns[1] != kConnectAttempts) {
+    std::this_thread::sleep_for(1ms);
+  }
+  // The kernel hashes connections (by their source port) to the listeners,
+  // both of them should have got some.
+  EXPECT_GT(conns[0], 0);
+  EXPECT_GT(conns[1], 0);
+  for (auto&& e : acceptors) {
+    e->Stop();
+    e->Join();
+  }
+}
+
 }  // namespace tinyRPC
 
 TINYRPC_TEST_MAIN
@@ -9,6 +9,7 @@
 
 #include "../../base/Likely.h"
 #include "../../base/Logging.h"
+#include "../../base/ObjectPool.h"
 #include "../detail/EintrSafe.h"
 #include "../detail/ReadAtMost.h"
 #include "../util/Socket.h"
@@ -27,6 +28,15 @@ struct UintptrVector {
 
 }  // namespace
 
+template <>
+struct object_pool::PoolTraits<UintptrVector> {
+  static constexpr std::size_t kLocalCacheSize = 128;
+  static constexpr std::size_t kTransferCacheSize = 1024;
+  static constexpr std::size_t kTransferBatchSize = 32;
+
+  static void OnPut(UintptrVector* ptr) { ptr->vector.clear(); }
+};
+
 using HandshakingStatus = AbstractStreamIo::HandshakingStatus;
 
 NativeStreamConnection::NativeStreamConnection(Handle fd, Options options)
@@ -34,8 +44,7 @@ NativeStreamConnection::NativeStreamConnection(Handle fd, Options options)
     // once handshaking is done.
     : Descriptor(std::move(fd), Event{}, "NativeStreamConnection"),
       options_(std::move(options)) {
-  CHECK_NE(options.read_buffer_size, 0);
-  options_.read_buffer_size = std::min(options.read_buffer_size, static_cast<std::size_t>(4 * 1024 * 1024));
+  CHECK_NE(options_.read_buffer_size, 0);
   options_.handler->OnAttach(this);
 
   if (!options_.stream_io) {
@@ -65,7 +74,7 @@ void NativeStreamConnection::StartHandshaking() {
   }
 }
 
-bool NativeStreamConnection::Write(const std::string& buffer,
+bool NativeStreamConnection::Write(NoncontiguousBuffer buffer,
                                    std::uintptr_t ctx) {
   if (FLARE_LIKELY(writing_buffers_.Append(std::move(buffer), ctx))) {
     if (FLARE_UNLIKELY(
@@ -161,13 +170,12 @@ Descriptor::EventAction NativeStreamConnection::OnReadable() {
   }
   FLARE_CHECK(handshaking_state_.done);
 
-  // We might use `readv` if excessive `read` turns out to be a performance
-  // bottleneck.
-  auto bytes_to_read = options_.read_buffer_size - read_buffer_.size();
+  auto bytes_to_read = options_.read_buffer_size - read_buffer_.ByteSize();
   while (bytes_to_read) {
     std::size_t bytes_read;
     auto status = io::detail::ReadAtMost(
-        bytes_to_read, options_.stream_io.get(), read_buffer_, &bytes_read);
+        bytes_to_read, options_.stream_io.get(), &reader_, read_buffer_,
+        &bytes_read);
 
     bytes_to_read -= bytes_read;
 
@@ -179,7 +187,7 @@ Descriptor::EventAction NativeStreamConnection::OnReadable() {
         status == io::detail::ReadStatus::PeerClosing ||
         status == io::detail::ReadStatus::MaxBytesRead) {
       // Really read something..
-      if (FLARE_LIKELY(read_buffer_.size())) {
+      if (FLARE_LIKELY(!read_buffer_.Empty())) {
         // Call user's handler.
         if (auto rc = ConsumeReadBuffer();
             FLARE_UNLIKELY(rc != EventAction::Ready)) {
@@ -189,7 +197,7 @@ Descriptor::EventAction NativeStreamConnection::OnReadable() {
 
       // If we've already have `read_buffer_size` bytes and the implementation
       // is still not able to extract a packet, signal an error.
-      if (FLARE_UNLIKELY(read_buffer_.size() >=
+      if (FLARE_UNLIKELY(read_buffer_.ByteSize() >=
                          options_.read_buffer_size)) {
         FLARE_VLOG(10, "Read buffer overrun. Killing the connection (fd [{}]).",
                    fd());
@@ -303,7 +311,7 @@ NativeStreamConnection::FlushStatus NativeStreamConnection::FlushWritingBuffer(
   bool ever_succeeded = false;
 
   while (bytes_quota) {
-    auto ctxs = new UintptrVector();
+    auto ctxs = object_pool::GetPooled<UintptrVector>();
     bool emptied, short_write;
     auto written =
         writing_buffers_.FlushTo(options_.stream_io.get(), bytes_quota,
@@ -5,6 +5,7 @@
 #include <memory>
 
 #include "../Descriptor.h"
+#include "../detail/ReadAtMost.h"
 #include "../detail/WritingBufferList.h"
 #include "../StreamConnection.h"
 #include "../util/StreamIO.h"
@@ -39,7 +40,7 @@ class NativeStreamConnection final : public Descriptor,
   void StartHandshaking() override;
 
   // Write `buffer` to the remote side.
-  bool Write(const std::string& buffer, std::uintptr_t ctx) override;
+  bool Write(NoncontiguousBuffer buffer, std::uintptr_t ctx) override;
 
   // Restart reading data.
   void RestartRead() override;
@@ -93,7 +94,8 @@ class NativeStreamConnection final : public Descriptor,
   HandshakingState handshaking_state_;
 
   // Accessed by reader.
-  std::string read_buffer_;
+  io::detail::AdaptiveReadBuffer reader_;
+  NoncontiguousBuffer read_buffer_;
 
   // Accessed by writers, usually a different thread.
    io::detail::WritingBufferList
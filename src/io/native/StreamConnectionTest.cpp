@@ -28,7 +28,7 @@ std::atomic<int> err {0};
 
 class ConnectionHandler : public StreamConnectionHandler {
  public:
-  using Callback = UniqueFunction<DataConsumptionStatus(std::string&)>;
+  using Callback = UniqueFunction<DataConsumptionStatus(NoncontiguousBuffer&)>;
 
   explicit ConnectionHandler(std::string name, Callback cb)
       : name_(std::move(name)), cb_(std::move(cb)) {}
@@ -39,7 +39,7 @@ class ConnectionHandler : public StreamConnectionHandler {
   void OnWriteBufferEmpty() override {}
   void OnDataWritten(std::uintptr_t ctx) override {}
 
-  DataConsumptionStatus OnDataArrival(std::string& buffer) override {
+  DataConsumptionStatus OnDataArrival(NoncontiguousBuffer& buffer) override {
     return cb_(buffer);
   }
 
@@ -57,7 +57,7 @@ class ClosedConnectionHandler : public StreamConnectionHandler {
   void OnDetach() override {}
   void OnWriteBufferEmpty() override { CHECK(!"Unexpected."); }
   void OnDataWritten(std::uintptr_t ctx) override { CHECK(!"Unexpected."); }
-  DataConsumptionStatus OnDataArrival(std::string& buffer) override {
+  DataConsumptionStatus OnDataArrival(NoncontiguousBuffer& buffer) override {
     CHECK(!"Unexpected.");
   }
   void OnClose() override { ++closed; }
@@ -71,7 +71,7 @@ class ErrorConnectionHandler : public StreamConnectionHandler {
   void OnDetach() override {}
   void OnWriteBufferEmpty() override { CHECK(!"Unexpected."); }
   void OnDataWritten(std::uintptr_t ctx) override { CHECK(!"Unexpected."); }
-  DataConsumptionStatus OnDataArrival(std::string& buffer) override {
+  DataConsumptionStatus OnDataArrival(NoncontiguousBuffer& buffer) override {
     CHECK(!"Unexpected.");
   }
   void OnClose() override { CHECK(!"Unexpected."); }
@@ -104,11 +104,11 @@ class NativeStreamConnectionTest : public ::testing::Test {
       opts.read_buffer_size = 11111;
       opts.handler = std::make_unique<ConnectionHandler>(
           Format("server handler {}", index),
-          [this, index](std::string& buffer) {
-            if(buffer != std::string("hello")){
+          [this, index](NoncontiguousBuffer& buffer) {
+            if(FlattenSlow(buffer) != std::string("hello")){
               LOG(INFO) << "Not eq" << "\n";
             }
-            LOG(INFO) << "Buffer = " << buffer << " Size = " << buffer.size() << "\n";
+            LOG(INFO) << "Buffer = " << FlattenSlow(buffer) << " Size = " << buffer.ByteSize() << "\n";
             server_conns_[index]->Write(buffer, 0);
             return StreamConnectionHandler::DataConsumptionStatus::Ready;
           });
@@ -158,11 +158,11 @@ TEST_F(NativeStreamConnectionTest, Echo) {
     io::util::StartConnect(fd.Get(), addr_);
     NativeStreamConnection::Options opts;
     opts.handler = std::make_unique<ConnectionHandler>(
-        Format("client handler {}", i), [&](std::string& buffer) {
-          if (buffer.size() != kData.size()) {
+        Format("client handler {}", i), [&](NoncontiguousBuffer& buffer) {
+          if (buffer.ByteSize() != kData.size()) {
             return StreamConnectionHandler::DataConsumptionStatus::Ready;
           }
-          [&] { ASSERT_EQ(kData, buffer); }();
+          [&] { ASSERT_EQ(kData, FlattenSlow(buffer)); }();
           ++replied;
           return StreamConnectionHandler::DataConsumptionStatus::Ready;
         });
@@ -171,7 +171,7 @@ TEST_F(NativeStreamConnectionTest, Echo) {
         std::make_shared<NativeStreamConnection>(std::move(fd), std::move(opts));
     GetGlobalEventLoop(0)->AttachDescriptor(std::dynamic_pointer_cast<Descriptor>(clients[i]));
     clients[i]->StartHandshaking();
-    clients[i]->Write(kData, 0);
+    clients[i]->Write(CreateBufferSlow(kData), 0);
   }
   while (replied != kConnectAttempts) {
     std::this_thread::sleep_for(100ms);
@@ -198,10 +198,10 @@ TEST_F(NativeStreamConnectionTest, EchoWithHeavilyFragmentedBuffer) {
   io::util::StartConnect(fd.Get(), addr_);
   NativeStreamConnection::Options opts;
   opts.handler =
-      std::make_unique<ConnectionHandler>("", [&](std::string& buffer) {
-        bytes_received += buffer.size();
-        received += buffer;
-        buffer.clear();
+      std::make_unique<ConnectionHandler>("", [&](NoncontiguousBuffer& buffer) {
+        bytes_received += buffer.ByteSize();
+        received += FlattenSlow(buffer);
+        buffer.Clear();
         return StreamConnectionHandler::DataConsumptionStatus::Ready;
       });
   opts.read_buffer_size = 111111;
@@ -209,7 +209,7 @@ TEST_F(NativeStreamConnectionTest, EchoWithHeavilyFragmentedBuffer) {
       std::make_shared<NativeStreamConnection>(std::move(fd), std::move(opts));
   GetGlobalEventLoop(0)->AttachDescriptor(std::dynamic_pointer_cast<Descriptor>(client));
   client->StartHandshaking();
-  client->Write(buffer, 0);
+  client->Write(CreateBufferSlow(buffer), 0);
   while (bytes_received != buffer.size()) {
     std::this_thread::sleep_for(100ms);
   }
@@ -277,9 +277,9 @@ TEST(NativeStreamConnection, NoBandwidthLimit) {
       NativeStreamConnection::Options opts;
       opts.read_buffer_size = kBodySize;
       opts.handler = std::make_unique<ConnectionHandler>(
-          Format("server handler "), [&](std::string& buffer) {
-            received += buffer.size();
-            buffer.clear();  // All consumed.
+          Format("server handler "), [&](NoncontiguousBuffer& buffer) {
+            received += buffer.ByteSize();
+            buffer.Clear();  // All consumed.
             return StreamConnectionHandler::DataConsumptionStatus::Ready;
           });
       server_conn = std::make_shared<NativeStreamConnection>(std::move(fd),
@@ -303,7 +303,7 @@ TEST(NativeStreamConnection, NoBandwidthLimit) {
     io::util::StartConnect(fd.Get(), addr);
     NativeStreamConnection::Options opts;
     opts.handler = std::make_unique<ConnectionHandler>(
-        Format("client handler"), [&](std::string& buffer) {
+        Format("client handler"), [&](NoncontiguousBuffer& buffer) {
           CHECK(!"Nothing should be echo-d back.");
           return StreamConnectionHandler::DataConsumptionStatus::Ready;
         });
@@ -314,7 +314,7 @@ TEST(NativeStreamConnection, NoBandwidthLimit) {
   GetGlobalEventLoop(0)->AttachDescriptor(std::dynamic_pointer_cast<Descriptor>(client_conn));
   client_conn->StartHandshaking();
   auto start = ReadSteadyClock();
-  client_conn->Write(std::string(kBodySize, 1), 0);
+  client_conn->Write(CreateBufferSlow(std::string(kBodySize, 1)), 0);
   while (received.load() != kBodySize) {
     this_fiber::SleepFor(1ms);
   }
@@ -68,7 +68,7 @@ int SetFlags(int fd, int flags) {
 
 }  // namespace
 
-Handle CreateListener(const Endpoint& addr, int backlog) {
+Handle CreateListener(const Endpoint& addr, int backlog, bool reuse_port) {
   // For performance reasons, we don't expect this value to change (even if it
   // can.)
   static const int kMaximumBacklog = [] {
@@ -107,6 +107,9 @@ Handle CreateListener(const Endpoint& addr, int backlog) {
   if (!SetSockOpt<int>(rc.Get(), SOL_SOCKET, SO_REUSEADDR, 1)) {
     return {};
   }
+  if (reuse_port && !SetSockOpt<int>(rc.Get(), SOL_SOCKET, SO_REUSEPORT, 1)) {
+    return {};
+  }
   if (bind(rc.Get(), addr.Get(), addr.Length()) != 0) {
     FLARE_PLOG_WARNING("Cannot bind socket to [{}]. ", addr.ToString());
     return {};
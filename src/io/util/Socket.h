@@ -12,7 +12,12 @@ namespace tinyRPC::io::util {
 //
 // If you're not able to accept connections quick enough, you're likely to lose
 // them or have other troubles with accepting them.
-Handle CreateListener(const Endpoint& addr, int backlog);
+//
+// If `reuse_port` is set, `SO_REUSEPORT` is enabled on the listener, so that
+// several listeners can be bound to the same `addr`. The kernel balances
+// incoming connections among them.
+Handle CreateListener(const Endpoint& addr, int backlog,
+                      bool reuse_port = false);
 
 // For client side's use.
 Handle CreateStreamSocket(sa_family_t family);
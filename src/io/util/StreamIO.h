@@ -21,8 +21,14 @@ class AbstractStreamIo {
 
   virtual ssize_t Read(char* buf, ssize_t len) = 0;
 
+  // Scattering read. `iovcnt` must not exceed `IOV_MAX`.
+  virtual ssize_t ReadV(const iovec* iov, int iovcnt) = 0;
+
   // TODO: whether `const` ?
   virtual ssize_t Write(std::string& buf) = 0;
+
+  // Gathering write. `iovcnt` must not exceed `IOV_MAX`.
+  virtual ssize_t WriteV(const iovec* iov, int iovcnt) = 0;
 };
 
 class SystemStreamIo : public AbstractStreamIo {
@@ -35,10 +41,18 @@ class SystemStreamIo : public AbstractStreamIo {
     return io::detail::EIntrSafeRead(fd_, buf, len);
   }
 
+  ssize_t ReadV(const iovec* iov, int iovcnt) override {
+    return io::detail::EIntrSafeReadV(fd_, iov, iovcnt);
+  }
+
   ssize_t Write(std::string& buf) override {
     return io::detail::EIntrSafeWrite(fd_, &buf[0], buf.size());
   }
 
+  ssize_t WriteV(const iovec* iov, int iovcnt) override {
+    return io::detail::EIntrSafeWriteV(fd_, iov, iovcnt);
+  }
+
   int GetFd() const noexcept { return fd_; }
 
  private:
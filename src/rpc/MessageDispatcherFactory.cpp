@@ -149,7 +149,7 @@ void SetDefaultMessageDispatcherFactory(
 std::unique_ptr<MessageDispatcher> MakeCompositedMessageDispatcher(
     std::string_view resolver, std::string_view load_balancer) {
   auto r = name_resolver_registry.TryGet(resolver);
-  auto lb = load_balancer_registry.TryNew(load_balancer);
+  auto lb = MakeLoadBalancer(load_balancer);
   if (!r || !lb) {
     return nullptr;
   }
@@ -0,0 +1,35 @@
+#ifndef _SRC_RPC_PEER_INFO_H_
+#define _SRC_RPC_PEER_INFO_H_
+
+#include <cstdint>
+#include <string>
+
+#include "../base/Endpoint.h"
+
+namespace tinyRPC {
+
+// A peer as resolved by `NameResolver`, with hints for `LoadBalancer`.
+struct PeerInfo {
+  Endpoint address;
+
+  // Relative capacity of this peer. Load balancers respecting weights (e.g.,
+  // "wrr") send traffic to peers in proportion to it.
+  std::uint32_t weight = 1;
+
+  // Where this peer is deployed (e.g., name of its rack or zone), empty if not
+  // known. Locality-aware load balancers prefer peers in our own locality.
+  std::string locality;
+};
+
+inline bool operator==(const PeerInfo& left, const PeerInfo& right) {
+  return left.address == right.address && left.weight == right.weight &&
+         left.locality == right.locality;
+}
+
+inline bool operator!=(const PeerInfo& left, const PeerInfo& right) {
+  return !(left == right);
+}
+
+}  // namespace tinyRPC
+
+#endif
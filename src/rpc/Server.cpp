@@ -29,6 +29,11 @@ DEFINE_int32(flare_rpc_server_max_request_queueing_delay, 0,
              "longer is rejected. Setting it to zero disables this behavior.");
 DEFINE_int32(flare_rpc_server_max_packet_size, 4 * 1024 * 1024,
              "Default maximum packet size of `Server`.");
+DEFINE_bool(flare_rpc_server_reuse_port, false,
+            "If set, servers create one `SO_REUSEPORT` listener per "
+            "scheduling group, so that connections are accepted (and served) "
+            "in all scheduling groups instead of all being accepted by "
+            "scheduling group 0's event loop.");
 DEFINE_int32(flare_rpc_server_remove_idle_connection_interval, 15,
              "Interval, in seconds, between to run of removing idle "
              "server-side connections.");
@@ -115,7 +120,14 @@ void Server::AddProtocols(const std::vector<std::string>& names) {
 
 void Server::AddService(
     MaybeOwningArgument<google::protobuf::Service> service) {
-  GetBuiltinNativeService<protobuf::Service>()->AddService(std::move(service));
+  GetBuiltinNativeService<protobuf::Service>()->AddService(
+      std::move(service), options_.execution_policy);
+}
+
+void Server::SetExecutionPolicy(const std::string& method_name,
+                                StreamService::ExecutionPolicy policy) {
+  GetBuiltinNativeService<protobuf::Service>()->SetExecutionPolicy(method_name,
+                                                                   policy);
 }
 
 void Server::AddNativeService(MaybeOwningArgument<StreamService> service) {
@@ -142,22 +154,28 @@ void Server::ListenOn(const Endpoint& addr, int backlog) {
       EndpointGetPort(addr));
   listening_on_ = addr;
   listen_cb_ = [=] {
-    // Create listening socket.
-    auto fd = io::util::CreateListener(addr, backlog);
-    FLARE_CHECK(!!fd, "Cannot create listener.");
-    io::util::SetNonBlocking(fd.Get());
-    io::util::SetCloseOnExec(fd.Get());
-    io::util::SetTcpNoDelay(fd.Get());
-
-    // In fact we start listening once `ListenOn` is called (instead of on
-    // `Start()`'s return.)
-    NativeAcceptor::Options opts;
-    opts.connection_handler = [this](auto&&... args) {
-      return OnConnection(std::move(args)...);
-    };
-    acceptor_ = std::make_shared<NativeAcceptor>(std::move(fd), std::move(opts));
-    // TODO(luobogao): Duplicate fd and create several acceptors, one for each
-    // worker group.
+    auto listeners =
+        options_.reuse_port ? fiber::GetSchedulingGroupCount() : 1;
+    for (std::size_t i = 0; i != listeners; ++i) {
+      // Create listening socket.
+      auto fd = io::util::CreateListener(addr, backlog, options_.reuse_port);
+      FLARE_CHECK(!!fd, "Cannot create listener.");
+      io::util::SetNonBlocking(fd.Get());
+      io::util::SetCloseOnExec(fd.Get());
+      // Inherited by accepted sockets.
+      io::util::SetTcpNoDelay(fd.Get());
+
+      // In fact we start listening once `ListenOn` is called (instead of on
+      // `Start()`'s return.)
+      NativeAcceptor::Options opts;
+      opts.connection_handler =
+          [this, sg = options_.reuse_port ? i : kAnySchedulingGroup](
+              Handle fd, Endpoint peer) {
+            return OnConnection(std::move(fd), std::move(peer), sg);
+          };
+      acceptors_.push_back(
+          std::make_shared<NativeAcceptor>(std::move(fd), std::move(opts)));
+    }
   };
 }
 
@@ -170,7 +188,11 @@ bool Server::Start() {
   FLARE_CHECK(!!listen_cb_, "You haven't called `ListenOn` yet.");
   listen_cb_();
 
-  GetGlobalEventLoop(0)->AttachDescriptor(acceptor_);
+  // With `reuse_port` set, each scheduling group accepts (and serves)
+  // connections on its own.
+  for (std::size_t i = 0; i != acceptors_.size(); ++i) {
+    GetGlobalEventLoop(i)->AttachDescriptor(acceptors_[i]);
+  }
   return true;
 }
 
@@ -183,7 +205,9 @@ void Server::Stop() {
   fiber::KillTimer(idle_conn_cleaner_);
 
   // We're no longer interested in accepting new connections.
-  acceptor_->Stop();
+  for (auto&& e : acceptors_) {
+    e->Stop();
+  }
 }
 
 void Server::Join() {
@@ -192,7 +216,9 @@ void Server::Join() {
   state_ = ServerState::Joined;
 
   // Make sure no new connection will come first.
-  acceptor_->Join();
+  for (auto&& e : acceptors_) {
+    e->Join();
+  }
 
   // Now we're safe to close existing connections.
   std::unordered_map<std::uint64_t, std::unique_ptr<ConnectionContext>>
@@ -236,7 +262,8 @@ void Server::Join() {
 }
 
 
-void Server::OnConnection(Handle fd, Endpoint peer) {
+void Server::OnConnection(Handle fd, Endpoint peer,
+                          std::size_t scheduling_group) {
   FLARE_CHECK(!!fd);
 
 
@@ -253,16 +280,17 @@ void Server::OnConnection(Handle fd, Endpoint peer) {
   static std::atomic<std::size_t> next_scheduling_group = 0;
   static std::atomic<std::size_t> conn_id = 0;
 
-  auto scheduling_group = next_scheduling_group++ % kSchedulingGroups;
+  if (scheduling_group == kAnySchedulingGroup) {
+    scheduling_group = next_scheduling_group++ % kSchedulingGroups;
+  }
 
   // TODO(luobogao): Prevent TIME_WAIT here.
 
   FLARE_VLOG(10, "Accepted connection from [{}].", peer.ToString());
 
-  // Initialize the socket.
-  io::util::SetNonBlocking(fd.Get());
-  io::util::SetCloseOnExec(fd.Get());
-  io::util::SetTcpNoDelay(fd.Get());
+  // `O_NONBLOCK` / `FD_CLOEXEC` are set by `accept4`, `TCP_NODELAY` is
+  // inherited from the listener.
+  //
   // `io::util::SetSendBufferSize` & `io::util::SetReceiveBufferSize`?
 
   auto icc = std::make_unique<ConnectionContext>();
@@ -21,11 +21,13 @@
 #include "../base/TypeIndex.h"
 #include "../base/Endpoint.h"
 #include "../fiber/Timer.h"
+#include "protocol/StreamService.h"
 
 DECLARE_int32(flare_rpc_server_max_ongoing_calls);
 DECLARE_int32(flare_rpc_server_max_connections);
 DECLARE_int32(flare_rpc_server_max_request_queueing_delay);
 DECLARE_int32(flare_rpc_server_max_packet_size);
+DECLARE_bool(flare_rpc_server_reuse_port);
 
 namespace tinyRPC {
 
@@ -89,6 +91,21 @@ class Server {
     std::chrono::nanoseconds max_request_queueing_delay =
         FLAGS_flare_rpc_server_max_request_queueing_delay *
         std::chrono::milliseconds(1);
+
+    // If set, one `SO_REUSEPORT` listener is created for each scheduling
+    // group, and attached to that group's event loop. Connections are then
+    // accepted and served in the same scheduling group, and the kernel
+    // balances connections among the groups.
+    //
+    // Otherwise a single listener is attached to scheduling group 0's event
+    // loop, and connections are handed to scheduling groups in a round-robin
+    // fashion.
+    bool reuse_port = FLAGS_flare_rpc_server_reuse_port;
+
+    // Where methods added via `AddService` are run, unless overridden via
+    // `SetExecutionPolicy`.
+    StreamService::ExecutionPolicy execution_policy =
+        StreamService::ExecutionPolicy::Detached;
   };
 
   Server();  // Equivelent to `Server(Options())`;
@@ -135,6 +152,12 @@ class Server {
   // Add services generated by Protocol Buffers.
   void AddService(MaybeOwningArgument<google::protobuf::Service> service);
 
+  // Overrides execution policy of a method added via `AddService`.
+  // `method_name` is the method's fully qualified name (e.g.
+  // `tinyRPC.testing.EchoService.Echo`).
+  void SetExecutionPolicy(const std::string& method_name,
+                          StreamService::ExecutionPolicy policy);
+
   ///////////////////////////////
   // Experts-only interfaces.  //
   ///////////////////////////////
@@ -165,8 +188,12 @@ class Server {
 
   enum class ServerState { Initialized, Running, Stopped, Joined };
 
+  static constexpr auto kAnySchedulingGroup = static_cast<std::size_t>(-1);
+
  private:
-  void OnConnection(Handle fd, Endpoint peer);
+  // `scheduling_group` is the one the connection should be served in, or
+  // `kAnySchedulingGroup` to pick one in a round-robin fashion.
+  void OnConnection(Handle fd, Endpoint peer, std::size_t scheduling_group);
 
   // Called when a new call come. (Note that for stream calls, only the first
   // message triggers this callback.).
@@ -210,7 +237,9 @@ class Server {
   std::unordered_set<std::string> known_protocols_;
 
   std::vector<Factory<StreamProtocol>> protocol_factories_;
-  std::shared_ptr<NativeAcceptor> acceptor_;
+  // One for each scheduling group if `Options::reuse_port` is set, otherwise
+  // there's only one, attached to scheduling group 0.
+  std::vector<std::shared_ptr<NativeAcceptor>> acceptors_;
 
   //  Contains pointers into `services_`. It's used by shortcut methods for
   //  adding services / HTTP handlers / ...
@@ -236,7 +265,7 @@ T* Server::GetBuiltinNativeService() {
   auto key = GetTypeIndex<T>();
   auto iter = builtin_services_.find(key);
   if (iter == builtin_services_.end()) {
-    FLARE_CHECK(!acceptor_,
+    FLARE_CHECK(acceptors_.empty(),
                 "GetBuiltinNativeService() is only usable for finding services "
                 "that has been enabled once `Start()` is called.");
     services_.push_back(std::make_unique<T>());
@@ -0,0 +1,66 @@
+#ifndef _SRC_RPC_INTERNAL_BACKUP_REQUEST_RACE_H_
+#define _SRC_RPC_INTERNAL_BACKUP_REQUEST_RACE_H_
+
+#include "RequestBudget.h"
+
+namespace tinyRPC::rpc::internal {
+
+// Decides which of a call and its backup request completes an RPC.
+//
+// The first successful response wins, and whatever completes after that is
+// discarded. A failed call does not win as long as the other one is still
+// outstanding, in case the other one does better.
+//
+// The primary call is assumed to be writing to the user's response, so the
+// backup call can win only after the primary one has completed or has been
+// cancelled.
+//
+// Not thread-safe, the caller should serialize calls to it (along with
+// whatever else it keeps about the calls).
+class BackupRequestRace {
+ public:
+  // Returns `true` once a call has won.
+  bool Completed() const noexcept { return completed_; }
+
+  // Called when the backup request is due. Returns `false` if it should not be
+  // sent, either because the RPC has completed or `budget` refuses it.
+  bool TryStartBackup(RequestBudget* budget) noexcept {
+    if (completed_ || !budget->TryWithdraw()) {
+      return false;
+    }
+    ++outstanding_;
+    return true;
+  }
+
+  // Called when a call completes. `try_cancel_primary` is called if the backup
+  // call is about to win while the primary call is still outstanding. It
+  // returns `false` if the primary call can't be cancelled (e.g., its response
+  // is being parsed), in which case the primary call wins instead.
+  //
+  // Returns `true` if this call completes the RPC.
+  template <class F>
+  bool OnCompletion(bool is_backup, bool succeeded, F&& try_cancel_primary) {
+    if (completed_) {
+      return false;  // The other call has won.
+    }
+    --outstanding_;
+    primary_done_ |= !is_backup;
+    if (!succeeded && outstanding_) {
+      return false;  // Let's see if the other call does better.
+    }
+    if (is_backup && !primary_done_ && !try_cancel_primary()) {
+      return false;
+    }
+    completed_ = true;
+    return true;
+  }
+
+ private:
+  bool completed_ = false;  // Set once the winner is decided.
+  int outstanding_ = 1;     // Calls not completed yet.
+  bool primary_done_ = false;
+};
+
+}  // namespace tinyRPC::rpc::internal
+
+#endif
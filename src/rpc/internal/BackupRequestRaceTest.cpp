@@ -0,0 +1,116 @@
+#include "BackupRequestRace.h"
+
+#include "../../../include/gtest/gtest.h"
+
+namespace tinyRPC::rpc::internal {
+
+namespace {
+
+constexpr auto kPrimary = false;
+constexpr auto kBackup = true;
+
+auto CancelPrimary(int* cancelled, bool result = true) {
+  return [cancelled, result] {
+    ++*cancelled;
+    return result;
+  };
+}
+
+}  // namespace
+
+TEST(BackupRequestRace, NoBackup) {
+  RequestBudget budget(1, 1);
+  BackupRequestRace race;
+  int cancelled = 0;
+
+  EXPECT_TRUE(race.OnCompletion(kPrimary, false, CancelPrimary(&cancelled)));
+  EXPECT_TRUE(race.Completed());
+  // No backup request once the RPC has completed.
+  EXPECT_FALSE(race.TryStartBackup(&budget));
+  EXPECT_TRUE(budget.TryWithdraw());  // Not consumed.
+  EXPECT_EQ(0, cancelled);
+}
+
+TEST(BackupRequestRace, PrimaryWins) {
+  RequestBudget budget(1, 1);
+  BackupRequestRace race;
+  int cancelled = 0;
+
+  ASSERT_TRUE(race.TryStartBackup(&budget));
+  EXPECT_TRUE(race.OnCompletion(kPrimary, true, CancelPrimary(&cancelled)));
+  // The backup call is discarded.
+  EXPECT_FALSE(race.OnCompletion(kBackup, true, CancelPrimary(&cancelled)));
+  EXPECT_EQ(0, cancelled);
+}
+
+TEST(BackupRequestRace, BackupWins) {
+  RequestBudget budget(1, 1);
+  BackupRequestRace race;
+  int cancelled = 0;
+
+  ASSERT_TRUE(race.TryStartBackup(&budget));
+  EXPECT_TRUE(race.OnCompletion(kBackup, true, CancelPrimary(&cancelled)));
+  EXPECT_EQ(1, cancelled);
+  // Should the primary call complete anyway, it's discarded.
+  EXPECT_FALSE(race.OnCompletion(kPrimary, true, CancelPrimary(&cancelled)));
+  EXPECT_EQ(1, cancelled);
+}
+
+TEST(BackupRequestRace, PrimaryNotCancellable) {
+  RequestBudget budget(1, 1);
+  BackupRequestRace race;
+  int cancelled = 0;
+
+  ASSERT_TRUE(race.TryStartBackup(&budget));
+  // The primary call's response is being parsed, so it wins.
+  EXPECT_FALSE(
+      race.OnCompletion(kBackup, true, CancelPrimary(&cancelled, false)));
+  EXPECT_EQ(1, cancelled);
+  EXPECT_FALSE(race.Completed());
+  EXPECT_TRUE(race.OnCompletion(kPrimary, false, CancelPrimary(&cancelled)));
+  EXPECT_EQ(1, cancelled);
+}
+
+TEST(BackupRequestRace, BackupAfterPrimaryFailed) {
+  RequestBudget budget(1, 1);
+  BackupRequestRace race;
+  int cancelled = 0;
+
+  ASSERT_TRUE(race.TryStartBackup(&budget));
+  // Failed, but the backup call may do better.
+  EXPECT_FALSE(race.OnCompletion(kPrimary, false, CancelPrimary(&cancelled)));
+  EXPECT_FALSE(race.Completed());
+  // No need to cancel the primary call, it has completed.
+  EXPECT_TRUE(race.OnCompletion(kBackup, true, CancelPrimary(&cancelled)));
+  EXPECT_EQ(0, cancelled);
+}
+
+TEST(BackupRequestRace, BothFailed) {
+  RequestBudget budget(1, 1);
+  BackupRequestRace race;
+  int cancelled = 0;
+
+  ASSERT_TRUE(race.TryStartBackup(&budget));
+  EXPECT_FALSE(race.OnCompletion(kBackup, false, CancelPrimary(&cancelled)));
+  // The last one completes the RPC, whatever its result is.
+  EXPECT_TRUE(race.OnCompletion(kPrimary, false, CancelPrimary(&cancelled)));
+  EXPECT_EQ(0, cancelled);
+}
+
+TEST(BackupRequestRace, BudgetRefused) {
+  RequestBudget budget(1, 1);
+  BackupRequestRace race1, race2;
+  int cancelled = 0;
+
+  ASSERT_TRUE(budget.TryWithdraw());  // Drains the budget.
+  EXPECT_FALSE(race1.TryStartBackup(&budget));
+  // Without a backup call, the primary call completes the RPC even if it
+  // failed.
+  EXPECT_TRUE(race1.OnCompletion(kPrimary, false, CancelPrimary(&cancelled)));
+
+  budget.Deposit();
+  EXPECT_TRUE(race2.TryStartBackup(&budget));
+  EXPECT_EQ(0, cancelled);
+}
+
+}  // namespace tinyRPC::rpc::internal
@@ -0,0 +1,39 @@
+#ifndef _SRC_RPC_INTERNAL_CALL_HANDOFF_H_
+#define _SRC_RPC_INTERNAL_CALL_HANDOFF_H_
+
+#include <atomic>
+
+namespace tinyRPC::rpc::internal {
+
+// Base of the state of a call handed to a service which may complete it (and
+// tell us so by calling the `on_completion` we passed to it) either before or
+// after the call into the service returns.
+//
+// It's referenced by both parties: the caller, which releases it once the
+// service returns, and the service's completion. It's freed by whichever of
+// them comes last, so neither may touch it after releasing its reference.
+//
+// `T` must derive from `CallHandoff<T>`, and be allocated via `new`.
+template <class T>
+class CallHandoff {
+ public:
+  // Drops a reference. Returns `true` if it was the last one, in which case
+  // the state has been freed (and the caller may finalize the call).
+  [[nodiscard]] bool Release() noexcept {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete static_cast<T*>(this);
+      return true;
+    }
+    return false;
+  }
+
+ protected:
+  ~CallHandoff() = default;
+
+ private:
+  std::atomic<int> refs_{2};
+};
+
+}  // namespace tinyRPC::rpc::internal
+
+#endif
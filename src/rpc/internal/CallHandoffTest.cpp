@@ -0,0 +1,105 @@
+#include "CallHandoff.h"
+
+#include <atomic>
+#include <thread>
+#include <utility>
+
+#include "../../../include/gtest/gtest.h"
+
+#include "../../base/Function.h"
+
+namespace tinyRPC::rpc::internal {
+
+namespace {
+
+struct State : CallHandoff<State> {
+  int value = 0;
+  std::atomic<int>* destroyed = nullptr;
+
+  ~State() { destroyed->fetch_add(1, std::memory_order_relaxed); }
+};
+
+// Hands `call` to `service` the way `NormalConnectionHandler::InvokeFastCall`
+// does. `finished` is incremented once the call is finalized, at which point
+// the state must have been freed.
+template <class F>
+void Invoke(State* call, F&& service, std::atomic<int>* finished) {
+  auto destroyed = call->destroyed;
+  auto finish = [destroyed, finished] {
+    EXPECT_EQ(finished->load(std::memory_order_relaxed) + 1,
+              destroyed->load(std::memory_order_relaxed));
+    finished->fetch_add(1, std::memory_order_relaxed);
+  };
+  std::forward<F>(service)([call, finish] {
+    if (call->Release()) {
+      finish();
+    }
+  });
+  if (call->Release()) {
+    finish();
+  }
+}
+
+State* NewCall(std::atomic<int>* destroyed) {
+  auto call = new State();
+  call->destroyed = destroyed;
+  return call;
+}
+
+}  // namespace
+
+TEST(CallHandoff, CompletedBeforeReturn) {
+  std::atomic<int> destroyed = 0, finished = 0;
+  auto call = NewCall(&destroyed);
+
+  Invoke(
+      call,
+      [&](auto on_completion) {
+        call->value = 1;
+        on_completion();
+        // Still referenced by the caller.
+        EXPECT_EQ(0, destroyed);
+        EXPECT_EQ(0, finished);
+      },
+      &finished);
+  EXPECT_EQ(1, destroyed);
+  EXPECT_EQ(1, finished);
+}
+
+TEST(CallHandoff, CompletedAfterReturn) {
+  std::atomic<int> destroyed = 0, finished = 0;
+  auto call = NewCall(&destroyed);
+  UniqueFunction<void()> pending;
+
+  Invoke(
+      call, [&](auto on_completion) { pending = std::move(on_completion); },
+      &finished);
+  // Still referenced by the service.
+  EXPECT_EQ(0, destroyed);
+  EXPECT_EQ(0, finished);
+  call->value = 1;  // Still usable.
+
+  pending();
+  EXPECT_EQ(1, destroyed);
+  EXPECT_EQ(1, finished);
+}
+
+TEST(CallHandoff, Race) {
+  constexpr auto kCalls = 10000;
+  std::atomic<int> destroyed = 0, finished = 0;
+
+  for (int i = 0; i != kCalls; ++i) {
+    std::thread completer;
+    Invoke(
+        NewCall(&destroyed),
+        [&](auto on_completion) {
+          completer = std::thread(std::move(on_completion));
+        },
+        &finished);
+    completer.join();
+  }
+  EXPECT_EQ(kCalls, destroyed);
+  EXPECT_EQ(kCalls, finished);
+}
+
+}  // namespace tinyRPC::rpc::internal
@@ -5,7 +5,7 @@
 
 #include "../../base/IDAlloc.h"
 #include "../../fiber/Runtime.h"
-#include "ShardedCallMap.h"
+#include "FixedSizeCallMap.h"
 
 // Here we use a semi-global correlation map for all outgoing RPCs.
 //
@@ -25,17 +25,13 @@
 
 namespace tinyRPC::rpc::internal {
 
-// TODO(luobogao): Now that we're using a (semi-)global map, we can use a
-// fixed-sized lockless map instead of `ShardedCallMap` for more stable
-// performance.
-//
-// The reason why we can't do this previously is that we can't afford to keep a
-// large fixed-size map for each connection. Now that it's semi-global, it's
-// affordable.
+// Now that we're using a (semi-)global map, we can afford a fixed-sized
+// lockless map (one per scheduling group) for more stable performance. We
+// can't keep such a large map for each connection.
 //
 // TODO(luobogao): Expose statistics of each correlation map via `ExposedVar`.
 template <class T>
-using CorrelationMap = ShardedCallMap<T>;
+using CorrelationMap = FixedSizeCallMap<T>;
 
 // Get correlation map for the given scheduling group. The resulting map is
 // indexed by key generated via `MergeCorrelationId`.
@@ -0,0 +1,69 @@
+#include <memory>
+#include <vector>
+
+#include "../../../include/benchmark/benchmark.h"
+
+#include "CorrelationID.h"
+#include "FixedSizeCallMap.h"
+#include "ShardedCallMap.h"
+
+// Compares `FixedSizeCallMap` (what `CorrelationMap` is) with the
+// `ShardedCallMap` it replaces.
+//
+// Each thread mimics a connection issuing RPCs: correlation IDs are allocated
+// the same way as real RPCs, `state.range(0)` RPCs are kept on-going, and each
+// of them is completed (removed) before a new one is issued (inserted).
+
+namespace tinyRPC::rpc::internal {
+
+namespace {
+
+template <class Map>
+void InsertRemove(benchmark::State& state) {
+  // Setup code of each thread is not synchronized, so the map is not created
+  // by the first thread.
+  static Map map_instance;
+  auto map = &map_instance;
+  std::vector<std::uint64_t> ongoing(state.range(0));
+  auto conn_id = NewConnectionCorrelationId();
+  for (auto&& e : ongoing) {
+    e = MergeCorrelationId(conn_id, NewRpcCorrelationId());
+    map->Insert(e, std::make_shared<int>());
+  }
+  auto value = std::make_shared<int>();
+  std::size_t index = 0;
+  while (state.KeepRunning()) {
+    auto&& e = ongoing[index++ % ongoing.size()];
+    auto v = map->Remove(e);
+    e = MergeCorrelationId(conn_id, NewRpcCorrelationId());
+    map->Insert(e, std::move(v));
+  }
+  for (auto&& e : ongoing) {
+    map->Remove(e);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+void Benchmark_ShardedCallMap(benchmark::State& state) {
+  InsertRemove<ShardedCallMap<std::shared_ptr<int>>>(state);
+}
+
+BENCHMARK(Benchmark_ShardedCallMap)
+    ->Arg(1)
+    ->Arg(256)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+void Benchmark_FixedSizeCallMap(benchmark::State& state) {
+  InsertRemove<FixedSizeCallMap<std::shared_ptr<int>>>(state);
+}
+
+BENCHMARK(Benchmark_FixedSizeCallMap)
+    ->Arg(1)
+    ->Arg(256)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+}  // namespace tinyRPC::rpc::internal
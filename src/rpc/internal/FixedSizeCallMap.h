@@ -0,0 +1,181 @@
+#ifndef _SRC_RPC_INTERNAL_FIXED_SIZE_CALL_MAP_H_
+#define _SRC_RPC_INTERNAL_FIXED_SIZE_CALL_MAP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "../../base/Likely.h"
+#include "../../base/Logging.h"
+
+namespace tinyRPC::rpc::internal {
+
+// Lockless concurrent map from correlation ID to `T`.
+//
+// Slots are kept in a fixed-size, power-of-two array indexed by the low bits
+// of the key, i.e., the RPC correlation ID (@sa: `MergeCorrelationId`). Since
+// RPC correlation IDs are allocated (in batches) from a global counter,
+// on-going RPCs are mostly mapped to distinct slots without probing at all.
+//
+// A slot is claimed / released by CAS-ing its key. There are no tombstones:
+// instead of stopping at the first empty slot, lookups probe a fixed number of
+// slots (`kMaxProbes`). Should all of them be occupied, the value is put into a
+// (locked) overflow map instead. This should be rare.
+//
+// Neither `Insert` nor `Remove` allocates memory (unless the overflow map is
+// used, or `T` itself allocates on move).
+//
+// Keys must not have their lower 32 bits all zero (which is never the case
+// for keys produced by `MergeCorrelationId`.). `T` must be default
+// constructible, and its default constructed value is returned by `Remove` if
+// the key is not found.
+template <class T>
+class FixedSizeCallMap {
+  inline static constexpr std::uint64_t kEmpty = 0;
+  // Slot is being written (or read) by someone.
+  inline static constexpr std::uint64_t kBusy = 0xffff'ffff'0000'0000;
+  inline static constexpr std::size_t kMaxProbes = 8;
+
+ public:
+  // We use a map for each scheduling group. 32K on-going RPCs per group should
+  // be far more than enough.
+  inline static constexpr std::size_t kDefaultSlots = 32768;
+
+  explicit FixedSizeCallMap(std::size_t slots = kDefaultSlots)
+      : mask_(slots - 1), slots_(std::make_unique<Slot[]>(slots)) {
+    FLARE_CHECK(slots >= kMaxProbes && (slots & (slots - 1)) == 0,
+                "Number of slots must be a power of 2.");
+  }
+
+  // Insert a new correlation.
+  //
+  // Were duplicate found, we crash. Note that only duplicates residing in
+  // slots probed before a free one is found are detected.
+  void Insert(std::uint64_t correlation_id, T value) {
+    FLARE_CHECK(IsValidKey(correlation_id));
+    for (std::size_t i = 0; i != kMaxProbes; ++i) {
+      auto&& slot = slots_[(correlation_id + i) & mask_];
+      auto key = slot.key.load(std::memory_order_relaxed);
+      FLARE_CHECK_NE(key, correlation_id, "Duplicate correlation_id {}.",
+                     correlation_id);
+      if (key == kEmpty && slot.key.compare_exchange_strong(
+                               key, kBusy, std::memory_order_acquire,
+                               std::memory_order_relaxed)) {
+        slot.value = std::move(value);
+        slot.key.store(correlation_id, std::memory_order_release);
+        return;
+      }
+    }
+    InsertOverflow(correlation_id, std::move(value));
+  }
+
+  // Returns value removed, or a default constructed `T` if nothing was
+  // removed.
+  T Remove(std::uint64_t correlation_id) {
+    for (std::size_t i = 0; i != kMaxProbes; ++i) {
+      auto&& slot = slots_[(correlation_id + i) & mask_];
+      auto key = slot.key.load(std::memory_order_relaxed);
+      while (true) {
+        if (FLARE_UNLIKELY(key == kBusy)) {
+          // Someone else is accessing this slot, which won't take long. It can
+          // be our key being visited by `ForEach`, so we can't just skip it.
+          Pause();
+          key = slot.key.load(std::memory_order_relaxed);
+          continue;
+        }
+        if (key != correlation_id) {
+          break;  // Not here, or someone else has just removed it.
+        }
+        if (slot.key.compare_exchange_weak(key, kBusy,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+          auto result = std::exchange(slot.value, T());
+          slot.key.store(kEmpty, std::memory_order_release);
+          return result;
+        }
+        // `key` is reloaded on failure, recheck it.
+      }
+    }
+    if (FLARE_UNLIKELY(overflow_size_.load(std::memory_order_acquire))) {
+      return RemoveOverflow(correlation_id);
+    }
+    return T();
+  }
+
+  // Call this method concurrently to other modifications may lose those
+  // concurrent changes. Also note that you must not modify the map in the
+  // callback, and the callback must return quickly (`Remove`s of the key being
+  // visited wait for the callback). Otherwise THE BEHAVIOR IS UNDEFINED.
+  template <class F>
+  void ForEach(F&& f) {
+    for (std::size_t i = 0; i != mask_ + 1; ++i) {
+      auto&& slot = slots_[i];
+      auto key = slot.key.load(std::memory_order_relaxed);
+      if (IsValidKey(key) &&
+          slot.key.compare_exchange_strong(key, kBusy,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+        std::forward<F>(f)(key, slot.value);
+        slot.key.store(key, std::memory_order_release);
+      }
+    }
+    if (overflow_size_.load(std::memory_order_acquire)) {
+      std::scoped_lock _(overflow_lock_);
+      for (auto&& [k, v] : overflow_) {
+        std::forward<F>(f)(k, v);
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    std::atomic<std::uint64_t> key{kEmpty};
+    T value{};
+  };
+
+  static bool IsValidKey(std::uint64_t key) noexcept {
+    return key & 0xffff'ffff;  // Rules out `kEmpty` and `kBusy`.
+  }
+
+  static void Pause() noexcept { asm volatile("pause" ::: "memory"); }
+
+  [[gnu::noinline]] void InsertOverflow(std::uint64_t correlation_id,
+                                        T value) {
+    FLARE_LOG_WARNING_ONCE(
+        "Too many on-going RPCs collide in correlation map, performance may "
+        "degrade.");
+    std::scoped_lock _(overflow_lock_);
+    auto&& [iter, inserted] =
+        overflow_.emplace(correlation_id, std::move(value));
+    FLARE_CHECK(inserted, "Duplicate correlation_id {}.", correlation_id);
+    overflow_size_.fetch_add(1, std::memory_order_release);
+  }
+
+  [[gnu::noinline]] T RemoveOverflow(std::uint64_t correlation_id) {
+    std::scoped_lock _(overflow_lock_);
+    if (auto iter = overflow_.find(correlation_id); iter != overflow_.end()) {
+      auto v = std::move(iter->second);
+      overflow_.erase(iter);
+      overflow_size_.fetch_sub(1, std::memory_order_relaxed);
+      return v;
+    }
+    return T();
+  }
+
+ private:
+  std::size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+
+  // Values that can't find a free slot in `kMaxProbes` probes go here.
+  std::atomic<std::size_t> overflow_size_{0};
+  std::mutex overflow_lock_;
+  std::unordered_map<std::uint64_t, T> overflow_;
+};
+
+}  // namespace tinyRPC::rpc::internal
+
+#endif
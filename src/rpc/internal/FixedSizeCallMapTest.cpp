@@ -0,0 +1,82 @@
+#include "FixedSizeCallMap.h"
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "../../../include/gtest/gtest.h"
+
+#include "CorrelationID.h"
+
+namespace tinyRPC::rpc::internal {
+
+TEST(FixedSizeCallMap, Basic) {
+  FixedSizeCallMap<std::unique_ptr<int>> map(16);
+  map.Insert(MergeCorrelationId(1, 1), std::make_unique<int>(1));
+  map.Insert(MergeCorrelationId(2, 1), std::make_unique<int>(2));  // Probed.
+  EXPECT_FALSE(map.Remove(MergeCorrelationId(1, 2)));
+  EXPECT_EQ(2, *map.Remove(MergeCorrelationId(2, 1)));
+  EXPECT_FALSE(map.Remove(MergeCorrelationId(2, 1)));
+  EXPECT_EQ(1, *map.Remove(MergeCorrelationId(1, 1)));
+}
+
+TEST(FixedSizeCallMap, Overflow) {
+  FixedSizeCallMap<std::unique_ptr<int>> map(16);
+  // All mapped to the same slot.
+  for (int i = 1; i != 100; ++i) {
+    map.Insert(MergeCorrelationId(i, 1), std::make_unique<int>(i));
+  }
+  std::set<std::uint64_t> keys;
+  map.ForEach([&](auto k, auto&& v) {
+    EXPECT_EQ(SplitCorrelationId(k).first, *v);
+    keys.insert(k);
+  });
+  EXPECT_EQ(99, keys.size());
+  for (int i = 1; i != 100; ++i) {
+    EXPECT_EQ(i, *map.Remove(MergeCorrelationId(i, 1)));
+  }
+  EXPECT_FALSE(map.Remove(MergeCorrelationId(1, 1)));
+}
+
+TEST(FixedSizeCallMap, Concurrent) {
+  FixedSizeCallMap<std::shared_ptr<int>> map(1024);
+  std::atomic<std::uint32_t> next_id{1};
+  std::atomic<int> removed{};
+  std::vector<std::thread> ts;
+  for (int i = 0; i != 8; ++i) {
+    ts.emplace_back([&, i] {
+      for (int j = 0; j != 100000; ++j) {
+        auto key = MergeCorrelationId(i, next_id.fetch_add(1) % 5000 + 1);
+        map.Insert(key, std::make_shared<int>(j));
+        // Races with "timeout" below. Either one of us wins.
+        if (map.Remove(key)) {
+          ++removed;
+        }
+      }
+    });
+  }
+  // Simulates timeouts, i.e., removal from other threads.
+  std::atomic<bool> leaving{false};
+  std::thread timer([&] {
+    while (!leaving) {
+      std::vector<std::uint64_t> keys;
+      map.ForEach([&](auto k, auto&&) { keys.push_back(k); });
+      for (auto&& e : keys) {
+        if (map.Remove(e)) {
+          ++removed;
+        }
+      }
+    }
+  });
+  for (auto&& t : ts) {
+    t.join();
+  }
+  leaving = true;
+  timer.join();
+  map.ForEach([&](auto, auto&&) { ++removed; });
+  EXPECT_EQ(8 * 100000, removed);
+}
+
+}  // namespace tinyRPC::rpc::internal
@@ -0,0 +1,31 @@
+#include "MethodExecutionPolicy.h"
+
+#include "gflags/gflags.h"
+
+DEFINE_int32(flare_rpc_server_inline_execution_threshold_us, 10,
+             "Methods with `Adaptive` execution policy are run in the I/O "
+             "fiber if they have been returning in this many microseconds "
+             "(on average) recently.");
+
+namespace tinyRPC::rpc::internal {
+
+bool MethodExecutionPolicy::ShouldRunInline() const noexcept {
+  auto policy = Get();
+  if (policy == ExecutionPolicy::Inline) {
+    return true;
+  } else if (policy == ExecutionPolicy::Adaptive) {
+    return running_time_.load(std::memory_order_relaxed) <
+           FLAGS_flare_rpc_server_inline_execution_threshold_us * 1000ULL;
+  }
+  return false;
+}
+
+void MethodExecutionPolicy::AddRunningTime(
+    std::chrono::nanoseconds running_time) noexcept {
+  // Weight of the new sample is 1/8.
+  std::uint64_t sample = running_time.count();
+  auto was = running_time_.load(std::memory_order_relaxed);
+  running_time_.store(was - was / 8 + sample / 8, std::memory_order_relaxed);
+}
+
+}  // namespace tinyRPC::rpc::internal
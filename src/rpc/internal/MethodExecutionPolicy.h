@@ -0,0 +1,67 @@
+#ifndef _SRC_RPC_INTERNAL_METHOD_EXECUTION_POLICY_H_
+#define _SRC_RPC_INTERNAL_METHOD_EXECUTION_POLICY_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "gflags/gflags_declare.h"
+
+#include "../protocol/StreamService.h"
+
+DECLARE_int32(flare_rpc_server_inline_execution_threshold_us);
+
+namespace tinyRPC::rpc::internal {
+
+// Execution policy of a method (@sa: `StreamService::ExecutionPolicy`), along
+// with how long the method has been running recently, which is what
+// `Adaptive` policy is decided upon.
+//
+// Thread-safe. The policy may be changed while calls to the method are being
+// made, calls already dispatched are not affected.
+class alignas(64) MethodExecutionPolicy {
+ public:
+  using ExecutionPolicy = StreamService::ExecutionPolicy;
+
+  explicit MethodExecutionPolicy(
+      ExecutionPolicy policy = ExecutionPolicy::Detached)
+      : policy_(policy) {}
+
+  ExecutionPolicy Get() const noexcept {
+    return policy_.load(std::memory_order_relaxed);
+  }
+
+  // Returns the policy replaced.
+  ExecutionPolicy Set(ExecutionPolicy policy) noexcept {
+    return policy_.exchange(policy, std::memory_order_relaxed);
+  }
+
+  // Returns `true` if a call to the method should be run inline (given that
+  // the framework allows it).
+  //
+  // For `Adaptive` methods, that's the case if the (EWMA of) running time is
+  // below `FLAGS_flare_rpc_server_inline_execution_threshold_us`.
+  bool ShouldRunInline() const noexcept;
+
+  // Feeds running time of a call to the EWMA. Applicable to `Adaptive` methods
+  // only, it's measured whether the call was run inline or not, so that the
+  // method can switch back to inline once it's fast again.
+  //
+  // Concurrent updates may overwrite each other. Losing a sample now and then
+  // does not hurt.
+  void AddRunningTime(std::chrono::nanoseconds running_time) noexcept;
+
+  // EWMA of running time reported via `AddRunningTime`.
+  std::chrono::nanoseconds GetRunningTime() const noexcept {
+    return std::chrono::nanoseconds(
+        running_time_.load(std::memory_order_relaxed));
+  }
+
+ private:
+  std::atomic<ExecutionPolicy> policy_;
+  std::atomic<std::uint64_t> running_time_{0};  // In nanoseconds.
+};
+
+}  // namespace tinyRPC::rpc::internal
+
+#endif
@@ -0,0 +1,87 @@
+#include "MethodExecutionPolicy.h"
+
+#include <chrono>
+
+#include "../../../include/gtest/gtest.h"
+
+using namespace std::literals;
+
+namespace tinyRPC::rpc::internal {
+
+using ExecutionPolicy = StreamService::ExecutionPolicy;
+
+TEST(MethodExecutionPolicy, Detached) {
+  MethodExecutionPolicy policy;
+  EXPECT_EQ(ExecutionPolicy::Detached, policy.Get());
+  EXPECT_FALSE(policy.ShouldRunInline());
+}
+
+TEST(MethodExecutionPolicy, Inline) {
+  MethodExecutionPolicy policy(ExecutionPolicy::Inline);
+  EXPECT_TRUE(policy.ShouldRunInline());
+  // Running time is not cared about.
+  for (int i = 0; i != 100; ++i) {
+    policy.AddRunningTime(1s);
+  }
+  EXPECT_TRUE(policy.ShouldRunInline());
+}
+
+TEST(MethodExecutionPolicy, Set) {
+  MethodExecutionPolicy policy;
+  EXPECT_EQ(ExecutionPolicy::Detached, policy.Set(ExecutionPolicy::Inline));
+  EXPECT_TRUE(policy.ShouldRunInline());
+  EXPECT_EQ(ExecutionPolicy::Inline, policy.Set(ExecutionPolicy::Adaptive));
+  EXPECT_TRUE(policy.ShouldRunInline());  // Nothing measured yet.
+  EXPECT_EQ(ExecutionPolicy::Adaptive, policy.Set(ExecutionPolicy::Detached));
+  EXPECT_FALSE(policy.ShouldRunInline());
+}
+
+TEST(MethodExecutionPolicy, Adaptive) {
+  FLAGS_flare_rpc_server_inline_execution_threshold_us = 10;
+  MethodExecutionPolicy policy(ExecutionPolicy::Adaptive);
+  EXPECT_TRUE(policy.ShouldRunInline());
+
+  // Fast calls keep it inline.
+  for (int i = 0; i != 100; ++i) {
+    policy.AddRunningTime(5us);
+    EXPECT_TRUE(policy.ShouldRunInline());
+  }
+  EXPECT_LT(policy.GetRunningTime(), 10us);
+
+  // A single slow call is not enough to move it out.
+  policy.AddRunningTime(20us);
+  EXPECT_TRUE(policy.ShouldRunInline());
+
+  // It's detached once the average reaches the threshold...
+  int slow_calls = 1;
+  while (policy.ShouldRunInline()) {
+    policy.AddRunningTime(20us);
+    ++slow_calls;
+  }
+  EXPECT_GE(policy.GetRunningTime(), 10us);
+  EXPECT_LT(slow_calls, 10);
+
+  // ... and is back once it's fast again.
+  int fast_calls = 0;
+  while (!policy.ShouldRunInline()) {
+    policy.AddRunningTime(1us);
+    ++fast_calls;
+  }
+  EXPECT_LT(policy.GetRunningTime(), 10us);
+  EXPECT_LT(fast_calls, 10);
+}
+
+TEST(MethodExecutionPolicy, Threshold) {
+  MethodExecutionPolicy policy(ExecutionPolicy::Adaptive);
+  for (int i = 0; i != 200; ++i) {
+    policy.AddRunningTime(50us);
+  }
+  FLAGS_flare_rpc_server_inline_execution_threshold_us = 10;
+  EXPECT_FALSE(policy.ShouldRunInline());
+  // The flag is read on each call.
+  FLAGS_flare_rpc_server_inline_execution_threshold_us = 100;
+  EXPECT_TRUE(policy.ShouldRunInline());
+  FLAGS_flare_rpc_server_inline_execution_threshold_us = 10;
+}
+
+}  // namespace tinyRPC::rpc::internal
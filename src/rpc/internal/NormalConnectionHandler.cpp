@@ -1,5 +1,6 @@
 #include "NormalConnectionHandler.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -10,6 +11,7 @@
 #include "../../fiber/Fiber.h"
 #include "../../fiber/ThisFiber.h"
 #include "../Server.h"
+#include "StreamIoAdaptor.h"
 
 using namespace std::literals;
 
@@ -24,7 +26,10 @@ NormalConnectionHandler::NormalConnectionHandler(Server* owner,
   last_service_ = ctx_->services.front();
 }
 
-void NormalConnectionHandler::Stop() {}
+void NormalConnectionHandler::Stop() {
+  // Services blocked on reading / writing streams are woken up.
+  BreakAllStreams();
+}
 
 void NormalConnectionHandler::Join() {
   while (ongoing_requests_) {
@@ -39,14 +44,14 @@ void NormalConnectionHandler::OnDetach() {}
 void NormalConnectionHandler::OnWriteBufferEmpty() {}
 
 StreamConnectionHandler::DataConsumptionStatus
-NormalConnectionHandler::OnDataArrival(std::string& buffer) {
+NormalConnectionHandler::OnDataArrival(NoncontiguousBuffer& buffer) {
   FLARE_CHECK(conn_);  // This cannot fail.
 
   ScopedDeferred _([&] { ConsiderUpdateCoarseLastEventTimestamp(); });
   bool ever_suppressed = false;
   auto receive_tsc = ReadTsc();
 
-  while (!buffer.empty()) {
+  while (!buffer.Empty()) {
     auto rc = ProcessOnePacket(buffer, receive_tsc);
     if (FLARE_LIKELY(rc == ProcessingStatus::Success)) {
       continue;
@@ -67,6 +72,7 @@ NormalConnectionHandler::OnDataArrival(std::string& buffer) {
 void NormalConnectionHandler::OnClose() {
   FLARE_VLOG(10, "Connection from [{}] closed.", ctx_->remote_peer.ToString());
 
+  BreakAllStreams();
   owner_->OnConnectionClosed(ctx_->id);
 }
 
@@ -79,9 +85,9 @@ void NormalConnectionHandler::OnError() {
 void NormalConnectionHandler::OnDataWritten(std::uintptr_t ctx) {}
 
 NormalConnectionHandler::ProcessingStatus
-NormalConnectionHandler::ProcessOnePacket(std::string& buffer,
+NormalConnectionHandler::ProcessOnePacket(NoncontiguousBuffer& buffer,
                                           std::uint64_t receive_tsc) {
-  auto buffer_size_was = buffer.size();
+  auto buffer_size_was = buffer.ByteSize();
   std::unique_ptr<Message> msg;
   StreamProtocol* protocol;
                               
@@ -96,16 +102,17 @@ NormalConnectionHandler::ProcessOnePacket(std::string& buffer,
     return ProcessingStatus::Saturated;
   }
   FLARE_CHECK(rc == ProcessingStatus::Success);
-  auto pkt_size = buffer_size_was - buffer.size();  // Size of this packet.
+  auto pkt_size = buffer_size_was - buffer.ByteSize();  // Size of this packet.
 
   if (auto type = msg->GetType(); FLARE_LIKELY(type == Message::Type::Single)) {
     // Call service to handle it in separate fiber.
     //
-    // FIXME: We always create start a fiber in the background to call service,
-    // this is needed for better responsiveness in I/O fiber (had we used
-    // `Dispatch` here, I/O fiber will be keep migrating between workers).
-    // However, in this case, responsiveness of RPCs suffers. It might be better
-    // if we call last service in foreground.
+    // We start a fiber in the background to call service, this is needed for
+    // better responsiveness in I/O fiber (had we used `Dispatch` here, I/O
+    // fiber will be keep migrating between workers). However, in this case,
+    // responsiveness of RPCs suffers. Therefore, for the last message in the
+    // batch, we allow the service to ask for running it in foreground (@sa:
+    // `StreamService::ExecutionPolicy`).
 
     // This check must be done here.
     //
@@ -123,23 +130,45 @@ NormalConnectionHandler::ProcessOnePacket(std::string& buffer,
       // finished.
       auto ctlr = NewController(*msg, protocol);
       ServiceOverloaded(std::move(msg), protocol, ctlr.get());
+    } else if (buffer.Empty() && MayRunInline()) {
+      // Nothing else would be delayed if we handle it in this fiber. Whether
+      // it's indeed run inline is determined once it's parsed.
+      auto ctlr = NewController(*msg, protocol);
+      ServiceFastCall(std::move(msg), protocol, std::move(ctlr), receive_tsc,
+                      pkt_size, true);
     } else {
       // FIXME: Too many captures hurts performance.
       fiber::StartFiberDetached([this, msg = std::move(msg), protocol,
                                            receive_tsc, pkt_size]() mutable {
         auto ctlr = NewController(*msg, protocol);
+        // `OnCallCompletion` is called once the call finishes, which can be
+        // after `ServiceFastCall` returns.
         ServiceFastCall(std::move(msg), protocol, std::move(ctlr), receive_tsc,
-                        pkt_size);
-        OnCallCompletion();
+                        pkt_size, false);
       });
     }
+  } else if ((type & Message::Type::StartOfStream) ==
+             Message::Type::StartOfStream) {
+    // The same as above, the counter must be incremented in I/O fiber. The
+    // stream counts as a single call.
+    if (FLARE_UNLIKELY(!OnNewCall())) {
+      auto ctlr = NewController(*msg, protocol);
+      ServiceOverloaded(std::move(msg), protocol, ctlr.get());
+    } else {
+      StartStreamCall(std::move(msg), protocol);
+    }
+  } else {
+    // Subsequent messages (or window updates) of a stream. They're buffered by
+    // the stream until the service reads them. Parsing them in I/O fiber would
+    // delay other calls on this connection.
+    NotifyStream(std::move(msg));
   }
-    return ProcessingStatus::Success;
+  return ProcessingStatus::Success;
 }
 
 StreamProtocol::MessageCutStatus
 NormalConnectionHandler::TryCutMessageUsingLastProtocol(
-    std::string& buffer, std::unique_ptr<Message>* msg,
+    NoncontiguousBuffer& buffer, std::unique_ptr<Message>* msg,
     StreamProtocol** used_protocol) {
   FLARE_CHECK(ever_succeeded_cut_msg_);
   FLARE_CHECK_LT(last_protocol_, ctx_->protocols.size());
@@ -160,7 +189,7 @@ NormalConnectionHandler::TryCutMessageUsingLastProtocol(
 }
 
 NormalConnectionHandler::ProcessingStatus
-NormalConnectionHandler::TryCutMessage(std::string& buffer,
+NormalConnectionHandler::TryCutMessage(NoncontiguousBuffer& buffer,
                                        std::unique_ptr<Message>* msg,
                                        StreamProtocol** used_protocol) {
   // If we succeeded in cutting off a message, we try the protocol we last used
@@ -232,9 +261,9 @@ std::size_t NormalConnectionHandler::WriteMessage(const Message& msg,
                                                   Controller* controller,
                                                   std::uintptr_t ctx) const {
   ScopedDeferred _([&] { ConsiderUpdateCoarseLastEventTimestamp(); });
-  std::string nb;
+  NoncontiguousBuffer nb;
   protocol->WriteMessage(msg, nb, controller);
-  auto bytes = nb.size();
+  auto bytes = nb.ByteSize();
   (void)conn_->Write(std::move(nb), ctx);  // Failure is ignored.
   return bytes;
 }
@@ -242,7 +271,7 @@ std::size_t NormalConnectionHandler::WriteMessage(const Message& msg,
 void NormalConnectionHandler::ServiceFastCall(
     std::unique_ptr<Message>&& msg, StreamProtocol* protocol,
     std::unique_ptr<Controller> controller, std::uint64_t receive_tsc,
-    std::size_t pkt_size) {
+    std::size_t pkt_size, bool in_io_fiber) {
   auto dispatched_tsc = ReadTsc();
 
   // If the request has been in queue for too long, reject it now.
@@ -253,6 +282,7 @@ void NormalConnectionHandler::ServiceFastCall(
         "Request #{} has been in queue for too long, rejected.",
         msg->GetCorrelationId());
     WriteOverloaded(*msg, protocol, &*controller);
+    OnCallCompletion();
     return;
   }
 
@@ -260,6 +290,7 @@ void NormalConnectionHandler::ServiceFastCall(
   auto cid = msg->GetCorrelationId();
   if (FLARE_UNLIKELY(!protocol->TryParse(&msg, controller.get()))) {
     FLARE_LOG_WARNING("Failed to parse message #{}.", cid);
+    OnCallCompletion();
     return;
   }
   auto parsed_tsc = ReadTsc();
@@ -287,42 +318,199 @@ void NormalConnectionHandler::ServiceFastCall(
         "any service. The message was successfully parsed by protocol [{}].",
         GetTypeName(*msg), ctx_->remote_peer.ToString(),
         protocol->GetCharacteristics().name);
+    OnCallCompletion();
     return;
   }
 
-  // Prepare the execution context and call user's code.
-  PrepareForRpc(inspection_result, *controller, [&] {
+  // The service may complete the call asynchronously, so everything it may
+  // touch is moved to heap. Freed once both `FastCall` returns and the service
+  // calls `on_completion`, whichever comes last.
+  auto call = new FastCall();
+  call->msg = std::move(msg);
+  call->controller = std::move(controller);
+  call->context = std::move(call_context);
+  call->writer = [this, protocol,
+                  controller = call->controller.get()](const Message& m) {
+    return WriteMessage(m, protocol, controller, kFastCallReservedContextId);
+  };
+
+  if (in_io_fiber && !handler->ShouldRunInline(*call->msg)) {
+    // Not suitable for running in I/O fiber, move it out.
+    fiber::StartFiberDetached(
+        [this, call, handler, protocol, inspection_result] {
+          InvokeFastCall(call, handler, protocol, inspection_result);
+        });
+    return;
+  }
+  InvokeFastCall(call, handler, protocol, inspection_result);
+}
 
+void NormalConnectionHandler::InvokeFastCall(
+    FastCall* call, StreamService* handler, StreamProtocol* protocol,
+    const StreamService::InspectionResult& inspection_result) {
+  // Prepare the execution context and call user's code.
+  PrepareForRpc(inspection_result, *call->controller, [&] {
     // Call user's code.
-    auto writer = [&](auto&& m) {
-      return WriteMessage(m, protocol, controller.get(),
-                          kFastCallReservedContextId);
-    };
-
-    auto processing_status = handler->FastCall(&msg, writer, &call_context);
+    auto processing_status =
+        handler->FastCall(&call->msg, call->writer, &call->context,
+                          [this, call] { ReleaseFastCall(call); });
     if (processing_status == StreamService::ProcessingStatus::Processed ||
         processing_status == StreamService::ProcessingStatus::Completed) {
-      // Nothing.
+      // Nothing. The service will call `on_completion` (or has called it).
     } else {
-      call_context.status = -1;  // ...
+      call->context.status = -1;  // ...
       if (processing_status == StreamService::ProcessingStatus::Overloaded) {
-        WriteOverloaded(*msg, protocol, &*controller);
+        WriteOverloaded(*call->msg, protocol, call->controller.get());
       }  // No special action required for other errors.
+      ReleaseFastCall(call);  // `on_completion` is not called in this case.
     }
 
-    WaitForRpcCompletion();
-
-
     // The connection should be closed ASAP. Calling `OnConnectionClosed` looks
     // weird as we're actually actively closing the connection. Anyway, that
     // callback should serve us well.
     if (processing_status == StreamService::ProcessingStatus::Completed) {
       owner_->OnConnectionClosed(ctx_->id);
     }
+    ReleaseFastCall(call);
   });
 }
 
+void NormalConnectionHandler::ReleaseFastCall(FastCall* call) {
+  if (call->Release()) {
+    OnCallCompletion();
+  }
+}
+
+void NormalConnectionHandler::StartStreamCall(std::unique_ptr<Message> msg,
+                                              StreamProtocol* protocol) {
+  auto cid = msg->GetCorrelationId();
+  std::shared_ptr<Controller> controller = NewController(*msg, protocol);
+  rpc::internal::StreamIoAdaptor::Operations ops = {
+      .write =
+          [this, protocol, controller, cid](const Message& m) {
+            // Failure is detected via `OnError`, which breaks the stream.
+            WriteMessage(m, protocol, controller.get(), cid);
+            return true;
+          },
+      .parse =
+          [protocol, controller](std::unique_ptr<Message>* m) {
+            return protocol->TryParse(m, controller.get());
+          },
+      .create_window_update =
+          [protocol, cid](std::uint32_t consumed) {
+            return protocol->GetMessageFactory()->CreateStreamWindowUpdate(
+                cid, consumed);
+          },
+      .on_close =
+          [this, cid] {
+            {
+              std::scoped_lock _(lock_);
+              // Don't remove a new stream reusing the correlation ID.
+              if (auto iter = streams_.find(cid);
+                  iter != streams_.end() && iter->second.expired()) {
+                streams_.erase(iter);
+              }
+            }
+            OnCallCompletion();
+          }};
+  auto stream = std::make_shared<rpc::internal::StreamIoAdaptor>(
+      FLAGS_flare_rpc_stream_window_size, std::move(ops));
+
+  bool duplicate;
+  {
+    std::scoped_lock _(lock_);
+    auto&& entry = streams_[cid];
+    duplicate = !entry.expired();
+    if (!duplicate) {
+      entry = stream;
+    }
+  }
+  if (FLARE_UNLIKELY(duplicate)) {
+    FLARE_LOG_WARNING_ONCE(
+        "Stream #{} from [{}] is already open. The new one is dropped.", cid,
+        ctx_->remote_peer.ToString());
+    return;  // `OnCallCompletion` is called once `stream` is gone.
+  }
+
+  stream->NotifyRead(std::move(msg));
+  fiber::StartFiberDetached(
+      [this, stream = std::move(stream), protocol, controller]() mutable {
+        ServiceStreamCall(std::move(stream), protocol, controller.get());
+      });
+}
 
+void NormalConnectionHandler::ServiceStreamCall(
+    std::shared_ptr<rpc::internal::StreamIoAdaptor> stream,
+    StreamProtocol* protocol, Controller* controller) {
+  auto first = stream->Peek();
+  if (FLARE_UNLIKELY(!first)) {
+    FLARE_LOG_WARNING("Failed to parse the first message of a stream from [{}].",
+                      ctx_->remote_peer.ToString());
+    return;
+  }
+  auto cid = first->GetCorrelationId();
+
+  StreamService::Context call_context;
+  call_context.local_peer = ctx_->local_peer;
+  call_context.remote_peer = ctx_->remote_peer;
+  call_context.controller = controller;
+
+  StreamService::InspectionResult inspection_result;
+  auto handler =
+      FindAndCacheMessageHandler(*first, *controller, &inspection_result);
+  if (FLARE_UNLIKELY(!handler)) {
+    FLARE_LOG_ERROR(
+        "Received a stream of type [{}] from [{}] which is not interested by "
+        "any service.",
+        GetTypeName(*first), ctx_->remote_peer.ToString());
+    return;
+  }
+
+  PrepareForRpc(inspection_result, *controller, [&] {
+    auto processing_status = handler->StreamCall(std::move(stream), &call_context);
+    if (processing_status == StreamService::ProcessingStatus::Overloaded) {
+      auto factory = protocol->GetMessageFactory();
+      if (auto msg = factory->Create(MessageFactory::Type::Overloaded, cid)) {
+        WriteMessage(*msg, protocol, controller, cid);
+      }
+    } else if (processing_status ==
+               StreamService::ProcessingStatus::Completed) {
+      owner_->OnConnectionClosed(ctx_->id);
+    }
+  });
+}
+
+void NormalConnectionHandler::NotifyStream(std::unique_ptr<Message> msg) {
+  auto cid = msg->GetCorrelationId();
+  std::shared_ptr<rpc::internal::StreamIoAdaptor> stream;
+  {
+    std::scoped_lock _(lock_);
+    if (auto iter = streams_.find(cid); iter != streams_.end()) {
+      stream = iter->second.lock();
+    }
+  }
+  if (FLARE_UNLIKELY(!stream)) {
+    // The service may have finished the stream before the caller does.
+    FLARE_VLOG(10, "Message #{} of an unknown stream is dropped.", cid);
+    return;
+  }
+  stream->NotifyRead(std::move(msg));
+}
+
+void NormalConnectionHandler::BreakAllStreams() {
+  std::vector<std::shared_ptr<rpc::internal::StreamIoAdaptor>> streams;
+  {
+    std::scoped_lock _(lock_);
+    for (auto&& [_, e] : streams_) {
+      if (auto ptr = e.lock()) {
+        streams.push_back(std::move(ptr));
+      }
+    }
+  }
+  for (auto&& e : streams) {
+    e->NotifyError();
+  }
+}
 
 void NormalConnectionHandler::ServiceOverloaded(std::unique_ptr<Message> msg,
                                                 StreamProtocol* protocol,
@@ -364,8 +552,11 @@ void NormalConnectionHandler::PrepareForRpc(
 
 }
 
-void NormalConnectionHandler::WaitForRpcCompletion() {}
 
+bool NormalConnectionHandler::MayRunInline() const {
+  return std::any_of(ctx_->services.begin(), ctx_->services.end(),
+                     [](auto&& e) { return e->MayRunInline(); });
+}
 
 bool NormalConnectionHandler::OnNewCall() {
   if (!owner_->OnNewCall()) {
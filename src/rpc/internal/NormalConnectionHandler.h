@@ -7,6 +7,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "CallHandoff.h"
 #include "ServerConnectionHandler.h"
 #include "../protocol/StreamProtocol.h"
 #include "../protocol/StreamService.h"
@@ -18,6 +19,12 @@ class Server;
 
 }  // namespace flare
 
+namespace tinyRPC::rpc::internal {
+
+class StreamIoAdaptor;
+
+}  // namespace tinyRPC::rpc::internal
+
 namespace tinyRPC::rpc::detail {
 
 class NormalConnectionHandler : public ServerConnectionHandler {
@@ -46,7 +53,7 @@ class NormalConnectionHandler : public ServerConnectionHandler {
   void OnWriteBufferEmpty() override;
   void OnDataWritten(std::uintptr_t ctx) override;
 
-  DataConsumptionStatus OnDataArrival(std::string& buffer) override;
+  DataConsumptionStatus OnDataArrival(NoncontiguousBuffer& buffer) override;
 
   void OnClose() override;
   void OnError() override;
@@ -54,18 +61,18 @@ class NormalConnectionHandler : public ServerConnectionHandler {
  private:
   enum class ProcessingStatus { Success, Error, Saturated, SuppressRead };
 
-  ProcessingStatus ProcessOnePacket(std::string& buffer,
+  ProcessingStatus ProcessOnePacket(NoncontiguousBuffer& buffer,
                                     std::uint64_t receive_tsc);
 
   // This method try cutting off a message using the protocol that had
   // succeeded.
   StreamProtocol::MessageCutStatus TryCutMessageUsingLastProtocol(
-      std::string& buffer, std::unique_ptr<Message>* msg,
+      NoncontiguousBuffer& buffer, std::unique_ptr<Message>* msg,
       StreamProtocol** used_protocol);
 
   // The method cut off a message without parsing it, to release CPU as soon as
   // possible.
-  ProcessingStatus TryCutMessage(std::string& buffer,
+  ProcessingStatus TryCutMessage(NoncontiguousBuffer& buffer,
                                  std::unique_ptr<Message>* msg,
                                  StreamProtocol** used_protocol);
 
@@ -80,13 +87,52 @@ class NormalConnectionHandler : public ServerConnectionHandler {
   std::size_t WriteMessage(const Message& msg, StreamProtocol* protocol,
                            Controller* controller, std::uintptr_t ctx) const;
 
-  // This method is executed in dedicated fiber, so blocking does not matter
-  // much.
+  // State of a fast call handed to `StreamService`. It's referenced by both
+  // `InvokeFastCall` and the service's `on_completion`, and freed (followed by
+  // `OnCallCompletion`) once both have released it.
+  struct FastCall : rpc::internal::CallHandoff<FastCall> {
+    std::unique_ptr<Message> msg;
+    std::unique_ptr<Controller> controller;
+    StreamService::Context context;
+    UniqueFunction<std::size_t(const Message&)> writer;
+  };
+
+  // This method is executed in dedicated fiber (unless `in_io_fiber` is set),
+  // so blocking does not matter much. The service may complete the call after
+  // this method returns though, `OnCallCompletion` is called once the call has
+  // finished.
+  //
+  // If `in_io_fiber` is set, the call is moved to a dedicated fiber once
+  // parsed, unless the service wants it to be run inline.
   //
   // Any (unrecoverable) failure in this method leads to packet drop.
   void ServiceFastCall(std::unique_ptr<Message>&& msg, StreamProtocol* protocol,
                        std::unique_ptr<Controller> controller,
-                       std::uint64_t receive_tsc, std::size_t pkt_size);
+                       std::uint64_t receive_tsc, std::size_t pkt_size,
+                       bool in_io_fiber);
+
+  // Calls `handler` to handle the parsed request in `call`.
+  void InvokeFastCall(FastCall* call, StreamService* handler,
+                      StreamProtocol* protocol,
+                      const StreamService::InspectionResult& inspection_result);
+
+  // Drops a reference to `call`.
+  void ReleaseFastCall(FastCall* call);
+
+  // Called in I/O fiber upon the first message of a stream. The stream is
+  // registered and served in a dedicated fiber.
+  void StartStreamCall(std::unique_ptr<Message> msg, StreamProtocol* protocol);
+
+  // Called in dedicated fiber. The stream is finished (and `OnCallCompletion`
+  // called) once the service drops its last reference to `stream`.
+  void ServiceStreamCall(std::shared_ptr<rpc::internal::StreamIoAdaptor> stream,
+                         StreamProtocol* protocol, Controller* controller);
+
+  // Feeds a message to the stream it belongs to.
+  void NotifyStream(std::unique_ptr<Message> msg);
+
+  // Break all streams on this connection, e.g., on connection error.
+  void BreakAllStreams();
 
   // In case the server is overloaded, both fast call & streaming call messages
   // are handled by this method.
@@ -105,13 +151,11 @@ class NormalConnectionHandler : public ServerConnectionHandler {
   void PrepareForRpc(const StreamService::InspectionResult& inspection_result,
                      const Controller& controller, F&& cb);
 
-  // Wait until the RPC has fully completed.
-  //
-  // This method usually immediately returns. However, if the user did some
-  // fire-and-forget operation, this method wait until all those (possibly
-  // asynchronous) operations finished.
-  void WaitForRpcCompletion();
 
+  // Returns `true` if any of the services may want to run calls in I/O fiber.
+  // Execution policies can be changed at any time, so this is asked for each
+  // call.
+  bool MayRunInline() const;
 
   // Called upon new RPC arrival. For streaming RPC, this is only called for the
   // first message in the stream.
@@ -158,6 +202,11 @@ class NormalConnectionHandler : public ServerConnectionHandler {
   // different pthread worker, albeit in the same fiber.).
   fiber::Mutex lock_;
 
+  // Streams being served, keyed by correlation ID. They're owned by fibers
+  // serving them.
+  std::unordered_map<std::uint64_t,
+                     std::weak_ptr<rpc::internal::StreamIoAdaptor>>
+      streams_;
 };
 
 }  // namespace tinyRPC::rpc::detail
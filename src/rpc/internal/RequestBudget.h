@@ -0,0 +1,64 @@
+#ifndef _SRC_RPC_INTERNAL_REQUEST_BUDGET_H_
+#define _SRC_RPC_INTERNAL_REQUEST_BUDGET_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "../../base/Logging.h"
+
+namespace tinyRPC::rpc::internal {
+
+// Caps "extra" requests (e.g., backup requests) to a ratio of "normal" ones,
+// so that they can't amplify an overload of the servers.
+//
+// This is a token bucket. Each normal request earns `ratio` token, and each
+// extra request costs one. At most `burst` tokens can be saved up. The bucket
+// starts full.
+//
+// Thread-safe.
+class RequestBudget {
+ public:
+  RequestBudget(double ratio, std::size_t burst)
+      : deposit_(std::max<std::int64_t>(ratio * kScale, 1)),
+        capacity_(burst * kScale),
+        tokens_(capacity_) {
+    FLARE_CHECK(ratio > 0, "Ratio must be positive.");
+  }
+
+  // Called for each normal request.
+  void Deposit() noexcept {
+    auto current = tokens_.load(std::memory_order_relaxed);
+    while (current < capacity_ &&
+           !tokens_.compare_exchange_weak(
+               current, std::min(current + deposit_, capacity_),
+               std::memory_order_relaxed)) {
+      // `current` is reloaded, retry.
+    }
+  }
+
+  // Returns `false` if there's no budget for an extra request.
+  bool TryWithdraw() noexcept {
+    auto current = tokens_.load(std::memory_order_relaxed);
+    while (current >= kScale) {
+      if (tokens_.compare_exchange_weak(current, current - kScale,
+                                        std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  // Tokens are kept in fixed point.
+  static constexpr std::int64_t kScale = 1000;
+
+  std::int64_t deposit_;
+  std::int64_t capacity_;
+  std::atomic<std::int64_t> tokens_;
+};
+
+}  // namespace tinyRPC::rpc::internal
+
+#endif
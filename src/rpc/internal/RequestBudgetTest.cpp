@@ -0,0 +1,57 @@
+#include "RequestBudget.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../../../include/gtest/gtest.h"
+
+namespace tinyRPC::rpc::internal {
+
+TEST(RequestBudget, Ratio) {
+  RequestBudget budget(0.1, 1);
+  EXPECT_TRUE(budget.TryWithdraw());  // Starts full.
+  EXPECT_FALSE(budget.TryWithdraw());
+  for (int i = 0; i != 9; ++i) {
+    budget.Deposit();
+    EXPECT_FALSE(budget.TryWithdraw());
+  }
+  budget.Deposit();
+  EXPECT_TRUE(budget.TryWithdraw());
+  EXPECT_FALSE(budget.TryWithdraw());
+}
+
+TEST(RequestBudget, Burst) {
+  RequestBudget budget(1, 3);
+  for (int i = 0; i != 100; ++i) {
+    budget.Deposit();
+  }
+  for (int i = 0; i != 3; ++i) {
+    EXPECT_TRUE(budget.TryWithdraw());
+  }
+  EXPECT_FALSE(budget.TryWithdraw());
+}
+
+TEST(RequestBudget, Concurrent) {
+  RequestBudget budget(0.5, 10);
+  std::atomic<int> withdrawn{};
+  std::vector<std::thread> ts;
+  for (int i = 0; i != 8; ++i) {
+    ts.emplace_back([&] {
+      for (int j = 0; j != 10000; ++j) {
+        budget.Deposit();
+        if (budget.TryWithdraw()) {
+          ++withdrawn;
+        }
+      }
+    });
+  }
+  for (auto&& t : ts) {
+    t.join();
+  }
+  // Initial burst plus half of the deposits.
+  EXPECT_LE(withdrawn, 10 + 8 * 10000 / 2);
+  EXPECT_GE(withdrawn, 8 * 10000 / 2);
+}
+
+}  // namespace tinyRPC::rpc::internal
@@ -30,7 +30,7 @@ StreamCallGate::~StreamCallGate() = default;
 void StreamCallGate::Open(const Endpoint& address, Options options) {
   options_ = std::move(options);
   endpoint_ = address;
-  correlation_map_ = GetCorrelationMapFor<std::shared_ptr<FastCallContext>>(
+  correlation_map_ = GetCorrelationMapFor<RefPtr<FastCallArgs>>(
       fiber::GetCurrentSchedulingGroupIndex());
 
   FLARE_CHECK(options_.protocol);
@@ -67,7 +67,7 @@ const StreamProtocol& StreamCallGate::GetProtocol() const {
   return *options_.protocol;
 }
 
-void StreamCallGate::FastCall(const Message& m, std::shared_ptr<FastCallArgs> args,
+void StreamCallGate::FastCall(const Message& m, RefPtr<FastCallArgs> args,
                               std::chrono::steady_clock::time_point timeout) {
   FLARE_CHECK_LE(m.GetCorrelationId(),
                  std::numeric_limits<std::uint32_t>::max(),
@@ -81,7 +81,7 @@ void StreamCallGate::FastCall(const Message& m, std::shared_ptr<FastCallArgs> ar
     //
     // The race is unlikely but possible:
     //
-    // 1. We allocated the context for this packet.
+    // 1. We inserted the context for this packet into the map.
     // 2. Before we finished initializing this context (and before we send this
     //    packet out), the remote side (possibly erroneously) sends us a packet
     //    with the same correlation ID this packet carries, and triggers
@@ -90,8 +90,8 @@ void StreamCallGate::FastCall(const Message& m, std::shared_ptr<FastCallArgs> ar
     //
     // In this case, we'd risk use-after-free when enabling the timeout timer
     // later.
-    std::unique_lock<fiber::Mutex> ctx_lock;
-    fiber::detail::TimerPtr timeout_timer = 0;
+    std::unique_lock ctx_lock(args->lock);
+    fiber::detail::TimerPtr timeout_timer;
 
     if (timeout != std::chrono::steady_clock::time_point::max()) {
       auto timeout_cb = [map = correlation_map_,
@@ -104,14 +104,12 @@ void StreamCallGate::FastCall(const Message& m, std::shared_ptr<FastCallArgs> ar
           fiber::internal::CreateTimer(timeout, std::move(timeout_cb));
     }
 
-    // Initialize call context in call map.
-    AllocateRpcContextFastCall(m.GetCorrelationId(), [&](FastCallContext* ctx) {
-      ctx_lock = std::unique_lock(ctx->lock);
-
-      ctx->timestamps.sent_tsc = ReadTsc();  // Not exactly.
-      ctx->timeout_timer = timeout_timer;
-      ctx->user_args = std::move(args);
-    });
+    // Initialize call context and put it into call map.
+    args->timestamps.sent_tsc = ReadTsc();  // Not exactly.
+    args->timeout_timer = timeout_timer;
+    correlation_map_->Insert(
+        MergeCorrelationId(conn_correlation_id_, m.GetCorrelationId()),
+        std::move(args));
     if (timeout_timer) {
       fiber::internal::EnableTimer(timeout_timer);
     }
@@ -127,10 +125,63 @@ void StreamCallGate::FastCall(const Message& m, std::shared_ptr<FastCallArgs> ar
   }
 }
 
-std::shared_ptr<StreamCallGate::FastCallArgs> StreamCallGate::CancelFastCall(
+RefPtr<StreamCallGate::FastCallArgs> StreamCallGate::CancelFastCall(
     std::uint32_t correlation_id) {
   auto ptr = TryReclaimRpcContextFastCall(correlation_id);
-  return ptr ? std::move(ptr->user_args) : nullptr;
+  if (ptr) {
+    {
+      // Make sure the context is fully initialized.
+      std::scoped_lock _(ptr->lock);
+    }
+    if (auto t = std::exchange(ptr->timeout_timer, nullptr)) {
+      fiber::internal::KillTimer(t);
+    }
+  }
+  return ptr;
+}
+
+std::shared_ptr<StreamIoAdaptor> StreamCallGate::StreamCall(
+    std::uint32_t correlation_id, std::shared_ptr<Controller> controller,
+    UniqueFunction<void()> on_close) {
+  StreamIoAdaptor::Operations ops = {
+      .write =
+          [this, controller](const Message& m) {
+            auto serialized = WriteMessage(m, controller.get());
+            return healthy_.load(std::memory_order_acquire) &&
+                   WriteOut(serialized, 0);
+          },
+      .parse =
+          [this, controller](std::unique_ptr<Message>* m) {
+            return options_.protocol->TryParse(m, controller.get());
+          },
+      .create_window_update =
+          [this, correlation_id](std::uint32_t consumed) {
+            return options_.protocol->GetMessageFactory()
+                ->CreateStreamWindowUpdate(correlation_id, consumed);
+          },
+      .on_close =
+          [this, correlation_id, on_close = std::move(on_close)] {
+            {
+              std::scoped_lock _(streams_lock_);
+              if (auto iter = streams_.find(correlation_id);
+                  iter != streams_.end() && iter->second.expired()) {
+                streams_.erase(iter);
+              }
+            }
+            on_close();
+          }};
+  auto stream = std::make_shared<StreamIoAdaptor>(
+      FLAGS_flare_rpc_stream_window_size, std::move(ops));
+  {
+    std::scoped_lock _(streams_lock_);
+    auto&& entry = streams_[correlation_id];
+    FLARE_CHECK(entry.expired(), "Duplicate stream #{}.", correlation_id);
+    entry = stream;
+  }
+  if (!healthy_) {
+    stream->NotifyError();
+  }
+  return stream;
 }
 
 bool StreamCallGate::InitializeConnection(const Endpoint& ep) {
@@ -153,6 +204,7 @@ bool StreamCallGate::InitializeConnection(const Endpoint& ep) {
 
   // Initialize connection.
   NativeStreamConnection::Options opts;
+  opts.handler = MaybeOwning(non_owning, this);
   opts.read_buffer_size = options_.maximum_packet_size;
   conn_ =
       std::make_shared<NativeStreamConnection>(std::move(fd), std::move(opts));
@@ -171,29 +223,17 @@ bool StreamCallGate::InitializeConnection(const Endpoint& ep) {
   return true;
 }
 
-bool StreamCallGate::WriteOut(std::string& buffer, std::uintptr_t ctx) {
+bool StreamCallGate::WriteOut(NoncontiguousBuffer& buffer, std::uintptr_t ctx) {
   return conn_->Write(std::move(buffer), ctx);
 }
 
-// Allocate a context associated with `correlation_id`. `f` is called to
-// initialize the context.
-template <class F>
-void StreamCallGate::AllocateRpcContextFastCall(std::uint32_t correlation_id,
-                                                F&& init) {
-  auto ptr = std::make_shared<FastCallContext>();
-  std::forward<F>(init)(&*ptr);
-
-  correlation_map_->Insert(
-      MergeCorrelationId(conn_correlation_id_, correlation_id), std::move(ptr));
-}
-
 // Reclaim rpc context if `correlation_id` is associated with a fast call,
 // otherwise `nullptr` is returned.
 //
 // Note that this method also returns `nullptr` if `correlation_id` does not
 // exist at all. This may somewhat degrade performance of processing
 // streams, we might optimize it some day later.
-std::shared_ptr<StreamCallGate::FastCallContext>
+RefPtr<StreamCallGate::FastCallArgs>
 StreamCallGate::TryReclaimRpcContextFastCall(std::uint32_t correlation_id) {
   return correlation_map_->Remove(
       MergeCorrelationId(conn_correlation_id_, correlation_id));
@@ -216,9 +256,7 @@ EventLoop* StreamCallGate::GetEventLoop() { return event_loop_; }
 
 // Called in dedicated fiber. Blocking is OK.
 void StreamCallGate::ServiceFastCallCompletion(std::unique_ptr<Message> msg,
-                                               std::shared_ptr<FastCallContext> ctx,
-                                               std::uint64_t tsc) {
-  ctx->timestamps.received_tsc = tsc;
+                                               RefPtr<FastCallArgs> ctx) {
   {
     // Wait until the context is fully initialized (if not yet).
     std::scoped_lock _(ctx->lock);
@@ -228,22 +266,17 @@ void StreamCallGate::ServiceFastCallCompletion(std::unique_ptr<Message> msg,
     fiber::internal::KillTimer(t);
   }
 
-  auto user_args = std::move(ctx->user_args);
-  auto cb = [&] {
-    auto ctlr = user_args->controller;
-    auto f = std::move(user_args->completion);
-    std::unique_ptr<Message> parsed =
-        options_.protocol->TryParse(&msg, ctlr) ? std::move(msg) : nullptr;
-
-    ctx->timestamps.parsed_tsc = ReadTsc();
-    if (parsed) {
-      f(CompletionStatus::Success, std::move(parsed), ctx->timestamps);
-    } else {
-      f(CompletionStatus::ParseError, nullptr, ctx->timestamps);
-    }
-  };
+  std::unique_ptr<Message> parsed =
+      options_.protocol->TryParse(&msg, ctx->controller) ? std::move(msg)
+                                                         : nullptr;
 
-    cb();
+  ctx->timestamps.parsed_tsc = ReadTsc();
+  if (parsed) {
+    ctx->OnCompletion(CompletionStatus::Success, std::move(parsed),
+                      ctx->timestamps);
+  } else {
+    ctx->OnCompletion(CompletionStatus::ParseError, nullptr, ctx->timestamps);
+  }
 
   // `*this` may not be touched since now as user's callback might have already
   // freed us.
@@ -251,10 +284,10 @@ void StreamCallGate::ServiceFastCallCompletion(std::unique_ptr<Message> msg,
 
 
 StreamConnectionHandler::DataConsumptionStatus StreamCallGate::OnDataArrival(
-    std::string& buffer) {
+    NoncontiguousBuffer& buffer) {
   auto arrival_tsc = ReadTsc();
   bool ever_suppressed = false;
-  while (!buffer.empty()) {
+  while (!buffer.Empty()) {
     std::unique_ptr<Message> m;
     auto rc = options_.protocol->TryCutMessage(buffer, &m);
 
@@ -287,14 +320,22 @@ StreamConnectionHandler::DataConsumptionStatus StreamCallGate::OnDataArrival(
             m->GetCorrelationId());
         continue;
       }
+      // Not protected by `ctx->lock`, but the context is not touched by
+      // anyone else until the fiber below is started.
+      ctx->timestamps.received_tsc = arrival_tsc;
       // FIXME: We need to wait for the callback to return before we could be
       // destroyed.
-      fiber::StartFiberDetached([this, tsc = arrival_tsc,
-                                           msg = std::move(m),
-                                           ctx = std::move(ctx)]() mutable {
-        ServiceFastCallCompletion(std::move(msg), std::move(ctx), tsc);
-      });
-    } 
+      fiber::StartFiberDetached(
+          [this, msg = std::move(m), ctx = std::move(ctx)]() mutable {
+            ServiceFastCallCompletion(std::move(msg), std::move(ctx));
+          });
+    } else if (auto stream = FindStream(correlation_id)) {
+      // Parsed by the reader, not here.
+      stream->NotifyRead(std::move(m));
+    } else {
+      // Timed out (or the stream was closed by us) in the mean time.
+      FLARE_VLOG(10, "Message #{} of unknown call is dropped.", correlation_id);
+    }
   }  // Loop until no more message could be cut off.
   return !ever_suppressed ? DataConsumptionStatus::Ready
                           : DataConsumptionStatus::SuppressRead;
@@ -303,15 +344,16 @@ StreamConnectionHandler::DataConsumptionStatus StreamCallGate::OnDataArrival(
 void StreamCallGate::OnAttach(StreamConnection*) {}
 void StreamCallGate::OnDetach() {}
 void StreamCallGate::OnWriteBufferEmpty() {}
+void StreamCallGate::OnDataWritten(std::uintptr_t ctx) {}
 void StreamCallGate::OnClose() { OnError(); }
 void StreamCallGate::OnError() {
   healthy_.store(false, std::memory_order_release);
   UnsafeRaiseErrorGlobally();
 }
 
-std::string StreamCallGate::WriteMessage(const Message& message,
+NoncontiguousBuffer StreamCallGate::WriteMessage(const Message& message,
                                                  Controller* controller) const {
-  std::string serialized;
+  NoncontiguousBuffer serialized;
 
   options_.protocol->WriteMessage(message, serialized, controller);
   return serialized;
@@ -320,7 +362,7 @@ std::string StreamCallGate::WriteMessage(const Message& message,
 // CAUTION: THIS METHOD CAN BE CALLED EITHER FROM PTHREAD CONTEXT (ON TIMEOUT)
 // OR FIBER CONTEXT (ON IO ERROR.).
 void StreamCallGate::RaiseErrorIfPresentFastCall(
-    CorrelationMap<std::shared_ptr<FastCallContext>>* map,
+    CorrelationMap<RefPtr<FastCallArgs>>* map,
     std::uint32_t conn_correlation_id, std::uint32_t rpc_correlation_id,
     CompletionStatus status) {
   auto ctx =
@@ -338,13 +380,7 @@ void StreamCallGate::RaiseErrorIfPresentFastCall(
     if (auto t = std::exchange(ctx->timeout_timer, nullptr)) {
       fiber::internal::KillTimer(t);
     }
-    auto user_args = std::move(ctx->user_args);
-    FLARE_CHECK(!!user_args->completion);
-    auto f = std::move(user_args->completion);
-    {
-      static Timestamps timeStamp;
-      f(status, nullptr, timeStamp);
-    }
+    ctx->OnCompletion(status, nullptr, {});
   });
 }
 
@@ -358,6 +394,28 @@ void StreamCallGate::UnsafeRaiseErrorGlobally() {
     RaiseErrorIfPresentFastCall(correlation_map_, conn_correlation_id_, c,
                                 CompletionStatus::IoError);
   }
+
+  std::vector<std::shared_ptr<StreamIoAdaptor>> streams;
+  {
+    std::scoped_lock _(streams_lock_);
+    for (auto&& e : streams_) {
+      if (auto ptr = e.second.lock()) {
+        streams.push_back(std::move(ptr));
+      }
+    }
+  }
+  for (auto&& e : streams) {
+    e->NotifyError();
+  }
+}
+
+std::shared_ptr<StreamIoAdaptor> StreamCallGate::FindStream(
+    std::uint32_t correlation_id) {
+  std::scoped_lock _(streams_lock_);
+  if (auto iter = streams_.find(correlation_id); iter != streams_.end()) {
+    return iter->second.lock();
+  }
+  return nullptr;
 }
 
 }  // namespace rpc::internal
@@ -13,12 +13,14 @@
 
 #include "../../base/Function.h"
 #include "../../base/MaybeOwning.h"
+#include "../../base/RefPtr.h"
 #include "../../base/Endpoint.h"
 #include "../../fiber/Mutex.h"
 #include "../../io/EventLoop.h"
 #include "../../io/native/StreamConnection.h"
 #include "CorrelationID.h"
 #include "CorrelationMap.h"
+#include "StreamIoAdaptor.h"
 #include "../protocol/Message.h"
 #include "../protocol/Controller.h"
 #include "../protocol/StreamProtocol.h"
@@ -46,14 +48,36 @@ class StreamCallGate : public StreamConnectionHandler {
   // Final status of an RPC.
   enum class CompletionStatus { Success, IoError, ParseError, Timeout };
 
-  // Arguments for making a fast call.
-  struct FastCallArgs {
-    // `msg_on_success` is applicable only if `status` is `Success`.
-    UniqueFunction<void(CompletionStatus status, MessagePtr msg_on_success,
-                  const Timestamps& timestamps)> completion;
+  // Arguments for making a fast call, and the state of the call.
+  //
+  // The caller derives from this class to keep whatever else it needs for the
+  // call in the same object, and frees it (e.g., returns it to an object pool)
+  // in `Destroy()`. This way the gate allocates nothing to keep track of the
+  // call.
+  class FastCallArgs : public RefCounted<FastCallArgs> {
+   public:
+    // Called upon completion. `msg_on_success` is applicable only if `status`
+    // is `Success`.
+    virtual void OnCompletion(CompletionStatus status,
+                              MessagePtr msg_on_success,
+                              const Timestamps& timestamps) = 0;
+
+    // Called when the last reference to this object is gone.
+    virtual void Destroy() noexcept = 0;
 
     // Passed to protocol object, opaque to us.
     Controller* controller;
+
+   protected:
+    virtual ~FastCallArgs() = default;
+
+   private:
+    friend class StreamCallGate;
+
+    // Used by the call gate.
+    fiber::Mutex lock;
+    tinyRPC::fiber::detail::TimerPtr timeout_timer;
+    Timestamps timestamps{};
   };
 
   struct Options {
@@ -92,15 +116,24 @@ class StreamCallGate : public StreamConnectionHandler {
   //
   // 64-bit correlation ID is NOT supported. AFAICT we don't generate 64-bit
   // correlation ID in our system.
-  void FastCall(const Message& m, std::shared_ptr<FastCallArgs> args,
+  void FastCall(const Message& m, RefPtr<FastCallArgs> args,
                 std::chrono::steady_clock::time_point timeout);
 
-  // Cancel a previous call to `FastCall`.
+  // Cancel a previous call to `FastCall`. The call won't be completed then.
   //
   // Returns `nullptr` is the call has already been completed (e.g., by
   // receiving its response from network).
-  std::shared_ptr<FastCallArgs> CancelFastCall(std::uint32_t correlation_id);
+  RefPtr<FastCallArgs> CancelFastCall(std::uint32_t correlation_id);
 
+  // Starts a stream. Messages carrying `correlation_id` are routed to the
+  // stream returned until it's destroyed. `on_close` is called (and destroyed)
+  // then.
+  //
+  // `controller` is passed to protocol object for parsing messages of the
+  // stream.
+  std::shared_ptr<StreamIoAdaptor> StreamCall(
+      std::uint32_t correlation_id, std::shared_ptr<Controller> controller,
+      UniqueFunction<void()> on_close);
 
  public:
   // Get event loop this gate is attached to.
@@ -111,20 +144,9 @@ class StreamCallGate : public StreamConnectionHandler {
  private:
   FRIEND_TEST(StreamCallGatePoolTest, RemoveBrokenGate);
 
-  struct FastCallContext {
-    fiber::Mutex lock;
-
-    std::uint64_t correlation_id;
-    tinyRPC::fiber::detail::TimerPtr timeout_timer;
-    Timestamps timestamps;
-    std::shared_ptr<FastCallArgs> user_args;
-  };
-
-
   // Called in dedicated fiber. Blocking is OK.
   void ServiceFastCallCompletion(std::unique_ptr<Message> msg,
-                                 std::shared_ptr<FastCallContext> ctx,
-                                 std::uint64_t tsc);
+                                 RefPtr<FastCallArgs> ctx);
 
   void OnAttach(StreamConnection*) override;  // Not cared.
   void OnDetach() override;                   // Not cared.
@@ -136,7 +158,7 @@ class StreamCallGate : public StreamConnectionHandler {
   void OnDataWritten(std::uintptr_t ctx) override;
 
   // Called upon new data is available.
-  DataConsumptionStatus OnDataArrival(std::string& buffer) override;
+  DataConsumptionStatus OnDataArrival(NoncontiguousBuffer& buffer) override;
 
   // Called upon remote close.  All outstanding RPCs are completed with error.
   void OnClose() override;
@@ -149,15 +171,7 @@ class StreamCallGate : public StreamConnectionHandler {
 
   // Write data out. This method also reconnect the underlying socket if it's
   // closed.
-  bool WriteOut(std::string& buffer, std::uintptr_t ctx);
-
-  // Allocate a context associated with `correlation_id`. `f` is called to
-  // initialize the context.
-  //
-  // Initialization of the new call context is sequenced before its insertion
-  // into the map.
-  template <class F>
-  void AllocateRpcContextFastCall(std::uint32_t correlation_id, F&& init);
+  bool WriteOut(NoncontiguousBuffer& buffer, std::uintptr_t ctx);
 
   // Reclaim rpc context if `correlation_id` is associated with a fast call,
   // otherwise `nullptr` is returned.
@@ -165,7 +179,7 @@ class StreamCallGate : public StreamConnectionHandler {
   // Note that this method also returns `nullptr` if `correlation_id` does not
   // exist at all. This may somewhat degrade performance of processing
   // streams, we might optimize it some day later.
-  std::shared_ptr<FastCallContext> TryReclaimRpcContextFastCall(
+  RefPtr<FastCallArgs> TryReclaimRpcContextFastCall(
       std::uint32_t correlation_id);
 
   // Traverse in-use fast-call correlations.
@@ -178,18 +192,21 @@ class StreamCallGate : public StreamConnectionHandler {
 
 
   // Serialize `message`.
-  std::string WriteMessage(const Message& message,
+  NoncontiguousBuffer WriteMessage(const Message& message,
                                    Controller* controller) const;
 
   // Raise an error if the corresponding RPC is found.
   static void RaiseErrorIfPresentFastCall(
-      CorrelationMap<std::shared_ptr<FastCallContext>>* map,
+      CorrelationMap<RefPtr<FastCallArgs>>* map,
       std::uint32_t conn_correlation_id, std::uint32_t rpc_correlation_id,
       CompletionStatus status);
 
   // Complete all on-going RPCs with failure status.
   void UnsafeRaiseErrorGlobally();
 
+  // Returns the stream `correlation_id` belongs to, if any.
+  std::shared_ptr<StreamIoAdaptor> FindStream(std::uint32_t correlation_id);
+
 
  private:
   Options options_{};
@@ -200,7 +217,23 @@ class StreamCallGate : public StreamConnectionHandler {
 
   // Connection correlation ID. Fast-calls need this to access correlation map.
   std::uint32_t conn_correlation_id_{NewConnectionCorrelationId()};
-  CorrelationMap<std::shared_ptr<FastCallContext>>* correlation_map_;
+  CorrelationMap<RefPtr<FastCallArgs>>* correlation_map_;
+
+  // Streams are far less common than fast calls, a plain map suffices. They're
+  // owned by their readers / writers.
+  fiber::Mutex streams_lock_;
+  std::unordered_map<std::uint32_t, std::weak_ptr<StreamIoAdaptor>> streams_;
+};
+
+}  // namespace tinyRPC::rpc::internal
+
+namespace tinyRPC {
+
+template <>
+struct RefTraits<rpc::internal::StreamCallGate::FastCallArgs> {
+  static void Destroy(rpc::internal::StreamCallGate::FastCallArgs* ptr) {
+    ptr->Destroy();
+  }
 };
 
 }  // namespace tinyRPC
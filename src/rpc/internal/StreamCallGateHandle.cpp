@@ -14,7 +14,7 @@
 #include "../../fiber/ThisFiber.h"
 #include "../../io/EventLoop.h"
 #include "StreamCallGate.h"
-#include "StreamCallGateHandle.h"
+#include "StreamCallGatePool.h"
 
 DEFINE_int32(flare_rpc_client_max_connections_per_server, 8,
              "Maximum connections per server. This number is round down to "
@@ -41,13 +41,35 @@ StreamCallGateHandle::StreamCallGateHandle() = default;
 StreamCallGateHandle::StreamCallGateHandle(std::shared_ptr<StreamCallGate> p)
     : ptr_(std::move(p)) {}
 
+StreamCallGateHandle::StreamCallGateHandle(StreamCallGatePool* owner,
+                                           std::shared_ptr<StreamCallGate> p)
+    : owner_(owner), ptr_(std::move(p)) {}
+
 StreamCallGateHandle::~StreamCallGateHandle() { Close(); }
 
-StreamCallGateHandle::StreamCallGateHandle(StreamCallGateHandle&&) noexcept =
-    default;
+StreamCallGateHandle::StreamCallGateHandle(
+    StreamCallGateHandle&& other) noexcept
+    : owner_(std::exchange(other.owner_, nullptr)),
+      ptr_(std::move(other.ptr_)) {}
+
 StreamCallGateHandle& StreamCallGateHandle::operator=(
-    StreamCallGateHandle&&) noexcept = default;
+    StreamCallGateHandle&& other) noexcept {
+  if (this != &other) {
+    Close();
+    owner_ = std::exchange(other.owner_, nullptr);
+    ptr_ = std::move(other.ptr_);
+  }
+  return *this;
+}
 
-void StreamCallGateHandle::Close() noexcept {}
+void StreamCallGateHandle::Close() noexcept {
+  if (!ptr_) {
+    return;
+  }
+  if (owner_) {
+    owner_->Release(std::move(ptr_));
+  }
+  ptr_.reset();
+}
 
 }  // namespace tinyRPC::rpc::internal
@@ -1,5 +1,5 @@
-#ifndef _SRC_RPC_INTERNAL_STREAM_CALL_GATE_POOL_H_
-#define _SRC_RPC_INTERNAL_STREAM_CALL_GATE_POOL_H_
+#ifndef _SRC_RPC_INTERNAL_STREAM_CALL_GATE_HANDLE_H_
+#define _SRC_RPC_INTERNAL_STREAM_CALL_GATE_HANDLE_H_
 
 #include <chrono>
 #include <memory>
@@ -14,20 +14,25 @@
 
 DECLARE_int32(flare_rpc_client_max_connections_per_server);
 DECLARE_int32(flare_rpc_client_connection_max_idle);
+DECLARE_int32(flare_rpc_client_remove_idle_connection_interval);
 
 namespace tinyRPC::rpc::internal {
 
 class StreamCallGate;
+class StreamCallGatePool;
 
 // RAII wrapper for `StreamCallGate*`.
 class StreamCallGateHandle {
  public:
   StreamCallGateHandle();
 
-  // Note that you should only call `release` if the gate is still usable
-  // (`Healthy()` holds), otherwise you should free the gate instead of return
-  // it back to the pool.
+  // The gate is not owned by any pool, it's simply dropped on `Close()`.
   StreamCallGateHandle(std::shared_ptr<StreamCallGate> p);
+
+  // The gate is returned to `owner` on `Close()`. Should the gate have become
+  // unhealthy by then, `owner` evicts it.
+  StreamCallGateHandle(StreamCallGatePool* owner,
+                       std::shared_ptr<StreamCallGate> p);
   ~StreamCallGateHandle();
 
   // Move-able only.
@@ -42,9 +47,11 @@ class StreamCallGateHandle {
   StreamCallGate& operator*() const { return *Get(); }
   explicit operator bool() const noexcept { return !!Get(); }
 
+  // Return the gate to its pool (if any). The handle is empty afterwards.
   void Close() noexcept;
 
  private:
+  StreamCallGatePool* owner_ = nullptr;
   std::shared_ptr<StreamCallGate> ptr_;
 };
 
@@ -0,0 +1,197 @@
+#include "StreamCallGatePool.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "../../base/chrono.h"
+#include "../../fiber/Fiber.h"
+#include "../../fiber/Runtime.h"
+#include "../../fiber/ThisFiber.h"
+#include "../../fiber/Timer.h"
+
+using namespace std::literals;
+
+namespace tinyRPC::rpc::internal {
+
+namespace {
+
+std::size_t GetMaxConnectionsPerEndpointPerGroup() {
+  // `FLAGS_flare_rpc_client_max_connections_per_server` applies to the whole
+  // process, and each scheduling group has its own pool.
+  auto per_group = FLAGS_flare_rpc_client_max_connections_per_server /
+                   fiber::GetSchedulingGroupCount();
+  return std::max<std::size_t>(per_group, 1);
+}
+
+}  // namespace
+
+StreamCallGatePool::StreamCallGatePool()
+    : max_conns_per_endpoint_(GetMaxConnectionsPerEndpointPerGroup()) {
+  purge_timer_ = fiber::SetTimer(
+      ReadSteadyClock(),
+      FLAGS_flare_rpc_client_remove_idle_connection_interval * 1s,
+      [this] { OnPurgeTimer(); });
+}
+
+StreamCallGatePool::~StreamCallGatePool() {
+  if (purge_timer_) {
+    fiber::KillTimer(std::exchange(purge_timer_, nullptr));
+  }
+}
+
+std::size_t StreamCallGatePool::GetConnectionCount(const Endpoint& key) const {
+  std::shared_lock lk(lock_);
+  auto iter = gates_.find(key);
+  return iter == gates_.end() ? 0 : iter->second.size();
+}
+
+void StreamCallGatePool::Stop() {
+  if (purge_timer_) {
+    fiber::KillTimer(std::exchange(purge_timer_, nullptr));
+  }
+
+  std::unordered_map<Endpoint, std::vector<std::shared_ptr<GateDesc>>> gates;
+  {
+    std::scoped_lock lk(lock_);
+    gates.swap(gates_);
+  }
+  std::vector<std::shared_ptr<StreamCallGate>> destroying;
+  for (auto&& [_, descs] : gates) {
+    for (auto&& e : descs) {
+      destroying.push_back(std::move(e->gate));
+    }
+  }
+  DestroyGatesAsync(std::move(destroying));
+}
+
+void StreamCallGatePool::Join() {
+  while (destroying_.load(std::memory_order_acquire)) {
+    this_fiber::SleepFor(10ms);
+  }
+}
+
+void StreamCallGatePool::Release(std::shared_ptr<StreamCallGate> gate) {
+  if (FLARE_LIKELY(gate->Healthy())) {
+    // Shared gates are kept in the pool all the time, dropping our ref. is
+    // enough.
+    return;
+  }
+
+  // The gate is broken, evict it (if it has not been evicted yet.).
+  std::vector<std::shared_ptr<StreamCallGate>> destroying;
+  {
+    std::scoped_lock lk(lock_);
+    auto iter = gates_.find(gate->GetEndpoint());
+    if (iter == gates_.end()) {
+      return;
+    }
+    auto&& descs = iter->second;
+    for (auto it = descs.begin(); it != descs.end(); ++it) {
+      if ((*it)->gate == gate) {
+        destroying.push_back(std::move((*it)->gate));
+        descs.erase(it);
+        break;
+      }
+    }
+    if (descs.empty()) {
+      gates_.erase(iter);
+    }
+  }
+  DestroyGatesAsync(std::move(destroying));
+}
+
+void StreamCallGatePool::UnsafeRemoveBrokenGates(
+    std::vector<std::shared_ptr<GateDesc>>* gates) {
+  std::vector<std::shared_ptr<StreamCallGate>> destroying;
+  auto iter = std::remove_if(gates->begin(), gates->end(), [&](auto&& e) {
+    if (e->gate->Healthy()) {
+      return false;
+    }
+    destroying.push_back(std::move(e->gate));
+    return true;
+  });
+  gates->erase(iter, gates->end());
+  DestroyGatesAsync(std::move(destroying));
+}
+
+void StreamCallGatePool::OnPurgeTimer() {
+  auto expires_at =
+      ReadSteadyClock() - FLAGS_flare_rpc_client_connection_max_idle * 1s;
+  std::vector<std::shared_ptr<StreamCallGate>> destroying;
+  {
+    std::scoped_lock lk(lock_);
+    for (auto iter = gates_.begin(); iter != gates_.end();) {
+      auto&& descs = iter->second;
+      auto removing = std::remove_if(descs.begin(), descs.end(), [&](auto&& e) {
+        if (e->gate->Healthy() &&
+            e->last_used.load(std::memory_order_relaxed) >= expires_at) {
+          return false;
+        }
+        destroying.push_back(std::move(e->gate));
+        return true;
+      });
+      descs.erase(removing, descs.end());
+      if (descs.empty()) {
+        iter = gates_.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+  }
+  if (!destroying.empty()) {
+    FLARE_VLOG(10, "Removing {} broken or idle call gates.",
+               destroying.size());
+  }
+  DestroyGatesAsync(std::move(destroying));
+}
+
+void StreamCallGatePool::DestroyGatesAsync(
+    std::vector<std::shared_ptr<StreamCallGate>> gates) {
+  if (gates.empty()) {
+    return;
+  }
+  destroying_.fetch_add(1, std::memory_order_relaxed);
+  fiber::StartFiberDetached([this, gates = std::move(gates)] {
+    for (auto&& e : gates) {
+      e->Stop();
+    }
+    for (auto&& e : gates) {
+      e->Join();
+    }
+    destroying_.fetch_sub(1, std::memory_order_release);
+  });
+}
+
+StreamCallGatePool* GetGlobalStreamCallGatePool(const std::string& key) {
+  // Each worker thread belongs to exactly one scheduling group, so it's safe
+  // to cache the result thread-locally.
+  thread_local std::unordered_map<std::string, StreamCallGatePool*> cache;
+  if (auto iter = cache.find(key); FLARE_LIKELY(iter != cache.end())) {
+    return iter->second;
+  }
+
+  struct PoolsOfGroup {
+    std::mutex lock;
+    std::unordered_map<std::string, std::unique_ptr<StreamCallGatePool>> pools;
+  };
+  // Intentionally leaked, gates may still be in use on exit.
+  static auto pools_of_groups = new std::vector<PoolsOfGroup>(
+      fiber::GetSchedulingGroupCount());
+
+  auto&& pools = (*pools_of_groups)[fiber::GetCurrentSchedulingGroupIndex()];
+  std::scoped_lock lk(pools.lock);
+  auto&& pool = pools.pools[key];
+  if (FLARE_UNLIKELY(!pool)) {
+    pool = std::make_unique<StreamCallGatePool>();
+  }
+  return cache[key] = pool.get();
+}
+
+}  // namespace tinyRPC::rpc::internal
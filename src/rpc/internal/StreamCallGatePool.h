@@ -0,0 +1,169 @@
+#ifndef _SRC_RPC_INTERNAL_STREAM_CALL_GATE_POOL_H_
+#define _SRC_RPC_INTERNAL_STREAM_CALL_GATE_POOL_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest_prod.h"
+
+#include "../../base/chrono.h"
+#include "../../base/Endpoint.h"
+#include "../../base/Likely.h"
+#include "../../base/Logging.h"
+#include "../../fiber/Timer.h"
+#include "StreamCallGate.h"
+#include "StreamCallGateHandle.h"
+
+namespace tinyRPC::rpc::internal {
+
+// This class pools multiplexed call gates, keyed by their remote endpoints.
+//
+// Since correlation IDs are used to match responses with requests, a single
+// gate can carry many outstanding RPCs at the same time. Therefore gates
+// returned by this pool are shared between callers. At most
+// `GetMaxConnectionsPerEndpoint()` gates are opened to a given endpoint.
+//
+// Gates that turned unhealthy or have been idle for too long are evicted.
+//
+// Each scheduling group has its own pool (per protocol), see
+// `GetGlobalStreamCallGatePool` below.
+//
+// Thread-safe.
+class StreamCallGatePool {
+ public:
+  StreamCallGatePool();
+  ~StreamCallGatePool();
+
+  // Get a (possibly shared) gate to `key`. `creator` is called to open a new
+  // gate if there are not enough gates to `key` yet.
+  //
+  // The gate returned is NOT guaranteed to be healthy (e.g., we failed to
+  // connect to `key`), it's the caller's responsibility to check it.
+  template <class F>
+  StreamCallGateHandle GetOrCreateShared(const Endpoint& key, F&& creator);
+
+  // Number of gates currently opened to `key`.
+  std::size_t GetConnectionCount(const Endpoint& key) const;
+
+  // Upper limit of gates that may be opened to a single endpoint. This is
+  // derived from `FLAGS_flare_rpc_client_max_connections_per_server`.
+  std::size_t GetMaxConnectionsPerEndpoint() const noexcept {
+    return max_conns_per_endpoint_;
+  }
+
+  // Close all gates in this pool. Outstanding RPCs are completed with
+  // `IoError`.
+  void Stop();
+  void Join();
+
+ private:
+  FRIEND_TEST(StreamCallGatePoolTest, RemoveBrokenGate);
+  friend class StreamCallGateHandle;
+
+  struct GateDesc {
+    std::shared_ptr<StreamCallGate> gate;
+    std::atomic<std::chrono::steady_clock::time_point> last_used{
+        ReadSteadyClock()};
+  };
+
+  // Called by `StreamCallGateHandle::Close()` upon the caller is done with
+  // `gate`.
+  void Release(std::shared_ptr<StreamCallGate> gate);
+
+  // Slow path of `GetOrCreateShared`. Evicts broken gates to `key` and opens
+  // a new one if there's still room.
+  template <class F>
+  StreamCallGateHandle GetOrCreateSharedSlow(const Endpoint& key, F&& creator);
+
+  // Remove broken gates in `gates`. The lock must be held by the caller.
+  void UnsafeRemoveBrokenGates(std::vector<std::shared_ptr<GateDesc>>* gates);
+
+  // Called periodically to remove broken / idle gates.
+  void OnPurgeTimer();
+
+  // Gates removed from the pool are stopped and joined asynchronously, as
+  // joining a gate may block.
+  void DestroyGatesAsync(std::vector<std::shared_ptr<StreamCallGate>> gates);
+
+ private:
+  const std::size_t max_conns_per_endpoint_;
+  fiber::detail::TimerPtr purge_timer_;
+
+  mutable std::shared_mutex lock_;
+  std::unordered_map<Endpoint, std::vector<std::shared_ptr<GateDesc>>> gates_;
+
+  // Gates that have been removed from `gates_` but not fully destroyed yet.
+  std::atomic<std::size_t> destroying_{0};
+};
+
+// Get call gate pool associated with `key` (usually protocol name) of the
+// scheduling group the calling thread belongs to.
+//
+// Pools returned by this method are never destroyed.
+StreamCallGatePool* GetGlobalStreamCallGatePool(const std::string& key);
+
+//////////////////////////////////////////
+// Implementation goes below.           //
+//////////////////////////////////////////
+
+template <class F>
+StreamCallGateHandle StreamCallGatePool::GetOrCreateShared(const Endpoint& key,
+                                                           F&& creator) {
+  // Gates are used in round-robin fashion once the limit is reached.
+  thread_local std::size_t next = 0;
+
+  {
+    std::shared_lock lk(lock_);
+    auto iter = gates_.find(key);
+    if (FLARE_LIKELY(iter != gates_.end() &&
+                     iter->second.size() >= max_conns_per_endpoint_)) {
+      auto&& desc = iter->second[next++ % iter->second.size()];
+      if (FLARE_LIKELY(desc->gate->Healthy())) {
+        desc->last_used.store(ReadSteadyClock(),
+                              std::memory_order_relaxed);
+        return StreamCallGateHandle(this, desc->gate);
+      }
+    }
+  }
+  return GetOrCreateSharedSlow(key, std::forward<F>(creator));
+}
+
+template <class F>
+StreamCallGateHandle StreamCallGatePool::GetOrCreateSharedSlow(
+    const Endpoint& key, F&& creator) {
+  std::unique_lock lk(lock_);
+  auto&& gates = gates_[key];
+  UnsafeRemoveBrokenGates(&gates);
+
+  if (gates.size() < max_conns_per_endpoint_) {
+    // Opening a gate does not block (connection is established
+    // asynchronously), so it's fine to do it with the lock held.
+    auto desc = std::make_shared<GateDesc>();
+    desc->gate = std::forward<F>(creator)();
+    FLARE_CHECK(desc->gate->GetEndpoint() == key);
+    if (!desc->gate->Healthy()) {
+      // Not pooled. The caller will see its failure on calling it.
+      return StreamCallGateHandle(this, std::move(desc->gate));
+    }
+    gates.push_back(desc);
+    return StreamCallGateHandle(this, desc->gate);
+  }
+
+  // Someone else opened the gates for us in the mean time.
+  thread_local std::size_t next = 0;
+  auto&& desc = gates[next++ % gates.size()];
+  desc->last_used.store(ReadSteadyClock(), std::memory_order_relaxed);
+  return StreamCallGateHandle(this, desc->gate);
+}
+
+}  // namespace tinyRPC::rpc::internal
+
+#endif
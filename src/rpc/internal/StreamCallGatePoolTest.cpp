@@ -0,0 +1,156 @@
+#include "StreamCallGatePool.h"
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "../../../include/gtest/gtest.h"
+
+#include "../../io/util/Socket.h"
+#include "../../testing/Endpoint.h"
+#include "../../testing/main.h"
+
+namespace tinyRPC::rpc::internal {
+
+namespace {
+
+// No message is ever exchanged in these tests.
+class NullProtocol : public StreamProtocol {
+ public:
+  const Characteristics& GetCharacteristics() const override {
+    static const Characteristics characteristics = {.name = "null"};
+    return characteristics;
+  }
+  const MessageFactory* GetMessageFactory() const override { return nullptr; }
+  const ControllerFactory* GetControllerFactory() const override {
+    return nullptr;
+  }
+  MessageCutStatus TryCutMessage(NoncontiguousBuffer& buffer,
+                                 std::unique_ptr<Message>* message) override {
+    return MessageCutStatus::Error;
+  }
+  bool TryParse(std::unique_ptr<Message>* message,
+                Controller* controller) override {
+    return false;
+  }
+  void WriteMessage(const Message& message, NoncontiguousBuffer& buffer,
+                    Controller* controller) override {}
+};
+
+// Connections to it are accepted by the kernel, and never read.
+struct Listener {
+  Endpoint addr = testing::PickAvailableEndpoint();
+  Handle fd = io::util::CreateListener(addr, 100);
+};
+
+// Opens gates to `addr`, counting gates opened in `*created`.
+auto GateCreator(const Endpoint& addr, int* created) {
+  return [addr, created] {
+    ++*created;
+    auto gate = std::make_shared<StreamCallGate>();
+    StreamCallGate::Options opts;
+    opts.protocol = std::make_unique<NullProtocol>();
+    opts.maximum_packet_size = 4096;
+    gate->Open(addr, std::move(opts));
+    return gate;
+  };
+}
+
+}  // namespace
+
+TEST(StreamCallGatePoolTest, ShareGates) {
+  Listener listener;
+  StreamCallGatePool pool;
+  auto max_gates = pool.GetMaxConnectionsPerEndpoint();
+  int created = 0;
+
+  {
+    std::vector<StreamCallGateHandle> handles;
+    std::unordered_set<StreamCallGate*> gates;
+    for (std::size_t i = 0; i != max_gates * 4; ++i) {
+      handles.push_back(pool.GetOrCreateShared(
+          listener.addr, GateCreator(listener.addr, &created)));
+      ASSERT_TRUE(handles.back()->Healthy());
+      gates.insert(handles.back().Get());
+    }
+    // Opened up to the limit, and shared afterwards.
+    EXPECT_EQ(max_gates, created);
+    EXPECT_EQ(max_gates, gates.size());
+    EXPECT_EQ(max_gates, pool.GetConnectionCount(listener.addr));
+  }
+
+  // Still pooled after all handles are closed.
+  EXPECT_EQ(max_gates, pool.GetConnectionCount(listener.addr));
+  pool.GetOrCreateShared(listener.addr, GateCreator(listener.addr, &created));
+  EXPECT_EQ(max_gates, created);
+
+  pool.Stop();
+  pool.Join();
+  EXPECT_EQ(0, pool.GetConnectionCount(listener.addr));
+}
+
+TEST(StreamCallGatePoolTest, PerEndpointLimit) {
+  Listener listener1, listener2;
+  StreamCallGatePool pool;
+  auto max_gates = pool.GetMaxConnectionsPerEndpoint();
+  int created1 = 0, created2 = 0;
+
+  for (std::size_t i = 0; i != max_gates * 4; ++i) {
+    pool.GetOrCreateShared(listener1.addr,
+                           GateCreator(listener1.addr, &created1));
+  }
+  EXPECT_EQ(max_gates, created1);
+  EXPECT_EQ(0, pool.GetConnectionCount(listener2.addr));
+
+  // Gates to another endpoint are not limited by those to `listener1`.
+  for (std::size_t i = 0; i != max_gates * 4; ++i) {
+    pool.GetOrCreateShared(listener2.addr,
+                           GateCreator(listener2.addr, &created2));
+  }
+  EXPECT_EQ(max_gates, created2);
+  EXPECT_EQ(max_gates, pool.GetConnectionCount(listener1.addr));
+  EXPECT_EQ(max_gates, pool.GetConnectionCount(listener2.addr));
+
+  pool.Stop();
+  pool.Join();
+}
+
+TEST(StreamCallGatePoolTest, RemoveBrokenGate) {
+  Listener listener;
+  StreamCallGatePool pool;
+  auto max_gates = pool.GetMaxConnectionsPerEndpoint();
+  int created = 0;
+  auto creator = GateCreator(listener.addr, &created);
+
+  std::vector<StreamCallGateHandle> handles;
+  for (std::size_t i = 0; i != max_gates; ++i) {
+    handles.push_back(pool.GetOrCreateShared(listener.addr, creator));
+  }
+  ASSERT_EQ(max_gates, created);
+
+  // Closed by the remote side. It's evicted once the caller is done with it.
+  handles[0]->OnClose();
+  EXPECT_FALSE(handles[0]->Healthy());
+  handles[0].Close();
+  EXPECT_EQ(max_gates - 1, pool.GetConnectionCount(listener.addr));
+
+  // A new one is opened in its place.
+  for (std::size_t i = 0; i != max_gates * 4; ++i) {
+    EXPECT_TRUE(pool.GetOrCreateShared(listener.addr, creator)->Healthy());
+  }
+  EXPECT_EQ(max_gates + 1, created);
+  EXPECT_EQ(max_gates, pool.GetConnectionCount(listener.addr));
+
+  // Broken gates still in use are evicted by the purge timer.
+  handles[1]->OnError();
+  pool.OnPurgeTimer();
+  EXPECT_EQ(max_gates - 1, pool.GetConnectionCount(listener.addr));
+
+  handles.clear();
+  pool.Stop();
+  pool.Join();
+}
+
+}  // namespace tinyRPC::rpc::internal
+
+TINYRPC_TEST_MAIN
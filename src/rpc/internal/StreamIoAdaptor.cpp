@@ -0,0 +1,179 @@
+#include "StreamIoAdaptor.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "gflags/gflags.h"
+
+#include "../../base/Logging.h"
+
+DEFINE_int32(flare_rpc_stream_window_size, 64,
+             "Number of messages either side of a stream may send before they "
+             "are consumed by the other side. Both the client and the server "
+             "must use the same value.");
+
+namespace tinyRPC::rpc::internal {
+
+StreamIoAdaptor::StreamIoAdaptor(std::uint32_t window, Operations ops)
+    : window_(window), ops_(std::move(ops)), send_credits_(window) {
+  FLARE_CHECK_GT(window_, 0);
+}
+
+StreamIoAdaptor::~StreamIoAdaptor() {
+  if (ops_.on_close) {
+    ops_.on_close();
+  }
+}
+
+void StreamIoAdaptor::SetExpiration(
+    std::chrono::steady_clock::time_point expires_at) {
+  std::scoped_lock _(lock_);
+  expires_at_ = expires_at;
+}
+
+void StreamIoAdaptor::NotifyRead(std::unique_ptr<Message> msg) {
+  std::scoped_lock _(lock_);
+  if (auto n = msg->GetStreamWindowUpdate()) {
+    send_credits_ += n;
+    cv_.notify_all();
+    return;
+  }
+  if (FLARE_UNLIKELY(remote_closed_)) {
+    FLARE_LOG_WARNING_ONCE(
+        "Message #{} arrived after the stream has been closed by the peer. "
+        "Dropped.",
+        msg->GetCorrelationId());
+    return;
+  }
+  auto type = msg->GetType();
+  if ((type & Message::Type::Stream) != Message::Type::Stream ||
+      (type & Message::Type::EndOfStream) == Message::Type::EndOfStream) {
+    remote_closed_ = true;
+  }
+  received_.push_back(std::move(msg));
+  cv_.notify_all();
+}
+
+void StreamIoAdaptor::NotifyError() {
+  std::scoped_lock _(lock_);
+  if (!broken_) {
+    broken_ = true;
+    error_ = Error::IoError;
+  }
+  cv_.notify_all();
+}
+
+Message* StreamIoAdaptor::Peek(Error* error) {
+  if (!peeked_) {
+    peeked_ = ReadAndParse(error);
+  }
+  return peeked_.get();
+}
+
+std::unique_ptr<Message> StreamIoAdaptor::Read(Error* error) {
+  if (peeked_) {
+    return std::move(peeked_);
+  }
+  return ReadAndParse(error);
+}
+
+bool StreamIoAdaptor::Write(const Message& msg, bool end_of_stream,
+                            Error* error) {
+  {
+    std::unique_lock lk(lock_);
+    if (FLARE_UNLIKELY(local_closed_)) {
+      if (error) {
+        *error = Error::EndOfStream;
+      }
+      return false;
+    }
+    if (!WaitUntil(lk, [&] { return end_of_stream || send_credits_; }) ||
+        broken_) {
+      if (error) {
+        *error = error_;
+      }
+      return false;
+    }
+    if (!end_of_stream) {
+      --send_credits_;
+    }
+    local_closed_ = end_of_stream;
+  }
+
+  if (FLARE_UNLIKELY(!ops_.write(msg))) {
+    SetBroken(Error::IoError);
+    if (error) {
+      *error = Error::IoError;
+    }
+    return false;
+  }
+  return true;
+}
+
+template <class F>
+bool StreamIoAdaptor::WaitUntil(std::unique_lock<fiber::Mutex>& lk, F&& pred) {
+  auto satisfied = [&] { return broken_ || pred(); };
+  if (expires_at_ == std::chrono::steady_clock::time_point::max()) {
+    cv_.wait(lk, satisfied);
+    return true;
+  }
+  if (!cv_.wait_until(lk, expires_at_, satisfied)) {
+    broken_ = true;
+    error_ = Error::Timeout;
+    cv_.notify_all();
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<Message> StreamIoAdaptor::ReadAndParse(Error* error) {
+  std::unique_ptr<Message> msg;
+  std::uint32_t ack = 0;
+  {
+    std::unique_lock lk(lock_);
+    // Messages already received are still delivered if the stream is broken
+    // afterwards.
+    if (!WaitUntil(lk, [&] { return !received_.empty() || remote_closed_; }) ||
+        received_.empty()) {
+      if (error) {
+        *error = remote_closed_ ? Error::EndOfStream : error_;
+      }
+      return nullptr;
+    }
+    msg = std::move(received_.front());
+    received_.pop_front();
+
+    // Let the peer know we've made room for more messages. It won't send us
+    // anything once it has closed the stream, so don't bother then.
+    if (++consumed_ >= std::max<std::uint32_t>(window_ / 2, 1) &&
+        !remote_closed_) {
+      ack = std::exchange(consumed_, 0);
+    }
+  }
+
+  if (ack) {
+    if (auto update = ops_.create_window_update(ack)) {
+      (void)ops_.write(*update);  // Failure is detected by the writer.
+    }
+  }
+  if (FLARE_UNLIKELY(!ops_.parse(&msg))) {
+    FLARE_LOG_WARNING("Failed to parse message of the stream.");
+    SetBroken(Error::ParseError);
+    if (error) {
+      *error = Error::ParseError;
+    }
+    return nullptr;
+  }
+  return msg;
+}
+
+void StreamIoAdaptor::SetBroken(Error error) {
+  std::scoped_lock _(lock_);
+  if (!broken_) {
+    broken_ = true;
+    error_ = error;
+  }
+  cv_.notify_all();
+}
+
+}  // namespace tinyRPC::rpc::internal
@@ -0,0 +1,121 @@
+#ifndef _SRC_RPC_INTERNAL_STREAM_IO_ADAPTOR_H_
+#define _SRC_RPC_INTERNAL_STREAM_IO_ADAPTOR_H_
+
+#include <chrono>
+#include <deque>
+#include <memory>
+
+#include "gflags/gflags_declare.h"
+
+#include "../../base/Function.h"
+#include "../../fiber/ConditionalVariable.h"
+#include "../../fiber/Mutex.h"
+#include "../protocol/Message.h"
+
+DECLARE_int32(flare_rpc_stream_window_size);
+
+namespace tinyRPC::rpc::internal {
+
+// Bridges messages of a stream on a (likely multiplexed) connection and the
+// fibers reading / writing the stream. It's used by both `StreamCallGate` (for
+// calling streaming methods) and the server (for serving them), and knows
+// nothing about the protocol being used.
+//
+// Messages of the stream are fed by the connection via `NotifyRead`, in the I/O
+// fiber. They're buffered here (without being parsed) until someone `Read`s
+// them.
+//
+// Flow control: Each side may send at most `window` messages to its peer
+// before they're consumed by the peer. Once the reader has consumed half the
+// window, it tells its peer so by a "window update" message. Note that the
+// window counts messages, not bytes (the size of each message is limited by
+// maximum packet size anyway), and it's NOT negotiated. Both sides must agree
+// on its value (@sa: `FLAGS_flare_rpc_stream_window_size`).
+//
+// Thread-safe. A reader and a writer may use the adaptor concurrently, but
+// there shouldn't be more than one of each.
+class StreamIoAdaptor {
+ public:
+  // How the adaptor talks to the connection.
+  struct Operations {
+    // Writes a message out. Returns `false` on failure.
+    UniqueFunction<bool(const Message&)> write;
+
+    // Parses a message cut off by the protocol (@sa: `StreamProtocol`).
+    UniqueFunction<bool(std::unique_ptr<Message>*)> parse;
+
+    // Creates a window update message acknowledging `consumed` messages.
+    UniqueFunction<std::unique_ptr<Message>(std::uint32_t consumed)>
+        create_window_update;
+
+    // Called when the adaptor is destroyed. The owner should stop feeding it
+    // then.
+    UniqueFunction<void()> on_close;
+  };
+
+  // Why the stream can't be read / written any further.
+  enum class Error { EndOfStream, IoError, Timeout, ParseError };
+
+  StreamIoAdaptor(std::uint32_t window, Operations ops);
+  ~StreamIoAdaptor();
+
+  // Deadline of all subsequent reads / writes. Once it's reached, the stream
+  // is broken.
+  void SetExpiration(std::chrono::steady_clock::time_point expires_at);
+
+  // Called by the connection when a new message of the stream is received.
+  // Never blocks.
+  //
+  // A message that's not part of a stream (e.g., an "overloaded" response) is
+  // treated as the last one.
+  void NotifyRead(std::unique_ptr<Message> msg);
+
+  // Called by the connection upon error. Both directions are broken then,
+  // although messages already received can still be read.
+  void NotifyError();
+
+  // Blocks until the next message is available and returns it (parsed) without
+  // removing it from the stream. `nullptr` is returned if there won't be any
+  // more messages, the reason is saved in `error`.
+  Message* Peek(Error* error = nullptr);
+
+  // Same as `Peek` except that the message is removed from the stream.
+  std::unique_ptr<Message> Read(Error* error = nullptr);
+
+  // Writes `msg` out. This method blocks if the peer hasn't caught up.
+  //
+  // If `end_of_stream` is set, `msg` must be the last message written, and
+  // it's not subject to flow control.
+  bool Write(const Message& msg, bool end_of_stream, Error* error = nullptr);
+
+ private:
+  // Waits until `pred` holds or the stream expires, whichever comes first.
+  template <class F>
+  bool WaitUntil(std::unique_lock<fiber::Mutex>& lk, F&& pred);
+
+  std::unique_ptr<Message> ReadAndParse(Error* error);
+  void SetBroken(Error error);
+
+ private:
+  const std::uint32_t window_;
+  Operations ops_;
+
+  // Accessed by the reader only.
+  std::unique_ptr<Message> peeked_;
+  std::uint32_t consumed_ = 0;  // Not acknowledged yet.
+
+  fiber::Mutex lock_;
+  fiber::ConditionVariable cv_;
+  std::chrono::steady_clock::time_point expires_at_ =
+      std::chrono::steady_clock::time_point::max();
+  std::deque<std::unique_ptr<Message>> received_;  // Not parsed yet.
+  std::uint32_t send_credits_;
+  bool remote_closed_ = false;  // End-of-stream has been received.
+  bool local_closed_ = false;   // End-of-stream has been written.
+  bool broken_ = false;
+  Error error_;  // Applicable only if `broken_` is set.
+};
+
+}  // namespace tinyRPC::rpc::internal
+
+#endif
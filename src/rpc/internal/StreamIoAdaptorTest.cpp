@@ -0,0 +1,219 @@
+#include "StreamIoAdaptor.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include "../../../include/gtest/gtest.h"
+
+#include "../../fiber/Fiber.h"
+#include "../../fiber/Latch.h"
+#include "../../fiber/Testing.h"
+#include "../../fiber/ThisFiber.h"
+
+using namespace std::literals;
+
+namespace tinyRPC::rpc::internal {
+
+struct FakeMessage : Message {
+  FakeMessage(Type type, int value, std::uint32_t window_update = 0)
+      : type(type), value(value), window_update(window_update) {}
+
+  std::uint64_t GetCorrelationId() const noexcept override { return 1; }
+  Type GetType() const noexcept override { return type; }
+  std::uint32_t GetStreamWindowUpdate() const noexcept override {
+    return window_update;
+  }
+
+  Type type;
+  int value;  // Negative values fail parsing.
+  std::uint32_t window_update;
+};
+
+// Two adaptors talking to each other, as if they're on both ends of a
+// connection.
+struct StreamPair {
+  explicit StreamPair(std::uint32_t window) {
+    client = std::make_unique<StreamIoAdaptor>(window, MakeOps(&server));
+    server = std::make_unique<StreamIoAdaptor>(window, MakeOps(&client));
+  }
+
+  StreamIoAdaptor::Operations MakeOps(std::unique_ptr<StreamIoAdaptor>* peer) {
+    return {
+        .write =
+            [this, peer](const Message& m) {
+              ++messages_written;
+              (*peer)->NotifyRead(std::make_unique<FakeMessage>(
+                  static_cast<const FakeMessage&>(m)));
+              return true;
+            },
+        .parse =
+            [](std::unique_ptr<Message>* m) {
+              return static_cast<FakeMessage*>(m->get())->value >= 0;
+            },
+        .create_window_update =
+            [](std::uint32_t n) {
+              return std::make_unique<FakeMessage>(Message::Type::Stream, 0,
+                                                   n);
+            },
+        .on_close = [this] { ++closed; }};
+  }
+
+  std::atomic<int> messages_written{};
+  std::atomic<int> closed{};
+  std::unique_ptr<StreamIoAdaptor> client, server;
+};
+
+int ValueOf(const std::unique_ptr<Message>& msg) {
+  return static_cast<FakeMessage*>(msg.get())->value;
+}
+
+TEST(StreamIoAdaptor, ReadWrite) {
+  fiber::testing::RunAsFiber([] {
+    StreamPair pair(64);
+    for (int i = 0; i != 3; ++i) {
+      ASSERT_TRUE(pair.client->Write(
+          FakeMessage(i ? Message::Type::Stream : Message::Type::StartOfStream,
+                      i),
+          false));
+    }
+    ASSERT_TRUE(
+        pair.client->Write(FakeMessage(Message::Type::EndOfStream, 3), true));
+
+    // Nothing can be written after end-of-stream.
+    StreamIoAdaptor::Error error;
+    EXPECT_FALSE(
+        pair.client->Write(FakeMessage(Message::Type::Stream, 4), false, &error));
+    EXPECT_EQ(StreamIoAdaptor::Error::EndOfStream, error);
+
+    EXPECT_EQ(0, static_cast<FakeMessage*>(pair.server->Peek())->value);
+    for (int i = 0; i != 4; ++i) {
+      auto msg = pair.server->Read();
+      ASSERT_TRUE(msg);
+      EXPECT_EQ(i, ValueOf(msg));
+    }
+    EXPECT_FALSE(pair.server->Read(&error));
+    EXPECT_EQ(StreamIoAdaptor::Error::EndOfStream, error);
+
+    // The other direction is still open.
+    ASSERT_TRUE(
+        pair.server->Write(FakeMessage(Message::Type::EndOfStream, 5), true));
+    auto msg = pair.client->Read();
+    ASSERT_TRUE(msg);
+    EXPECT_EQ(5, ValueOf(msg));
+    EXPECT_FALSE(pair.client->Read(&error));
+    EXPECT_EQ(StreamIoAdaptor::Error::EndOfStream, error);
+
+    pair.client.reset();
+    pair.server.reset();
+    EXPECT_EQ(2, pair.closed);
+  });
+}
+
+TEST(StreamIoAdaptor, NonStreamMessageEndsStream) {
+  fiber::testing::RunAsFiber([] {
+    StreamPair pair(64);
+    // E.g., the server rejected the stream as it's overloaded.
+    pair.client->NotifyRead(
+        std::make_unique<FakeMessage>(Message::Type::Single, 1));
+    pair.client->NotifyRead(
+        std::make_unique<FakeMessage>(Message::Type::Stream, 2));  // Dropped.
+    ASSERT_TRUE(pair.client->Read());
+    StreamIoAdaptor::Error error;
+    EXPECT_FALSE(pair.client->Read(&error));
+    EXPECT_EQ(StreamIoAdaptor::Error::EndOfStream, error);
+  });
+}
+
+TEST(StreamIoAdaptor, FlowControl) {
+  fiber::testing::RunAsFiber([] {
+    constexpr auto kWindow = 4;
+    constexpr auto kMessages = 100;
+    StreamPair pair(kWindow);
+    std::atomic<int> written{};
+    fiber::Latch latch(1);
+
+    fiber::StartFiberDetached([&] {
+      for (int i = 0; i != kMessages; ++i) {
+        ASSERT_TRUE(pair.client->Write(FakeMessage(Message::Type::Stream, i),
+                                       false));
+        ++written;
+      }
+      latch.count_down();
+    });
+    this_fiber::SleepFor(100ms);
+    EXPECT_EQ(kWindow, written);  // Blocked until the server reads.
+
+    for (int i = 0; i != kMessages; ++i) {
+      auto msg = pair.server->Read();
+      ASSERT_TRUE(msg);
+      EXPECT_EQ(i, ValueOf(msg));
+      // The writer is never ahead of us by more than a window.
+      EXPECT_LE(written, i + 1 + kWindow);
+    }
+    latch.wait();
+    // A window update is sent for every `kWindow / 2` messages read.
+    EXPECT_EQ(kMessages + kMessages / (kWindow / 2), pair.messages_written);
+  });
+}
+
+TEST(StreamIoAdaptor, EndOfStreamIgnoresWindow) {
+  fiber::testing::RunAsFiber([] {
+    StreamPair pair(1);
+    ASSERT_TRUE(
+        pair.client->Write(FakeMessage(Message::Type::StartOfStream, 0), false));
+    // Window is exhausted, but we can always close the stream.
+    ASSERT_TRUE(
+        pair.client->Write(FakeMessage(Message::Type::EndOfStream, 1), true));
+    EXPECT_TRUE(pair.server->Read());
+    EXPECT_TRUE(pair.server->Read());
+  });
+}
+
+TEST(StreamIoAdaptor, Error) {
+  fiber::testing::RunAsFiber([] {
+    StreamPair pair(64);
+    ASSERT_TRUE(
+        pair.client->Write(FakeMessage(Message::Type::StartOfStream, 0), false));
+    pair.server->NotifyError();
+
+    StreamIoAdaptor::Error error;
+    // Messages received before the error are still delivered.
+    EXPECT_TRUE(pair.server->Read());
+    EXPECT_FALSE(pair.server->Read(&error));
+    EXPECT_EQ(StreamIoAdaptor::Error::IoError, error);
+    EXPECT_FALSE(
+        pair.server->Write(FakeMessage(Message::Type::Stream, 1), false, &error));
+    EXPECT_EQ(StreamIoAdaptor::Error::IoError, error);
+  });
+}
+
+TEST(StreamIoAdaptor, ParseError) {
+  fiber::testing::RunAsFiber([] {
+    StreamPair pair(64);
+    ASSERT_TRUE(
+        pair.client->Write(FakeMessage(Message::Type::StartOfStream, -1), false));
+    StreamIoAdaptor::Error error;
+    EXPECT_FALSE(pair.server->Peek(&error));
+    EXPECT_EQ(StreamIoAdaptor::Error::ParseError, error);
+  });
+}
+
+TEST(StreamIoAdaptor, Timeout) {
+  fiber::testing::RunAsFiber([] {
+    StreamPair pair(64);
+    auto start = std::chrono::steady_clock::now();
+    pair.server->SetExpiration(start + 100ms);
+    StreamIoAdaptor::Error error;
+    EXPECT_FALSE(pair.server->Read(&error));
+    EXPECT_EQ(StreamIoAdaptor::Error::Timeout, error);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 90ms);
+
+    // The stream is broken once expired.
+    EXPECT_FALSE(
+        pair.server->Write(FakeMessage(Message::Type::Stream, 1), false, &error));
+    EXPECT_EQ(StreamIoAdaptor::Error::Timeout, error);
+  });
+}
+
+}  // namespace tinyRPC::rpc::internal
@@ -0,0 +1,133 @@
+#include "ConsistentHash.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace tinyRPC::load_balancer {
+
+FLARE_RPC_REGISTER_LOAD_BALANCER("chash", ConsistentHash);
+
+namespace {
+
+// Finalizer of SplitMix64. Keys are mixed as well, since they're usually not
+// uniformly distributed (e.g. shard IDs).
+std::uint64_t Mix(std::uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111eb;
+  x ^= x >> 31;
+  return x;
+}
+
+// FNV-1a. Unlike `std::hash`, it's the same everywhere, so that clients agree
+// on where each key goes.
+std::uint64_t Fnv1a(std::string_view s) {
+  std::uint64_t hash = 0xcbf29ce484222325;
+  for (auto c : s) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+  }
+  return hash;
+}
+
+}  // namespace
+
+ConsistentHash::~ConsistentHash() {}
+
+void ConsistentHash::SetPeers(std::vector<Endpoint> addresses) {
+  // We're the only writer, so `current` won't go away until we replace it.
+  auto current = ring_.Get();
+  std::unordered_map<std::string, Peer*> known;
+  for (auto&& e : current->peers) {
+    known[e->address.ToString()] = e.Get();
+  }
+
+  // Peers that are kept, and virtual nodes of new peers.
+  auto ring = std::make_unique<Ring>();
+  std::unordered_set<Peer*> kept;
+  std::vector<std::pair<std::uint64_t, Peer*>> new_points;
+  for (auto&& e : addresses) {
+    auto name = e.ToString();
+    if (auto iter = known.find(name); iter != known.end()) {
+      if (kept.insert(iter->second).second) {
+        ring->peers.push_back(RefPtr<Peer>(ref_ptr, iter->second));
+      }
+      continue;
+    }
+    auto peer = MakeRefCounted<Peer>();
+    peer->address = std::move(e);
+    auto base = Fnv1a(name);
+    for (std::size_t i = 0; i != kVirtualNodes; ++i) {
+      new_points.emplace_back(Mix(base + i), peer.Get());
+    }
+    known[name] = peer.Get();  // In case it's duplicated in `addresses`.
+    kept.insert(peer.Get());
+    ring->peers.push_back(std::move(peer));
+  }
+
+  // The ring is rebuilt by merging virtual nodes that are kept (which are
+  // already sorted) with the new ones.
+  std::vector<std::pair<std::uint64_t, Peer*>> old_points;
+  std::copy_if(current->points.begin(), current->points.end(),
+               std::back_inserter(old_points),
+               [&](auto&& e) { return kept.count(e.second) != 0; });
+  std::sort(new_points.begin(), new_points.end());
+  ring->points.reserve(old_points.size() + new_points.size());
+  std::merge(old_points.begin(), old_points.end(), new_points.begin(),
+             new_points.end(), std::back_inserter(ring->points));
+
+  ring_.Reset(std::move(ring));
+}
+
+bool ConsistentHash::GetPeer(std::uint64_t key, Endpoint* addr,
+                             std::uintptr_t* ctx) {
+  RcuReadLock _;
+  auto ring = ring_.Get();
+  auto&& points = ring->points;
+  if (FLARE_UNLIKELY(points.empty())) {
+    return false;
+  }
+
+  // Counting this call.
+  auto capacity = static_cast<std::int64_t>(
+      std::ceil((inflight_.load(std::memory_order_relaxed) + 1) * kLoadFactor /
+                ring->peers.size()));
+  auto start = std::lower_bound(
+                   points.begin(), points.end(),
+                   std::pair<std::uint64_t, Peer*>(Mix(key), nullptr)) -
+               points.begin();
+
+  // Walk clockwise until we find a peer that is not overloaded. Should all of
+  // them be overloaded (which is unlikely, as `capacity` is larger than the
+  // average), the first one is used.
+  auto chosen = points[start % points.size()].second;
+  for (std::size_t i = 0; i != points.size(); ++i) {
+    auto peer = points[(start + i) % points.size()].second;
+    if (peer->inflight.load(std::memory_order_relaxed) < capacity) {
+      chosen = peer;
+      break;
+    }
+  }
+
+  chosen->inflight.fetch_add(1, std::memory_order_relaxed);
+  inflight_.fetch_add(1, std::memory_order_relaxed);
+  chosen->Ref();  // Dropped in `Report`.
+  *addr = chosen->address;
+  *ctx = reinterpret_cast<std::uintptr_t>(chosen);
+  return true;
+}
+
+void ConsistentHash::Report(const Endpoint& addr, Status status,
+                            std::chrono::nanoseconds time_cost,
+                            std::uintptr_t ctx) {
+  RefPtr<Peer> peer(adopt_ptr, reinterpret_cast<Peer*>(ctx));
+  peer->inflight.fetch_sub(1, std::memory_order_relaxed);
+  inflight_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+}  // namespace tinyRPC::load_balancer
@@ -0,0 +1,62 @@
+#ifndef _SRC_RPC_LOAD_BALANCER_CONSISTENT_HASH_H_
+#define _SRC_RPC_LOAD_BALANCER_CONSISTENT_HASH_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "../../base/Likely.h"
+#include "../../base/Rcu.h"
+#include "../../base/RefPtr.h"
+#include "LoadBalancer.h"
+
+namespace tinyRPC::load_balancer {
+
+// Routes requests with the same `key` to the same peer, using a hash ring with
+// virtual nodes. Adding or removing a peer only moves keys from / to that peer.
+//
+// To keep a hot key from overloading its peer, load is bounded: A peer with
+// more in-flight calls than `kLoadFactor` times the average is skipped, and the
+// next one on the ring is tried instead ("consistent hashing with bounded
+// loads").
+class ConsistentHash : public LoadBalancer {
+ public:
+  // Number of virtual nodes each peer has on the ring.
+  static constexpr std::size_t kVirtualNodes = 160;
+
+  // In-flight calls a peer may have, relative to the average.
+  static constexpr double kLoadFactor = 1.25;
+
+  ~ConsistentHash();
+
+  // Only virtual nodes of new peers are hashed. The rest of the ring is reused.
+  void SetPeers(std::vector<Endpoint> addresses) override;
+  bool GetPeer(std::uint64_t key, Endpoint* addr, std::uintptr_t* ctx) override;
+  void Report(const Endpoint& addr, Status status,
+              std::chrono::nanoseconds time_cost, std::uintptr_t ctx) override;
+
+ private:
+  // Kept alive (by `ctx` returned by `GetPeer`) until all calls made to it are
+  // reported, even if it's been removed by `SetPeers`.
+  struct Peer : RefCounted<Peer> {
+    Endpoint address;
+    std::atomic<std::int64_t> inflight{0};
+  };
+
+  struct Ring {
+    std::vector<RefPtr<Peer>> peers;
+    std::vector<std::pair<std::uint64_t, Peer*>> points;  // Sorted.
+  };
+
+  RcuPtr<const Ring> ring_{std::make_unique<Ring>()};
+
+  // In-flight calls to all peers.
+  std::atomic<std::int64_t> inflight_{0};
+};
+
+}  // namespace tinyRPC::load_balancer
+
+#endif
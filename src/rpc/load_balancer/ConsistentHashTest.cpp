@@ -0,0 +1,120 @@
+#include "ConsistentHash.h"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "TestUtil.h"
+
+using namespace std::literals;
+
+namespace tinyRPC::load_balancer {
+
+using testing::MakePeers;
+
+namespace {
+
+// Maps each of keys to its peer. Calls are completed immediately.
+std::vector<std::string> Route(ConsistentHash* lb, int keys) {
+  std::vector<std::string> result;
+  for (int i = 0; i != keys; ++i) {
+    result.push_back(testing::Pick(lb, LoadBalancer::Status::Success, i));
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(ConsistentHash, Registry) {
+  EXPECT_TRUE(load_balancer_registry.TryNew("chash"));
+}
+
+TEST(ConsistentHash, Empty) {
+  ConsistentHash lb;
+  Endpoint peer;
+  std::uintptr_t ctx;
+  EXPECT_FALSE(lb.GetPeer(0, &peer, &ctx));
+}
+
+TEST(ConsistentHash, SameKeySamePeer) {
+  ConsistentHash lb1, lb2;
+  lb1.SetPeers(MakePeers(0, 10));
+  lb2.SetPeers(MakePeers(0, 10));
+  EXPECT_EQ(Route(&lb1, 1000), Route(&lb1, 1000));
+  EXPECT_EQ(Route(&lb1, 1000), Route(&lb2, 1000));  // Agreed among clients.
+}
+
+TEST(ConsistentHash, Distribution) {
+  ConsistentHash lb;
+  lb.SetPeers(MakePeers(0, 10));
+  std::unordered_map<std::string, int> counts;
+  for (auto&& e : Route(&lb, 100000)) {
+    ++counts[e];
+  }
+  ASSERT_EQ(10, counts.size());
+  for (auto&& [k, v] : counts) {
+    EXPECT_GT(v, 100000 / 10 / 2);
+    EXPECT_LT(v, 100000 / 10 * 2);
+  }
+}
+
+TEST(ConsistentHash, AddPeer) {
+  ConsistentHash lb;
+  lb.SetPeers(MakePeers(0, 10));
+  auto before = Route(&lb, 10000);
+  lb.SetPeers(MakePeers(0, 11));
+  auto after = Route(&lb, 10000);
+  auto added = "198.51.100.11";
+  int moved = 0;
+  for (int i = 0; i != 10000; ++i) {
+    if (before[i] != after[i]) {
+      EXPECT_EQ(added, after[i]);  // Only to the new peer.
+      ++moved;
+    }
+  }
+  EXPECT_GT(moved, 10000 / 11 / 2);
+  EXPECT_LT(moved, 10000 / 11 * 2);
+}
+
+TEST(ConsistentHash, RemovePeer) {
+  ConsistentHash lb;
+  lb.SetPeers(MakePeers(0, 10));
+  auto before = Route(&lb, 10000);
+  lb.SetPeers(MakePeers(1, 10));
+  auto after = Route(&lb, 10000);
+  auto removed = "198.51.100.1";
+  for (int i = 0; i != 10000; ++i) {
+    if (before[i] != removed) {
+      EXPECT_EQ(before[i], after[i]);  // Only keys of the removed peer move.
+    } else {
+      EXPECT_NE(removed, after[i]);
+    }
+  }
+}
+
+TEST(ConsistentHash, BoundedLoad) {
+  ConsistentHash lb;
+  lb.SetPeers(MakePeers(0, 4));
+  std::vector<std::pair<Endpoint, std::uintptr_t>> calls;
+  std::unordered_map<std::string, int> counts;
+  // All for the same key, and none of them completes.
+  for (int i = 0; i != 100; ++i) {
+    Endpoint peer;
+    std::uintptr_t ctx;
+    ASSERT_TRUE(lb.GetPeer(1, &peer, &ctx));
+    ++counts[EndpointGetIp(peer)];
+    calls.emplace_back(peer, ctx);
+  }
+  EXPECT_EQ(4, counts.size());  // Spilled over to all of them.
+  for (auto&& [k, v] : counts) {
+    EXPECT_LE(v, 100 / 4 * ConsistentHash::kLoadFactor + 1);
+  }
+  for (auto&& [peer, ctx] : calls) {
+    lb.Report(peer, LoadBalancer::Status::Success, 1ms, ctx);
+  }
+}
+
+}  // namespace tinyRPC::load_balancer
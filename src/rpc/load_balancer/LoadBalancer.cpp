@@ -1,7 +1,25 @@
 #include "LoadBalancer.h"
 
+#include "OutlierDetection.h"
+
+using namespace std::literals;
+
 namespace tinyRPC {
 
 FLARE_DEFINE_CLASS_DEPENDENCY_REGISTRY(load_balancer_registry, LoadBalancer);
 
+std::unique_ptr<LoadBalancer> MakeLoadBalancer(std::string_view name) {
+  constexpr auto kOutlierDetectionPrefix = "od-"sv;
+  if (name.substr(0, kOutlierDetectionPrefix.size()) ==
+      kOutlierDetectionPrefix) {
+    auto inner = load_balancer_registry.TryNew(
+        name.substr(kOutlierDetectionPrefix.size()));
+    if (!inner) {
+      return nullptr;
+    }
+    return std::make_unique<load_balancer::OutlierDetection>(std::move(inner));
+  }
+  return load_balancer_registry.TryNew(name);
 }
+
+}  // namespace tinyRPC
@@ -3,10 +3,13 @@
 
 #include <chrono>
 #include <cstdint>
+#include <memory>
+#include <string_view>
 #include <vector>
 
 #include "../../base/DependencyRegistry.h"
 #include "../../base/Endpoint.h"
+#include "../PeerInfo.h"
 
 namespace tinyRPC {
 
@@ -30,19 +33,46 @@ class LoadBalancer {
   // makes no sense in doing so.
   virtual void SetPeers(std::vector<Endpoint> addresses) = 0;
 
+  // Same as `SetPeers`, with weight and locality of each peer. Implementations
+  // not interested in them may leave this method as-is.
+  virtual void SetPeerInfos(std::vector<PeerInfo> peers) {
+    std::vector<Endpoint> addresses;
+    for (auto&& e : peers) {
+      addresses.push_back(std::move(e.address));
+    }
+    SetPeers(std::move(addresses));
+  }
+
+  // `ctx` is an opaque value to be passed back to `Report`.
   virtual bool GetPeer(std::uint64_t key, Endpoint* addr,
                        std::uintptr_t* ctx) = 0;
 
   enum class Status {
     Success,
-    Overloaded,  // Not implemented at this time.
+    Overloaded,
     Failed
   };
 
+  // Feeds back the result of a call made to `addr`. For each successful call
+  // to `GetPeer`, this method must be called exactly once, with the `ctx`
+  // returned by `GetPeer`.
+  //
+  // `time_cost` of zero means it's not measured (e.g., the peer returned by
+  // `GetPeer` is not used at all.).
+  virtual void Report(const Endpoint& addr, Status status,
+                      std::chrono::nanoseconds time_cost,
+                      std::uintptr_t ctx) = 0;
 };
 
 FLARE_DECLARE_CLASS_DEPENDENCY_REGISTRY(load_balancer_registry, LoadBalancer);
 
+// Instantiates load balancer `name` from `load_balancer_registry`. A name of
+// the form "od-xxx" wraps load balancer `xxx` with outlier detection (see
+// `load_balancer::OutlierDetection`.).
+//
+// Returns `nullptr` if the load balancer is not recognized.
+std::unique_ptr<LoadBalancer> MakeLoadBalancer(std::string_view name);
+
 }  // namespace tinyRPC
 
 #define FLARE_RPC_REGISTER_LOAD_BALANCER(Name, Implementation)         \
@@ -0,0 +1,97 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../../../include/benchmark/benchmark.h"
+
+#include "ConsistentHash.h"
+#include "OutlierDetection.h"
+#include "PowerOfTwoChoices.h"
+#include "RoundRobin.h"
+#include "WeightedRoundRobin.h"
+
+using namespace std::literals;
+
+// `GetPeer` (and `Report`) of each load balancer, while its peers are replaced
+// by thread 0 every `kUpdateInterval` calls.
+//
+// Setup code of each thread is not synchronized, so load balancers are shared
+// by all threads, and are created on first use.
+
+namespace tinyRPC::load_balancer {
+
+namespace {
+
+constexpr auto kPeers = 100;
+constexpr auto kUpdateInterval = 64;
+
+// Two sets of peers, differ in one peer.
+std::vector<Endpoint> MakePeers(int generation) {
+  std::vector<Endpoint> peers;
+  for (int i = 0; i != kPeers; ++i) {
+    peers.push_back(EndpointFromIpv4("192.0.2.1", 1000 + i + generation % 2));
+  }
+  return peers;
+}
+
+std::unique_ptr<LoadBalancer> WithPeers(std::unique_ptr<LoadBalancer> lb) {
+  lb->SetPeers(MakePeers(0));
+  return lb;
+}
+
+void GetPeerUnderUpdate(benchmark::State& state, LoadBalancer* lb) {
+  std::uint64_t key = state.thread_index() * 0x9e3779b97f4a7c15;
+  int generation = 0;
+  std::size_t iterations = 0;
+  while (state.KeepRunning()) {
+    if (state.thread_index() == 0 && ++iterations % kUpdateInterval == 0) {
+      lb->SetPeers(MakePeers(++generation));
+    }
+    Endpoint peer;
+    std::uintptr_t ctx;
+    if (lb->GetPeer(++key, &peer, &ctx)) {
+      lb->Report(peer, LoadBalancer::Status::Success, 1ms, ctx);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+void Benchmark_RoundRobin(benchmark::State& state) {
+  static auto lb = WithPeers(std::make_unique<RoundRobin>());
+  GetPeerUnderUpdate(state, lb.get());
+}
+
+BENCHMARK(Benchmark_RoundRobin)->ThreadRange(1, 64)->UseRealTime();
+
+void Benchmark_WeightedRoundRobin(benchmark::State& state) {
+  static auto lb = WithPeers(std::make_unique<WeightedRoundRobin>());
+  GetPeerUnderUpdate(state, lb.get());
+}
+
+BENCHMARK(Benchmark_WeightedRoundRobin)->ThreadRange(1, 64)->UseRealTime();
+
+void Benchmark_PowerOfTwoChoices(benchmark::State& state) {
+  static auto lb = WithPeers(std::make_unique<PowerOfTwoChoices>());
+  GetPeerUnderUpdate(state, lb.get());
+}
+
+BENCHMARK(Benchmark_PowerOfTwoChoices)->ThreadRange(1, 64)->UseRealTime();
+
+void Benchmark_ConsistentHash(benchmark::State& state) {
+  static auto lb = WithPeers(std::make_unique<ConsistentHash>());
+  GetPeerUnderUpdate(state, lb.get());
+}
+
+BENCHMARK(Benchmark_ConsistentHash)->ThreadRange(1, 64)->UseRealTime();
+
+void Benchmark_OutlierDetection(benchmark::State& state) {
+  static auto lb = WithPeers(
+      std::make_unique<OutlierDetection>(std::make_unique<RoundRobin>()));
+  GetPeerUnderUpdate(state, lb.get());
+}
+
+BENCHMARK(Benchmark_OutlierDetection)->ThreadRange(1, 64)->UseRealTime();
+
+}  // namespace tinyRPC::load_balancer
@@ -0,0 +1,219 @@
+#include "OutlierDetection.h"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+#include "../../base/Likely.h"
+#include "../../base/Logging.h"
+#include "../../base/chrono.h"
+
+using namespace std::literals;
+
+namespace tinyRPC::load_balancer {
+
+namespace {
+
+// Number of peers we ask the wrapped load balancer for before giving up on
+// finding one not ejected.
+constexpr auto kMaxPicks = 8;
+
+}  // namespace
+
+OutlierDetection::OutlierDetection(std::unique_ptr<LoadBalancer> inner)
+    : OutlierDetection(std::move(inner), Options()) {}
+
+OutlierDetection::OutlierDetection(std::unique_ptr<LoadBalancer> inner,
+                                   const Options& options)
+    : inner_(std::move(inner)), options_(options) {
+  FLARE_CHECK(inner_);
+}
+
+OutlierDetection::~OutlierDetection() {}
+
+void OutlierDetection::SetPeers(std::vector<Endpoint> addresses) {
+  UpdatePeers(addresses);
+  inner_->SetPeers(std::move(addresses));
+}
+
+void OutlierDetection::SetPeerInfos(std::vector<PeerInfo> peers) {
+  std::vector<Endpoint> addresses;
+  for (auto&& e : peers) {
+    addresses.push_back(e.address);
+  }
+  UpdatePeers(addresses);
+  inner_->SetPeerInfos(std::move(peers));
+}
+
+bool OutlierDetection::GetPeer(std::uint64_t key, Endpoint* addr,
+                               std::uintptr_t* ctx) {
+  RcuReadLock _;
+  auto peers = peers_.Get();
+  auto now = ReadSteadyClock();
+  for (int i = 0; i != kMaxPicks; ++i) {
+    if (!inner_->GetPeer(key, addr, ctx)) {
+      return false;
+    }
+    auto peer = FindPeer(*peers, *addr);
+    if (!peer || TryAdmit(peer, now)) {
+      return true;
+    }
+    // We're not going to call it.
+    inner_->Report(*addr, Status::Success, 0ns, *ctx);
+  }
+  // We keep getting ejected peers (e.g., the wrapped load balancer respects
+  // `key`), let's call whatever we get then.
+  return inner_->GetPeer(key, addr, ctx);
+}
+
+void OutlierDetection::Report(const Endpoint& addr, Status status,
+                              std::chrono::nanoseconds time_cost,
+                              std::uintptr_t ctx) {
+  inner_->Report(addr, status, time_cost, ctx);
+
+  RcuReadLock rcu_lock;
+  auto peers = peers_.Get();
+  auto peer = FindPeer(*peers, addr);
+  if (!peer) {
+    return;  // It has been removed.
+  }
+  auto now = ReadSteadyClock();
+  auto failed = status != Status::Success ||
+                (options_.slow_call_threshold != 0ns &&
+                 time_cost > options_.slow_call_threshold);
+  auto measured = failed || time_cost != 0ns;
+
+  std::scoped_lock _(peer->lock);
+  if (peer->state == State::Probing) {
+    peer->probes -= std::min<std::size_t>(peer->probes, 1);
+    if (!measured) {
+      return;  // The probe was not made at all.
+    }
+    if (failed) {
+      EjectLocked(peer, now);
+    } else {
+      RestoreLocked(peer, now);
+    }
+    return;
+  }
+  if (peer->state == State::Ejected || !measured) {
+    // Calls made before the ejection are not counted.
+    return;
+  }
+
+  if (now - peer->interval_start > options_.interval) {
+    peer->interval_start = now;
+    peer->calls = peer->failures = 0;
+  }
+  ++peer->calls;
+  if (!failed) {
+    peer->consecutive_failures = 0;
+    return;
+  }
+  ++peer->failures;
+  ++peer->consecutive_failures;
+  if (peer->consecutive_failures >= options_.consecutive_failures ||
+      (peer->calls >= options_.minimum_calls &&
+       peer->failures >= options_.failure_rate * peer->calls)) {
+    if (!peer->removed &&
+        TryCountEjection(peers->size() * options_.max_ejection_percent / 100)) {
+      peer->counted = true;
+      EjectLocked(peer, now);
+    }
+  }
+}
+
+void OutlierDetection::UpdatePeers(const std::vector<Endpoint>& addresses) {
+  // Peers we already know are kept, along with their states. We're the only
+  // writer, so it's safe to read them without `RcuReadLock`.
+  auto current = peers_.Get();
+  auto peers = std::make_unique<Peers>();
+  for (auto&& e : addresses) {
+    if (auto iter = current->find(e); iter != current->end()) {
+      (*peers)[e] = iter->second;
+    } else {
+      (*peers)[e] = MakeRefCounted<Peer>();
+    }
+  }
+  // Ejected peers that are removed are no longer counted. `Report`s racing
+  // with us may still see them, `removed` keeps them from being counted
+  // again.
+  for (auto&& [addr, peer] : *current) {
+    if (!peers->count(addr)) {
+      std::scoped_lock _(peer->lock);
+      peer->removed = true;
+      UncountLocked(peer.Get());
+    }
+  }
+  peers_.Reset(std::move(peers));
+}
+
+OutlierDetection::Peer* OutlierDetection::FindPeer(const Peers& peers,
+                                                   const Endpoint& addr) const {
+  auto iter = peers.find(addr);
+  return iter != peers.end() ? iter->second.Get() : nullptr;
+}
+
+bool OutlierDetection::TryAdmit(Peer* peer,
+                                std::chrono::steady_clock::time_point now) {
+  std::scoped_lock _(peer->lock);
+  if (FLARE_LIKELY(peer->state == State::Healthy)) {
+    return true;
+  }
+  if (peer->state == State::Ejected) {
+    if (now < peer->ejected_until) {
+      return false;
+    }
+    peer->state = State::Probing;
+  }
+  if (peer->probes < options_.probe_calls) {
+    ++peer->probes;
+    return true;
+  }
+  return false;
+}
+
+bool OutlierDetection::TryCountEjection(std::size_t allowed) {
+  auto current = ejected_.load(std::memory_order_relaxed);
+  do {
+    if (current >= allowed) {
+      return false;
+    }
+  } while (!ejected_.compare_exchange_weak(current, current + 1,
+                                           std::memory_order_relaxed));
+  return true;
+}
+
+void OutlierDetection::EjectLocked(Peer* peer,
+                                   std::chrono::steady_clock::time_point now) {
+  if (peer->ejections && now - peer->restored_at > options_.max_ejection_time &&
+      peer->state == State::Healthy) {
+    peer->ejections = 0;  // It has been well for long, start over.
+  }
+  auto ejection_time = options_.base_ejection_time;
+  for (std::size_t i = 0;
+       i != peer->ejections && ejection_time < options_.max_ejection_time;
+       ++i) {
+    ejection_time *= 2;
+  }
+  ++peer->ejections;
+  peer->state = State::Ejected;
+  peer->ejected_until = now + std::min(ejection_time, options_.max_ejection_time);
+}
+
+void OutlierDetection::RestoreLocked(Peer* peer,
+                                     std::chrono::steady_clock::time_point now) {
+  peer->state = State::Healthy;
+  peer->restored_at = now;
+  peer->interval_start = now;
+  peer->calls = peer->failures = peer->consecutive_failures = 0;
+  UncountLocked(peer);
+}
+
+void OutlierDetection::UncountLocked(Peer* peer) {
+  if (std::exchange(peer->counted, false)) {
+    ejected_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace tinyRPC::load_balancer
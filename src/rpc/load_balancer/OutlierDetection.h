@@ -0,0 +1,119 @@
+#ifndef _SRC_RPC_LOAD_BALANCER_OUTLIER_DETECTION_H_
+#define _SRC_RPC_LOAD_BALANCER_OUTLIER_DETECTION_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "../../base/Rcu.h"
+#include "../../base/RefPtr.h"
+#include "../../base/SpinLock.h"
+#include "LoadBalancer.h"
+
+namespace tinyRPC::load_balancer {
+
+// Wraps another load balancer, and ejects peers that keep failing (or keep
+// being slow) from it for a while. Ejection time grows exponentially each
+// time the same peer is ejected again.
+//
+// Once its ejection expires, a peer is probed with a limited number of calls.
+// If they succeed, the peer is restored, otherwise it's ejected again.
+//
+// Ejected peers are skipped by asking the wrapped load balancer for another
+// one. Therefore, this works best with load balancers that ignore `key`.
+//
+// Use `MakeLoadBalancer("od-xxx")` to wrap a registered load balancer `xxx`.
+class OutlierDetection : public LoadBalancer {
+ public:
+  struct Options {
+    // A peer is ejected after so many consecutive failures, ...
+    std::size_t consecutive_failures = 5;
+
+    // ... or if its failure rate in `interval` reaches `failure_rate`, given
+    // that at least `minimum_calls` calls were made to it in that interval.
+    double failure_rate = 0.5;
+    std::size_t minimum_calls = 20;
+    std::chrono::nanoseconds interval = std::chrono::seconds(10);
+
+    // If non-zero, calls slower than this count as failures.
+    std::chrono::nanoseconds slow_call_threshold{};
+
+    // The n-th successive ejection of a peer lasts for
+    // `base_ejection_time * 2^(n - 1)`, capped at `max_ejection_time`. A peer
+    // that has stayed healthy for `max_ejection_time` starts over.
+    std::chrono::nanoseconds base_ejection_time = std::chrono::seconds(1);
+    std::chrono::nanoseconds max_ejection_time = std::chrono::seconds(60);
+
+    // At most this percentage of peers are ejected at the same time.
+    int max_ejection_percent = 50;
+
+    // In-flight calls allowed to a peer being probed.
+    std::size_t probe_calls = 1;
+  };
+
+  explicit OutlierDetection(std::unique_ptr<LoadBalancer> inner);
+  OutlierDetection(std::unique_ptr<LoadBalancer> inner,
+                   const Options& options);
+  ~OutlierDetection();
+
+  void SetPeers(std::vector<Endpoint> addresses) override;
+  void SetPeerInfos(std::vector<PeerInfo> peers) override;
+  bool GetPeer(std::uint64_t key, Endpoint* addr, std::uintptr_t* ctx) override;
+  void Report(const Endpoint& addr, Status status,
+              std::chrono::nanoseconds time_cost, std::uintptr_t ctx) override;
+
+ private:
+  enum class State { Healthy, Ejected, Probing };
+
+  struct Peer : RefCounted<Peer> {
+    SpinLock lock;
+    State state = State::Healthy;
+
+    // Statistics of calls made in current interval.
+    std::chrono::steady_clock::time_point interval_start;
+    std::size_t calls = 0, failures = 0;
+    std::size_t consecutive_failures = 0;
+
+    std::size_t ejections = 0;  // Successive ejections.
+    std::chrono::steady_clock::time_point ejected_until;
+    std::chrono::steady_clock::time_point restored_at;
+    std::size_t probes = 0;  // In-flight probes.
+
+    // Set if this peer is counted in `ejected_`. The counter is only updated
+    // when this flag flips, so it can't drift whatever order `Report` and
+    // `UpdatePeers` run in.
+    bool counted = false;
+    // Set once it's removed from `peers_`. It's not counted again then.
+    bool removed = false;
+  };
+
+  using Peers = std::unordered_map<Endpoint, RefPtr<Peer>>;
+
+  void UpdatePeers(const std::vector<Endpoint>& addresses);
+  Peer* FindPeer(const Peers& peers, const Endpoint& addr) const;
+
+  // Returns `false` if calls to `peer` should not be made now.
+  bool TryAdmit(Peer* peer, std::chrono::steady_clock::time_point now);
+
+  // Counts one more peer in `ejected_`, unless `allowed` are already counted.
+  bool TryCountEjection(std::size_t allowed);
+
+  // Called with `peer->lock` held.
+  void EjectLocked(Peer* peer, std::chrono::steady_clock::time_point now);
+  void RestoreLocked(Peer* peer, std::chrono::steady_clock::time_point now);
+  void UncountLocked(Peer* peer);
+
+ private:
+  std::unique_ptr<LoadBalancer> inner_;
+  Options options_;
+
+  RcuPtr<const Peers> peers_{std::make_unique<Peers>()};
+  std::atomic<std::size_t> ejected_{0};  // Peers with `counted` set.
+};
+
+}  // namespace tinyRPC::load_balancer
+
+#endif
@@ -0,0 +1,246 @@
+#include "OutlierDetection.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "RoundRobin.h"
+#include "TestUtil.h"
+
+using namespace std::literals;
+
+namespace tinyRPC::load_balancer {
+
+using testing::MakePeers;
+using testing::Pick;
+using testing::PickWithFailingPeer;
+
+namespace {
+
+// Every call fails.
+void FailAll(LoadBalancer* lb, int times) {
+  for (int i = 0; i != times; ++i) {
+    Endpoint peer;
+    std::uintptr_t ctx;
+    ASSERT_TRUE(lb->GetPeer(0, &peer, &ctx));
+    lb->Report(peer, LoadBalancer::Status::Failed, 1ms, ctx);
+  }
+}
+
+std::unordered_map<std::string, int> CountPicks(LoadBalancer* lb, int times) {
+  std::unordered_map<std::string, int> counts;
+  for (int i = 0; i != times; ++i) {
+    ++counts[Pick(lb)];
+  }
+  return counts;
+}
+
+// `RoundRobin` ignores feedbacks, so peers are skipped by us only.
+std::unique_ptr<OutlierDetection> MakeLoadBalancer(
+    int peers, const OutlierDetection::Options& options) {
+  auto lb = std::make_unique<OutlierDetection>(
+      std::make_unique<RoundRobin>(), options);
+  lb->SetPeers(MakePeers(peers));
+  return lb;
+}
+
+}  // namespace
+
+TEST(OutlierDetection, MakeLoadBalancer) {
+  EXPECT_TRUE(tinyRPC::MakeLoadBalancer("od-rr"));
+  EXPECT_TRUE(tinyRPC::MakeLoadBalancer("rr"));
+  EXPECT_FALSE(tinyRPC::MakeLoadBalancer("od-nonexistent"));
+}
+
+TEST(OutlierDetection, ConsecutiveFailures) {
+  OutlierDetection::Options opts;
+  opts.consecutive_failures = 2;
+  auto lb = MakeLoadBalancer(4, opts);
+
+  // The first failure does not trigger ejection.
+  while (PickWithFailingPeer(lb.get(), "198.51.100.1") != "198.51.100.1") {
+  }
+  EXPECT_EQ(1, CountPicks(lb.get(), 4)["198.51.100.1"]);
+
+  while (PickWithFailingPeer(lb.get(), "198.51.100.1") != "198.51.100.1") {
+  }
+  while (PickWithFailingPeer(lb.get(), "198.51.100.1") != "198.51.100.1") {
+  }
+  EXPECT_EQ(0, CountPicks(lb.get(), 100)["198.51.100.1"]);
+}
+
+TEST(OutlierDetection, FailureRate) {
+  OutlierDetection::Options opts;
+  opts.consecutive_failures = 1000;
+  opts.failure_rate = 0.5;
+  opts.minimum_calls = 10;
+  auto lb = MakeLoadBalancer(2, opts);
+
+  // Failures interleaved with successes.
+  for (int i = 0; i != 4; ++i) {
+    PickWithFailingPeer(lb.get(), "198.51.100.1");
+    PickWithFailingPeer(lb.get(), "198.51.100.1");
+    PickWithFailingPeer(lb.get(), "198.51.100.1",
+                        LoadBalancer::Status::Success);
+    PickWithFailingPeer(lb.get(), "198.51.100.1",
+                        LoadBalancer::Status::Success);
+  }
+  EXPECT_GT(CountPicks(lb.get(), 10)["198.51.100.1"], 0);  // Too few calls.
+
+  for (int i = 0; i != 20; ++i) {
+    PickWithFailingPeer(lb.get(), "198.51.100.1");
+  }
+  EXPECT_EQ(0, CountPicks(lb.get(), 100)["198.51.100.1"]);
+}
+
+TEST(OutlierDetection, SlowCalls) {
+  OutlierDetection::Options opts;
+  opts.consecutive_failures = 2;
+  opts.slow_call_threshold = 100ms;
+  auto lb = MakeLoadBalancer(2, opts);
+
+  for (int i = 0; i != 10; ++i) {
+    PickWithFailingPeer(lb.get(), "198.51.100.1",
+                        LoadBalancer::Status::Success, 200ms);
+  }
+  EXPECT_EQ(0, CountPicks(lb.get(), 100)["198.51.100.1"]);
+}
+
+TEST(OutlierDetection, MaxEjectionPercent) {
+  OutlierDetection::Options opts;
+  opts.consecutive_failures = 1;
+  opts.max_ejection_percent = 50;
+  auto lb = MakeLoadBalancer(4, opts);
+
+  // Everyone fails, but only two of them are ejected.
+  FailAll(lb.get(), 100);
+  EXPECT_EQ(2, CountPicks(lb.get(), 100).size());
+}
+
+TEST(OutlierDetection, MaxEjectionPercentConcurrent) {
+  OutlierDetection::Options opts;
+  opts.consecutive_failures = 1;
+  opts.max_ejection_percent = 50;
+  auto lb = MakeLoadBalancer(10, opts);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i != 4; ++i) {
+    threads.emplace_back([&] { FailAll(lb.get(), 1000); });
+  }
+  for (auto&& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(5, CountPicks(lb.get(), 100).size());
+}
+
+TEST(OutlierDetection, UpdatePeersConcurrently) {
+  OutlierDetection::Options opts;
+  opts.consecutive_failures = 1;
+  opts.max_ejection_percent = 50;
+  opts.base_ejection_time = 1ms;
+  opts.max_ejection_time = 1ms;
+  auto lb = MakeLoadBalancer(4, opts);
+
+  // Peers are ejected, probed and restored (or ejected again) while the peer
+  // list keeps changing.
+  std::atomic<bool> leaving = false;
+  std::vector<std::thread> threads;
+  for (int i = 0; i != 4; ++i) {
+    threads.emplace_back([&, i] {
+      while (!leaving.load(std::memory_order_relaxed)) {
+        PickWithFailingPeer(lb.get(), "198.51.100." + std::to_string(i + 1));
+        std::this_thread::yield();
+      }
+    });
+  }
+  for (int i = 0; i != 1000; ++i) {
+    lb->SetPeers(MakePeers(i % 2 ? 4 : 2));
+    std::this_thread::yield();
+  }
+  lb->SetPeers(MakePeers(4));
+  leaving = true;
+  for (auto&& t : threads) {
+    t.join();
+  }
+
+  // Let everyone be restored.
+  std::this_thread::sleep_for(10ms);
+  for (int i = 0; i != 100; ++i) {
+    Pick(lb.get());
+  }
+  EXPECT_EQ(4, CountPicks(lb.get(), 100).size());
+
+  // Ejection still works, and is still capped.
+  FailAll(lb.get(), 100);
+  EXPECT_EQ(2, CountPicks(lb.get(), 100).size());
+}
+
+TEST(OutlierDetection, ProbeAndRestore) {
+  OutlierDetection::Options opts;
+  opts.consecutive_failures = 1;
+  opts.base_ejection_time = 100ms;
+  auto lb = MakeLoadBalancer(2, opts);
+
+  while (PickWithFailingPeer(lb.get(), "198.51.100.1") != "198.51.100.1") {
+  }
+  EXPECT_EQ(0, CountPicks(lb.get(), 100)["198.51.100.1"]);
+
+  std::this_thread::sleep_for(200ms);
+
+  // Only one probe is allowed at a time.
+  std::vector<std::pair<Endpoint, std::uintptr_t>> calls;
+  for (int i = 0; i != 10; ++i) {
+    Endpoint peer;
+    std::uintptr_t ctx;
+    ASSERT_TRUE(lb->GetPeer(0, &peer, &ctx));
+    calls.emplace_back(peer, ctx);
+  }
+  int probes = 0;
+  for (auto&& [peer, ctx] : calls) {
+    probes += EndpointGetIp(peer) == "198.51.100.1";
+    lb->Report(peer, LoadBalancer::Status::Success, 1ms, ctx);
+  }
+  EXPECT_EQ(1, probes);
+
+  // The probe succeeded, so it's restored.
+  EXPECT_EQ(50, CountPicks(lb.get(), 100)["198.51.100.1"]);
+}
+
+TEST(OutlierDetection, ExponentialBackoff) {
+  OutlierDetection::Options opts;
+  opts.consecutive_failures = 1;
+  opts.base_ejection_time = 100ms;
+  auto lb = MakeLoadBalancer(2, opts);
+
+  while (PickWithFailingPeer(lb.get(), "198.51.100.1") != "198.51.100.1") {
+  }
+  std::this_thread::sleep_for(150ms);
+  // The probe fails, and it's ejected for 200ms this time.
+  while (PickWithFailingPeer(lb.get(), "198.51.100.1") != "198.51.100.1") {
+  }
+  std::this_thread::sleep_for(150ms);
+  EXPECT_EQ(0, CountPicks(lb.get(), 100)["198.51.100.1"]);
+  std::this_thread::sleep_for(100ms);
+  EXPECT_GT(CountPicks(lb.get(), 100)["198.51.100.1"], 0);
+}
+
+TEST(OutlierDetection, KeepStatesOnUpdate) {
+  OutlierDetection::Options opts;
+  opts.consecutive_failures = 1;
+  auto lb = MakeLoadBalancer(2, opts);
+
+  while (PickWithFailingPeer(lb.get(), "198.51.100.1") != "198.51.100.1") {
+  }
+  lb->SetPeers(MakePeers(3));
+  auto counts = CountPicks(lb.get(), 100);
+  EXPECT_EQ(0, counts["198.51.100.1"]);
+  EXPECT_GT(counts["198.51.100.3"], 0);
+}
+
+}  // namespace tinyRPC::load_balancer
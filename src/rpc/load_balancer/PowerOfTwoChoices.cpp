@@ -0,0 +1,112 @@
+#include "PowerOfTwoChoices.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace tinyRPC::load_balancer {
+
+FLARE_RPC_REGISTER_LOAD_BALANCER("p2c", PowerOfTwoChoices);
+
+namespace {
+
+// Weight of a new latency sample is 1 / (2 ^ kDecayShift).
+constexpr auto kDecayShift = 3;
+
+// Latency of a failed call is taken as at least this much, and at least twice
+// the current estimation.
+constexpr std::int64_t kMinimumFailurePenalty = 1'000'000;  // 1ms.
+
+std::size_t NextRandom(std::size_t upper) {
+  thread_local std::minstd_rand engine(std::random_device{}());
+  return std::uniform_int_distribution<std::size_t>(0, upper - 1)(engine);
+}
+
+}  // namespace
+
+PowerOfTwoChoices::~PowerOfTwoChoices() {}
+
+void PowerOfTwoChoices::SetPeers(std::vector<Endpoint> addresses) {
+  // Statistics of peers we already know are kept.
+  // We're the only writer, so it's safe to read them without `RcuReadLock`.
+  std::unordered_map<std::string, RefPtr<Peer>> known;
+  for (auto&& e : peers_.Get()->peers) {
+    known[e->address.ToString()] = e;
+  }
+
+  auto peers = std::make_unique<Peers>();
+  for (auto&& e : addresses) {
+    if (auto iter = known.find(e.ToString()); iter != known.end()) {
+      peers->peers.push_back(iter->second);
+    } else {
+      auto peer = MakeRefCounted<Peer>();
+      peer->address = std::move(e);
+      peers->peers.push_back(std::move(peer));
+    }
+  }
+  peers_.Reset(std::move(peers));
+}
+
+bool PowerOfTwoChoices::GetPeer(std::uint64_t key, Endpoint* addr,
+                                std::uintptr_t* ctx) {
+  RcuReadLock _;
+  auto peers = peers_.Get();
+  auto size = peers->peers.size();
+  if (FLARE_UNLIKELY(size == 0)) {
+    return false;
+  }
+
+  auto index = NextRandom(size);
+  auto chosen = peers->peers[index].Get();
+  if (size > 1) {
+    // Another one, distinct from `chosen`.
+    auto other_index = NextRandom(size - 1);
+    auto other =
+        peers->peers[other_index + (other_index >= index ? 1 : 0)].Get();
+    auto a_inflight = chosen->inflight.load(std::memory_order_relaxed) + 1;
+    auto b_inflight = other->inflight.load(std::memory_order_relaxed) + 1;
+    auto a_latency = chosen->latency.load(std::memory_order_relaxed);
+    auto b_latency = other->latency.load(std::memory_order_relaxed);
+    if (a_latency && b_latency) {
+      // Compared as `double`s so that we don't have to worry about overflow.
+      if (static_cast<double>(b_latency) * b_inflight <
+          static_cast<double>(a_latency) * a_inflight) {
+        chosen = other;
+      }
+    } else if (b_inflight < a_inflight) {
+      // Latency of (at least) one of them is not known yet. Let's compare
+      // their in-flight calls only.
+      chosen = other;
+    }
+  }
+
+  chosen->inflight.fetch_add(1, std::memory_order_relaxed);
+  chosen->Ref();  // Dropped in `Report`.
+  *addr = chosen->address;
+  *ctx = reinterpret_cast<std::uintptr_t>(chosen);
+  return true;
+}
+
+void PowerOfTwoChoices::Report(const Endpoint& addr, Status status,
+                               std::chrono::nanoseconds time_cost,
+                               std::uintptr_t ctx) {
+  RefPtr<Peer> peer(adopt_ptr, reinterpret_cast<Peer*>(ctx));
+  peer->inflight.fetch_sub(1, std::memory_order_relaxed);
+
+  auto current = peer->latency.load(std::memory_order_relaxed);
+  auto sample = static_cast<std::int64_t>(time_cost.count());
+  if (status != Status::Success) {
+    sample = std::max({sample, current * 2, kMinimumFailurePenalty});
+  } else if (sample == 0) {
+    return;  // Not measured.
+  }
+
+  // Racing updates may lose samples. That's fine for an estimation.
+  peer->latency.store(
+      current ? current + ((sample - current) >> kDecayShift) : sample,
+      std::memory_order_relaxed);
+}
+
+}  // namespace tinyRPC::load_balancer
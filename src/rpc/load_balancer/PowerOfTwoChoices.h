@@ -0,0 +1,51 @@
+#ifndef _SRC_RPC_LOAD_BALANCER_POWER_OF_TWO_CHOICES_H_
+#define _SRC_RPC_LOAD_BALANCER_POWER_OF_TWO_CHOICES_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../../base/Likely.h"
+#include "../../base/Rcu.h"
+#include "../../base/RefPtr.h"
+#include "LoadBalancer.h"
+
+namespace tinyRPC::load_balancer {
+
+// Picks two peers at random, and chooses the less loaded one.
+//
+// Load of a peer is estimated as its (EWMA of) latency multiplied by number of
+// calls in-flight to it. This way slow or overloaded peers shed traffic
+// automatically. Failed calls count as slow ones.
+//
+// `key` is ignored.
+class PowerOfTwoChoices : public LoadBalancer {
+ public:
+  ~PowerOfTwoChoices();
+
+  void SetPeers(std::vector<Endpoint> addresses) override;
+  bool GetPeer(std::uint64_t key, Endpoint* addr, std::uintptr_t* ctx) override;
+  void Report(const Endpoint& addr, Status status,
+              std::chrono::nanoseconds time_cost, std::uintptr_t ctx) override;
+
+ private:
+  // Kept alive (by `ctx` returned by `GetPeer`) until all calls made to it are
+  // reported, even if it's been removed by `SetPeers`.
+  struct Peer : RefCounted<Peer> {
+    Endpoint address;
+    std::atomic<std::int64_t> latency{0};  // In nanoseconds, 0 if not known.
+    std::atomic<std::int64_t> inflight{0};
+  };
+
+  struct Peers {
+    std::vector<RefPtr<Peer>> peers;
+  };
+
+  RcuPtr<const Peers> peers_{std::make_unique<Peers>()};
+};
+
+}  // namespace tinyRPC::load_balancer
+
+#endif
@@ -0,0 +1,82 @@
+#include "PowerOfTwoChoices.h"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+#include "gtest/gtest.h"
+
+#include "TestUtil.h"
+
+using namespace std::literals;
+
+namespace tinyRPC::load_balancer {
+
+using testing::MakePeers;
+using testing::PickWithFailingPeer;
+
+TEST(PowerOfTwoChoices, Registry) {
+  EXPECT_TRUE(load_balancer_registry.TryNew("p2c"));
+}
+
+TEST(PowerOfTwoChoices, Empty) {
+  PowerOfTwoChoices lb;
+  Endpoint peer;
+  std::uintptr_t ctx;
+  EXPECT_FALSE(lb.GetPeer(0, &peer, &ctx));
+}
+
+TEST(PowerOfTwoChoices, PreferFaster) {
+  PowerOfTwoChoices lb;
+  lb.SetPeers(MakePeers(2));
+  std::unordered_map<std::string, int> picked;
+  for (int i = 0; i != 10000; ++i) {
+    ++picked[PickWithFailingPeer(&lb, "198.51.100.1",
+                                 LoadBalancer::Status::Success, 10ms)];
+  }
+  // With two peers, we always compare both of them. Once latency of both of
+  // them is known, the slow one is never chosen.
+  EXPECT_LT(picked["198.51.100.1"], 10);
+}
+
+TEST(PowerOfTwoChoices, ShedInflight) {
+  PowerOfTwoChoices lb;
+  lb.SetPeers(MakePeers(2));
+  Endpoint stuck;
+  std::uintptr_t stuck_ctx;
+  ASSERT_TRUE(lb.GetPeer(0, &stuck, &stuck_ctx));  // Never completes.
+
+  for (int i = 0; i != 100; ++i) {
+    Endpoint peer;
+    std::uintptr_t ctx;
+    ASSERT_TRUE(lb.GetPeer(0, &peer, &ctx));
+    EXPECT_FALSE(peer == stuck);
+    lb.Report(peer, LoadBalancer::Status::Success, 0ns, ctx);
+  }
+  lb.Report(stuck, LoadBalancer::Status::Success, 0ns, stuck_ctx);
+}
+
+TEST(PowerOfTwoChoices, FailedCountsAsSlow) {
+  PowerOfTwoChoices lb;
+  lb.SetPeers(MakePeers(2));
+  std::unordered_map<std::string, int> picked;
+  for (int i = 0; i != 10000; ++i) {
+    // Failing fast shouldn't attract more traffic.
+    ++picked[PickWithFailingPeer(&lb, "198.51.100.1",
+                                 LoadBalancer::Status::Failed, 1us)];
+  }
+  EXPECT_LT(picked["198.51.100.1"], 10);
+}
+
+TEST(PowerOfTwoChoices, ReportAfterRemoval) {
+  PowerOfTwoChoices lb;
+  lb.SetPeers(MakePeers(3));
+  Endpoint peer;
+  std::uintptr_t ctx;
+  ASSERT_TRUE(lb.GetPeer(0, &peer, &ctx));
+  lb.SetPeers({});
+  lb.Report(peer, LoadBalancer::Status::Success, 1ms, ctx);  // Still valid.
+  EXPECT_FALSE(lb.GetPeer(0, &peer, &ctx));
+}
+
+}  // namespace tinyRPC::load_balancer
@@ -10,16 +10,25 @@ FLARE_RPC_REGISTER_LOAD_BALANCER("rr", RoundRobin);
 RoundRobin::~RoundRobin() {}
 
 void RoundRobin::SetPeers(std::vector<Endpoint> addresses) {
-  endpoints_ -> peers = std::move(addresses);
+  auto peers = std::make_unique<Peers>();
+  peers->peers = std::move(addresses);
+  endpoints_.Reset(std::move(peers));
 }
 
 bool RoundRobin::GetPeer(std::uint64_t key, Endpoint* addr,
                          std::uintptr_t* ctx) {
-  if (FLARE_UNLIKELY(endpoints_->peers.empty())) {
+  RcuReadLock _;
+  auto&& peers = endpoints_.Get()->peers;
+  if (FLARE_UNLIKELY(peers.empty())) {
     return false;
   }
-  *addr = endpoints_->peers[next_.fetch_add(1) % endpoints_->peers.size()];
+  *addr = peers[next_.fetch_add(1, std::memory_order_relaxed) % peers.size()];
+  *ctx = 0;  // Not used by `Report`, but wrappers may pass it along.
   return true;
 }
 
+void RoundRobin::Report(const Endpoint& addr, Status status,
+                        std::chrono::nanoseconds time_cost,
+                        std::uintptr_t ctx) {}
+
 }  // namespace tinyRPC::load_balancer
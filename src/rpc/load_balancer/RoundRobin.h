@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "../../base/Random.h"
+#include "../../base/Rcu.h"
 #include "LoadBalancer.h"
 
 namespace tinyRPC::load_balancer {
@@ -21,13 +22,17 @@ class RoundRobin : public LoadBalancer {
   // `key` is ignored, as we select endpoints in a round-robin fashion.
   bool GetPeer(std::uint64_t key, Endpoint* addr, std::uintptr_t* ctx) override;
 
+  // Feedbacks are ignored.
+  void Report(const Endpoint& addr, Status status,
+              std::chrono::nanoseconds time_cost, std::uintptr_t ctx) override;
+
  private:
   struct Peers {
     std::vector<Endpoint> peers;
   };
 
   std::atomic<std::size_t> next_{Random()};  // FIXME: Make it thread-local.
-  std::shared_ptr<Peers> endpoints_{std::make_shared<Peers>()};
+  RcuPtr<const Peers> endpoints_{std::make_unique<Peers>()};
 };
 
 }  // namespace tinyRPC::load_balancer
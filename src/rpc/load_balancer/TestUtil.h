@@ -0,0 +1,66 @@
+#ifndef _SRC_RPC_LOAD_BALANCER_TEST_UTIL_H_
+#define _SRC_RPC_LOAD_BALANCER_TEST_UTIL_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "LoadBalancer.h"
+
+// Helpers shared by tests of load balancers. Peers are told apart by their IP.
+
+namespace tinyRPC::load_balancer::testing {
+
+// Peers #`from` to #`to` (exclusive), i.e., 198.51.100.`from + 1`:80, ...
+inline std::vector<Endpoint> MakePeers(int from, int to) {
+  std::vector<Endpoint> peers;
+  for (int i = from; i != to; ++i) {
+    peers.push_back(EndpointFromIpv4("198.51.100." + std::to_string(i + 1), 80));
+  }
+  return peers;
+}
+
+inline std::vector<Endpoint> MakePeers(int count) {
+  return MakePeers(0, count);
+}
+
+// Picks a peer for `key` and completes the call with `status` immediately.
+inline std::string Pick(
+    LoadBalancer* lb,
+    LoadBalancer::Status status = LoadBalancer::Status::Success,
+    std::uint64_t key = 0) {
+  using namespace std::literals;
+
+  Endpoint peer;
+  std::uintptr_t ctx;
+  EXPECT_TRUE(lb->GetPeer(key, &peer, &ctx));
+  lb->Report(peer, status, 1ms, ctx);
+  return EndpointGetIp(peer);
+}
+
+// Calls to `failing` complete with `status` in `time_cost`, others succeed in
+// 1ms.
+inline std::string PickWithFailingPeer(
+    LoadBalancer* lb, const std::string& failing,
+    LoadBalancer::Status status = LoadBalancer::Status::Failed,
+    std::chrono::nanoseconds time_cost = std::chrono::milliseconds(1)) {
+  using namespace std::literals;
+
+  Endpoint peer;
+  std::uintptr_t ctx;
+  EXPECT_TRUE(lb->GetPeer(0, &peer, &ctx));
+  auto ip = EndpointGetIp(peer);
+  if (ip == failing) {
+    lb->Report(peer, status, time_cost, ctx);
+  } else {
+    lb->Report(peer, LoadBalancer::Status::Success, 1ms, ctx);
+  }
+  return ip;
+}
+
+}  // namespace tinyRPC::load_balancer::testing
+
+#endif
@@ -0,0 +1,267 @@
+#include "WeightedRoundRobin.h"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "gflags/gflags.h"
+
+#include "../../base/Likely.h"
+#include "../../base/chrono.h"
+
+DEFINE_string(flare_rpc_locality, "",
+              "Locality (e.g., name of the rack or zone) of this process. "
+              "Peers in the same locality are preferred by locality-aware load "
+              "balancers.");
+DEFINE_int32(flare_rpc_locality_max_inflight, 32,
+             "Number of in-flight calls per unit of weight local peers may "
+             "have before locality-aware load balancers spill calls to remote "
+             "peers.");
+
+using namespace std::literals;
+
+namespace tinyRPC::load_balancer {
+
+FLARE_RPC_REGISTER_LOAD_BALANCER("wrr", WeightedRoundRobin);
+FLARE_REGISTER_CLASS_DEPENDENCY_FACTORY(load_balancer_registry, "local-wrr", [] {
+  return std::make_unique<WeightedRoundRobin>(true);
+});
+
+namespace {
+
+// After so many consecutive failures, a peer is considered unhealthy for
+// `kUnhealthyPeriod` since its last failure.
+constexpr auto kMaxConsecutiveFailures = 3;
+constexpr auto kUnhealthyPeriod = 5s;
+
+bool InSameSubnet(const Endpoint& left, const Endpoint& right) {
+  if (left.Family() != right.Family()) {
+    return false;
+  }
+  if (left.Family() == AF_INET) {  // /24
+    return memcmp(&left.UnsafeGet<sockaddr_in>()->sin_addr,
+                  &right.UnsafeGet<sockaddr_in>()->sin_addr, 3) == 0;
+  } else if (left.Family() == AF_INET6) {  // /64
+    return memcmp(&left.UnsafeGet<sockaddr_in6>()->sin6_addr,
+                  &right.UnsafeGet<sockaddr_in6>()->sin6_addr, 8) == 0;
+  }
+  return false;
+}
+
+bool IsLocal(const PeerInfo& peer) {
+  if (!FLAGS_flare_rpc_locality.empty() &&
+      peer.locality == FLAGS_flare_rpc_locality) {
+    return true;
+  }
+  static const auto kLocalAddresses = GetInterfaceAddresses();
+  for (auto&& e : kLocalAddresses) {
+    if (InSameSubnet(peer.address, e)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Scales `weights` down so that they sum up to no more than `limit` (each of
+// them is kept at least 1 though), and divides them by their GCD.
+void NormalizeWeights(std::vector<std::int64_t>* weights, std::int64_t limit) {
+  auto total = std::accumulate(weights->begin(), weights->end(),
+                               std::int64_t(0));
+  std::int64_t gcd = 0;
+  for (auto&& e : *weights) {
+    if (total > limit) {
+      e = std::max<std::int64_t>(e * limit / total, 1);
+    }
+    gcd = std::gcd(gcd, e);
+  }
+  for (auto&& e : *weights) {
+    e /= gcd;
+  }
+}
+
+// Runs smooth weighted round-robin until each peer is picked as many times as
+// its weight, and returns indices of the peers picked.
+std::vector<std::size_t> MakeRound(const std::vector<std::int64_t>& weights) {
+  std::vector<std::size_t> round;
+  if (std::all_of(weights.begin(), weights.end(),
+                  [](auto w) { return w == 1; })) {
+    // Plain round-robin then. It's what the loop below ends up with anyway,
+    // only faster.
+    round.resize(weights.size());
+    std::iota(round.begin(), round.end(), 0);
+    return round;
+  }
+
+  // Each peer earns its weight, and the one with the most is chosen and pays
+  // all peers' weight back.
+  auto total = std::accumulate(weights.begin(), weights.end(),
+                               std::int64_t(0));
+  std::vector<std::int64_t> current(weights.size());
+  for (std::int64_t i = 0; i != total; ++i) {
+    std::size_t chosen = 0;
+    for (std::size_t j = 0; j != weights.size(); ++j) {
+      current[j] += weights[j];
+      if (current[j] > current[chosen]) {
+        chosen = j;
+      }
+    }
+    current[chosen] -= total;
+    round.push_back(chosen);
+  }
+  return round;
+}
+
+}  // namespace
+
+WeightedRoundRobin::WeightedRoundRobin(bool locality_first)
+    : locality_first_(locality_first) {}
+
+WeightedRoundRobin::~WeightedRoundRobin() {}
+
+void WeightedRoundRobin::SetPeers(std::vector<Endpoint> addresses) {
+  std::vector<PeerInfo> peers;
+  for (auto&& e : addresses) {
+    peers.push_back(PeerInfo{.address = std::move(e)});
+  }
+  SetPeerInfos(std::move(peers));
+}
+
+void WeightedRoundRobin::SetPeerInfos(std::vector<PeerInfo> peers) {
+  // Peers we already know are kept, along with their statistics. We're the
+  // only writer, so it's safe to read them without `RcuReadLock`.
+  auto current = peers_.Get();
+  std::unordered_map<std::string, RefPtr<Peer>> known;
+  for (auto&& e : current->preferred.peers) {
+    known[e->address.ToString()] = e;
+  }
+  for (auto&& e : current->others.peers) {
+    known[e->address.ToString()] = e;
+  }
+
+  auto updated = std::make_unique<Peers>();
+  std::vector<std::int64_t> preferred_weights, other_weights;
+  for (auto&& e : peers) {
+    RefPtr<Peer> peer;
+    if (auto iter = known.find(e.address.ToString()); iter != known.end()) {
+      peer = std::move(iter->second);
+      known.erase(iter);
+    } else {
+      peer = MakeRefCounted<Peer>();
+      peer->address = e.address;  // `e` is still needed by `IsLocal`.
+    }
+    auto weight = std::max<std::int64_t>(e.weight, 1);
+    if (!locality_first_ || IsLocal(e)) {
+      updated->preferred_weight += weight;
+      updated->preferred.peers.push_back(std::move(peer));
+      preferred_weights.push_back(weight);
+    } else {
+      updated->others.peers.push_back(std::move(peer));
+      other_weights.push_back(weight);
+    }
+  }
+
+  for (auto&& [candidates, weights] :
+       {std::pair(&updated->preferred, &preferred_weights),
+        std::pair(&updated->others, &other_weights)}) {
+    NormalizeWeights(weights, kMaxRoundSize);
+    for (auto&& e : MakeRound(*weights)) {
+      candidates->round.push_back(candidates->peers[e].Get());
+    }
+  }
+  peers_.Reset(std::move(updated));
+}
+
+bool WeightedRoundRobin::GetPeer(std::uint64_t key, Endpoint* addr,
+                                 std::uintptr_t* ctx) {
+  auto now = ReadSteadyClock();
+  RcuReadLock rcu_lock;
+  auto&& [preferred, others, preferred_weight] = *peers_.Get();
+
+  auto saturated = false;
+  if (!others.peers.empty()) {
+    std::int64_t inflight = 0;
+    for (auto&& e : preferred.peers) {
+      inflight += e->inflight.load(std::memory_order_relaxed);
+    }
+    saturated = inflight >= static_cast<std::int64_t>(
+                                FLAGS_flare_rpc_locality_max_inflight) *
+                                preferred_weight;
+  }
+
+  Peer* chosen = nullptr;
+  if (!saturated) {
+    chosen = Pick(preferred, now, false);
+  }
+  if (!chosen) {
+    chosen = Pick(others, now, false);
+  }
+  if (!chosen && saturated) {
+    chosen = Pick(preferred, now, false);
+  }
+  if (!chosen) {
+    // None of them is healthy. Let's try our luck.
+    chosen = Pick(preferred.peers.empty() ? others : preferred, now, true);
+  }
+  if (FLARE_UNLIKELY(!chosen)) {
+    return false;
+  }
+
+  chosen->inflight.fetch_add(1, std::memory_order_relaxed);
+  chosen->Ref();  // Dropped in `Report`.
+  *addr = chosen->address;
+  *ctx = reinterpret_cast<std::uintptr_t>(chosen);
+  return true;
+}
+
+void WeightedRoundRobin::Report(const Endpoint& addr, Status status,
+                                std::chrono::nanoseconds time_cost,
+                                std::uintptr_t ctx) {
+  RefPtr<Peer> peer(adopt_ptr, reinterpret_cast<Peer*>(ctx));
+  peer->inflight.fetch_sub(1, std::memory_order_relaxed);
+  if (status == Status::Success) {
+    peer->consecutive_failures.store(0, std::memory_order_relaxed);
+  } else {
+    peer->last_failure.store(ReadSteadyClock().time_since_epoch().count(),
+                             std::memory_order_relaxed);
+    peer->consecutive_failures.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+bool WeightedRoundRobin::IsHealthy(
+    const Peer& peer, std::chrono::steady_clock::time_point now) const {
+  if (peer.consecutive_failures.load(std::memory_order_relaxed) <
+      kMaxConsecutiveFailures) {
+    return true;
+  }
+  // Give it another chance once it has been unhealthy for a while.
+  auto last_failure = std::chrono::steady_clock::time_point(
+      std::chrono::steady_clock::duration(
+          peer.last_failure.load(std::memory_order_relaxed)));
+  return now - last_failure > kUnhealthyPeriod;
+}
+
+WeightedRoundRobin::Peer* WeightedRoundRobin::Pick(
+    const Candidates& candidates, std::chrono::steady_clock::time_point now,
+    bool ignore_health) const {
+  auto&& round = candidates.round;
+  // Turns of unhealthy peers are consumed as well, so that the healthy ones
+  // are still picked in proportion to their weights.
+  for (std::size_t i = 0; i != round.size(); ++i) {
+    auto peer =
+        round[candidates.next.fetch_add(1, std::memory_order_relaxed) %
+              round.size()];
+    if (ignore_health || IsHealthy(*peer, now)) {
+      return peer;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace tinyRPC::load_balancer
@@ -0,0 +1,100 @@
+#ifndef _SRC_RPC_LOAD_BALANCER_WEIGHTED_ROUND_ROBIN_H_
+#define _SRC_RPC_LOAD_BALANCER_WEIGHTED_ROUND_ROBIN_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "gflags/gflags_declare.h"
+
+#include "../../base/Rcu.h"
+#include "../../base/RefPtr.h"
+#include "LoadBalancer.h"
+
+DECLARE_string(flare_rpc_locality);
+DECLARE_int32(flare_rpc_locality_max_inflight);
+
+namespace tinyRPC::load_balancer {
+
+// Smooth weighted round-robin (the one nginx uses). Each peer is chosen in
+// proportion to its weight, and picks of a heavy peer are interleaved with
+// those of the others rather than being made in a burst.
+//
+// If `locality_first` is set ("local-wrr"), peers local to us are preferred.
+// A peer is local if it's on this host, in the same subnet (/24 for IPv4, /64
+// for IPv6) as one of our interfaces, or if its locality matches
+// `FLAGS_flare_rpc_locality`. Remote peers are used only if none of the local
+// ones is healthy, or if the local ones are saturated (i.e., have more than
+// `FLAGS_flare_rpc_locality_max_inflight` in-flight calls per unit of weight).
+//
+// A peer is considered unhealthy for a while after several consecutive
+// failures.
+//
+// `GetPeer` is wait-free. A full round of picks (with weights scaled down if
+// they sum up to more than `kMaxRoundSize`) is computed by `SetPeers` and
+// published along with the peers, and callers walk it with an atomic cursor.
+// Unhealthy peers' turns are skipped, so the others still get picked in
+// proportion to their weights.
+//
+// `key` is ignored.
+class WeightedRoundRobin : public LoadBalancer {
+ public:
+  // Weights are scaled down if they sum up to more than this, to bound the
+  // size of a round (unless there are even more peers than this).
+  static constexpr std::int64_t kMaxRoundSize = 4096;
+
+  explicit WeightedRoundRobin(bool locality_first = false);
+  ~WeightedRoundRobin();
+
+  // All peers are weighted equally.
+  void SetPeers(std::vector<Endpoint> addresses) override;
+  void SetPeerInfos(std::vector<PeerInfo> peers) override;
+  bool GetPeer(std::uint64_t key, Endpoint* addr, std::uintptr_t* ctx) override;
+  void Report(const Endpoint& addr, Status status,
+              std::chrono::nanoseconds time_cost, std::uintptr_t ctx) override;
+
+ private:
+  // Kept alive (by `ctx` returned by `GetPeer`) until all calls made to it are
+  // reported, even if it's been removed by `SetPeers`.
+  struct Peer : RefCounted<Peer> {
+    Endpoint address;
+    std::atomic<std::int64_t> inflight{0};
+    std::atomic<int> consecutive_failures{0};
+    std::atomic<std::chrono::steady_clock::rep> last_failure{0};
+  };
+
+  // Peers to pick from, and the order they're picked in.
+  struct Candidates {
+    std::vector<RefPtr<Peer>> peers;
+    // A full round of smooth weighted round-robin over `peers`.
+    std::vector<Peer*> round;
+    // Position in `round` of the next pick.
+    mutable std::atomic<std::uint64_t> next{0};
+  };
+
+  bool IsHealthy(const Peer& peer,
+                 std::chrono::steady_clock::time_point now) const;
+
+  // Picks a healthy peer from `candidates`. Unless `ignore_health` is set,
+  // returns `nullptr` if none of them is healthy.
+  Peer* Pick(const Candidates& candidates,
+             std::chrono::steady_clock::time_point now,
+             bool ignore_health) const;
+
+ private:
+  bool locality_first_;
+
+  struct Peers {
+    // Local peers if `locality_first_` is set. All peers are here otherwise.
+    Candidates preferred;
+    Candidates others;
+    std::int64_t preferred_weight = 0;
+  };
+
+  RcuPtr<const Peers> peers_{std::make_unique<Peers>()};
+};
+
+}  // namespace tinyRPC::load_balancer
+
+#endif
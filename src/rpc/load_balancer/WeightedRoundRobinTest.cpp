@@ -0,0 +1,158 @@
+#include "WeightedRoundRobin.h"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "TestUtil.h"
+
+using namespace std::literals;
+
+namespace tinyRPC::load_balancer {
+
+using testing::Pick;
+using testing::PickWithFailingPeer;
+
+namespace {
+
+PeerInfo MakePeer(const std::string& ip, std::uint32_t weight,
+                  std::string locality = "") {
+  return PeerInfo{.address = EndpointFromIpv4(ip, 80),
+                  .weight = weight,
+                  .locality = std::move(locality)};
+}
+
+}  // namespace
+
+TEST(WeightedRoundRobin, Registry) {
+  EXPECT_TRUE(load_balancer_registry.TryNew("wrr"));
+  EXPECT_TRUE(load_balancer_registry.TryNew("local-wrr"));
+}
+
+TEST(WeightedRoundRobin, Empty) {
+  WeightedRoundRobin lb;
+  Endpoint peer;
+  std::uintptr_t ctx;
+  EXPECT_FALSE(lb.GetPeer(0, &peer, &ctx));
+}
+
+TEST(WeightedRoundRobin, Proportional) {
+  WeightedRoundRobin lb;
+  lb.SetPeerInfos({MakePeer("192.0.2.1", 1), MakePeer("192.0.2.2", 2),
+                   MakePeer("192.0.2.3", 3)});
+  std::unordered_map<std::string, int> counts;
+  for (int i = 0; i != 600; ++i) {
+    ++counts[Pick(&lb)];
+  }
+  EXPECT_EQ(100, counts["192.0.2.1"]);
+  EXPECT_EQ(200, counts["192.0.2.2"]);
+  EXPECT_EQ(300, counts["192.0.2.3"]);
+}
+
+TEST(WeightedRoundRobin, LargeWeights) {
+  WeightedRoundRobin lb;
+  // Scaled down to fit in a round, the ratio is kept.
+  lb.SetPeerInfos({MakePeer("192.0.2.1", 1000000), MakePeer("192.0.2.2", 1),
+                   MakePeer("192.0.2.3", 3000000)});
+  std::unordered_map<std::string, int> counts;
+  for (int i = 0; i != WeightedRoundRobin::kMaxRoundSize * 10; ++i) {
+    ++counts[Pick(&lb)];
+  }
+  EXPECT_NEAR(counts["192.0.2.3"], counts["192.0.2.1"] * 3,
+              counts["192.0.2.1"] * 3 / 100);
+  EXPECT_GT(counts["192.0.2.2"], 0);  // Never starved.
+}
+
+TEST(WeightedRoundRobin, Smooth) {
+  WeightedRoundRobin lb;
+  lb.SetPeerInfos({MakePeer("192.0.2.1", 5), MakePeer("192.0.2.2", 1),
+                   MakePeer("192.0.2.3", 1)});
+  std::vector<std::string> picks;
+  for (int i = 0; i != 7; ++i) {
+    picks.push_back(Pick(&lb));
+  }
+  // The heavy one is not picked 5 times in a row.
+  EXPECT_EQ((std::vector<std::string>{"192.0.2.1", "192.0.2.1", "192.0.2.2",
+                                      "192.0.2.1", "192.0.2.3", "192.0.2.1",
+                                      "192.0.2.1"}),
+            picks);
+}
+
+TEST(WeightedRoundRobin, SkipUnhealthy) {
+  WeightedRoundRobin lb;
+  lb.SetPeerInfos({MakePeer("192.0.2.1", 1), MakePeer("192.0.2.2", 1)});
+  for (int i = 0; i != 10; ++i) {
+    PickWithFailingPeer(&lb, "192.0.2.1");
+  }
+  for (int i = 0; i != 100; ++i) {
+    EXPECT_EQ("192.0.2.2", Pick(&lb));
+  }
+}
+
+TEST(WeightedRoundRobin, LocalityFirst) {
+  // 127.0.0.1 is on the loopback interface. Addresses in 198.51.100.0/24 are
+  // reserved for documentation, and are unlikely to be local.
+  WeightedRoundRobin lb(true);
+  lb.SetPeerInfos({MakePeer("127.0.0.1", 1), MakePeer("198.51.100.1", 100)});
+  for (int i = 0; i != 100; ++i) {
+    EXPECT_EQ("127.0.0.1", Pick(&lb));
+  }
+}
+
+TEST(WeightedRoundRobin, LocalityTag) {
+  FLAGS_flare_rpc_locality = "rack1";
+  WeightedRoundRobin lb(true);
+  lb.SetPeerInfos(
+      {MakePeer("198.51.100.1", 1, "rack1"), MakePeer("198.51.100.2", 1, "rack2")});
+  for (int i = 0; i != 100; ++i) {
+    EXPECT_EQ("198.51.100.1", Pick(&lb));
+  }
+  FLAGS_flare_rpc_locality = "";
+}
+
+TEST(WeightedRoundRobin, SpillOnUnhealthy) {
+  WeightedRoundRobin lb(true);
+  lb.SetPeerInfos({MakePeer("127.0.0.1", 1), MakePeer("198.51.100.1", 1)});
+  for (int i = 0; i != 3; ++i) {
+    EXPECT_EQ("127.0.0.1", Pick(&lb, LoadBalancer::Status::Failed));
+  }
+  EXPECT_EQ("198.51.100.1", Pick(&lb));
+}
+
+TEST(WeightedRoundRobin, SpillOnSaturation) {
+  WeightedRoundRobin lb(true);
+  lb.SetPeerInfos({MakePeer("127.0.0.1", 1), MakePeer("198.51.100.1", 1)});
+  std::vector<std::pair<Endpoint, std::uintptr_t>> calls;
+  std::unordered_map<std::string, int> counts;
+  for (int i = 0; i != FLAGS_flare_rpc_locality_max_inflight + 10; ++i) {
+    Endpoint peer;
+    std::uintptr_t ctx;
+    ASSERT_TRUE(lb.GetPeer(0, &peer, &ctx));
+    ++counts[EndpointGetIp(peer)];
+    calls.emplace_back(peer, ctx);
+  }
+  EXPECT_EQ(FLAGS_flare_rpc_locality_max_inflight, counts["127.0.0.1"]);
+  EXPECT_EQ(10, counts["198.51.100.1"]);
+  for (auto&& [peer, ctx] : calls) {
+    lb.Report(peer, LoadBalancer::Status::Success, 1ms, ctx);
+  }
+  EXPECT_EQ("127.0.0.1", Pick(&lb));  // Back to local.
+}
+
+TEST(WeightedRoundRobin, KeepStatisticsOnUpdate) {
+  WeightedRoundRobin lb;
+  lb.SetPeerInfos({MakePeer("192.0.2.1", 1), MakePeer("192.0.2.2", 1)});
+  for (int i = 0; i != 10; ++i) {
+    PickWithFailingPeer(&lb, "192.0.2.1");
+  }
+  lb.SetPeerInfos({MakePeer("192.0.2.1", 1), MakePeer("192.0.2.2", 1),
+                   MakePeer("192.0.2.3", 1)});
+  for (int i = 0; i != 100; ++i) {
+    EXPECT_NE("192.0.2.1", Pick(&lb));  // Still unhealthy.
+  }
+}
+
+}  // namespace tinyRPC::load_balancer
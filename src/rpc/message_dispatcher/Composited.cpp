@@ -27,9 +27,9 @@ bool Composited::GetPeer(std::uint64_t key, Endpoint* addr,
   if (version != last_version_.load(std::memory_order_relaxed)) {
     std::scoped_lock _(reset_peers_lock_);
     if (version != last_version_.load(std::memory_order_relaxed)) {  // DCLP.
-      std::vector<Endpoint> peers;
-      nrv_->GetPeers(&peers);
-      lb_->SetPeers(std::move(peers));
+      std::vector<PeerInfo> peers;
+      nrv_->GetPeerInfos(&peers);
+      lb_->SetPeerInfos(std::move(peers));
       last_version_.store(version, std::memory_order_relaxed);
     }
   }
@@ -37,5 +37,11 @@ bool Composited::GetPeer(std::uint64_t key, Endpoint* addr,
   return lb_->GetPeer(key, addr, ctx);
 }
 
+void Composited::Report(const Endpoint& addr, Status status,
+                        std::chrono::nanoseconds time_cost,
+                        std::uintptr_t ctx) {
+  lb_->Report(addr, status, time_cost, ctx);
+}
+
 
 }  
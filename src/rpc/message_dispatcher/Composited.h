@@ -20,6 +20,8 @@ class Composited : public MessageDispatcher {
 
   bool Open(const std::string& name) override;
   bool GetPeer(std::uint64_t key, Endpoint* addr, std::uintptr_t* ctx) override;
+  void Report(const Endpoint& addr, Status status,
+              std::chrono::nanoseconds time_cost, std::uintptr_t ctx) override;
 
  private:
   NameResolver* nr_;
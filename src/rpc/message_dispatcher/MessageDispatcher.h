@@ -43,6 +43,12 @@ class MessageDispatcher {
 
   using Status = LoadBalancer::Status;
 
+  // Feeds back the result of a call made to a peer returned by `GetPeer`.
+  //
+  // @sa: `LoadBalancer::Report`.
+  virtual void Report(const Endpoint& addr, Status status,
+                      std::chrono::nanoseconds time_cost,
+                      std::uintptr_t ctx) = 0;
 };
 
 FLARE_DECLARE_CLASS_DEPENDENCY_REGISTRY(message_dispatcher_registry,
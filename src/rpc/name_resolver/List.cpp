@@ -17,6 +17,32 @@ bool SplitAddr(std::string_view addr, std::string* hostname, uint16_t* port) {
   return false;
 }
 
+// Splits "addr;weight=N;locality=X" into address and attributes of the peer.
+bool SplitAttributes(std::string_view entry, std::string_view* addr,
+                     PeerInfo* attributes) {
+  auto parts = Split(entry, ';');
+  *addr = parts[0];
+  for (std::size_t i = 1; i != parts.size(); ++i) {
+    auto pos = parts[i].find('=');
+    if (pos == std::string_view::npos) {
+      return false;
+    }
+    auto key = parts[i].substr(0, pos), value = parts[i].substr(pos + 1);
+    if (key == "weight") {
+      auto weight = TryParse<std::uint32_t>(value);
+      if (!weight || *weight == 0) {
+        return false;
+      }
+      attributes->weight = *weight;
+    } else if (key == "locality") {
+      attributes->locality = std::string(value);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace
 
 FLARE_RPC_REGISTER_NAME_RESOLVER("list", List);
@@ -24,8 +50,14 @@ FLARE_RPC_REGISTER_NAME_RESOLVER("list", List);
 List::List() { updater_ = GetUpdater(); }
 
 bool List::CheckValid(const std::string& name) {
-  auto addrs = Split(name, ',');
-  for (auto&& e : addrs) {
+  auto entries = Split(name, ',');
+  for (auto&& entry : entries) {
+    std::string_view e;
+    PeerInfo attributes;
+    if (!SplitAttributes(entry, &e, &attributes)) {
+      FLARE_LOG_ERROR("Attributes invalid {}", entry);
+      return false;
+    }
     std::string hostname;
     uint16_t port;
     if (!SplitAddr(e, &hostname, &port)) {
@@ -45,25 +77,34 @@ bool List::CheckValid(const std::string& name) {
   return true;
 }
 
-bool List::GetRouteTable(const std::string& name,
-                         const std::string& old_signature,
-                         std::vector<Endpoint>* new_address,
-                         std::string* new_signature) {
-  auto addrs = Split(name, ",");
-  for (auto&& e : addrs) {
+bool List::GetWeightedRouteTable(const std::string& name,
+                                 const std::string& old_signature,
+                                 std::vector<PeerInfo>* new_peers,
+                                 std::string* new_signature) {
+  auto entries = Split(name, ",");
+  for (auto&& entry : entries) {
+    std::string_view e;
+    PeerInfo attributes;
+    FLARE_CHECK(SplitAttributes(entry, &e, &attributes),
+                "Attributes should already be checked");
     std::string hostname;
     uint16_t port;
     FLARE_CHECK(SplitAddr(e, &hostname, &port),
                 "Addr should already be checked");
+    std::vector<Endpoint> addresses;
     if (hostname.size() > 2 && e.find('[') != std::string_view::npos) {
       // hostname ex : [2001:db8::1]
-      new_address->push_back(
+      addresses.push_back(
           EndpointFromIpv6(hostname.substr(1, hostname.size() - 2), port));
     } else if (hostname.size() > 2 && isdigit(hostname[0]) &&
                isdigit(hostname.back())) {
-      new_address->push_back(EndpointFromIpv4(hostname, port));
+      addresses.push_back(EndpointFromIpv4(hostname, port));
     } else {
-      tinyRPC::name_resolver::util::ResolveDomain(hostname, port, new_address);
+      tinyRPC::name_resolver::util::ResolveDomain(hostname, port, &addresses);
+    }
+    for (auto&& address : addresses) {
+      new_peers->push_back(attributes);
+      new_peers->back().address = std::move(address);
     }
   }
   return true;
@@ -12,6 +12,13 @@ namespace tinyRPC::name_resolver {
 // name e.g.: 192.0.2.1:80,192.0.2.2:8080,[2001:db8::1]:8088,www.qq.com:443
 //
 // IP (v4 / v6) and domain.
+//
+// Each address may be followed by attributes of the peer, separated by ';':
+//
+// - `weight=N`: Weight of the peer, 1 if not specified.
+// - `locality=X`: Locality of the peer (@sa: `PeerInfo::locality`).
+//
+// e.g.: 192.0.2.1:80;weight=3;locality=rack1,192.0.2.2:8080
 class List : public NameResolverImpl {
  public:
   List();
@@ -19,9 +26,10 @@ class List : public NameResolverImpl {
  private:
   bool CheckValid(const std::string& name) override;
 
-  bool GetRouteTable(const std::string& name, const std::string& old_signature,
-                     std::vector<Endpoint>* new_address,
-                     std::string* new_signature) override;
+  bool GetWeightedRouteTable(const std::string& name,
+                             const std::string& old_signature,
+                             std::vector<PeerInfo>* new_peers,
+                             std::string* new_signature) override;
 };
 
 }  // namespace tinyRPC::name_resolver
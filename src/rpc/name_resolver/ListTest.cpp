@@ -23,4 +23,22 @@ TEST(ListNameResolver, StartResolving) {
   ASSERT_EQ("[2001:db8::1]:8088", peers[2].ToString());
 }
 
+TEST(ListNameResolver, Attributes) {
+  List resolver;
+  EXPECT_FALSE(resolver.StartResolving("192.0.2.1:80;weight=0"));
+  EXPECT_FALSE(resolver.StartResolving("192.0.2.1:80;color=red"));
+  auto view = resolver.StartResolving(
+      "192.0.2.1:80;weight=3;locality=rack1,192.0.2.2:8080");
+  ASSERT_TRUE(!!view);
+  std::vector<PeerInfo> peers;
+  view->GetPeerInfos(&peers);
+  ASSERT_EQ(2, peers.size());
+  EXPECT_EQ("192.0.2.1:80", peers[0].address.ToString());
+  EXPECT_EQ(3, peers[0].weight);
+  EXPECT_EQ("rack1", peers[0].locality);
+  EXPECT_EQ("192.0.2.2:8080", peers[1].address.ToString());
+  EXPECT_EQ(1, peers[1].weight);
+  EXPECT_EQ("", peers[1].locality);
+}
+
 }  // namespace tinyRPC::name_resolver
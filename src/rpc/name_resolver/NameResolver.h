@@ -7,6 +7,7 @@
 
 #include "../../base/DependencyRegistry.h"
 #include "../../base/Endpoint.h"
+#include "../PeerInfo.h"
 
 namespace tinyRPC {
 
@@ -47,6 +48,17 @@ class NameResolutionView {
   // However, since we also implemented our own "generic" cache, it's allowed
   // for the implementation not to implement cache behavior at all.
   virtual void GetPeers(std::vector<Endpoint>* addresses) = 0;
+
+  // Same as `GetPeers`, with weight and locality of each peer. Implementations
+  // that don't know about them may leave this method as-is.
+  virtual void GetPeerInfos(std::vector<PeerInfo>* peers) {
+    std::vector<Endpoint> addresses;
+    GetPeers(&addresses);
+    peers->clear();
+    for (auto&& e : addresses) {
+      peers->push_back(PeerInfo{.address = std::move(e)});
+    }
+  }
 };
 
 // `NameResolver` is responsible for resolving name to a list of
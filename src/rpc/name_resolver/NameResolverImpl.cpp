@@ -58,12 +58,13 @@ std::unique_ptr<NameResolutionView> NameResolverImpl::StartResolving(const std::
 
 void NameResolverImpl::UpdateRoute(
     const std::string& name, std::shared_ptr<RouteInfo> route_info) {
-  std::vector<Endpoint> new_address_table;
+  std::vector<PeerInfo> new_address_table;
   std::string old_signature, new_signature;
   if (name_signatures_.find(name) != name_signatures_.end()) {
     old_signature = name_signatures_[name];
   }
-  if (!GetRouteTable(name, old_signature, &new_address_table, &new_signature)) {
+  if (!GetWeightedRouteTable(name, old_signature, &new_address_table,
+                             &new_signature)) {
     return;
   }
   if (!new_signature.empty()) {
@@ -75,13 +76,40 @@ void NameResolverImpl::UpdateRoute(
     }
   }
   std::sort(new_address_table.begin(), new_address_table.end(), [] (auto&& left, auto&& right) {
-    return left.ToString() < right.ToString();
+    return left.address.ToString() < right.address.ToString();
   });
-  std::scoped_lock lk(route_info->route_mutex);
-  if (new_address_table != route_info->route_table) {
-    route_info->route_table = std::move(new_address_table);
-    route_info->version.fetch_add(1, std::memory_order_relaxed);
+  {
+    RcuReadLock _;
+    if (new_address_table == *route_info->route_table.Get()) {
+      return;
+    }
+  }
+  route_info->route_table.Reset(
+      std::make_unique<std::vector<PeerInfo>>(std::move(new_address_table)));
+  // Readers seeing the new version see the new table as well.
+  route_info->version.fetch_add(1, std::memory_order_release);
+}
+
+bool NameResolverImpl::GetRouteTable(const std::string& name,
+                                     const std::string& old_signature,
+                                     std::vector<Endpoint>* new_address,
+                                     std::string* new_signature) {
+  FLARE_UNREACHABLE(
+      "Either `GetRouteTable` or `GetWeightedRouteTable` must be overridden.");
+}
+
+bool NameResolverImpl::GetWeightedRouteTable(const std::string& name,
+                                             const std::string& old_signature,
+                                             std::vector<PeerInfo>* new_peers,
+                                             std::string* new_signature) {
+  std::vector<Endpoint> addresses;
+  if (!GetRouteTable(name, old_signature, &addresses, new_signature)) {
+    return false;
+  }
+  for (auto&& e : addresses) {
+    new_peers->push_back(PeerInfo{.address = std::move(e)});
   }
+  return true;
 }
 
 NameResolverUpdater* NameResolverImpl::GetUpdater() {
@@ -98,12 +126,22 @@ NameResolutionViewImpl::~NameResolutionViewImpl() {
 }
 
 std::int64_t NameResolutionViewImpl::GetVersion() {
-  return route_->version;
+  return route_->version.load(std::memory_order_acquire);
 }
 
 void NameResolutionViewImpl::GetPeers(std::vector<Endpoint>* addresses) {
-  std::scoped_lock lk(route_->route_mutex);
-  addresses->assign(route_->route_table.begin(), route_->route_table.end());
+  RcuReadLock _;
+  auto&& route_table = *route_->route_table.Get();
+  addresses->clear();
+  for (auto&& e : route_table) {
+    addresses->push_back(e.address);
+  }
+}
+
+void NameResolutionViewImpl::GetPeerInfos(std::vector<PeerInfo>* peers) {
+  RcuReadLock _;
+  auto&& route_table = *route_->route_table.Get();
+  peers->assign(route_table.begin(), route_table.end());
 }
 
 }  // namespace tinyRPC::name_resolver
@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "../../base/Endpoint.h"
+#include "../../base/Rcu.h"
 #include "NameResolver.h"
 #include "NameResolverUpdater.h"
 
@@ -24,10 +25,10 @@ class NameResolverImpl : public NameResolver {
  public:
   struct RouteInfo {
     RouteInfo() = default;
-    // Sorted by string of endpoint.
-    std::vector<Endpoint> route_table;
+    // Sorted by string of endpoint. Read it with `RcuReadLock` held.
+    RcuPtr<const std::vector<PeerInfo>> route_table{
+        std::make_unique<std::vector<PeerInfo>>()};
     std::atomic<int64_t> version = 0;
-    std::shared_mutex route_mutex;
   };
   virtual ~NameResolverImpl();
   std::unique_ptr<NameResolutionView> StartResolving(
@@ -51,10 +52,18 @@ class NameResolverImpl : public NameResolver {
   // old_signature. We will consider the route address has not changed and
   // directly return. We will set the value of old_signature to new_signature
   // for the next turn.
+  //
+  // Subclasses must override either this method or `GetWeightedRouteTable`.
   virtual bool GetRouteTable(const std::string& name,
                              const std::string& old_signature,
                              std::vector<Endpoint>* new_address,
-                             std::string* new_signature) = 0;
+                             std::string* new_signature);
+  // Same as `GetRouteTable`, with weight and locality of each peer. By default
+  // `GetRouteTable` is called and peers are weighted equally.
+  virtual bool GetWeightedRouteTable(const std::string& name,
+                                     const std::string& old_signature,
+                                     std::vector<PeerInfo>* new_peers,
+                                     std::string* new_signature);
 
  protected:
   std::shared_mutex name_mutex_;
@@ -71,6 +80,7 @@ class NameResolutionViewImpl : public NameResolutionView {
   virtual ~NameResolutionViewImpl();
   std::int64_t GetVersion() override;
   void GetPeers(std::vector<Endpoint>* addresses) override;
+  void GetPeerInfos(std::vector<PeerInfo>* peers) override;
 
  private:
   std::shared_ptr<NameResolverImpl::RouteInfo> route_;
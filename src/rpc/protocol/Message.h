@@ -13,9 +13,21 @@ class Message {
  public:
   virtual ~Message() = default;
 
+  // Bitmask. `StartOfStream` and `EndOfStream` imply `Stream`.
   enum class Type : std::uint64_t {
     // There is no stream involved.
-    Single
+    Single = 1,
+
+    // The message is part of a stream.
+    Stream = 2,
+
+    // The message starts a new stream. Only set on messages sent by the
+    // caller.
+    StartOfStream = Stream | 4,
+
+    // Nothing else will be sent by the sender in this stream. Note that the
+    // opposite direction of the stream may still be open.
+    EndOfStream = Stream | 8
   };
 
   // Value of this constant does not matter, as there's only one call on the
@@ -33,6 +45,13 @@ class Message {
 
   // Returns type of this message. @sa: `Type`.
   virtual Type GetType() const noexcept = 0;
+
+  // If this message is a window update of a stream (@sa: `StreamIoAdaptor`),
+  // returns number of messages the peer has consumed. Otherwise 0 is returned.
+  //
+  // Window updates are handled by the framework, and are never passed to
+  // services.
+  virtual std::uint32_t GetStreamWindowUpdate() const noexcept { return 0; }
 };
 
 // Factory for producing "special" messages.
@@ -64,6 +83,15 @@ class MessageFactory {
   virtual std::unique_ptr<Message> Create(Type type,
                                           std::uint64_t correlation_id) const = 0;
 
+  // Creates a message telling the peer we've consumed `consumed` more messages
+  // of stream `correlation_id` (@sa: `GetStreamWindowUpdate`).
+  //
+  // Protocols not supporting streaming RPC needn't override this.
+  virtual std::unique_ptr<Message> CreateStreamWindowUpdate(
+      std::uint64_t correlation_id, std::uint32_t consumed) const {
+    return nullptr;
+  }
+
   // A predefined factory that always returns `nullptr`.
   static const MessageFactory* null_factory;
 };
@@ -4,6 +4,7 @@
 #include <memory>
 #include <string>
 
+#include "../../base/Buffer.h"
 #include "../../base/DependencyRegistry.h"
 #include "../../base/Enum.h"
 #include "Controller.h"
@@ -88,7 +89,7 @@ class StreamProtocol {
   // For optimization, the implementation may return a partially parsed message
   // here and left the rest to `TryParse(...)`, which is called in "worker"
   // thread.
-  virtual MessageCutStatus TryCutMessage(std::string& buffer,
+  virtual MessageCutStatus TryCutMessage(NoncontiguousBuffer& buffer,
                                          std::unique_ptr<Message>* message) = 0;
 
   // If `TryCutMessage` has already done all parsing, this method could just
@@ -103,7 +104,7 @@ class StreamProtocol {
                         Controller* controller) = 0;
 
   // Serialize `message` to `buffer`.
-  virtual void WriteMessage(const Message& message, std::string& buffer,
+  virtual void WriteMessage(const Message& message, NoncontiguousBuffer& buffer,
                             Controller* controller) = 0;
 };
 
@@ -15,6 +15,12 @@ namespace tinyRPC {
 
 class StreamProtocol;
 
+namespace rpc::internal {
+
+class StreamIoAdaptor;
+
+}  // namespace rpc::internal
+
 // The implementation is responsible for processing messages received by
 // `Server`. Only messages extracted by `StreamProtocol` is tried on
 // `StreamService`.
@@ -111,6 +117,24 @@ class StreamService {
     Unexpected
   };
 
+  // Determines where a fast call is run.
+  enum class ExecutionPolicy {
+    // The call is run in a dedicated fiber. This is the default.
+    Detached,
+
+    // If the request is the last one in the batch read from the connection,
+    // the call is run in the I/O fiber, which saves us a fiber creation and
+    // (likely) waking up another worker. Other requests in the batch are still
+    // run in dedicated fibers, so as not to delay them.
+    //
+    // Use it for short, non-blocking methods only. The connection is not read
+    // until the call returns.
+    Inline,
+
+    // Same as `Inline` if the method has been returning quickly recently, same
+    // as `Detached` otherwise.
+    Adaptive
+  };
 
   // Inspects `message` and if the implementation recognizes the message,
   // returns some basic information needed by the framework. The framework
@@ -125,6 +149,17 @@ class StreamService {
   virtual bool Inspect(const Message& message, const Controller& controller,
                        InspectionResult* result) = 0;
 
+  // Returns true if some of the calls may be run inline. If not, the framework
+  // won't bother asking `ShouldRunInline` (which requires the request to be
+  // parsed in the I/O fiber).
+  virtual bool MayRunInline() const { return false; }
+
+  // Called in the I/O fiber for the last request in a batch (already parsed),
+  // to determine if it should be run inline (@sa: `ExecutionPolicy`).
+  //
+  // Make it fast.
+  virtual bool ShouldRunInline(const Message& message) { return false; }
+
   // For both `FastCall` and `StreamCall`:
   //
   // These two methods are responsible for dealing with facilities such as
@@ -133,17 +168,38 @@ class StreamService {
 
   // Handles RPCs in one-response-to-one-request fashion.
   //
-  // Called outside of event loop's workers. Blocking is acceptable.
+  // Called outside of event loop's workers. Blocking is acceptable, but not
+  // required: The implementation may return before the call finishes.
   //
   // To be more responsiveness, `writer` is provided for the implementation to
   // write response (before even returning from this method). The Implementation
   // should call `writer` exactly once (on success).
   //
+  // If `Processed` or `Completed` is returned, `on_completion` must be called
+  // exactly once after the call has finished (response written, `status`
+  // filled). It can be called either before this method returns, or later in
+  // any fiber. `request`, `writer` and `context` are kept alive by the
+  // framework until then, and must not be touched afterwards.
+  //
   // `request` should be left untouched if a failure status is returned.
   virtual ProcessingStatus FastCall(
       std::unique_ptr<Message>* request,
       const UniqueFunction<std::size_t(const Message&)>& writer,
-      Context* context) = 0;
+      Context* context, UniqueFunction<void()> on_completion) = 0;
+
+  // Handles streaming RPCs. The first message of the stream can be `Peek`-ed
+  // (already parsed) from `stream`.
+  //
+  // Called in a dedicated fiber, blocking is expected. The stream is finished
+  // once the last reference to `stream` is dropped, which is usually the case
+  // when this method returns. `context` is only valid until then.
+  //
+  // Protocols not supporting streaming RPC needn't override this.
+  virtual ProcessingStatus StreamCall(
+      std::shared_ptr<rpc::internal::StreamIoAdaptor> stream,
+      Context* context) {
+    return ProcessingStatus::Unexpected;
+  }
 
   virtual void Stop() = 0;
   virtual void Join() = 0;
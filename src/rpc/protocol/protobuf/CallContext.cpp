@@ -4,6 +4,9 @@ namespace tinyRPC::protobuf {
 
 MaybeOwning<google::protobuf::Message>
 ProactiveCallContext::GetOrCreateResponse() {
+  if (!expecting_stream) {
+    return MaybeOwning(non_owning, response_ptr);
+  }
   FLARE_CHECK(response_prototype);
   return MaybeOwning(owning, response_prototype->New());
 }
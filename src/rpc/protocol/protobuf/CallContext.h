@@ -19,6 +19,9 @@ struct ProactiveCallContext : Controller {
   // Method being called.
   const google::protobuf::MethodDescriptor* method;
 
+  // Set for streaming RPCs, each response is parsed into a new message then.
+  bool expecting_stream = false;
+
   // Return `response_ptr` or create a new response buffer from
   // `response_prototype`, depending on whether `expecting_stream` is set.
   MaybeOwning<google::protobuf::Message> GetOrCreateResponse();
@@ -0,0 +1,104 @@
+#include "Compression.h"
+
+#include <string_view>
+
+#include "gflags/gflags.h"
+
+#include "../../../base/Logging.h"
+#include "../../../base/compression/Compression.h"
+
+DEFINE_int32(flare_rpc_compression_min_size, 256,
+             "Messages (body and attachment in total) smaller than this are "
+             "never compressed, even if compression is requested. The saving "
+             "hardly pays for the CPU cycles spent.");
+
+namespace tinyRPC::protobuf::compression {
+
+namespace {
+
+// Name of compressor / decompressor implementing `algorithm` in the registry.
+std::string_view GetCompressorName(rpc::CompressionAlgorithm algorithm) {
+  switch (algorithm) {
+    case rpc::COMPRESSION_ALGORITHM_GZIP:
+      return "gzip";
+    case rpc::COMPRESSION_ALGORITHM_LZ4_FRAME:
+      return "lz4-frame";
+    case rpc::COMPRESSION_ALGORITHM_ZSTD:
+      return "zstd";
+    default:  // Including `COMPRESSION_ALGORITHM_SNAPPY`, not implemented.
+      return {};
+  }
+}
+
+std::uint64_t InitializeAcceptableCompressionAlgorithms() {
+  std::uint64_t result = 1ULL << rpc::COMPRESSION_ALGORITHM_NONE;
+  for (int i = rpc::CompressionAlgorithm_MIN;
+       i <= rpc::CompressionAlgorithm_MAX; ++i) {
+    auto name = GetCompressorName(static_cast<rpc::CompressionAlgorithm>(i));
+    if (!name.empty() && decompressor_registry.TryGetFactory(name)) {
+      result |= 1ULL << i;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+std::uint64_t GetAcceptableCompressionAlgorithms() {
+  // Compressors are registered before `main`, this never changes afterwards.
+  static const auto result = InitializeAcceptableCompressionAlgorithms();
+  return result;
+}
+
+rpc::CompressionAlgorithm SelectCompressionAlgorithm(
+    rpc::CompressionAlgorithm desired, std::uint64_t acceptable,
+    std::size_t size) {
+  if (FLARE_LIKELY(!IsCompressed(desired)) ||
+      size < FLAGS_flare_rpc_compression_min_size ||
+      !(acceptable & (1ULL << desired)) ||
+      !(GetAcceptableCompressionAlgorithms() & (1ULL << desired))) {
+    return rpc::COMPRESSION_ALGORITHM_NONE;
+  }
+  return desired;
+}
+
+void SetCompressionAlgorithm(rpc::CompressionAlgorithm desired,
+                             std::uint64_t acceptable, const PBMessage& msg,
+                             const NoncontiguousBuffer& attachment,
+                             rpc::RpcMeta* meta) {
+  if (FLARE_LIKELY(!IsCompressed(desired))) {
+    return;  // Don't bother computing the size then.
+  }
+  auto algorithm = SelectCompressionAlgorithm(
+      desired, acceptable, GetByteSize(msg) + attachment.ByteSize());
+  if (IsCompressed(algorithm)) {
+    meta->set_compression_algorithm(algorithm);
+    meta->set_attachment_compressed(!attachment.Empty());
+  }
+}
+
+bool Compress(rpc::CompressionAlgorithm algorithm,
+              const NoncontiguousBuffer& buffer,
+              NoncontiguousBufferBuilder* builder) {
+  auto compressor = MakeCompressor(GetCompressorName(algorithm));
+  if (FLARE_UNLIKELY(!compressor)) {
+    FLARE_LOG_WARNING_ONCE("Compression algorithm #{} is not supported.",
+                           static_cast<int>(algorithm));
+    return false;
+  }
+  return tinyRPC::Compress(compressor.get(), buffer, builder);
+}
+
+std::optional<NoncontiguousBuffer> Decompress(
+    rpc::CompressionAlgorithm algorithm, const NoncontiguousBuffer& buffer,
+    std::size_t max_size) {
+  auto decompressor = MakeDecompressor(GetCompressorName(algorithm));
+  if (FLARE_UNLIKELY(!decompressor)) {
+    FLARE_LOG_WARNING_ONCE("Compression algorithm #{} is not supported.",
+                           static_cast<int>(algorithm));
+    return std::nullopt;
+  }
+  return tinyRPC::Decompress(decompressor.get(), buffer, max_size);
+}
+
+}  // namespace tinyRPC::protobuf::compression
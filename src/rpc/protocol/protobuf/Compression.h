@@ -0,0 +1,66 @@
+#ifndef _SRC_RPC_PROTOCOL_PROTOBUF_COMPRESSION_H_
+#define _SRC_RPC_PROTOCOL_PROTOBUF_COMPRESSION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "gflags/gflags_declare.h"
+
+#include "../../../base/Buffer.h"
+#include "Message.h"
+#include "rpc_meta.pb.h"
+
+DECLARE_int32(flare_rpc_compression_min_size);
+
+// Glue between `rpc::CompressionAlgorithm` and compressors in
+// `base/compression`.
+
+namespace tinyRPC::protobuf::compression {
+
+// Returns `true` if `algorithm` actually compresses something, i.e., it's
+// neither `UNKNOWN` nor `NONE`.
+constexpr bool IsCompressed(rpc::CompressionAlgorithm algorithm) {
+  return algorithm > rpc::COMPRESSION_ALGORITHM_NONE;
+}
+
+// Bitmask (of `1 << algorithm`) of algorithms we're able to decompress. This
+// is what we tell our peer via `acceptable_compression_algorithms`.
+std::uint64_t GetAcceptableCompressionAlgorithms();
+
+// Determines algorithm to use for compressing `size` bytes (body and
+// attachment) sent to a peer accepting `acceptable` (@sa:
+// `GetAcceptableCompressionAlgorithms`).
+//
+// `COMPRESSION_ALGORITHM_NONE` is returned if `desired` is not accepted by the
+// peer, not supported by us, or the message is too small to bother
+// (@sa: `FLAGS_flare_rpc_compression_min_size`).
+rpc::CompressionAlgorithm SelectCompressionAlgorithm(
+    rpc::CompressionAlgorithm desired, std::uint64_t acceptable,
+    std::size_t size);
+
+// Fills `compression_algorithm` (and `attachment_compressed`) of `meta` of a
+// message carrying `msg` and `attachment`, using `desired` if it's selected by
+// `SelectCompressionAlgorithm`. The message is compressed by the protocol
+// object on serialization.
+//
+// Not applicable to streams, as their messages share the same meta.
+void SetCompressionAlgorithm(rpc::CompressionAlgorithm desired,
+                             std::uint64_t acceptable, const PBMessage& msg,
+                             const NoncontiguousBuffer& attachment,
+                             rpc::RpcMeta* meta);
+
+// Compresses `buffer` using `algorithm`, appending result to `builder`.
+bool Compress(rpc::CompressionAlgorithm algorithm,
+              const NoncontiguousBuffer& buffer,
+              NoncontiguousBufferBuilder* builder);
+
+// Decompresses `buffer` using `algorithm`. Fails if the result would be larger
+// than `max_size`.
+std::optional<NoncontiguousBuffer> Decompress(
+    rpc::CompressionAlgorithm algorithm, const NoncontiguousBuffer& buffer,
+    std::size_t max_size);
+
+}  // namespace tinyRPC::protobuf::compression
+
+#endif
@@ -0,0 +1,235 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "../../../../include/benchmark/benchmark.h"
+#include "../../../base/ObjectPool.h"
+#include "../../../base/chrono.h"
+#include "../../../fiber/Latch.h"
+#include "../../../init.h"
+#include "../../../io/EventLoop.h"
+#include "../../../io/native/Acceptor.h"
+#include "../../../io/native/StreamConnection.h"
+#include "../../../io/util/Socket.h"
+#include "../../../testing/Endpoint.h"
+#include "../../../testing/echo_service.pb.h"
+#include "../../internal/CorrelationID.h"
+#include "../../internal/StreamCallGate.h"
+#include "CallContext.h"
+#include "Message.h"
+#include "stdProtocol.h"
+
+// Allocations made per (non-streaming) RPC, from issuing the call to its
+// completion, against a loopback server.
+//
+// The call is made the way `RpcChannel` makes it: a pooled call object carries
+// everything the call needs (including the meta) and is handed to the call gate
+// as its `FastCallArgs`. Allocations made by the server's message handler are
+// not counted.
+//
+// allocs/call:   Allocations made by the client side, per call.
+// issue_allocs:  Allocations made in `StreamCallGate::FastCall` (serialization,
+//                call map, timeout timer), per call.
+
+namespace {
+
+std::atomic<std::uint64_t> allocations{0};
+thread_local bool in_server = false;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  if (!in_server) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (auto p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+// Not inlined, otherwise GCC complains about `free`-ing memory returned by
+// `operator new`.
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace tinyRPC::protobuf {
+
+namespace {
+
+using rpc::internal::StreamCallGate;
+
+struct Call final : StreamCallGate::FastCallArgs {
+  ProactiveCallContext call_ctx;
+  rpc::RpcMeta meta;
+  fiber::Latch* latch;
+
+  void OnCompletion(StreamCallGate::CompletionStatus status,
+                    StreamCallGate::MessagePtr,
+                    const StreamCallGate::Timestamps&) override {
+    FLARE_CHECK(status == StreamCallGate::CompletionStatus::Success);
+    latch->count_down();
+  }
+
+  void Destroy() noexcept override {
+    meta.Clear();
+    ResetRefCount();
+    object_pool::Put<Call>(this);
+  }
+};
+
+}  // namespace
+
+}  // namespace tinyRPC::protobuf
+
+namespace tinyRPC::object_pool {
+
+template <>
+struct PoolTraits<protobuf::Call> {
+  static constexpr std::size_t kLocalCacheSize = 1024;
+  static constexpr std::size_t kTransferCacheSize = 16384;
+  static constexpr std::size_t kTransferBatchSize = 256;
+};
+
+}  // namespace tinyRPC::object_pool
+
+namespace tinyRPC::protobuf {
+
+namespace {
+
+// Responds to each request with an empty `EchoResponse`.
+class LoopbackServer : public StreamConnectionHandler {
+ public:
+  explicit LoopbackServer(const Endpoint& ep) {
+    auto listen_fd = io::util::CreateListener(ep, 100);
+    FLARE_CHECK(listen_fd);
+    io::util::SetNonBlocking(listen_fd.Get());
+    io::util::SetCloseOnExec(listen_fd.Get());
+    NativeAcceptor::Options opts;
+    opts.connection_handler = [this](Handle fd, const Endpoint&) {
+      io::util::SetNonBlocking(fd.Get());
+      io::util::SetCloseOnExec(fd.Get());
+      NativeStreamConnection::Options opts;
+      opts.handler = MaybeOwning(non_owning, this);
+      opts.read_buffer_size = 1048576;
+      conn_ = std::make_shared<NativeStreamConnection>(std::move(fd),
+                                                       std::move(opts));
+      GetGlobalEventLoop(0)->AttachDescriptor(conn_);
+      conn_->StartHandshaking();
+    };
+    acceptor_ =
+        std::make_shared<NativeAcceptor>(std::move(listen_fd), std::move(opts));
+    GetGlobalEventLoop(0)->AttachDescriptor(acceptor_);
+  }
+
+  ~LoopbackServer() {
+    acceptor_->Stop();
+    acceptor_->Join();
+    if (conn_) {
+      conn_->Stop();
+      conn_->Join();
+    }
+  }
+
+  DataConsumptionStatus OnDataArrival(NoncontiguousBuffer& buffer) override {
+    in_server = true;
+    std::unique_ptr<Message> msg;
+    NoncontiguousBuffer responses;
+    while (protocol_.TryCutMessage(buffer, &msg) ==
+           StreamProtocol::MessageCutStatus::Cut) {
+      auto meta = std::make_shared<rpc::RpcMeta>();
+      meta->set_correlation_id(msg->GetCorrelationId());
+      meta->set_method_type(rpc::METHOD_TYPE_SINGLE);
+      meta->mutable_response_meta()->set_status(rpc::STATUS_SUCCESS);
+      ProtoMessage resp(std::move(meta),
+                        MaybeOwning<const google::protobuf::Message>(
+                            non_owning, &response_body_));
+      protocol_.WriteMessage(resp, responses, nullptr);
+    }
+    conn_->Write(std::move(responses), 0);
+    in_server = false;
+    return DataConsumptionStatus::Ready;
+  }
+
+  void OnAttach(StreamConnection*) override {}
+  void OnDetach() override {}
+  void OnWriteBufferEmpty() override {}
+  void OnDataWritten(std::uintptr_t) override {}
+  void OnClose() override {}
+  void OnError() override {}
+
+ private:
+  StdProtocol protocol_{true};
+  testing::EchoResponse response_body_;
+  std::shared_ptr<NativeAcceptor> acceptor_;
+  std::shared_ptr<NativeStreamConnection> conn_;
+};
+
+void Benchmark_FastCall(benchmark::State& state) {
+  auto ep = testing::PickAvailableEndpoint();
+  LoopbackServer server(ep);
+  StreamCallGate gate;
+  StreamCallGate::Options opts;
+  opts.protocol = std::make_unique<StdProtocol>(false);
+  opts.maximum_packet_size = 1048576;
+  gate.Open(ep, std::move(opts));
+  FLARE_CHECK(gate.Healthy());
+
+  testing::EchoRequest req;
+  req.set_body("hello");
+  testing::EchoResponse resp;
+
+  std::uint64_t allocs = 0, issue_allocs = 0;
+  for (auto _ : state) {
+    fiber::Latch latch(1);
+    RefPtr<Call> call(adopt_ptr, object_pool::Get<Call>());
+    call->latch = &latch;
+    call->call_ctx.method = testing::EchoService::descriptor()->method(0);
+    call->call_ctx.response_ptr = &resp;
+    call->controller = &call->call_ctx;
+
+    auto start = allocations.load(std::memory_order_relaxed);
+    ProtoMessage msg;
+    call->meta.set_correlation_id(rpc::internal::NewRpcCorrelationId());
+    call->meta.set_method_type(rpc::METHOD_TYPE_SINGLE);
+    call->meta.mutable_request_meta()->mutable_method_name()->assign(
+        "tinyRPC.testing.EchoService.Echo");
+    call->meta.mutable_request_meta()->set_timeout(1000);
+    msg.meta = std::shared_ptr<rpc::RpcMeta>(std::shared_ptr<void>(),
+                                             &call->meta);
+    msg.msg = MaybeOwning<const google::protobuf::Message>(non_owning, &req);
+    auto issue_start = allocations.load(std::memory_order_relaxed);
+    gate.FastCall(msg, call, ReadSteadyClock() + std::chrono::seconds(10));
+    issue_allocs += allocations.load(std::memory_order_relaxed) - issue_start;
+    call = nullptr;
+    latch.wait();
+    allocs += allocations.load(std::memory_order_relaxed) - start;
+  }
+  state.counters["allocs/call"] =
+      benchmark::Counter(allocs, benchmark::Counter::kAvgIterations);
+  state.counters["issue_allocs"] =
+      benchmark::Counter(issue_allocs, benchmark::Counter::kAvgIterations);
+
+  gate.Stop();
+  gate.Join();
+}
+
+BENCHMARK(Benchmark_FastCall);
+
+}  // namespace
+
+}  // namespace tinyRPC::protobuf
+
+int main(int argc, char** argv) {
+  // Consumes `--benchmark_xxx`, which are unknown to gflags.
+  benchmark::Initialize(&argc, argv);
+  return tinyRPC::Start(argc, argv, [](auto, auto) {
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+  });
+}
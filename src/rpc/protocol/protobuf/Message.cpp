@@ -1,12 +1,15 @@
 #include "Message.h"
 
+#include <limits>
 #include <string>
 
 #include "gflags/gflags.h"
+#include "google/protobuf/io/coded_stream.h"
 
 #include "../../../base/Enum.h"
 #include "../../../base/Logging.h"
 #include "../../../base/String.h"
+#include "../../../base/ZeroCopyStream.h"
 
 namespace tinyRPC::protobuf {
 
@@ -28,13 +31,13 @@ std::unique_ptr<Message> CreateErrorMessage(std::uint64_t correlation_id, int st
 ErrorMessageFactory error_message_factory;
 
 std::string Write(const PBMessage& msg) {
-  std::string nbb;
+  NoncontiguousBufferBuilder nbb;
   WriteTo(msg, nbb);
-  return nbb;
+  return FlattenSlow(nbb.DestructiveGet());
 }
 
 std::size_t WriteTo(const PBMessage& msg,
-                    std::string& builder) {
+                    NoncontiguousBufferBuilder& builder) {
   if (!msg.has_value()) {
     return 0;
   } else{
@@ -43,14 +46,68 @@ std::size_t WriteTo(const PBMessage& msg,
       // `msg->InInitialized()` is not checked here, it's too slow to be checked
       // in optimized build. For non-optimized build, it's already checked by
       // default (by Protocol Buffers' generated code).
-      FLARE_CHECK(pb_msg->SerializeToString(&builder));
-      return pb_msg->ByteSizeLong();
+      NoncontiguousBufferOutputStream nbos(&builder);
+      FLARE_CHECK(pb_msg->SerializeToZeroCopyStream(&nbos));
+      return nbos.ByteCount();
     } else {
       return 0;
     }
   }
 }
 
+std::size_t GetByteSize(const PBMessage& msg) {
+  if (!msg.has_value() || !msg.value()) {
+    return 0;
+  }
+  return msg.value()->ByteSizeLong();
+}
+
+void WriteWithCachedSizesTo(const google::protobuf::Message& msg,
+                            std::size_t size,
+                            NoncontiguousBufferBuilder& builder) {
+  if (FLARE_LIKELY(size <= builder.SizeAvailable())) {
+    auto end = msg.SerializeWithCachedSizesToArray(
+        reinterpret_cast<google::protobuf::uint8*>(builder.data()));
+    FLARE_CHECK_EQ(reinterpret_cast<char*>(end) - builder.data(), size,
+                   "The message was changed after its size was computed.");
+    builder.MarkWritten(size);
+    return;
+  }
+
+  // Spans multiple blocks. Serializing it into a dedicated buffer of exact
+  // size instead is slower (for large messages, allocating the buffer and
+  // faulting its pages in dominates.)
+  NoncontiguousBufferOutputStream nbos(&builder);
+  google::protobuf::io::CodedOutputStream cos(&nbos);
+  msg.SerializeWithCachedSizes(&cos);
+  FLARE_CHECK(!cos.HadError());
+  FLARE_CHECK_EQ(cos.ByteCount(), size,
+                 "The message was changed after its size was computed.");
+}
+
+void WriteWithCachedSizesTo(const PBMessage& msg, std::size_t size,
+                            NoncontiguousBufferBuilder& builder) {
+  if (msg.has_value() && msg.value()) {
+    WriteWithCachedSizesTo(*msg.value(), size, builder);
+  } else {
+    FLARE_CHECK_EQ(size, 0);
+  }
+}
+
+bool ParseFrom(const NoncontiguousBuffer& buffer,
+               google::protobuf::Message* msg) {
+  if (FLARE_UNLIKELY(buffer.Empty())) {
+    return msg->ParseFromArray(nullptr, 0);  // All fields are defaulted.
+  }
+  auto first = buffer.FirstContiguous();
+  if (FLARE_LIKELY(first.size() == buffer.ByteSize() &&
+                   first.size() <= std::numeric_limits<int>::max())) {
+    return msg->ParseFromArray(first.data(), first.size());
+  }
+  NoncontiguousBufferInputStream nbis(&buffer);
+  return msg->ParseFromZeroCopyStream(&nbis);
+}
+
 EarlyErrorMessage::EarlyErrorMessage(std::uint64_t correlation_id,
                                      rpc::Status status, std::string desc)
     : correlation_id_(correlation_id), status_(status), desc_(std::move(desc)) {
@@ -83,11 +140,38 @@ std::unique_ptr<Message> ErrorMessageFactory::Create(
   return nullptr;
 }
 
-Message::Type FromWireType(rpc::MethodType method_type, std::uint64_t flags) {
-  if (method_type == rpc::METHOD_TYPE_SINGLE) {
+std::unique_ptr<Message> ErrorMessageFactory::CreateStreamWindowUpdate(
+    std::uint64_t correlation_id, std::uint32_t consumed) const {
+  auto meta = std::make_shared<rpc::RpcMeta>();
+  meta->set_correlation_id(correlation_id);
+  meta->set_method_type(rpc::METHOD_TYPE_STREAM);
+  meta->set_flags(rpc::MESSAGE_FLAGS_NO_PAYLOAD);
+  meta->set_window_update(consumed);
+  return std::make_unique<ProtoMessage>(std::move(meta), std::nullopt);
+}
+
+std::optional<Message::Type> TryFromWireType(rpc::MethodType method_type,
+                                             std::uint64_t flags) {
+  if (FLARE_LIKELY(method_type == rpc::METHOD_TYPE_SINGLE)) {
     return Message::Type::Single;
   }
-  FLARE_CHECK(0);
+  if (FLARE_UNLIKELY(method_type != rpc::METHOD_TYPE_STREAM)) {
+    return std::nullopt;
+  }
+  auto type = Message::Type::Stream;
+  if (flags & rpc::MESSAGE_FLAGS_START_OF_STREAM) {
+    type |= Message::Type::StartOfStream;
+  }
+  if (flags & rpc::MESSAGE_FLAGS_END_OF_STREAM) {
+    type |= Message::Type::EndOfStream;
+  }
+  return type;
+}
+
+Message::Type FromWireType(rpc::MethodType method_type, std::uint64_t flags) {
+  auto type = TryFromWireType(method_type, flags);
+  FLARE_CHECK(type, "Unexpected method type {}.", static_cast<int>(method_type));
+  return *type;
 }
 
 }  // namespace tinyRPC::protobuf
@@ -6,6 +6,7 @@
 #include <string>
 #include <optional>
 
+#include "../../../base/Buffer.h"
 #include "../../../base/Enum.h"
 #include "../../../base/MaybeOwning.h"
 #include "../Message.h"
@@ -30,12 +31,36 @@ std::string Write(const PBMessage& msg);
 //
 // Number of bytes written is returned.
 std::size_t WriteTo(const PBMessage& msg,
-                    std::string& builder);
+                    NoncontiguousBufferBuilder& builder);
+
+// Returns size of `msg` once serialized. As a side effect, Protocol Buffers
+// caches sizes of `msg` (and its sub-messages), so `WriteWithCachedSizesTo`
+// can be used afterwards to serialize it without computing the sizes again.
+std::size_t GetByteSize(const PBMessage& msg);
+
+// Serializes `msg` using sizes cached by a preceding call to `ByteSizeLong()`
+// (or `GetByteSize` above). `size` must be what that call returned, and `msg`
+// must not be changed in between.
+//
+// If `msg` fits in the builder's current block, it's serialized there in
+// place. Otherwise it's streamed into the builder's blocks.
+void WriteWithCachedSizesTo(const google::protobuf::Message& msg,
+                            std::size_t size,
+                            NoncontiguousBufferBuilder& builder);
+void WriteWithCachedSizesTo(const PBMessage& msg, std::size_t size,
+                            NoncontiguousBufferBuilder& builder);
+
+// Parses `buffer` into `msg`, without copying it.
+//
+// If `buffer` is contiguous (likely the case for small messages), it's parsed
+// via `ParseFromArray` directly, otherwise a zero-copy stream is used.
+bool ParseFrom(const NoncontiguousBuffer& buffer,
+               google::protobuf::Message* msg);
 
 struct ProtoMessage : Message {
   ProtoMessage() {}
   ProtoMessage(std::shared_ptr<rpc::RpcMeta> meta, PBMessage&& msg,
-               std::string attachment = {})
+               NoncontiguousBuffer attachment = {})
       : meta(std::move(meta)),
         msg(std::move(msg)),
         attachment(std::move(attachment)) {
@@ -45,10 +70,13 @@ struct ProtoMessage : Message {
     return meta->correlation_id();
   }
   Type GetType() const noexcept override;
+  std::uint32_t GetStreamWindowUpdate() const noexcept override {
+    return meta->window_update();
+  }
 
   std::shared_ptr<rpc::RpcMeta> meta;
   PBMessage msg;
-  std::string attachment;
+  NoncontiguousBuffer attachment;
 
 };
 
@@ -81,10 +109,17 @@ class EarlyErrorMessage : public Message {
 class ErrorMessageFactory : public MessageFactory {
  public:
   std::unique_ptr<Message> Create(Type type, std::uint64_t correlation_id) const override;
+  std::unique_ptr<Message> CreateStreamWindowUpdate(
+      std::uint64_t correlation_id, std::uint32_t consumed) const override;
 };
 
 extern ErrorMessageFactory error_message_factory;
 
+// Returns `std::nullopt` if `method_type` is not recognized. Anything received
+// from the wire should be checked by this before `FromWireType` is called on it.
+std::optional<Message::Type> TryFromWireType(rpc::MethodType method_type,
+                                             std::uint64_t flags);
+
 Message::Type FromWireType(rpc::MethodType method_type, std::uint64_t flags);
 
 inline Message::Type ProtoMessage::GetType() const noexcept {
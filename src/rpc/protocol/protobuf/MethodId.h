@@ -0,0 +1,106 @@
+#ifndef _SRC_RPC_PROTOCOL_PROTOBUF_METHOD_ID_H_
+#define _SRC_RPC_PROTOCOL_PROTOBUF_METHOD_ID_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../../../base/Likely.h"
+
+// Compact method identification.
+//
+// Instead of `MethodDescriptor::full_name()`, a client may identify the method
+// it's calling by a 32-bit ID derived from the name. The ID is a stable hash,
+// so no negotiation (and no per-connection state) is needed: both sides
+// compute the same ID independently.
+//
+// Collisions among methods registered with a server are detected on service
+// registration (and crash the server), renaming one of the methods resolves
+// it.
+
+namespace tinyRPC::protobuf {
+
+// FNV-1a (32-bit) of `full_name`. This is part of the wire protocol, it must
+// not be changed.
+constexpr std::uint32_t GetMethodId(std::string_view full_name) {
+  std::uint32_t hash = 2166136261u;
+  for (auto c : full_name) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Maps method ID to `T*`.
+//
+// This is a flat open-addressed table, lookups touch one or two slots of a
+// contiguous array in most cases. It's populated on service registration and
+// read-only afterwards, therefore no synchronization is done.
+template <class T>
+class MethodIdMap {
+ public:
+  // Returns `false` if `id` was already there.
+  bool Insert(std::uint32_t id, T* value) {
+    if ((size_ + 1) * 2 > slots_.size()) {  // Load factor <= 0.5.
+      Rehash(slots_.empty() ? 16 : slots_.size() * 2);
+    }
+    if (!UnsafeInsert(id, value)) {
+      return false;
+    }
+    ++size_;
+    return true;
+  }
+
+  T* TryGet(std::uint32_t id) const noexcept {
+    if (FLARE_UNLIKELY(slots_.empty())) {
+      return nullptr;
+    }
+    auto mask = slots_.size() - 1;
+    for (auto i = id & mask;; i = (i + 1) & mask) {
+      auto&& slot = slots_[i];
+      if (slot.value == nullptr || slot.id == id) {
+        return slot.value;  // `nullptr` if it's an empty slot.
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    std::uint32_t id;
+    T* value = nullptr;  // Empty slot if `nullptr`.
+  };
+
+  bool UnsafeInsert(std::uint32_t id, T* value) {
+    auto mask = slots_.size() - 1;
+    for (auto i = id & mask;; i = (i + 1) & mask) {
+      auto&& slot = slots_[i];
+      if (slot.value == nullptr) {
+        slot.id = id;
+        slot.value = value;
+        return true;
+      }
+      if (slot.id == id) {
+        return false;
+      }
+    }
+  }
+
+  void Rehash(std::size_t new_size) {
+    auto old = std::exchange(slots_, std::vector<Slot>(new_size));
+    for (auto&& e : old) {
+      if (e.value) {
+        UnsafeInsert(e.id, e.value);
+      }
+    }
+  }
+
+ private:
+  std::size_t size_ = 0;
+  std::vector<Slot> slots_;  // Size is always a power of 2.
+};
+
+}  // namespace tinyRPC::protobuf
+
+#endif
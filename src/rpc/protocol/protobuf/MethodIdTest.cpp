@@ -0,0 +1,46 @@
+#include "MethodId.h"
+
+#include <deque>
+#include <unordered_map>
+
+#include "gtest/gtest.h"
+
+namespace tinyRPC::protobuf {
+
+TEST(MethodId, Stable) {
+  // These are part of the wire protocol, they must not change.
+  static_assert(GetMethodId("") == 2166136261u);
+  EXPECT_EQ(0xe40c292cu, GetMethodId("a"));
+  EXPECT_NE(GetMethodId("tinyRPC.testing.EchoService.Echo"),
+            GetMethodId("tinyRPC.testing.EchoService.Echo2"));
+}
+
+TEST(MethodIdMap, Basic) {
+  MethodIdMap<const int> map;
+  int x = 1, y = 2;
+  EXPECT_EQ(nullptr, map.TryGet(1));
+  EXPECT_TRUE(map.Insert(1, &x));
+  EXPECT_TRUE(map.Insert(17, &y));  // Same slot as `1`.
+  EXPECT_FALSE(map.Insert(1, &y));
+  EXPECT_EQ(&x, map.TryGet(1));
+  EXPECT_EQ(&y, map.TryGet(17));
+  EXPECT_EQ(nullptr, map.TryGet(33));
+}
+
+TEST(MethodIdMap, Many) {
+  MethodIdMap<int> map;
+  std::deque<int> values;
+  std::unordered_map<std::uint32_t, int*> expected;
+  for (int i = 0; i != 10000; ++i) {
+    auto id = GetMethodId(std::to_string(i));
+    auto&& v = values.emplace_back(i);
+    ASSERT_TRUE(map.Insert(id, &v));
+    expected[id] = &v;
+  }
+  for (auto&& [k, v] : expected) {
+    ASSERT_EQ(v, map.TryGet(k));
+  }
+  EXPECT_EQ(nullptr, map.TryGet(GetMethodId("not-inserted")));
+}
+
+}  // namespace tinyRPC::protobuf
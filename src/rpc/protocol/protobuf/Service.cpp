@@ -13,8 +13,11 @@
 
 #include "../../../base/Callback.h"
 #include "../../../base/String.h"
-#include "../../../base/Latch.h"
+#include "../../../base/chrono.h"
+#include "../../../fiber/Latch.h"
+#include "../../internal/StreamIoAdaptor.h"
 #include "CallContext.h"
+#include "Compression.h"
 #include "rpcControllerServer.h"
 #include "ServiceMethodLocator.h"
 #include "../StreamProtocol.h"
@@ -49,7 +52,8 @@ Service::~Service() {
   }
 }
 
-void Service::AddService(MaybeOwning<google::protobuf::Service> impl) {
+void Service::AddService(MaybeOwning<google::protobuf::Service> impl,
+                         ExecutionPolicy policy) {
   auto&& service_desc = impl->GetDescriptor();
 
   for (int i = 0; i != service_desc->method_count(); ++i) {
@@ -59,6 +63,8 @@ void Service::AddService(MaybeOwning<google::protobuf::Service> impl) {
     FLARE_CHECK(method_descs_.find(name) == method_descs_.end(),
                 "Duplicate method: {}", name);
     auto&& e = method_descs_[name];
+    FLARE_CHECK(method_ids_.Insert(GetMethodId(name), &e),
+                "ID of method [{}] collides with another method's.", name);
 
     // Basics.
     e.service = impl.Get();
@@ -81,6 +87,7 @@ void Service::AddService(MaybeOwning<google::protobuf::Service> impl) {
       e.ongoing_requests = std::make_unique<AlignedInt>();
     }
 
+    SetExecutionPolicy(name, policy);
   }
 
   services_.push_back(std::move(impl));
@@ -90,10 +97,40 @@ void Service::AddService(MaybeOwning<google::protobuf::Service> impl) {
   registered_services_.insert(services_.back()->GetDescriptor()->full_name());
 }
 
+void Service::SetExecutionPolicy(const std::string& method_name,
+                                 ExecutionPolicy policy) {
+  auto iter = method_descs_.find(method_name);
+  FLARE_CHECK(iter != method_descs_.end(), "Method [{}] is not found.",
+              method_name);
+  auto was = iter->second.execution_policy.Set(policy);
+  if (was == ExecutionPolicy::Detached && policy != ExecutionPolicy::Detached) {
+    non_detached_methods_.fetch_add(1, std::memory_order_relaxed);
+  } else if (was != ExecutionPolicy::Detached &&
+             policy == ExecutionPolicy::Detached) {
+    non_detached_methods_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+bool Service::MayRunInline() const {
+  return non_detached_methods_.load(std::memory_order_relaxed) != 0;
+}
+
+bool Service::ShouldRunInline(const Message& message) {
+  auto msg = dynamic_cast<const ProtoMessage*>(&message);
+  if (FLARE_UNLIKELY(!msg || !msg->meta->has_request_meta())) {
+    return false;  // Leave it to `FastCall` to reject it.
+  }
+  auto method = FindHandler(msg->meta->request_meta());
+  if (FLARE_UNLIKELY(!method)) {
+    return false;
+  }
+  return method->execution_policy.ShouldRunInline();
+}
+
 bool Service::Inspect(const Message& message, const Controller& controller,
                       InspectionResult* result) {
   if (auto msg = dynamic_cast<const ProtoMessage*>(&message); FLARE_LIKELY(msg)) {
-    result->method = msg->meta->request_meta().method_name();
+    result->method = GetMethodName(msg->meta->request_meta());
     return true;
   } else if (dynamic_cast<const EarlyErrorMessage*>(&message)) {
     result->method = "(unrecognized method)";
@@ -104,35 +141,190 @@ bool Service::Inspect(const Message& message, const Controller& controller,
 }
 
 
+// Per-call state of a fast call. It's also the `done` closure passed to the
+// user, which may be run long after `FastCall` returns, in whatever fiber the
+// user completes the call (e.g., in a callback of a downstream RPC). Once run,
+// it writes the response (unless it's already been written), releases the
+// processing quota, notifies the framework and frees itself.
+class Service::FastCallDone : public google::protobuf::Closure {
+ public:
+  FastCallDone(Service* service, const MethodDesc& method,
+               const ProtoMessage& req_msg,
+               const UniqueFunction<std::size_t(const Message&)>& writer,
+               Context* ctx, Deferred processing_quota,
+               UniqueFunction<void()> on_completion)
+      : service_(service),
+        method_(method),
+        req_msg_(req_msg),
+        writer_(writer),
+        ctx_(ctx),
+        processing_quota_(std::move(processing_quota)),
+        on_completion_(std::move(on_completion)),
+        resp_ptr_(method.response_prototype->New()) {
+    // For better responsiveness, we allow the user to write response early via
+    // `RpcServerController::WriteResponseImmediately` (or, if not called, once
+    // `done` is called), so we have to provide a callback to fill and write the
+    // response.
+    controller_.SetEarlyWriteResponseCallback(&write_resp_callback_);
+  }
+
+  RpcServerController* GetController() noexcept { return &controller_; }
+  google::protobuf::Message* GetResponse() noexcept { return resp_ptr_.get(); }
+
+  void Run() override {
+    // If the user did not call `WriteResponseImmediately` (likely), let's call
+    // it for them.
+    if (auto ptr = controller_.DestructiveGetEarlyWriteResponse()) {
+      ptr->Run();
+    }
+
+    // Save the result for later use.
+    ctx_->status = controller_.ErrorCode();
+
+    // `ctx_`, `writer_` and the request are not ours, they're only guaranteed
+    // to be alive until `on_completion_` is called.
+    auto on_completion = std::move(on_completion_);
+    delete this;  // Releases processing quota.
+    on_completion();
+  }
+
+ private:
+  class WriteResponseCallback : public google::protobuf::Closure {
+   public:
+    explicit WriteResponseCallback(FastCallDone* self) : self_(self) {}
+    void Run() override { self_->WriteResponse(); }
+
+   private:
+    FastCallDone* self_;
+  };
+
+  void WriteResponse() {
+    service_->CreateNativeResponse(method_, req_msg_, std::move(resp_ptr_),
+                                   &controller_, &resp_msg_);
+    writer_(resp_msg_);
+  }
+
+ private:
+  Service* service_;
+  const MethodDesc& method_;
+  const ProtoMessage& req_msg_;
+  const UniqueFunction<std::size_t(const Message&)>& writer_;
+  Context* ctx_;
+  Deferred processing_quota_;
+  UniqueFunction<void()> on_completion_;
+
+  RpcServerController controller_;
+  WriteResponseCallback write_resp_callback_{this};
+  std::unique_ptr<google::protobuf::Message> resp_ptr_;
+  ProtoMessage resp_msg_;
+};
+
 Service::ProcessingStatus Service::FastCall(
     std::unique_ptr<Message>* request,
-    const UniqueFunction<std::size_t(const Message&)>& writer, Context* context) {
+    const UniqueFunction<std::size_t(const Message&)>& writer, Context* context,
+    UniqueFunction<void()> on_completion) {
   // Do some sanity check first.
   auto method_desc =
       SanityCheckOrRejectEarlyForFastCall(**request, writer, *context);
   if (FLARE_UNLIKELY(!method_desc)) {
+    on_completion();
     return ProcessingStatus::Processed;
   }
 
   auto req_msg = dynamic_cast<ProtoMessage*>(&**request);
+  if (FLARE_UNLIKELY(!CheckTransferMode(*method_desc, *req_msg, false, writer))) {
+    on_completion();
+    return ProcessingStatus::Processed;
+  }
   auto processing_quota =
       AcquireProcessingQuotaOrReject(*req_msg, *method_desc, *context);
   if (!processing_quota) {
     return ProcessingStatus::Overloaded;
   }
 
-  // Initialize server RPC controller.
-  RpcServerController rpc_controller;
-  InitializeServerControllerForFastCall(*req_msg, *context, &rpc_controller);
+  // Freed by itself once the user calls `done`.
+  auto done = new FastCallDone(this, *method_desc, *req_msg, writer, context,
+                               std::move(processing_quota),
+                               std::move(on_completion));
+  InitializeServerControllerForFastCall(*req_msg, *context,
+                                        done->GetController());
 
-  // Call user's implementation and sent response out.
-  ProtoMessage resp_msg;
-  InvokeUserMethodForFastCall(*method_desc, *req_msg, &resp_msg,
-                              &rpc_controller, writer, context);
+  // Call user's implementation. The response is sent out (and the framework
+  // notified) in `done`, we don't wait for it here.
+  InvokeUserMethodForFastCall(*method_desc, *req_msg, done);
 
   return ProcessingStatus::Processed;
 }
 
+Service::ProcessingStatus Service::StreamCall(
+    std::shared_ptr<rpc::internal::StreamIoAdaptor> stream, Context* context) {
+  auto first = stream->Peek();  // Checked by the framework.
+  UniqueFunction<std::size_t(const Message&)> error_writer =
+      [&](const Message& m) -> std::size_t {
+    (void)stream->Write(m, true);  // It ends the stream.
+    return 0;
+  };
+  auto method_desc =
+      SanityCheckOrRejectEarlyForFastCall(*first, error_writer, *context);
+  if (FLARE_UNLIKELY(!method_desc)) {
+    return ProcessingStatus::Processed;
+  }
+  auto&& first_msg = *static_cast<ProtoMessage*>(first);
+  if (FLARE_UNLIKELY(
+          !CheckTransferMode(*method_desc, first_msg, true, error_writer))) {
+    return ProcessingStatus::Processed;
+  }
+
+  // Messages we write share the same meta, except for the flags.
+  RpcServerController ctlr;
+  ctlr.SetRemotePeer(context->remote_peer);
+  rpc::RpcMeta meta;
+  meta.set_correlation_id(first_msg.GetCorrelationId());
+  meta.mutable_response_meta()->set_status(rpc::STATUS_SUCCESS);
+  auto timeout = first_msg.meta->request_meta().timeout();
+  auto stream_ctx = std::make_shared<detail::StreamContext>(std::move(stream),
+                                                            std::move(meta));
+  if (timeout) {
+    auto expires_at = ReadSteadyClock() + timeout * 1ms;
+    ctlr.SetTimeout(expires_at);
+    stream_ctx->SetExpiration(expires_at);
+  }
+  ctlr.SetStream(stream_ctx);
+
+  // Single request / response of methods streaming in only one direction are
+  // read / written by us.
+  auto&& method = *method_desc->method;
+  std::unique_ptr<google::protobuf::Message> req, resp;
+  if (!method.client_streaming()) {
+    req.reset(method_desc->request_prototype->New());
+    if (!stream_ctx->Read(req.get())) {
+      FLARE_LOG_WARNING("Failed to read request of [{}] from [{}]: {}",
+                        method.full_name(), context->remote_peer.ToString(),
+                        stream_ctx->GetReadStatus().ToString());
+      return ProcessingStatus::Processed;
+    }
+  }
+  if (!method.server_streaming()) {
+    resp.reset(method_desc->response_prototype->New());
+  }
+
+  // The stream is finished once `done` is called.
+  fiber::Latch latch(1);
+  method_desc->service->CallMethod(&method, &ctlr, req.get(), resp.get(),
+                                   NewCallback([&] { latch.count_down(); }));
+  latch.wait();
+
+  context->status = ctlr.ErrorCode();
+  if (FLARE_UNLIKELY(ctlr.Failed())) {
+    stream_ctx->Close(ctlr.ErrorCode(), ctlr.ErrorText());
+  } else if (resp) {
+    stream_ctx->Write(resp.get(), true);
+  } else {
+    stream_ctx->Close();  // No-op if the user has closed it.
+  }
+  return ProcessingStatus::Processed;
+}
+
 void Service::Stop() {
   // Nothing.
   //
@@ -165,9 +357,17 @@ const Service::MethodDesc* Service::SanityCheckOrRejectEarlyForFastCall(
   // that the service the method belongs to, is not registered with us. If the
   // server is serving different "service" on different port, this can be the
   // case.
-  auto&& method_name = msg_ptr->meta->request_meta().method_name();
-  auto&& method_desc = FindHandler(method_name);
+  auto&& req_meta = msg_ptr->meta->request_meta();
+  auto&& method_desc = FindHandler(req_meta);
   if (FLARE_UNLIKELY(!method_desc)) {
+    if (req_meta.has_method_id()) {
+      // Service name is not known in this case.
+      resp_writer(CreateErrorResponse(
+          msg_ptr->GetCorrelationId(), rpc::STATUS_METHOD_NOT_FOUND,
+          Format("Method [{}] is not found.", GetMethodName(req_meta))));
+      return nullptr;
+    }
+    auto&& method_name = req_meta.method_name();
     std::string_view service_name = method_name;
     if (auto pos = service_name.find_last_of('.');
         pos != std::string_view::npos) {
@@ -188,6 +388,21 @@ const Service::MethodDesc* Service::SanityCheckOrRejectEarlyForFastCall(
   return method_desc;
 }
 
+bool Service::CheckTransferMode(
+    const MethodDesc& method, const ProtoMessage& msg, bool stream,
+    const UniqueFunction<std::size_t(const Message&)>& resp_writer) const {
+  auto streaming =
+      method.method->client_streaming() || method.method->server_streaming();
+  if (FLARE_LIKELY(streaming == stream)) {
+    return true;
+  }
+  resp_writer(CreateErrorResponse(
+      msg.GetCorrelationId(), rpc::STATUS_INVALID_TRANSFER_MODE,
+      Format("Method [{}] is {}a streaming method.", method.method->full_name(),
+             streaming ? "" : "not ")));
+  return false;
+}
+
 void Service::InitializeServerControllerForFastCall(const ProtoMessage& msg,
                                                     const Context& ctx,
                                                     RpcServerController* ctlr) {
@@ -198,55 +413,39 @@ void Service::InitializeServerControllerForFastCall(const ProtoMessage& msg,
     // can still be plenty of time elapsed on the network.
     ctlr->SetTimeout(TimestampFromTsc(ctx.received_tsc) + v * 1ms);
   }
-  if (FLARE_UNLIKELY(!msg.attachment.empty())) {
+  if (FLARE_UNLIKELY(!msg.attachment.Empty())) {
     ctlr->SetRequestAttachment(msg.attachment);
   }
 
+  // Respond in kind, unless the user says otherwise.
+  ctlr->SetAcceptableCompressionAlgorithms(
+      msg.meta->request_meta().acceptable_compression_algorithms());
+  ctlr->SetCompressionAlgorithm(msg.meta->compression_algorithm());
 }
 
-void Service::InvokeUserMethodForFastCall(
-    const MethodDesc& method, const ProtoMessage& req_msg,
-    ProtoMessage* resp_msg, RpcServerController* ctlr,
-    const UniqueFunction<std::size_t(const Message&)>& writer, Context* ctx) {
-  // Prepare response message.
-  auto resp_ptr = std::unique_ptr<google::protobuf::Message>(
-      method.response_prototype->New());
-
-  // For better responsiveness, we allow the user to write response early via
-  // `RpcServerController::WriteResponseImmediately` (or, if not called, once
-  // `done` is called, so we have to provide a callback to fill and write the
-  // response.
-  internal::LocalCallback write_resp_callback([&] {
-    CreateNativeResponse(method, req_msg, std::move(resp_ptr), ctlr, resp_msg);
-
-    // Note that `writer` does not mutate `resp_msg`, we rely on this as we'll
-    // still need the response later.
-    writer(*resp_msg);
-  });
-  ctlr->SetEarlyWriteResponseCallback(&write_resp_callback);
-
-  // We always call the callback in a synchronous fashion. Given that our fiber
-  // runtime is fairly fast, there's no point in implementing method invocation
-  // in a "asynchronous" fashion, which is even slower.
-  tinyRPC::Latch done_latch(1);
-  internal::LocalCallback done_callback([&] {
-    // If the user did not call `WriteResponseImmediately` (likely), let's call
-    // it for them.
-    if (auto ptr = ctlr->DestructiveGetEarlyWriteResponse()) {
-      ptr->Run();
-    }
-    done_latch.count_down();
-  });
-
-  method.service->CallMethod(method.method, ctlr, req_msg.msg.value().Get(), resp_ptr.get(), &done_callback);
-  done_latch.wait();
+void Service::InvokeUserMethodForFastCall(const MethodDesc& method,
+                                          const ProtoMessage& req_msg,
+                                          FastCallDone* done) {
+  // The user may finish the call asynchronously (in another fiber, or in a
+  // callback of a downstream RPC), so we don't block this fiber until `done`
+  // is called. `done` may well have been run (and freed) once `CallMethod`
+  // returns, don't touch it afterwards.
+  if (FLARE_LIKELY(method.execution_policy.Get() !=
+                   ExecutionPolicy::Adaptive)) {
+    method.service->CallMethod(method.method, done->GetController(),
+                               req_msg.msg.value().Get(), done->GetResponse(),
+                               done);
+    return;
+  }
 
-  // Save the result for later use.
-  ctx->status = ctlr->ErrorCode();
+  auto start_tsc = ReadTsc();
+  method.service->CallMethod(method.method, done->GetController(),
+                             req_msg.msg.value().Get(), done->GetResponse(),
+                             done);
+  method.execution_policy.AddRunningTime(
+      DurationFromTsc(start_tsc, ReadTsc()));
 }
 
-
-
 Deferred Service::AcquireProcessingQuotaOrReject(const ProtoMessage& msg,
                                                  const MethodDesc& method,
                                                  const Context& ctx) {
@@ -259,7 +458,7 @@ Deferred Service::AcquireProcessingQuotaOrReject(const ProtoMessage& msg,
                      max_queueing_delay)) {
     FLARE_LOG_WARNING(
         "Rejecting call to [{}] from [{}]: It has been in queue for too long.",
-        msg.meta->request_meta().method_name(), ctx.remote_peer.ToString());
+        method.method->full_name(), ctx.remote_peer.ToString());
     return Deferred();
   }
 
@@ -271,7 +470,7 @@ Deferred Service::AcquireProcessingQuotaOrReject(const ProtoMessage& msg,
     ongoing_req_ptr->value.fetch_sub(1);
     FLARE_LOG_WARNING(
         "Rejecting call to [{}] from [{}]: Too many concurrent requests.",
-        msg.meta->request_meta().method_name(), ctx.remote_peer.ToString());
+        method.method->full_name(), ctx.remote_peer.ToString());
     return Deferred();
   }
 
@@ -304,17 +503,38 @@ void Service::CreateNativeResponse(
   response->msg = std::move(resp_ptr);
 
   // And the attachment.
-  if (auto&& att = ctlr->GetResponseAttachment(); !att.empty()) {
+  if (auto&& att = ctlr->GetResponseAttachment(); !att.Empty()) {
     response->attachment = att;
   }
+
+  compression::SetCompressionAlgorithm(
+      ctlr->GetCompressionAlgorithm(),
+      ctlr->GetAcceptableCompressionAlgorithms(), response->msg,
+      response->attachment, response->meta.get());
 }
 
 inline const Service::MethodDesc* Service::FindHandler(
     const std::string& method_name) const {
-  if(method_descs_.find(method_name) != method_descs_.end()){
-    return &method_descs_.at(method_name);
+  auto iter = method_descs_.find(method_name);
+  return iter != method_descs_.end() ? &iter->second : nullptr;
+}
+
+inline const Service::MethodDesc* Service::FindHandler(
+    const rpc::RpcRequestMeta& meta) const {
+  if (meta.has_method_id()) {
+    return method_ids_.TryGet(meta.method_id());
+  }
+  return FindHandler(meta.method_name());
+}
+
+std::string Service::GetMethodName(const rpc::RpcRequestMeta& meta) const {
+  if (!meta.has_method_id()) {
+    return meta.method_name();
+  }
+  if (auto method = method_ids_.TryGet(meta.method_id())) {
+    return method->method->full_name();
   }
-  return nullptr;
+  return Format("#{:08x}", meta.method_id());
 }
 
 }  // namespace tinyRPC::protobuf
@@ -13,7 +13,9 @@
 
 #include "../../../base/ScopedDeferred.h"
 #include "../../../base/MaybeOwning.h"
+#include "../../internal/MethodExecutionPolicy.h"
 #include "../StreamService.h"
+#include "MethodId.h"
 
 namespace tinyRPC {
 
@@ -21,6 +23,12 @@ class RpcServerController;
 
 }  // namespace tinyRPC
 
+namespace tinyRPC::rpc {
+
+class RpcRequestMeta;
+
+}  // namespace tinyRPC::rpc
+
 namespace tinyRPC::protobuf {
 
 struct ProtoMessage;
@@ -35,16 +43,35 @@ class Service : public StreamService {  // Only `StreamService` is supported
  public:
   ~Service();
 
-  void AddService(MaybeOwning<google::protobuf::Service> impl);
+  // Methods of `impl` are run as `policy` specifies unless overridden via
+  // `SetExecutionPolicy`.
+  //
+  // Services must be added before the server starts.
+  void AddService(MaybeOwning<google::protobuf::Service> impl,
+                  ExecutionPolicy policy = ExecutionPolicy::Detached);
+
+  // Overrides execution policy of the given method. `method_name` is the
+  // fully qualified name of a method added via `AddService`.
+  //
+  // Unlike `AddService`, this may be called while the server is running. The
+  // new policy applies to requests read after it returns.
+  void SetExecutionPolicy(const std::string& method_name,
+                          ExecutionPolicy policy);
 
   bool Inspect(const Message& message, const Controller& controller,
                InspectionResult* result) override;
 
+  bool MayRunInline() const override;
+  bool ShouldRunInline(const Message& message) override;
+
   ProcessingStatus FastCall(
       std::unique_ptr<Message>* request,
       const UniqueFunction<std::size_t(const Message&)>& writer,
-      Context* context) override;
+      Context* context, UniqueFunction<void()> on_completion) override;
 
+  ProcessingStatus StreamCall(
+      std::shared_ptr<rpc::internal::StreamIoAdaptor> stream,
+      Context* context) override;
 
   void Stop() override;
   void Join() override;
@@ -71,6 +98,11 @@ class Service : public StreamService {  // Only `StreamService` is supported
 
     // Applicable only `max_ongoing_request` is not 0.
     std::unique_ptr<AlignedInt> ongoing_requests;
+
+    // Running time measured for `Adaptive` policy is the time spent in user's
+    // method until it returns, not until `done` is called. It's updated on
+    // each call, hence `mutable`.
+    mutable rpc::internal::MethodExecutionPolicy execution_policy;
   };
 
   // Returns [nullptr, nullptr] if the request is rejected.
@@ -79,19 +111,27 @@ class Service : public StreamService {  // Only `StreamService` is supported
       const UniqueFunction<std::size_t(const Message&)>& resp_writer,
       const Context& ctx) const;
 
+  // Rejects calls made in wrong fashion (e.g., calling a streaming method
+  // with a single request.) Returns `false` if the call is rejected.
+  bool CheckTransferMode(
+      const MethodDesc& method, const ProtoMessage& msg, bool stream,
+      const UniqueFunction<std::size_t(const Message&)>& resp_writer) const;
+
   void InitializeServerControllerForFastCall(const ProtoMessage& msg,
                                              const Context& ctx,
                                              RpcServerController* ctlr);
 
-  // Call user's service implementation. The response is written out by this
-  // method, *and* saved into `resp_msg`.
-  //
-  // The reason why we don't delay response writeout until this method's
-  // completes is for better responsiveness.
-  void InvokeUserMethodForFastCall(
-      const MethodDesc& method, const ProtoMessage& req_msg,
-      ProtoMessage* resp_msg, RpcServerController* ctlr,
-      const UniqueFunction<std::size_t(const Message&)>& writer, Context* ctx);
+  // State of a fast call that outlives `FastCall`. It's the `done` we pass to
+  // the user.
+  class FastCallDone;
+
+  // Call user's service implementation. This method returns as soon as the
+  // user's method does, the response is written out once `done` is run (or
+  // earlier, via `RpcServerController::WriteResponseImmediately`), which can
+  // be long after this method returns.
+  void InvokeUserMethodForFastCall(const MethodDesc& method,
+                                   const ProtoMessage& req_msg,
+                                   FastCallDone* done);
 
 
   // Determines if we have the resource to process the requested method. An
@@ -106,6 +146,12 @@ class Service : public StreamService {  // Only `StreamService` is supported
                             RpcServerController* ctlr, ProtoMessage* response);
   const MethodDesc* FindHandler(const std::string& method_name) const;
 
+  // Finds the method by ID if the request carries one, or by name otherwise.
+  const MethodDesc* FindHandler(const rpc::RpcRequestMeta& meta) const;
+
+  // For diagnostic purpose only.
+  std::string GetMethodName(const rpc::RpcRequestMeta& meta) const;
+
  private:
   std::vector<MaybeOwning<google::protobuf::Service>> services_;
 
@@ -115,6 +161,9 @@ class Service : public StreamService {  // Only `StreamService` is supported
   // Elements here references string of `ServiceDescriptor`.
   std::unordered_set<std::string_view> registered_services_;
 
+  // Number of methods whose execution policy is not `Detached`.
+  std::atomic<std::size_t> non_detached_methods_{0};
+
   // This is to workaround a common misuse: Users tend to free their service
   // class before destroying `flare::Server` (and the `protobuf::Service` here).
   // By the time we're destroyed, objects referenced by `services_` may have
@@ -125,6 +174,9 @@ class Service : public StreamService {  // Only `StreamService` is supported
 
   // Keyed by `MethodDescriptor::full_name()`.
   std::unordered_map<std::string, MethodDesc> method_descs_;
+
+  // Keyed by `GetMethodId(...)`. Values point to elements in `method_descs_`.
+  MethodIdMap<const MethodDesc> method_ids_;
 };
 
 }  // namespace tinyRPC::protobuf
@@ -2,6 +2,7 @@
 #define _SRC_RPC_PROTOCOL_PROTOBUF_SERVICE_METHOD_LOCATOR_H_
 
 #include <atomic>
+#include <cstdint>
 #include <map>
 #include <mutex>
 #include <shared_mutex>
@@ -40,6 +41,10 @@ inline constexpr struct Standard {
   using MethodKey = std::string;  // method.full_name()
 } standard;
 
+// Standard protocol, with methods identified by ID instead (@sa: `MethodId.h`).
+inline constexpr struct StandardMethodId {
+  using MethodKey = std::uint32_t;  // GetMethodId(method.full_name())
+} standard_method_id;
 
 }  // namespace protocol_ids
 
@@ -83,7 +88,9 @@ class ServiceMethodLocator : public tinyRPC::Singleton<ServiceMethodLocator>{
     UnsafeTryInitializeControlBlock<T>();
     auto&& cb = UnsafeGetControlBlock<T>();
     // For the moment we don't handle duplicate registration well.
-    FLARE_CHECK(cb->key_desc_map.find(key) == cb->key_desc_map.end());
+    FLARE_CHECK(cb->key_desc_map.find(key) == cb->key_desc_map.end(),
+                "Key of method [{}] collides with another method.",
+                method->full_name());
     FLARE_CHECK(cb->name_key_map.find(method->full_name()) == cb->name_key_map.end());
     cb->key_desc_map[key] = CreateMethodDesc<T>(method, key);
     cb->name_key_map[method->full_name()] = key;
@@ -95,11 +102,11 @@ class ServiceMethodLocator : public tinyRPC::Singleton<ServiceMethodLocator>{
   const MethodDesc<T>* TryGetMethodDesc(T protocol,
                                         const MethodKey<T>& key) const {
     auto&& cb = GetCachedControlBlock<T>();
-    if(cb->key_desc_map.find(key) != cb->key_desc_map.end()){
-      auto p = &cb->key_desc_map.at(key);
-      return p;
+    if (FLARE_UNLIKELY(!cb)) {
+      return nullptr;  // No method is registered for this protocol at all.
     }
-    return nullptr;
+    auto iter = cb->key_desc_map.find(key);
+    return iter != cb->key_desc_map.end() ? &iter->second : nullptr;
   }
 
   // Deregister a method.
@@ -0,0 +1,134 @@
+#include "Stream.h"
+
+#include <utility>
+
+#include "../../../base/Demangle.h"
+#include "../../../base/Logging.h"
+#include "../../internal/StreamIoAdaptor.h"
+#include "Message.h"
+
+namespace tinyRPC::protobuf::detail {
+
+namespace {
+
+Status TranslateStreamError(rpc::internal::StreamIoAdaptor::Error error) {
+  using Error = rpc::internal::StreamIoAdaptor::Error;
+  if (error == Error::EndOfStream) {
+    return Status();
+  } else if (error == Error::IoError) {
+    return Status(rpc::STATUS_IO_ERROR, "The stream is broken.");
+  } else if (error == Error::Timeout) {
+    return Status(rpc::STATUS_TIMEOUT, "The stream has expired.");
+  } else if (error == Error::ParseError) {
+    return Status(rpc::STATUS_MALFORMED_DATA, "Malformed message received.");
+  }
+  FLARE_UNREACHABLE();
+}
+
+}  // namespace
+
+StreamContext::StreamContext(std::shared_ptr<rpc::internal::StreamIoAdaptor> io,
+                             rpc::RpcMeta meta)
+    : io_(std::move(io)),
+      meta_(std::make_shared<rpc::RpcMeta>(std::move(meta))) {
+  meta_->set_method_type(rpc::METHOD_TYPE_STREAM);
+}
+
+StreamContext::StreamContext(Status failure)
+    : write_closed_(true), read_status_(std::move(failure)) {
+  FLARE_CHECK(!read_status_.ok());
+}
+
+StreamContext::~StreamContext() {
+  if (!write_closed_) {
+    (void)Close();
+  }
+}
+
+void StreamContext::SetExpiration(
+    std::chrono::steady_clock::time_point expires_at) {
+  if (io_) {
+    io_->SetExpiration(expires_at);
+  }
+}
+
+bool StreamContext::Read(google::protobuf::Message* msg) {
+  if (FLARE_UNLIKELY(!io_)) {
+    return false;  // `read_status_` was set on construction.
+  }
+  while (true) {
+    rpc::internal::StreamIoAdaptor::Error error;
+    auto ptr = io_->Read(&error);
+    if (!ptr) {
+      read_status_ = TranslateStreamError(error);
+      return false;
+    }
+
+    auto proto_msg = dynamic_cast<ProtoMessage*>(ptr.get());
+    if (FLARE_UNLIKELY(!proto_msg)) {
+      // The protocol failed to recognize the method being called.
+      auto e = dynamic_cast<EarlyErrorMessage*>(ptr.get());
+      FLARE_CHECK(e, "Unexpected message type [{}].", GetTypeName(*ptr));
+      read_status_ = Status(e->GetStatus(), e->GetDescription());
+      return false;
+    }
+    if (auto&& meta = *proto_msg->meta; meta.has_response_meta() &&
+        meta.response_meta().status() != rpc::STATUS_SUCCESS) {
+      read_status_ = Status(meta.response_meta().status(),
+                            meta.response_meta().description());
+      return false;
+    }
+    if (!proto_msg->msg || !proto_msg->msg.value()) {
+      continue;  // Nothing but flags.
+    }
+    // We own it, the `const` is only there because the same type is used for
+    // messages being written.
+    msg->GetReflection()->Swap(
+        msg, const_cast<google::protobuf::Message*>(proto_msg->msg->Get()));
+    return true;
+  }
+}
+
+bool StreamContext::Write(const google::protobuf::Message* msg, bool last) {
+  return WriteMessage(msg, last, rpc::STATUS_SUCCESS, {});
+}
+
+bool StreamContext::Close(int status, std::string description) {
+  return WriteMessage(nullptr, true, status, std::move(description));
+}
+
+bool StreamContext::WriteMessage(const google::protobuf::Message* msg,
+                                 bool last, int status,
+                                 std::string description) {
+  if (FLARE_UNLIKELY(write_closed_)) {
+    return false;
+  }
+  write_closed_ = last;
+
+  // Only the caller starts a stream.
+  std::uint64_t flags = 0;
+  if (!std::exchange(started_, true) && meta_->has_request_meta()) {
+    flags |= rpc::MESSAGE_FLAGS_START_OF_STREAM;
+  }
+  if (last) {
+    flags |= rpc::MESSAGE_FLAGS_END_OF_STREAM;
+  }
+  if (!msg) {
+    flags |= rpc::MESSAGE_FLAGS_NO_PAYLOAD;
+  }
+  meta_->set_flags(flags);
+  if (FLARE_UNLIKELY(status != rpc::STATUS_SUCCESS)) {
+    FLARE_CHECK(meta_->has_response_meta(),
+                "Only the server may fail a stream.");
+    meta_->mutable_response_meta()->set_status(status);
+    meta_->mutable_response_meta()->set_description(std::move(description));
+  }
+
+  PBMessage payload;
+  if (msg) {
+    payload = MaybeOwning(non_owning, msg);
+  }
+  return io_->Write(ProtoMessage(meta_, std::move(payload)), last);
+}
+
+}  // namespace tinyRPC::protobuf::detail
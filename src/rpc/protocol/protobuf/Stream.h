@@ -0,0 +1,147 @@
+#ifndef _SRC_RPC_PROTOCOL_PROTOBUF_STREAM_H_
+#define _SRC_RPC_PROTOCOL_PROTOBUF_STREAM_H_
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "google/protobuf/message.h"
+
+#include "../../../base/Status.h"
+#include "rpc_meta.pb.h"
+
+namespace tinyRPC {
+
+namespace rpc::internal {
+
+class StreamIoAdaptor;
+
+}  // namespace rpc::internal
+
+namespace protobuf::detail {
+
+// State of a stream, shared by its reader, writer and the controller. If not
+// closed yet, the write side is closed once it's destroyed.
+//
+// The reader and the writer may be used in different fibers concurrently.
+class StreamContext {
+ public:
+  // `meta` is used as the meta of messages written to `io`. It carries
+  // `request_meta` on client side, and `response_meta` on server side.
+  StreamContext(std::shared_ptr<rpc::internal::StreamIoAdaptor> io,
+                rpc::RpcMeta meta);
+
+  // The stream could not be established. Reading it fails with `failure`.
+  explicit StreamContext(Status failure);
+
+  ~StreamContext();
+
+  void SetExpiration(std::chrono::steady_clock::time_point expires_at);
+
+  // Reads the next message into `msg`. Messages without payload (e.g., a bare
+  // end-of-stream marker) are skipped. `false` is returned at end of stream
+  // or on failure, `GetReadStatus()` tells which.
+  bool Read(google::protobuf::Message* msg);
+
+  // Successful if the stream ended normally.
+  const Status& GetReadStatus() const noexcept { return read_status_; }
+
+  // Writes `msg` (or nothing but the flags, if it's `nullptr`). If `last` is
+  // set, the write side is closed afterwards.
+  bool Write(const google::protobuf::Message* msg, bool last);
+
+  // Closes the write side. A failure `status` is only applicable to the server
+  // side, it's reported to the caller's reader.
+  bool Close(int status = rpc::STATUS_SUCCESS, std::string description = "");
+
+ private:
+  bool WriteMessage(const google::protobuf::Message* msg, bool last,
+                    int status, std::string description);
+
+ private:
+  std::shared_ptr<rpc::internal::StreamIoAdaptor> io_;
+
+  // Accessed by the writer only. Messages are serialized before `Write`
+  // returns, so the meta is shared by all of them.
+  std::shared_ptr<rpc::RpcMeta> meta_;
+  bool started_ = false;
+  bool write_closed_ = false;
+
+  Status read_status_;  // Accessed by the reader only.
+};
+
+}  // namespace protobuf::detail
+
+// Reads messages of type `T` from a stream. This is how requests of a
+// client-streaming method are read by the service, and how responses of a
+// server-streaming method are read by the caller.
+//
+// Obtained via `RpcServerController::GetStreamReader` (or the generated stub,
+// on client side).
+template <class T>
+class StreamReader {
+ public:
+  StreamReader() = default;
+  explicit StreamReader(std::shared_ptr<protobuf::detail::StreamContext> ctx)
+      : ctx_(std::move(ctx)) {}
+
+  // Deadline of reading (and writing) the stream. Once it's reached, the
+  // stream is broken. By default it's the timeout of the controller.
+  void SetExpiration(std::chrono::steady_clock::time_point expires_at) {
+    ctx_->SetExpiration(expires_at);
+  }
+
+  // Blocks until the next message arrives. `std::nullopt` is returned at end
+  // of stream or on failure, use `GetStatus()` to tell them apart.
+  std::optional<T> Read() {
+    std::optional<T> msg(std::in_place);
+    if (!ctx_->Read(&*msg)) {
+      return std::nullopt;
+    }
+    return msg;
+  }
+
+  // Once `Read` has returned `std::nullopt`, this tells why. It's successful
+  // if the stream ended normally.
+  const Status& GetStatus() const noexcept { return ctx_->GetReadStatus(); }
+
+ private:
+  std::shared_ptr<protobuf::detail::StreamContext> ctx_;
+};
+
+// Writes messages of type `T` to a stream. Writing blocks if the other side
+// hasn't caught up (@sa: `FLAGS_flare_rpc_stream_window_size`).
+//
+// The stream is closed (if not yet) once the writer and its reader are both
+// gone (on server side, once `done` is called).
+template <class T>
+class StreamWriter {
+ public:
+  StreamWriter() = default;
+  explicit StreamWriter(std::shared_ptr<protobuf::detail::StreamContext> ctx)
+      : ctx_(std::move(ctx)) {}
+
+  // @sa: `StreamReader::SetExpiration`.
+  void SetExpiration(std::chrono::steady_clock::time_point expires_at) {
+    ctx_->SetExpiration(expires_at);
+  }
+
+  // Returns `false` if the stream is broken (or closed).
+  bool Write(const T& msg) { return ctx_->Write(&msg, false); }
+
+  // Writes `msg` and closes the stream. This saves a message compared to
+  // `Write` + `Close`.
+  bool WriteLast(const T& msg) { return ctx_->Write(&msg, true); }
+
+  // Tells the other side there will be no more messages.
+  bool Close() { return ctx_->Close(); }
+
+ private:
+  std::shared_ptr<protobuf::detail::StreamContext> ctx_;
+};
+
+}  // namespace tinyRPC
+
+#endif
@@ -12,6 +12,52 @@ using namespace std::literals;
 
 namespace tinyRPC::protobuf::plugin {
 
+namespace {
+
+// Parameters of `method` in service class. Requests / responses of streaming
+// methods are read / written via stream reader / writer respectively.
+std::string GetServiceMethodParameters(
+    const google::protobuf::MethodDescriptor* method) {
+  std::string pattern;
+  if (method->client_streaming()) {
+    pattern = "    ::flare::StreamReader<{input_type}> reader,\n";
+  } else {
+    pattern = "    const {input_type}& request,\n";  // Ref here, not pointer.
+  }
+  if (method->server_streaming()) {
+    pattern += "    ::flare::StreamWriter<{output_type}> writer,\n";
+  } else {
+    pattern += "    {output_type}* response,\n";
+  }
+  pattern += "    ::flare::RpcServerController* controller";
+  return Format(pattern, fmt::arg("input_type", GetInputType(method)),
+                fmt::arg("output_type", GetOutputType(method)));
+}
+
+// Arguments passed to `method` in `CallMethod`.
+std::string GetServiceMethodArguments(
+    const google::protobuf::MethodDescriptor* method) {
+  std::string pattern;
+  if (method->client_streaming()) {
+    pattern = "      ctlr->GetStreamReader<{input_type}>(),\n";
+  } else {
+    pattern =
+        "      *::google::protobuf::down_cast<const {input_type}*>(\n"
+        "          request),\n";
+  }
+  if (method->server_streaming()) {
+    pattern += "      ctlr->GetStreamWriter<{output_type}>(),\n";
+  } else {
+    pattern +=
+        "      ::google::protobuf::down_cast<{output_type}*>(response),\n";
+  }
+  pattern += "      ctlr";
+  return Format(pattern, fmt::arg("input_type", GetInputType(method)),
+                fmt::arg("output_type", GetOutputType(method)));
+}
+
+}  // namespace
+
 void SyncDeclGenerator::GenerateService(
     const google::protobuf::FileDescriptor* file,
     const google::protobuf::ServiceDescriptor* service, CodeWriter* writer) {
@@ -23,13 +69,10 @@ void SyncDeclGenerator::GenerateService(
 
     pattern =
         "virtual void {method}(\n"
-        "    const {input_type}& request,\n"  // Ref here, not pointer.
-        "    {output_type}* response,\n"
-        "    ::flare::RpcServerController* controller);";
+        "{parameters});";
     method_decls.emplace_back() =
         Format(pattern, fmt::arg("method", method->name()),
-               fmt::arg("input_type", GetInputType(method)),
-               fmt::arg("output_type", GetOutputType(method)));
+               fmt::arg("parameters", GetServiceMethodParameters(method)));
   }
   *writer->NewInsertionToHeader(kInsertionPointNamespaceScope) = Format(
       "class {service} : public ::google::protobuf::Service {{\n"
@@ -77,10 +120,7 @@ void SyncDeclGenerator::GenerateService(
     pattern =
         "case {index}: {{\n"
         "  {method}(\n"
-        "      *::google::protobuf::down_cast<const {input_type}*>(\n"
-        "          request),\n"
-        "      ::google::protobuf::down_cast<{output_type}*>(response),\n"
-        "      ctlr);\n"
+        "{arguments});\n"
         "  done->Run();\n"
         "  break;\n"
         "}}";
@@ -88,8 +128,7 @@ void SyncDeclGenerator::GenerateService(
     call_method_impls.emplace_back() =
         Format(pattern, fmt::arg("index", method->index()),
                fmt::arg("method", method->name()),
-               fmt::arg("input_type", GetInputType(method)),
-               fmt::arg("output_type", GetOutputType(method)));
+               fmt::arg("arguments", GetServiceMethodArguments(method)));
     get_request_prototype_impls.emplace_back() = Format(
         "case {index}:\n"
         "  return {input_type}::default_instance();",
@@ -173,9 +212,7 @@ void SyncDeclGenerator::GenerateService(
 
     pattern =
         "void {service}::{method}(\n"
-        "    const {input_type}& request,\n"  // Ref here, not pointer.
-        "    {output_type}* response,\n"
-        "    ::flare::RpcServerController* controller) {{\n"
+        "{parameters}) {{\n"
         "  {body}\n"
         "}}";
 
@@ -187,8 +224,7 @@ void SyncDeclGenerator::GenerateService(
     *writer->NewInsertionToSource(kInsertionPointNamespaceScope) =
         Format(pattern, fmt::arg("service", GetSyncServiceName(service)),
                fmt::arg("method", method->name()),
-               fmt::arg("input_type", GetInputType(method)),
-               fmt::arg("output_type", GetOutputType(method)),
+               fmt::arg("parameters", GetServiceMethodParameters(method)),
                fmt::arg("body", body)) +
         "\n\n";
   }
@@ -208,12 +244,26 @@ void SyncDeclGenerator::GenerateStub(
     // TBH I'm not sure if we should return `Expected<T>` or `optional<T>`.
     // The former looks more appropriate but our `Expected` has not been
     // thoroughly thought about.
-    pattern =
-        "::flare::Expected<{output_type},\n"
-        "                  ::flare::Status>\n"
-        "{method}(\n"
-        "    const {input_type}& request,\n"
-        "    ::flare::RpcClientController* controller);";
+    if (method->client_streaming()) {
+      // Requests are written via the writer returned.
+      pattern =
+          "std::pair<::flare::StreamReader<{output_type}>,\n"
+          "          ::flare::StreamWriter<{input_type}>>\n"
+          "{method}(::flare::RpcClientController* controller);";
+    } else if (method->server_streaming()) {
+      pattern =
+          "::flare::StreamReader<{output_type}>\n"
+          "{method}(\n"
+          "    const {input_type}& request,\n"
+          "    ::flare::RpcClientController* controller);";
+    } else {
+      pattern =
+          "::flare::Expected<{output_type},\n"
+          "                  ::flare::Status>\n"
+          "{method}(\n"
+          "    const {input_type}& request,\n"
+          "    ::flare::RpcClientController* controller);";
+    }
 
     method_decls.emplace_back() =
         Format(pattern, fmt::arg("method", method->name()),
@@ -255,21 +305,45 @@ void SyncDeclGenerator::GenerateStub(
 
     // TODO(luobogao): Support default controller (used when `controller` is not
     // specified or specified as `nullptr`.).
-    pattern =
-        "::flare::Expected<{output_type}, ::flare::Status>\n"
-        "{stub}::{method}(\n"
-        "    const {input_type}& request,\n"
-        "    ::flare::RpcClientController* ctlr) {{\n"
-        "  {output_type} rc;\n"
-        "  channel_->CallMethod(\n"
-        "      flare_rpc::GetServiceDescriptor({svc_idx})->method({index}),\n"
-        "      ctlr, &request, &rc, nullptr);\n"
-        "  if (!ctlr->Failed()) {{\n"
-        "    return rc;\n"
-        "  }}\n"
-        // By reaching here, the call must have failed.
-        "  return flare::Status(ctlr->ErrorCode(), ctlr->ErrorText());\n"
-        "}}";
+    if (method->client_streaming()) {
+      pattern =
+          "std::pair<::flare::StreamReader<{output_type}>,\n"
+          "          ::flare::StreamWriter<{input_type}>>\n"
+          "{stub}::{method}(::flare::RpcClientController* ctlr) {{\n"
+          "  channel_->CallMethod(\n"
+          "      flare_rpc::GetServiceDescriptor({svc_idx})->method({index}),\n"
+          "      ctlr, nullptr, nullptr, nullptr);\n"
+          "  return {{ctlr->GetStreamReader<{output_type}>(),\n"
+          "          ctlr->GetStreamWriter<{input_type}>()}};\n"
+          "}}";
+    } else if (method->server_streaming()) {
+      pattern =
+          "::flare::StreamReader<{output_type}>\n"
+          "{stub}::{method}(\n"
+          "    const {input_type}& request,\n"
+          "    ::flare::RpcClientController* ctlr) {{\n"
+          "  channel_->CallMethod(\n"
+          "      flare_rpc::GetServiceDescriptor({svc_idx})->method({index}),\n"
+          "      ctlr, &request, nullptr, nullptr);\n"
+          "  return ctlr->GetStreamReader<{output_type}>();\n"
+          "}}";
+    } else {
+      pattern =
+          "::flare::Expected<{output_type}, ::flare::Status>\n"
+          "{stub}::{method}(\n"
+          "    const {input_type}& request,\n"
+          "    ::flare::RpcClientController* ctlr) {{\n"
+          "  {output_type} rc;\n"
+          "  channel_->CallMethod(\n"
+          "      flare_rpc::GetServiceDescriptor({svc_idx})->method({index}),\n"
+          "      ctlr, &request, &rc, nullptr);\n"
+          "  if (!ctlr->Failed()) {{\n"
+          "    return rc;\n"
+          "  }}\n"
+          // By reaching here, the call must have failed.
+          "  return flare::Status(ctlr->ErrorCode(), ctlr->ErrorText());\n"
+          "}}";
+    }
 
     *writer->NewInsertionToSource(kInsertionPointNamespaceScope) =
         Format(pattern, fmt::arg("stub", GetSyncStubName(service)),
@@ -18,15 +18,28 @@
 #include "../../../base/Endian.h"
 #include "../../../base/Function.h"
 #include "../../../base/Endpoint.h"
+#include "../../../base/ObjectPool.h"
 #include "../../../base/Random.h"
 #include "../../../base/String.h"
 #include "../../../base/Tsc.h"
+#include "../../../base/chrono.h"
+#include "../../../fiber/Fiber.h"
 #include "../../../fiber/Latch.h"
+#include "../../../fiber/Mutex.h"
+#include "../../../fiber/Timer.h"
+#include "../../internal/BackupRequestRace.h"
 #include "../../internal/CorrelationID.h"
+#include "../../internal/RequestBudget.h"
 #include "../../internal/StreamCallGate.h"
+#include "../../internal/StreamCallGatePool.h"
 #include "../../MessageDispatcherFactory.h"
+#include "../../internal/StreamIoAdaptor.h"
+#include "../../load_balancer/LoadBalancer.h"
 #include "CallContext.h"
+#include "Compression.h"
 #include "Message.h"
+#include "MethodId.h"
+#include "Stream.h"
 #include "rpcControllerClient.h"
 #include "rpc_meta.pb.h"
 #include "ServiceMethodLocator.h"
@@ -45,20 +58,6 @@ using Factory = UniqueFunction<std::unique_ptr<T>()>;
 
 namespace {
 
-template <class F>
-rpc::internal::StreamCallGateHandle GetOrCreateExclusive(
-    const Endpoint& key, F&& creator) {
-  auto rc = creator();
-  FLARE_CHECK(rc->GetEndpoint() == key);
-  return rpc::internal::StreamCallGateHandle(std::move(rc));
-}
-
- struct FastCallContext {
-  std::uintptr_t nslb_ctx{};
-  std::shared_ptr<protobuf::ProactiveCallContext> call_ctx;
-  rpc::internal::StreamCallGateHandle call_gate_handle;
-};
-
 // TODO:
 protobuf::detail::MockChannel* mock_channel;
 
@@ -102,6 +101,18 @@ std::uint64_t GetNextPseudoRandomKey() {
   return index++;
 }
 
+// Tells the server which method we're calling, by ID if `use_method_id` is
+// set, or by name otherwise.
+void SetMethod(const google::protobuf::MethodDescriptor& method,
+               bool use_method_id, rpc::RpcRequestMeta* meta) {
+  if (use_method_id) {
+    meta->set_method_id(protobuf::GetMethodId(method.full_name()));
+  } else {
+    meta->mutable_method_name()->assign(method.full_name().begin(),
+                                        method.full_name().end());
+  }
+}
+
 rpc::Status TranslateRpcError(rpc::internal::StreamCallGate::CompletionStatus status) {
   FLARE_CHECK(status != rpc::internal::StreamCallGate::CompletionStatus::Success);
   if (status == rpc::internal::StreamCallGate::CompletionStatus::IoError) {
@@ -114,6 +125,19 @@ rpc::Status TranslateRpcError(rpc::internal::StreamCallGate::CompletionStatus st
   FLARE_UNREACHABLE();
 }
 
+// Translates result of an RPC to feedback to the load balancer. Errors returned
+// by the user's code are not the server's fault.
+LoadBalancer::Status GetLoadBalancerStatus(int status) {
+  if (status == rpc::STATUS_OVERLOADED) {
+    return LoadBalancer::Status::Overloaded;
+  }
+  if (status == rpc::STATUS_SUCCESS || status == rpc::STATUS_FAILED ||
+      status > rpc::STATUS_RESERVED_MAX) {
+    return LoadBalancer::Status::Success;
+  }
+  return LoadBalancer::Status::Failed;
+}
+
 }  // namespace
 
 struct RpcChannel::RpcCompletionDesc {
@@ -124,14 +148,99 @@ struct RpcChannel::RpcCompletionDesc {
   const Endpoint* remote_peer = nullptr;
 };
 
+// Everything we need for making a (non-streaming) RPC, so that we don't have to
+// allocate them separately for each call. Objects of this type are pooled.
+struct RpcChannel::FastCall final
+    : rpc::internal::StreamCallGate::FastCallArgs {
+  // Describes the call. Preserved across retries.
+  RpcChannel* channel;
+  const google::protobuf::MethodDescriptor* method;
+  RpcClientController* rpc_controller;
+  const google::protobuf::Message* request;
+  google::protobuf::Message* response;
+  google::protobuf::Closure* done;
+  std::size_t retries_left;
+
+  // Describes this attempt.
+  std::uintptr_t nslb_ctx{};
+  std::chrono::steady_clock::time_point start_time;
+  rpc::internal::StreamCallGateHandle call_gate_handle;
+  protobuf::ProactiveCallContext call_ctx;
+  rpc::RpcMeta meta;
+
+  // Set if a backup request may be (or has been) sent for this call. Shared by
+  // the primary call and the backup one.
+  RefPtr<BackupRequestContext> backup_ctx;
+
+  void OnCompletion(rpc::internal::StreamCallGate::CompletionStatus status,
+                    rpc::internal::StreamCallGate::MessagePtr msg_ptr,
+                    const rpc::internal::StreamCallGate::Timestamps&) override {
+    // Responses are matched with requests by correlation ID, so a timed out
+    // RPC does not confuse subsequent ones. The gate is kept in the pool unless
+    // it's broken (in which case the pool evicts it once the last handle to it
+    // is closed).
+    auto proto_msg = dynamic_cast<protobuf::ProtoMessage*>(msg_ptr.get());
+    int rpc_status = proto_msg ? proto_msg->meta->response_meta().status()
+                               : TranslateRpcError(status);
+    channel->OnFastCallCompletion(
+        this, RpcCompletionDesc{.status = rpc_status,
+                                .msg = proto_msg,
+                                .remote_peer = &call_gate_handle->GetEndpoint()});
+  }
+
+  void Destroy() noexcept override {
+    call_gate_handle.Close();
+    call_ctx.response_ptr = nullptr;
+    meta.Clear();  // Memory allocated by submessages are kept for reuse.
+    backup_ctx = nullptr;
+    ResetRefCount();
+    object_pool::Put<FastCall>(this);
+  }
+};
+
+// Shared by a call and its backup request. The one completes first wins.
+//
+// Unlike `FastCall`, this is allocated only for calls with backup request
+// enabled.
+struct RpcChannel::BackupRequestContext
+    : RefCounted<BackupRequestContext> {
+  fiber::Mutex lock;
+  rpc::internal::BackupRequestRace race;
+  Endpoint primary_peer;
+  fiber::detail::TimerPtr timer;
+
+  // Primary call and the backup one, if they've been issued and the RPC has
+  // not completed yet.
+  RefPtr<FastCall> calls[2];
+
+  // The backup call parses its response here. It's moved to the user's
+  // response if the backup call wins.
+  std::unique_ptr<google::protobuf::Message> backup_response;
+};
+
+namespace object_pool {
+
+template <>
+struct PoolTraits<RpcChannel::FastCall> {
+  static constexpr std::size_t kLocalCacheSize = 1024;
+  static constexpr std::size_t kTransferCacheSize = 16384;
+  static constexpr std::size_t kTransferBatchSize = 256;
+};
+
+}  // namespace object_pool
+
 struct RpcChannel::Impl {
   // If this, this channel will be used instead. Used for performing RPC mock /
   // dry-run.
   MaybeOwning<google::protobuf::RpcChannel> alternative_channel;
 
   bool opened = false;
+  std::string protocol_name;  // Call gates are pooled by protocol.
   std::unique_ptr<MessageDispatcher> message_dispatcher;
   Factory<StreamProtocol> protocol_factory;
+
+  // Caps backup requests made through this channel.
+  std::optional<rpc::internal::RequestBudget> backup_request_budget;
 };
 
 RpcChannel::RpcChannel() { impl_ = std::make_unique<Impl>(); }
@@ -165,6 +274,7 @@ bool RpcChannel::Open(std::string address, const Options& options) {
 
   // Initialize NSLB, etc.
   auto&& [scheme, addr] = *inspection_result;
+  impl_->protocol_name = scheme;
   impl_->protocol_factory =
       client_side_stream_protocol_registry.GetFactory(scheme);
   if (!options.override_nslb.empty()) {
@@ -177,6 +287,8 @@ bool RpcChannel::Open(std::string address, const Options& options) {
     FLARE_LOG_WARNING("URI [{}] is not resolvable.", address);
     return false;
   }
+  impl_->backup_request_budget.emplace(options.backup_request_ratio,
+                                       options.backup_request_burst);
   impl_->opened = true;
 
   return true;
@@ -201,142 +313,291 @@ void RpcChannel::CallMethod(const google::protobuf::MethodDescriptor* method,
                                                   response, done);
   }
 
+  if (method->client_streaming() || method->server_streaming()) {
+    return CallStreamingMethod(method, ctlr, request, done);
+  }
   CallMethodWritingImpl(method, ctlr, request, response, done);
 }
 
-void RpcChannel::CallMethodWritingImpl(
+void RpcChannel::CallStreamingMethod(
     const google::protobuf::MethodDescriptor* method,
     RpcClientController* controller, const google::protobuf::Message* request,
-    google::protobuf::Message* response, google::protobuf::Closure* done) {
-  fiber::Latch latch(1);
-
-  auto cb = [this, controller, done, response, &latch] {
-    if (done) {
-      done->Run();
+    google::protobuf::Closure* done) {
+  std::uintptr_t nslb_ctx;
+  Endpoint remote_peer;
+  auto fail_early = [&](const RpcCompletionDesc& desc) {
+    controller->SetStream(
+        std::make_shared<protobuf::detail::StreamContext>(Status(desc.status)));
+  };
+  if (GetPeerOrFailEarlyForFastCall(*method, *controller, &remote_peer,
+                                    nullptr, &nslb_ctx, fail_early)) {
+    controller->SetRemotePeer(remote_peer);
+    // We don't know when the stream ends, the call is not measured.
+    impl_->message_dispatcher->Report(remote_peer,
+                                      LoadBalancer::Status::Success, 0ns,
+                                      nslb_ctx);
+
+    // Each response of the stream is parsed into a new message.
+    auto call_ctx = std::make_shared<protobuf::ProactiveCallContext>();
+    call_ctx->method = method;
+    call_ctx->response_prototype =
+        google::protobuf::MessageFactory::generated_factory()->GetPrototype(
+            method->output_type());
+    call_ctx->expecting_stream = true;
+
+    // The stream holds the gate until it's closed.
+    auto handle = GetFastCallGate(remote_peer);
+    auto gate = handle.Get();
+    auto correlation_id = NextCorrelationId();
+    auto io = gate->StreamCall(correlation_id, std::move(call_ctx),
+                               [handle = std::move(handle)] {});
+    io->SetExpiration(controller->GetTimeout());
+
+    rpc::RpcMeta meta;
+    meta.set_correlation_id(correlation_id);
+    SetMethod(*method, options_.use_method_id, meta.mutable_request_meta());
+    meta.mutable_request_meta()->set_timeout(
+        controller->GetRelativeTimeout() / 1ms);
+    auto stream = std::make_shared<protobuf::detail::StreamContext>(
+        std::move(io), std::move(meta));
+    if (!method->client_streaming()) {
+      (void)stream->Write(request, true);  // Failure is seen by the reader.
     } else {
-      latch.count_down();
+      // Let the server start the call before our first request is written.
+      (void)stream->Write(nullptr, false);
     }
-  };
-  auto completion = tinyRPC::NewCallback(std::move(cb));
+    controller->SetStream(std::move(stream));
+  }
 
-  CallMethodWithRetry(method, controller, request, response, completion,
-                      controller->GetMaxRetries());
-  if (!done) {  // It was a blocking call.
-    latch.wait();
+  if (done) {
+    done->Run();
   }
 }
 
+void RpcChannel::CallMethodWritingImpl(
+    const google::protobuf::MethodDescriptor* method,
+    RpcClientController* controller, const google::protobuf::Message* request,
+    google::protobuf::Message* response, google::protobuf::Closure* done) {
+  if (done) {
+    CallMethodWithRetry(method, controller, request, response, done,
+                        controller->GetMaxRetries());
+    return;
+  }
+
+  // It's a blocking call. The closure lives on our stack until it's run.
+  struct Waiter : google::protobuf::Closure {
+    fiber::Latch latch{1};
+    void Run() override { latch.count_down(); }
+  } waiter;
+  CallMethodWithRetry(method, controller, request, response, &waiter,
+                      controller->GetMaxRetries());
+  waiter.latch.wait();
+}
+
 void RpcChannel::CallMethodWithRetry(
     const google::protobuf::MethodDescriptor* method,
     RpcClientController* controller, const google::protobuf::Message* request,
     google::protobuf::Message* response, google::protobuf::Closure* done,
     std::size_t retries_left) {
-  auto cb = [this, method, controller, request, response, done,
-             retries_left](const RpcCompletionDesc& desc) mutable {
-    // The RPC has failed and there's still budget for retry, let's retry then.
-    if (desc.status != rpc::STATUS_SUCCESS &&
-        // Not user error.
-        (desc.status != rpc::STATUS_FAILED &&
-         desc.status <= rpc::STATUS_RESERVED_MAX) &&
-        retries_left != 1) {
-      FLARE_CHECK_GT(retries_left, 1);
-      CallMethodWithRetry(method, controller, request, response, done,
-                          retries_left - 1);
+  RefPtr<FastCall> call(adopt_ptr, object_pool::Get<FastCall>());
+  call->channel = this;
+  call->method = method;
+  call->rpc_controller = controller;
+  call->request = request;
+  call->response = response;
+  call->done = done;
+  call->retries_left = retries_left;
+  call->call_ctx.response_ptr = response;
+  if (auto after = controller->GetBackupRequestAfter()) {
+    CallMethodWithBackupRequest(std::move(call), *after);
+  } else {
+    CallMethodNoRetry(std::move(call));
+  }
+}
+
+void RpcChannel::CallMethodWithBackupRequest(RefPtr<FastCall> call,
+                                             std::chrono::nanoseconds after) {
+  impl_->backup_request_budget->Deposit();
+
+  auto ctx = MakeRefCounted<BackupRequestContext>();
+  call->backup_ctx = ctx;
+  CallMethodNoRetry(call);
+
+  std::scoped_lock _(ctx->lock);
+  if (ctx->race.Completed()) {
+    return;  // Completed (e.g. failed) early, no backup request is needed.
+  }
+  ctx->calls[0] = call;
+  ctx->primary_peer = call->call_gate_handle->GetEndpoint();
+  ctx->timer = fiber::internal::CreateTimer(
+      ReadSteadyClock() + after, [this, ctx](auto&&) {
+        // We're in timer worker's context, don't block it.
+        fiber::StartFiberDetached([this, ctx] { SendBackupRequest(ctx); });
+      });
+  fiber::internal::EnableTimer(ctx->timer);
+}
+
+void RpcChannel::SendBackupRequest(RefPtr<BackupRequestContext> ctx) {
+  RefPtr<FastCall> primary;
+  {
+    std::scoped_lock _(ctx->lock);
+    ctx->timer = nullptr;  // Breaks the cycle between `ctx` and the timer.
+    if (!ctx->race.TryStartBackup(&*impl_->backup_request_budget)) {
       return;
     }
+    primary = ctx->calls[0];
+    primary->rpc_controller->SetBackupRequestSent();
+  }
 
-    // It's the final result.
-    controller->SetCompletion(done);
-    CopyInterestedFieldsFromMessageToController(desc, controller);
+  // The backup call shares everything but the response with the primary one.
+  ctx->backup_response.reset(primary->response->New());
+  RefPtr<FastCall> call(adopt_ptr, object_pool::Get<FastCall>());
+  call->channel = this;
+  call->method = primary->method;
+  call->rpc_controller = primary->rpc_controller;
+  call->request = primary->request;
+  call->response = primary->response;
+  call->done = primary->done;
+  call->retries_left = primary->retries_left;
+  call->call_ctx.response_ptr = ctx->backup_response.get();
+  call->backup_ctx = ctx;
+  CallMethodNoRetry(call, &ctx->primary_peer);
+
+  {
+    std::scoped_lock _(ctx->lock);
+    if (!ctx->race.Completed()) {
+      ctx->calls[1] = std::move(call);
+      return;
+    }
+  }
+  // The RPC has completed in the meantime, we don't need it any more.
+  (void)CancelFastCall(call.Get());
+}
 
-    if (desc.msg) {
-      auto&& resp_meta = desc.msg->meta->response_meta();
-      controller->NotifyCompletion(
-          FLARE_LIKELY(resp_meta.status() == rpc::STATUS_SUCCESS)
-              ? Status()
-              : Status(resp_meta.status(), resp_meta.description()));
-    } else {
-      controller->NotifyCompletion(Status(desc.status));
+bool RpcChannel::OnBackupRequestCompletion(FastCall* call,
+                                           const RpcCompletionDesc& desc) {
+  auto&& ctx = *call->backup_ctx;
+  auto is_backup = call->call_ctx.response_ptr != call->response;
+  RefPtr<FastCall> calls[2];
+  fiber::detail::TimerPtr timer;
+  {
+    std::scoped_lock _(ctx.lock);
+    // The primary call parses its response into user's response. Unless we
+    // manage to cancel it, we can't touch user's response. In this case the
+    // primary call, whose response is being parsed, wins.
+    if (!ctx.race.OnCompletion(
+            is_backup, desc.status == rpc::STATUS_SUCCESS,
+            [&] { return CancelFastCall(ctx.calls[0].Get()); })) {
+      return false;
     }
-  };
-  CallMethodNoRetry(method, request, *controller, response, std::move(cb));
+    calls[0] = std::move(ctx.calls[0]);
+    calls[1] = std::move(ctx.calls[1]);
+    timer = std::move(ctx.timer);
+  }
+
+  if (timer) {
+    fiber::internal::KillTimer(timer);
+  }
+  if (!is_backup && calls[1]) {
+    (void)CancelFastCall(calls[1].Get());
+  }
+  if (is_backup) {
+    // Move the response to where the user expects it.
+    call->response->GetReflection()->Swap(call->response,
+                                          call->call_ctx.response_ptr);
+  }
+  return true;
 }
 
-template <class F>
-void RpcChannel::CallMethodNoRetry(
-    const google::protobuf::MethodDescriptor* method,
-    const google::protobuf::Message* request,
-    const RpcClientController& controller, google::protobuf::Message* response,
-    F&& cb) {
-  // Find a peer to call.
-  std::uintptr_t nslb_ctx;
-  Endpoint remote_peer;
-  if (FLARE_UNLIKELY(!GetPeerOrFailEarlyForFastCall(*method, &remote_peer,
-                                                    &nslb_ctx, cb))) {
+bool RpcChannel::CancelFastCall(FastCall* call) {
+  if (!call->call_gate_handle ||
+      !call->call_gate_handle->CancelFastCall(call->meta.correlation_id())) {
+    return false;
+  }
+  // The call won't complete, its result is not known.
+  impl_->message_dispatcher->Report(call->call_gate_handle->GetEndpoint(),
+                                    LoadBalancer::Status::Success, 0ns,
+                                    call->nslb_ctx);
+  return true;
+}
+
+void RpcChannel::OnFastCallCompletion(FastCall* call,
+                                      const RpcCompletionDesc& desc) {
+  if (desc.remote_peer) {  // Otherwise we failed before a peer was chosen.
+    impl_->message_dispatcher->Report(
+        *desc.remote_peer, GetLoadBalancerStatus(desc.status),
+        ReadSteadyClock() - call->start_time, call->nslb_ctx);
+  }
+  if (call->backup_ctx && !OnBackupRequestCompletion(call, desc)) {
+    return;  // The other call completes the RPC.
+  }
+
+  // The RPC has failed and there's still budget for retry, let's retry then.
+  if (desc.status != rpc::STATUS_SUCCESS &&
+      // Not user error.
+      (desc.status != rpc::STATUS_FAILED &&
+       desc.status <= rpc::STATUS_RESERVED_MAX) &&
+      call->retries_left != 1) {
+    FLARE_CHECK_GT(call->retries_left, 1);
+    CallMethodWithRetry(call->method, call->rpc_controller, call->request,
+                        call->response, call->done, call->retries_left - 1);
     return;
   }
 
-  // Describe several aspect of this RPC.
-  auto call_ctx = std::make_shared<protobuf::ProactiveCallContext>();
-  auto call_ctx_ptr = call_ctx.get();  // Used later.
-  call_ctx->method = method;
-  call_ctx->response_ptr = response;
+  // It's the final result.
+  auto controller = call->rpc_controller;
+  controller->SetCompletion(call->done);
+  CopyInterestedFieldsFromMessageToController(desc, controller);
+
+  if (desc.msg) {
+    auto&& resp_meta = desc.msg->meta->response_meta();
+    controller->NotifyCompletion(
+        FLARE_LIKELY(resp_meta.status() == rpc::STATUS_SUCCESS)
+            ? Status()
+            : Status(resp_meta.status(), resp_meta.description()));
+  } else {
+    controller->NotifyCompletion(Status(desc.status));
+  }
+}
 
-  // Open a gate and keep an extra ref. on it.
-  //
-  // The extra ref. is required to keep the gate alive until `FastCall`
-  // finishes. This is necessary to prevent the case when our callback is called
-  // (therefore, `ctlr.DetachGate()` is called) before `FastCall` return, we
-  // need to keep a ref-count ourselves.
-  auto gate_handle = GetFastCallGate(remote_peer);
-
-  // Context passed to our completion callback.
-  auto cb_ctx = std::make_shared<FastCallContext>();
-  cb_ctx->nslb_ctx = nslb_ctx;
-  cb_ctx->call_ctx = std::move(call_ctx);
-  cb_ctx->call_gate_handle = std::move(gate_handle);
-
-  // Completion callback.
-  auto on_completion = [this, cb_ctx = std::move(cb_ctx), cb = std::move(cb)](
-                           auto status, auto msg_ptr,
-                           auto&& timestamps) mutable {
-    Endpoint remote_peer = cb_ctx->call_gate_handle->GetEndpoint();
-
-    // The RPC timed out. Besides, the connection does not support multiplexing.
-    //
-    // In this case we must close the connection to avoid confusion in
-    // correspondence between subsequent request and pending responses (to this
-    // one, and to newer request).
-    if (!msg_ptr) {
-      cb_ctx->call_gate_handle->SetUnhealthy();
-    }
-    cb_ctx->call_gate_handle.Close();
+void RpcChannel::CallMethodNoRetry(RefPtr<FastCall> call,
+                                   const Endpoint* avoid) {
+  auto&& method = *call->method;
+  auto&& controller = *call->rpc_controller;
 
-    auto proto_msg = dynamic_cast<protobuf::ProtoMessage*>(msg_ptr.get());
-    int rpc_status = proto_msg ? proto_msg->meta->response_meta().status()
-                               : TranslateRpcError(status);
+  // Find a peer to call.
+  Endpoint remote_peer;
+  if (FLARE_UNLIKELY(!GetPeerOrFailEarlyForFastCall(
+          method, controller, &remote_peer, avoid, &call->nslb_ctx,
+          [&](auto&& desc) { OnFastCallCompletion(call.Get(), desc); }))) {
+    return;
+  }
 
-    cb(RpcCompletionDesc{.status = rpc_status,
-                         .msg = proto_msg,
-                         .remote_peer = &remote_peer});
-  };
+  call->start_time = ReadSteadyClock();
+
+  // Describe several aspect of this RPC.
+  call->call_ctx.method = &method;
+  call->controller = &call->call_ctx;
+  call->call_gate_handle = GetFastCallGate(remote_peer);
 
   // Prepare the request message.
   protobuf::ProtoMessage req_msg;
-  CreateNativeRequestForFastCall(*method, request, controller, &req_msg);
+  CreateNativeRequestForFastCall(method, call->request, controller,
+                                 &call->meta, &req_msg);
 
   // And issue the call.
-  auto args = std::make_shared<rpc::internal::StreamCallGate::FastCallArgs>();
-  args->completion = std::move(on_completion);
-  args->controller = call_ctx_ptr;
-  gate_handle->FastCall(req_msg, std::move(args), controller.GetTimeout());
+  //
+  // We keep our own ref. on `call` (and therefore, the gate) until `FastCall`
+  // returns. Otherwise our completion callback may be called (and the gate be
+  // returned to the pool) before `FastCall` returns.
+  call->call_gate_handle->FastCall(req_msg, call, controller.GetTimeout());
 }
 
-
 template <class F>
 bool RpcChannel::GetPeerOrFailEarlyForFastCall(
-    const google::protobuf::MethodDescriptor& method, Endpoint* peer,
-    std::uintptr_t* nslb_ctx, F&& cb) {
+    const google::protobuf::MethodDescriptor& method,
+    const RpcClientController& controller, Endpoint* peer,
+    const Endpoint* avoid, std::uintptr_t* nslb_ctx, F&& cb) {
   if (FLARE_UNLIKELY(!impl_->opened)) {
     FLARE_LOG_WARNING(
         "Calling method [{}] on failed channel [{}].", method.full_name(),
@@ -344,14 +605,31 @@ bool RpcChannel::GetPeerOrFailEarlyForFastCall(
     cb(RpcCompletionDesc{.status = rpc::STATUS_INVALID_CHANNEL});
     return false;
   }
+  auto key = controller.GetRequestKey();
   if (FLARE_UNLIKELY(!impl_->message_dispatcher->GetPeer(
-          GetNextPseudoRandomKey(), peer, nslb_ctx))) {
+          key ? *key : GetNextPseudoRandomKey(), peer, nslb_ctx))) {
     FLARE_LOG_WARNING(
         "No peer available for calling method [{}] on [{}].",
         method.full_name(), address_);
     cb(RpcCompletionDesc{.status = rpc::STATUS_NO_PEER});
     return false;
   }
+  // Try a few more times to pick a different peer. If there's only one peer,
+  // we call it anyway. The request key (if any) is not respected here, as it
+  // would lead us to the same peer.
+  for (int i = 0; avoid && *peer == *avoid && i != 3; ++i) {
+    Endpoint another;
+    std::uintptr_t another_ctx;
+    if (!impl_->message_dispatcher->GetPeer(GetNextPseudoRandomKey(), &another,
+                                            &another_ctx)) {
+      break;
+    }
+    // The peer we're not going to call is not measured.
+    impl_->message_dispatcher->Report(*peer, LoadBalancer::Status::Success, 0ns,
+                                      *nslb_ctx);
+    *peer = another;
+    *nslb_ctx = another_ctx;
+  }
 
   return true;
 }
@@ -359,28 +637,50 @@ bool RpcChannel::GetPeerOrFailEarlyForFastCall(
 void RpcChannel::CreateNativeRequestForFastCall(
     const google::protobuf::MethodDescriptor& method,
     const google::protobuf::Message* request,
-    const RpcClientController& controller, protobuf::ProtoMessage* to) {
+    const RpcClientController& controller, rpc::RpcMeta* meta,
+    protobuf::ProtoMessage* to) {
   // Initialize meta.
-  auto meta = std::make_shared<rpc::RpcMeta>();
+  meta->set_correlation_id(NextCorrelationId());
   meta->set_method_type(rpc::METHOD_TYPE_SINGLE);
-  meta->mutable_request_meta()->mutable_method_name()->assign(
-      method.full_name().begin(), method.full_name().end());
+  SetMethod(method, options_.use_method_id, meta->mutable_request_meta());
   meta->mutable_request_meta()->set_timeout(controller.GetRelativeTimeout() /
                                             1ms);
-  to->meta = std::move(meta);
+  to->meta = std::shared_ptr<rpc::RpcMeta>(std::shared_ptr<void>(), meta);
 
   // Initialize body.
   to->msg = MaybeOwning(non_owning, request);
 
   // And (optionally) the attachment.
   to->attachment = controller.GetRequestAttachment();
+
+  // Tell the server what we can decompress, and compress the request if asked
+  // to. We don't know what the server accepts, so it's assumed to be capable
+  // of the same algorithms as we are.
+  auto acceptable = protobuf::compression::GetAcceptableCompressionAlgorithms();
+  to->meta->mutable_request_meta()->set_acceptable_compression_algorithms(
+      acceptable);
+  auto algorithm = controller.GetCompressionAlgorithm();
+  if (algorithm == rpc::COMPRESSION_ALGORITHM_UNKNOWN &&
+      !options_.compression_algorithms.empty()) {
+    if (auto iter = options_.compression_algorithms.find(method.full_name());
+        iter != options_.compression_algorithms.end()) {
+      algorithm = iter->second;
+    }
+  }
+  protobuf::compression::SetCompressionAlgorithm(
+      algorithm, acceptable, to->msg, to->attachment, to->meta.get());
+}
+
+std::uint32_t RpcChannel::NextCorrelationId() const noexcept {
+  return rpc::internal::NewRpcCorrelationId();
 }
 
 rpc::internal::StreamCallGateHandle RpcChannel::GetFastCallGate(
     const Endpoint& ep) {
-    return GetOrCreateExclusive(
-        ep, [&] { return CreateCallGate(ep); });
-  }
+  // Our protocol supports multiplexing, gates are shared between calls.
+  return rpc::internal::GetGlobalStreamCallGatePool(impl_->protocol_name)
+      ->GetOrCreateShared(ep, [&] { return CreateCallGate(ep); });
+}
 
 
 std::shared_ptr<rpc::internal::StreamCallGate> RpcChannel::CreateCallGate(
@@ -400,7 +700,9 @@ std::shared_ptr<rpc::internal::StreamCallGate> RpcChannel::CreateCallGate(
 
 void RpcChannel::CopyInterestedFieldsFromMessageToController(
     const RpcCompletionDesc& completion_desc, RpcClientController* ctlr) {
-  ctlr->SetRemotePeer(*completion_desc.remote_peer);
+  if (completion_desc.remote_peer) {
+    ctlr->SetRemotePeer(*completion_desc.remote_peer);
+  }
   if (auto msg = completion_desc.msg) {
     ctlr->SetResponseAttachment(msg->attachment);
   }
@@ -1,15 +1,19 @@
 #ifndef _SRC_RPC_PROTOCOL_PROTOBUF_RPC_CHANNEL_H_
 #define _SRC_RPC_PROTOCOL_PROTOBUF_RPC_CHANNEL_H_
 
+#include <chrono>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "gflags/gflags_declare.h"
 #include "gtest/gtest_prod.h"
 #include "google/protobuf/service.h"
 
+#include "../../../base/RefPtr.h"
 #include "../../../base/internal/LazyInit.h"
 #include "MockChannel.h"
+#include "rpc_meta.pb.h"
 
 DECLARE_int32(flare_rpc_channel_max_packet_size);
 
@@ -56,6 +60,27 @@ class RpcChannel : public google::protobuf::RpcChannel {
     // If non-empty, NSLB specified here will be used in place of the default
     // NSLB mechanism of protocol being used.
     std::string override_nslb;
+
+    // Compression algorithm for requests of each method (keyed by full name of
+    // the method). The server compresses its responses in the same way, if
+    // not told otherwise.
+    //
+    // @sa: `RpcClientController::SetCompressionAlgorithm`.
+    std::unordered_map<std::string, rpc::CompressionAlgorithm>
+        compression_algorithms;
+
+    // If set, methods are identified by a 32-bit ID instead of their full
+    // name on the wire (@sa: `protobuf/MethodId.h`). This saves some bytes
+    // and CPU cycles for small requests, but servers predating this option
+    // can't recognize such requests.
+    bool use_method_id = false;
+
+    // Backup requests (@sa: `RpcClientController::SetBackupRequestAfter`) are
+    // capped to this ratio of calls made through this channel, so that they
+    // can't amplify an overload of the servers. Up to `backup_request_burst`
+    // backup requests can be made above that ratio in a burst.
+    double backup_request_ratio = 0.1;
+    std::size_t backup_request_burst = 10;
   };
 
   RpcChannel();
@@ -86,6 +111,11 @@ class RpcChannel : public google::protobuf::RpcChannel {
   // read / written via `GetStreamReader()` / `GetStreamWriter()` of
   // `controller`.
   //
+  // For server-streaming methods, `request` is sent as the only request, and
+  // `response` is ignored. Responses should be read via `GetStreamReader()`.
+  //
+  // Streaming calls never block (`done`, if provided, is called immediately),
+  // and they're not retried.
   //
   // For non-streaming call, if `done` is not provided, it's a blocking call.
   void CallMethod(const google::protobuf::MethodDescriptor* method,
@@ -96,6 +126,8 @@ class RpcChannel : public google::protobuf::RpcChannel {
 
  private:
   struct RpcCompletionDesc;
+  struct FastCall;
+  struct BackupRequestContext;
 
   FRIEND_TEST(Channel, L5);
   void CallMethodWritingImpl(const google::protobuf::MethodDescriptor* method,
@@ -104,6 +136,11 @@ class RpcChannel : public google::protobuf::RpcChannel {
                               google::protobuf::Message* response,
                               google::protobuf::Closure* done);
 
+  void CallStreamingMethod(const google::protobuf::MethodDescriptor* method,
+                           RpcClientController* controller,
+                           const google::protobuf::Message* request,
+                           google::protobuf::Closure* done);
+
   void CallMethodWithRetry(const google::protobuf::MethodDescriptor* method,
                            RpcClientController* controller,
                            const google::protobuf::Message* request,
@@ -111,7 +148,7 @@ class RpcChannel : public google::protobuf::RpcChannel {
                            google::protobuf::Closure* done,
                            std::size_t retries_left);
 
-  // Make an RPC.
+  // Make an RPC, as described by `call`.
   //
   // This method is carefully designed so that you can call it concurrently even
   // with the same controller. This is essential for implementing things such as
@@ -120,25 +157,44 @@ class RpcChannel : public google::protobuf::RpcChannel {
   // The caller is responsible for ensuring that `response` is not shared with
   // anyone else.
   //
-  // `cb` is called with `(const RpcCompletionDesc&)`.
-  template <class F>
-  void CallMethodNoRetry(const google::protobuf::MethodDescriptor* method,
-                         const google::protobuf::Message* request,
-                         const RpcClientController& controller,
-                         google::protobuf::Message* response, F&& cb);
+  // If `avoid` is given, we try (but not guarantee) to call a peer other than
+  // it.
+  //
+  // `OnFastCallCompletion` is called on completion.
+  void CallMethodNoRetry(RefPtr<FastCall> call,
+                         const Endpoint* avoid = nullptr);
+
+  // Makes the call described by `call`, and sends a backup request if it's not
+  // completed `after` then.
+  void CallMethodWithBackupRequest(RefPtr<FastCall> call,
+                                   std::chrono::nanoseconds after);
+  void SendBackupRequest(RefPtr<BackupRequestContext> ctx);
 
+  // Decides which call (the primary one or the backup one) completes the RPC.
+  // Returns `false` if `call` should be dropped.
+  bool OnBackupRequestCompletion(FastCall* call, const RpcCompletionDesc& desc);
+
+  // Returns `true` if the call is cancelled before it completes.
+  bool CancelFastCall(FastCall* call);
+
+  // Retries the call if it's failed and there's still budget for that, or
+  // completes the call otherwise.
+  void OnFastCallCompletion(FastCall* call, const RpcCompletionDesc& desc);
 
   std::uint32_t NextCorrelationId() const noexcept;
 
   template <class F>
   bool GetPeerOrFailEarlyForFastCall(
-      const google::protobuf::MethodDescriptor& method, Endpoint* peer,
-      std::uintptr_t* nslb_ctx, F&& cb);
+      const google::protobuf::MethodDescriptor& method,
+      const RpcClientController& controller, Endpoint* peer,
+      const Endpoint* avoid, std::uintptr_t* nslb_ctx, F&& cb);
 
+  // `meta` is used as storage for `to->meta` and must outlive `to`.
   void CreateNativeRequestForFastCall(
       const google::protobuf::MethodDescriptor& method,
       const google::protobuf::Message* request,
-      const RpcClientController& controller, protobuf::ProtoMessage* to);
+      const RpcClientController& controller, rpc::RpcMeta* meta,
+      protobuf::ProtoMessage* to);
 
   void CopyInterestedFieldsFromMessageToController(
       const RpcCompletionDesc& completion_desc, RpcClientController* ctlr);
@@ -41,6 +41,28 @@ void RpcClientController::SetMaxRetries(std::size_t max_retries) {
 
 std::size_t RpcClientController::GetMaxRetries() const { return max_retries_; }
 
+void RpcClientController::SetBackupRequestAfter(
+    std::chrono::nanoseconds after) {
+  backup_request_after_ = after;
+}
+
+std::optional<std::chrono::nanoseconds>
+RpcClientController::GetBackupRequestAfter() const {
+  return backup_request_after_;
+}
+
+bool RpcClientController::IsBackupRequestSent() const {
+  return backup_request_sent_;
+}
+
+void RpcClientController::SetRequestKey(std::uint64_t key) {
+  request_key_ = key;
+}
+
+std::optional<std::uint64_t> RpcClientController::GetRequestKey() const {
+  return request_key_;
+}
+
 
 void RpcClientController::SetFailed(const std::string& reason) {
   FLARE_CHECK(0, "Unexpected.");
@@ -53,12 +75,17 @@ void RpcClientController::Reset() {
   completed_ = false;
 
   max_retries_ = 1;
+  backup_request_after_ = std::nullopt;
+  request_key_ = std::nullopt;
+  compression_algorithm_ = rpc::COMPRESSION_ALGORITHM_UNKNOWN;
   last_reset_ = ReadSteadyClock();
   timeout_ = last_reset_ + 1ms * FLAGS_flare_rpc_client_default_rpc_timeout_ms;
 
   completion_ = nullptr;
 
   rpc_status_ = std::nullopt;
+  backup_request_sent_ = false;
+  stream_ = nullptr;
 }
 
 void RpcClientController::PrecheckForNewRpc() {
@@ -1,13 +1,16 @@
 #ifndef _SRC_RPC_PROTOCOL_PROTOBUF_RPC_CLIENT_CONTROLLER_H_
 #define _SRC_RPC_PROTOCOL_PROTOBUF_RPC_CLIENT_CONTROLLER_H_
 
-#include <string>
+#include <chrono>
+#include <cstdint>
 #include <optional>
+#include <string>
 
 #include "gflags/gflags_declare.h"
 #include "gtest/gtest_prod.h"
 
 #include "../../../base/Status.h"
+#include "Stream.h"
 #include "rpcControllerCommon.h"
 
 DECLARE_int32(flare_rpc_client_default_rpc_timeout_ms);
@@ -48,6 +51,33 @@ class RpcClientController : public protobuf::RpcControllerCommon {
   void SetMaxRetries(std::size_t max_retries);
   std::size_t GetMaxRetries() const;
 
+  // Make sure that your call is idempotent before enabling this.
+  //
+  // If no response has been received `after` the call is made, the request is
+  // sent again to a different server (if there is one). The first response
+  // wins, and the other call is cancelled. This trades a bit more load for a
+  // lower tail latency.
+  //
+  // To keep backup requests from amplifying an overload, they're capped by the
+  // channel (@sa: `RpcChannel::Options::backup_request_ratio`). If there's no
+  // budget, no backup request is sent.
+  //
+  // Note that this method has no effect on streaming RPC.
+  void SetBackupRequestAfter(std::chrono::nanoseconds after);
+  std::optional<std::chrono::nanoseconds> GetBackupRequestAfter() const;
+
+  // Returns `true` if a backup request has been sent, regardless of which one
+  // completed the RPC.
+  bool IsBackupRequestSent() const;
+
+  // Requests with the same key are routed to the same server (if the load
+  // balancer respects keys, e.g. "chash"). This helps downstream services that
+  // cache (or shard) by key.
+  //
+  // If not set, requests are spread evenly among servers.
+  void SetRequestKey(std::uint64_t key);
+  std::optional<std::uint64_t> GetRequestKey() const;
+
   // For normal RPCs, certain protocols allow you to send an "attachment" along
   // with the message, which is more efficient compared to serializing the
   // attachment into the message.
@@ -58,6 +88,34 @@ class RpcClientController : public protobuf::RpcControllerCommon {
   // This allows you to know who is requesting you.
   using RpcControllerCommon::GetRemotePeer;
 
+  // Compresses the request (and its attachment, if any) using `algorithm`.
+  // This overrides the per-method setting of the channel (@sa:
+  // `RpcChannel::Options::compression_algorithms`).
+  //
+  // Requests smaller than `FLAGS_flare_rpc_compression_min_size` are not
+  // compressed. Neither is any streaming RPC.
+  void SetCompressionAlgorithm(rpc::CompressionAlgorithm algorithm) noexcept {
+    compression_algorithm_ = algorithm;
+  }
+  rpc::CompressionAlgorithm GetCompressionAlgorithm() const noexcept {
+    return compression_algorithm_;
+  }
+
+  // For streaming RPCs, responses are read from the reader, and requests
+  // (of client-streaming methods) are written to the writer. The stream is
+  // established once `CallMethod` returns (or `done` is called). Failures are
+  // reported by the reader.
+  //
+  // By default the stream expires at the timeout of this controller.
+  template <class T>
+  StreamReader<T> GetStreamReader() {
+    return StreamReader<T>(stream_);
+  }
+  template <class T>
+  StreamWriter<T> GetStreamWriter() {
+    return StreamWriter<T>(stream_);
+  }
+
 
   // Reset this controller to its initial status.
   //
@@ -96,12 +154,22 @@ class RpcClientController : public protobuf::RpcControllerCommon {
   // Not used.
   void SetFailed(const std::string& reason) override;
 
+  void SetStream(std::shared_ptr<protobuf::detail::StreamContext> stream) {
+    stream_ = std::move(stream);
+  }
+
+  void SetBackupRequestSent() { backup_request_sent_ = true; }
+
  private:
   bool in_use_ = false;
   bool completed_ = false;
 
   // User settings.
   std::size_t max_retries_ = 1;
+  std::optional<std::chrono::nanoseconds> backup_request_after_;
+  std::optional<std::uint64_t> request_key_;
+  rpc::CompressionAlgorithm compression_algorithm_ =
+      rpc::COMPRESSION_ALGORITHM_UNKNOWN;  // Not set.
   std::chrono::steady_clock::time_point last_reset_{ReadSteadyClock()};
   std::chrono::steady_clock::time_point timeout_{
       last_reset_ +
@@ -111,6 +179,8 @@ class RpcClientController : public protobuf::RpcControllerCommon {
 
   // RPC State.
   std::optional<Status> rpc_status_;
+  bool backup_request_sent_ = false;
+  std::shared_ptr<protobuf::detail::StreamContext> stream_;
 };
 
 }  // namespace tinyRPC
@@ -11,8 +11,8 @@ namespace tinyRPC::protobuf {
 
 
 void RpcControllerCommon::Reset() {
-  request_attachment_.clear();
-  response_attachment_.clear();
+  request_attachment_.Clear();
+  response_attachment_.Clear();
 }
 
 void RpcControllerCommon::StartCancel() {
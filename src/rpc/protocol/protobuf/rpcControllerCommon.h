@@ -7,6 +7,7 @@
 #include "gflags/gflags_declare.h"
 #include "google/protobuf/service.h"
 
+#include "../../../base/Buffer.h"
 #include "../../../base/Endpoint.h"
 #include "../../../base/Tsc.h"
 #include "Message.h"
@@ -43,16 +44,16 @@ class RpcControllerCommon : public google::protobuf::RpcController {
   // not supporting attachment, either `STATUS_NOT_SUPPORTED` is returned
   // (preferrably), or a warning is written to log.
 
-  void SetRequestAttachment(std::string attachment) noexcept {
+  void SetRequestAttachment(NoncontiguousBuffer attachment) noexcept {
     request_attachment_ = std::move(attachment);
   }
-  const std::string& GetRequestAttachment() const noexcept {
+  const NoncontiguousBuffer& GetRequestAttachment() const noexcept {
     return request_attachment_;
   }
-  void SetResponseAttachment(std::string attachment) noexcept {
+  void SetResponseAttachment(NoncontiguousBuffer attachment) noexcept {
     response_attachment_ = std::move(attachment);
   }
-  const std::string& GetResponseAttachment() const noexcept {
+  const NoncontiguousBuffer& GetResponseAttachment() const noexcept {
     return response_attachment_;
   }
 
@@ -93,8 +94,8 @@ class RpcControllerCommon : public google::protobuf::RpcController {
   Endpoint remote_peer_;
   // If there was an attachment attached to the request / response, it's saved
   // here.
-  std::string request_attachment_;
-  std::string response_attachment_;
+  NoncontiguousBuffer request_attachment_;
+  NoncontiguousBuffer response_attachment_;
 
 };
 
@@ -39,6 +39,9 @@ void RpcServerController::Reset() {
   error_code_ = rpc::STATUS_SUCCESS;
   timeout_from_caller_ = std::nullopt;
   early_write_resp_cb_ = nullptr;
+  stream_ = nullptr;
+  compression_algorithm_ = rpc::COMPRESSION_ALGORITHM_NONE;
+  acceptable_compression_algorithms_.reset();
   error_text_.clear();
 }
 
@@ -11,6 +11,7 @@
 #include "gtest/gtest_prod.h"
 
 #include "../../../base/String.h"
+#include "Stream.h"
 #include "rpcControllerCommon.h"
 
 namespace tinyRPC {
@@ -67,6 +68,18 @@ class RpcServerController : public protobuf::RpcControllerCommon {
   // No `SetTimeout` here. If you want to set a timeout for streaming RPC, use
   // `StreamReader/Writer::SetExpiration` instead.
 
+  // For streaming RPCs, requests are read from the reader (client-streaming),
+  // and responses are written to the writer (server-streaming). They're only
+  // usable until `done` is called.
+  template <class T>
+  StreamReader<T> GetStreamReader() {
+    return StreamReader<T>(stream_);
+  }
+  template <class T>
+  StreamWriter<T> GetStreamWriter() {
+    return StreamWriter<T>(stream_);
+  }
+
   // For normal RPCs, certain protocols allow you to send an "attachment" along
   // with the message, which is more efficient compared to serializing the
   // attachment into the message.
@@ -77,6 +90,20 @@ class RpcServerController : public protobuf::RpcControllerCommon {
   // This allows you to know who is requesting you.
   using RpcControllerCommon::GetRemotePeer;
 
+  // Compresses the response (and its attachment, if any) using `algorithm`.
+  //
+  // By default, the response is compressed in the same way as the request
+  // was. The algorithm is ignored if it's not acceptable to the caller, or the
+  // response is too small (@sa: `FLAGS_flare_rpc_compression_min_size`).
+  //
+  // Not applicable to streaming RPCs.
+  void SetCompressionAlgorithm(rpc::CompressionAlgorithm algorithm) noexcept {
+    compression_algorithm_ = algorithm;
+  }
+  rpc::CompressionAlgorithm GetCompressionAlgorithm() const noexcept {
+    return compression_algorithm_;
+  }
+
   // Reset this controller to its initial status.
   void Reset() override;
 
@@ -98,6 +125,18 @@ class RpcServerController : public protobuf::RpcControllerCommon {
     return std::exchange(early_write_resp_cb_, nullptr);
   }
 
+  void SetStream(std::shared_ptr<protobuf::detail::StreamContext> stream) {
+    stream_ = std::move(stream);
+  }
+
+  // Set from `acceptable_compression_algorithms` of the request.
+  void SetAcceptableCompressionAlgorithms(std::uint64_t algorithms) noexcept {
+    acceptable_compression_algorithms_ = algorithms;
+  }
+  std::uint64_t GetAcceptableCompressionAlgorithms() const noexcept {
+    return acceptable_compression_algorithms_.to_ullong();
+  }
+
 
  private:
   int error_code_ = rpc::STATUS_SUCCESS;
@@ -105,6 +144,10 @@ class RpcServerController : public protobuf::RpcControllerCommon {
   // using must support this field for it to be useful.
   std::optional<std::chrono::steady_clock::time_point> timeout_from_caller_;
   google::protobuf::Closure* early_write_resp_cb_ = nullptr;
+  std::shared_ptr<protobuf::detail::StreamContext> stream_;
+  rpc::CompressionAlgorithm compression_algorithm_ =
+      rpc::COMPRESSION_ALGORITHM_NONE;
+  std::bitset<64> acceptable_compression_algorithms_;  // `1 << algorithm`.
   std::string error_text_;
   std::mutex user_fields_lock_;
 };
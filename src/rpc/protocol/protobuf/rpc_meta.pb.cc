@@ -68,11 +68,13 @@ const ::google::protobuf::uint32 TableStruct::offsets[] GOOGLE_ATTRIBUTE_SECTION
   ~0u,  // no _oneof_case_
   ~0u,  // no _weak_field_map_
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(RpcRequestMeta, method_name_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(RpcRequestMeta, method_id_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(RpcRequestMeta, request_id_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(RpcRequestMeta, timeout_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(RpcRequestMeta, tracing_context_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(RpcRequestMeta, acceptable_compression_algorithms_),
   0,
+  5,
   2,
   3,
   1,
@@ -98,6 +100,7 @@ const ::google::protobuf::uint32 TableStruct::offsets[] GOOGLE_ATTRIBUTE_SECTION
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(RpcMeta, flags_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(RpcMeta, compression_algorithm_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(RpcMeta, attachment_compressed_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(RpcMeta, window_update_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(RpcMeta, request_meta_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(RpcMeta, response_meta_),
   2,
@@ -105,13 +108,14 @@ const ::google::protobuf::uint32 TableStruct::offsets[] GOOGLE_ATTRIBUTE_SECTION
   3,
   5,
   6,
+  7,
   0,
   1,
 };
 static const ::google::protobuf::internal::MigrationSchema schemas[] GOOGLE_ATTRIBUTE_SECTION_VARIABLE(protodesc_cold) = {
-  { 0, 10, sizeof(RpcRequestMeta)},
-  { 15, 23, sizeof(RpcResponseMeta)},
-  { 26, 38, sizeof(RpcMeta)},
+  { 0, 11, sizeof(RpcRequestMeta)},
+  { 17, 25, sizeof(RpcResponseMeta)},
+  { 28, 41, sizeof(RpcMeta)},
 };
 
 static ::google::protobuf::Message const * const file_default_instances[] = {
@@ -166,49 +170,53 @@ namespace {
 void AddDescriptorsImpl() {
   InitDefaults();
   static const char descriptor[] GOOGLE_ATTRIBUTE_SECTION_VARIABLE(protodesc_cold) = {
-      "\n\016rpc_meta.proto\022\013tinyRPC.rpc\"\216\001\n\016RpcReq"
-      "uestMeta\022\023\n\013method_name\030\002 \002(\t\022\022\n\nrequest"
-      "_id\030\003 \001(\r\022\017\n\007timeout\030\004 \001(\r\022\027\n\017tracing_co"
-      "ntext\030\005 \001(\014\022)\n!acceptable_compression_al"
-      "gorithms\030\006 \001(\004\"V\n\017RpcResponseMeta\022\016\n\006sta"
-      "tus\030\001 \002(\005\022\023\n\013description\030\002 \001(\t\022\036\n\026trace_"
-      "forcibly_sampled\030\003 \001(\010\"\247\002\n\007RpcMeta\022\026\n\016co"
-      "rrelation_id\030\001 \002(\004\022,\n\013method_type\030\007 \002(\0162"
-      "\027.tinyRPC.rpc.MethodType\022\r\n\005flags\030\010 \001(\004\022"
-      "@\n\025compression_algorithm\030\t \001(\0162!.tinyRPC"
-      ".rpc.CompressionAlgorithm\022\035\n\025attachment_"
-      "compressed\030\n \001(\010\0221\n\014request_meta\030\005 \001(\0132\033"
-      ".tinyRPC.rpc.RpcRequestMeta\0223\n\rresponse_"
-      "meta\030\006 \001(\0132\034.tinyRPC.rpc.RpcResponseMeta"
-      "*\237\005\n\006Status\022\022\n\016STATUS_SUCCESS\020\000\022\033\n\027STATU"
-      "S_CHANNEL_SHUTDOWN\020\001\022\032\n\026STATUS_FAIL_TO_C"
-      "ONNECT\020\002\022\034\n\030STATUS_SERIALIZE_REQUEST\020\004\022\030"
-      "\n\024STATUS_PARSE_REQUEST\020\005\022\035\n\031STATUS_SERIA"
-      "LIZE_RESPONSE\020\006\022\031\n\025STATUS_PARSE_RESPONSE"
-      "\020\007\022\036\n\032STATUS_INVALID_METHOD_NAME\020\010\022 \n\034ST"
-      "ATUS_INVALID_TRANSFER_MODE\020\014\022\035\n\031STATUS_F"
-      "ROM_USER_FEEDBACK\020\r\022\031\n\025STATUS_OUT_OF_SER"
-      "VICE\020\016\022\024\n\020STATUS_GET_ROUTE\020\017\022!\n\035STATUS_G"
-      "ET_ROUTE_ALL_DISABLED\020\021\022\024\n\020STATUS_FROM_U"
-      "SER\020d\022\022\n\016STATUS_TIMEOUT\020\003\022\025\n\021STATUS_OVER"
-      "LOADED\020\013\022\034\n\030STATUS_SERVICE_NOT_FOUND\020\t\022\033"
-      "\n\027STATUS_METHOD_NOT_FOUND\020\n\022\022\n\016STATUS_NO"
-      "_PEER\020\020\022\021\n\rSTATUS_FAILED\020c\022\030\n\024STATUS_NOT"
-      "_SUPPORTED\020e\022\031\n\025STATUS_MALFORMED_DATA\020f\022"
-      "\032\n\026STATUS_INVALID_CHANNEL\020g\022\023\n\017STATUS_IO"
-      "_ERROR\020h\022\030\n\023STATUS_RESERVED_MAX\020\350\007*=\n\nMe"
-      "thodType\022\027\n\023METHOD_TYPE_UNKNOWN\020\000\022\026\n\022MET"
-      "HOD_TYPE_SINGLE\020\001*G\n\014MessageFlags\022\031\n\025MES"
-      "SAGE_FLAGS_UNKNOWN\020\000\022\034\n\030MESSAGE_FLAGS_NO"
-      "_PAYLOAD\020\004*\340\001\n\024CompressionAlgorithm\022!\n\035C"
-      "OMPRESSION_ALGORITHM_UNKNOWN\020\000\022\036\n\032COMPRE"
-      "SSION_ALGORITHM_NONE\020\001\022\036\n\032COMPRESSION_AL"
-      "GORITHM_GZIP\020\002\022#\n\037COMPRESSION_ALGORITHM_"
-      "LZ4_FRAME\020\003\022 \n\034COMPRESSION_ALGORITHM_SNA"
-      "PPY\020\004\022\036\n\032COMPRESSION_ALGORITHM_ZSTD\020\005"
+      "\n\016rpc_meta.proto\022\013tinyRPC.rpc\"\241\001\n\016RpcReq"
+      "uestMeta\022\023\n\013method_name\030\002 \001(\t\022\021\n\tmethod_"
+      "id\030\007 \001(\007\022\022\n\nrequest_id\030\003 \001(\r\022\017\n\007timeout\030"
+      "\004 \001(\r\022\027\n\017tracing_context\030\005 \001(\014\022)\n!accept"
+      "able_compression_algorithms\030\006 \001(\004\"V\n\017Rpc"
+      "ResponseMeta\022\016\n\006status\030\001 \002(\005\022\023\n\013descript"
+      "ion\030\002 \001(\t\022\036\n\026trace_forcibly_sampled\030\003 \001("
+      "\010\"\276\002\n\007RpcMeta\022\026\n\016correlation_id\030\001 \002(\004\022,\n"
+      "\013method_type\030\007 \002(\0162\027.tinyRPC.rpc.MethodT"
+      "ype\022\r\n\005flags\030\010 \001(\004\022@\n\025compression_algori"
+      "thm\030\t \001(\0162!.tinyRPC.rpc.CompressionAlgor"
+      "ithm\022\035\n\025attachment_compressed\030\n \001(\010\022\025\n\rw"
+      "indow_update\030\013 \001(\r\0221\n\014request_meta\030\005 \001(\013"
+      "2\033.tinyRPC.rpc.RpcRequestMeta\0223\n\rrespons"
+      "e_meta\030\006 \001(\0132\034.tinyRPC.rpc.RpcResponseMe"
+      "ta*\237\005\n\006Status\022\022\n\016STATUS_SUCCESS\020\000\022\033\n\027STA"
+      "TUS_CHANNEL_SHUTDOWN\020\001\022\032\n\026STATUS_FAIL_TO"
+      "_CONNECT\020\002\022\034\n\030STATUS_SERIALIZE_REQUEST\020\004"
+      "\022\030\n\024STATUS_PARSE_REQUEST\020\005\022\035\n\031STATUS_SER"
+      "IALIZE_RESPONSE\020\006\022\031\n\025STATUS_PARSE_RESPON"
+      "SE\020\007\022\036\n\032STATUS_INVALID_METHOD_NAME\020\010\022 \n\034"
+      "STATUS_INVALID_TRANSFER_MODE\020\014\022\035\n\031STATUS"
+      "_FROM_USER_FEEDBACK\020\r\022\031\n\025STATUS_OUT_OF_S"
+      "ERVICE\020\016\022\024\n\020STATUS_GET_ROUTE\020\017\022!\n\035STATUS"
+      "_GET_ROUTE_ALL_DISABLED\020\021\022\024\n\020STATUS_FROM"
+      "_USER\020d\022\022\n\016STATUS_TIMEOUT\020\003\022\025\n\021STATUS_OV"
+      "ERLOADED\020\013\022\034\n\030STATUS_SERVICE_NOT_FOUND\020\t"
+      "\022\033\n\027STATUS_METHOD_NOT_FOUND\020\n\022\022\n\016STATUS_"
+      "NO_PEER\020\020\022\021\n\rSTATUS_FAILED\020c\022\030\n\024STATUS_N"
+      "OT_SUPPORTED\020e\022\031\n\025STATUS_MALFORMED_DATA\020"
+      "f\022\032\n\026STATUS_INVALID_CHANNEL\020g\022\023\n\017STATUS_"
+      "IO_ERROR\020h\022\030\n\023STATUS_RESERVED_MAX\020\350\007*U\n\n"
+      "MethodType\022\027\n\023METHOD_TYPE_UNKNOWN\020\000\022\026\n\022M"
+      "ETHOD_TYPE_SINGLE\020\001\022\026\n\022METHOD_TYPE_STREA"
+      "M\020\002*\213\001\n\014MessageFlags\022\031\n\025MESSAGE_FLAGS_UN"
+      "KNOWN\020\000\022!\n\035MESSAGE_FLAGS_START_OF_STREAM"
+      "\020\001\022\037\n\033MESSAGE_FLAGS_END_OF_STREAM\020\002\022\034\n\030M"
+      "ESSAGE_FLAGS_NO_PAYLOAD\020\004*\340\001\n\024Compressio"
+      "nAlgorithm\022!\n\035COMPRESSION_ALGORITHM_UNKN"
+      "OWN\020\000\022\036\n\032COMPRESSION_ALGORITHM_NONE\020\001\022\036\n"
+      "\032COMPRESSION_ALGORITHM_GZIP\020\002\022#\n\037COMPRES"
+      "SION_ALGORITHM_LZ4_FRAME\020\003\022 \n\034COMPRESSIO"
+      "N_ALGORITHM_SNAPPY\020\004\022\036\n\032COMPRESSION_ALGO"
+      "RITHM_ZSTD\020\005"
   };
   ::google::protobuf::DescriptorPool::InternalAddGeneratedFile(
-      descriptor, 1597);
+      descriptor, 1732);
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedFile(
     "rpc_meta.proto", &protobuf_RegisterTypes);
 }
@@ -272,6 +280,7 @@ bool MethodType_IsValid(int value) {
   switch (value) {
     case 0:
     case 1:
+    case 2:
       return true;
     default:
       return false;
@@ -285,6 +294,8 @@ const ::google::protobuf::EnumDescriptor* MessageFlags_descriptor() {
 bool MessageFlags_IsValid(int value) {
   switch (value) {
     case 0:
+    case 1:
+    case 2:
     case 4:
       return true;
     default:
@@ -315,6 +326,7 @@ bool CompressionAlgorithm_IsValid(int value) {
 
 #if !defined(_MSC_VER) || _MSC_VER >= 1900
 const int RpcRequestMeta::kMethodNameFieldNumber;
+const int RpcRequestMeta::kMethodIdFieldNumber;
 const int RpcRequestMeta::kRequestIdFieldNumber;
 const int RpcRequestMeta::kTimeoutFieldNumber;
 const int RpcRequestMeta::kTracingContextFieldNumber;
@@ -344,8 +356,8 @@ RpcRequestMeta::RpcRequestMeta(const RpcRequestMeta& from)
     tracing_context_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.tracing_context_);
   }
   ::memcpy(&request_id_, &from.request_id_,
-    static_cast<size_t>(reinterpret_cast<char*>(&acceptable_compression_algorithms_) -
-    reinterpret_cast<char*>(&request_id_)) + sizeof(acceptable_compression_algorithms_));
+    static_cast<size_t>(reinterpret_cast<char*>(&method_id_) -
+    reinterpret_cast<char*>(&request_id_)) + sizeof(method_id_));
   // @@protoc_insertion_point(copy_constructor:tinyRPC.rpc.RpcRequestMeta)
 }
 
@@ -354,8 +366,8 @@ void RpcRequestMeta::SharedCtor() {
   method_name_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
   tracing_context_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
   ::memset(&request_id_, 0, static_cast<size_t>(
-      reinterpret_cast<char*>(&acceptable_compression_algorithms_) -
-      reinterpret_cast<char*>(&request_id_)) + sizeof(acceptable_compression_algorithms_));
+      reinterpret_cast<char*>(&method_id_) -
+      reinterpret_cast<char*>(&request_id_)) + sizeof(method_id_));
 }
 
 RpcRequestMeta::~RpcRequestMeta() {
@@ -408,10 +420,10 @@ void RpcRequestMeta::Clear() {
       (*tracing_context_.UnsafeRawStringPointer())->clear();
     }
   }
-  if (cached_has_bits & 28u) {
+  if (cached_has_bits & 60u) {
     ::memset(&request_id_, 0, static_cast<size_t>(
-        reinterpret_cast<char*>(&acceptable_compression_algorithms_) -
-        reinterpret_cast<char*>(&request_id_)) + sizeof(acceptable_compression_algorithms_));
+        reinterpret_cast<char*>(&method_id_) -
+        reinterpret_cast<char*>(&request_id_)) + sizeof(method_id_));
   }
   _has_bits_.Clear();
   _internal_metadata_.Clear();
@@ -427,7 +439,7 @@ bool RpcRequestMeta::MergePartialFromCodedStream(
     tag = p.first;
     if (!p.second) goto handle_unusual;
     switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
-      // required string method_name = 2;
+      // optional string method_name = 2;
       case 2: {
         if (static_cast< ::google::protobuf::uint8>(tag) ==
             static_cast< ::google::protobuf::uint8>(18u /* 18 & 0xFF */)) {
@@ -497,6 +509,20 @@ bool RpcRequestMeta::MergePartialFromCodedStream(
         break;
       }
 
+      // optional fixed32 method_id = 7;
+      case 7: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(61u /* 61 & 0xFF */)) {
+          set_has_method_id();
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint32, ::google::protobuf::internal::WireFormatLite::TYPE_FIXED32>(
+                 input, &method_id_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
       default: {
       handle_unusual:
         if (tag == 0) {
@@ -524,7 +550,7 @@ void RpcRequestMeta::SerializeWithCachedSizes(
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  // required string method_name = 2;
+  // optional string method_name = 2;
   if (cached_has_bits & 0x00000001u) {
     ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
       this->method_name().data(), static_cast<int>(this->method_name().length()),
@@ -555,6 +581,11 @@ void RpcRequestMeta::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteUInt64(6, this->acceptable_compression_algorithms(), output);
   }
 
+  // optional fixed32 method_id = 7;
+  if (cached_has_bits & 0x00000020u) {
+    ::google::protobuf::internal::WireFormatLite::WriteFixed32(7, this->method_id(), output);
+  }
+
   if (_internal_metadata_.have_unknown_fields()) {
     ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
         _internal_metadata_.unknown_fields(), output);
@@ -570,7 +601,7 @@ void RpcRequestMeta::SerializeWithCachedSizes(
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  // required string method_name = 2;
+  // optional string method_name = 2;
   if (cached_has_bits & 0x00000001u) {
     ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
       this->method_name().data(), static_cast<int>(this->method_name().length()),
@@ -603,6 +634,11 @@ void RpcRequestMeta::SerializeWithCachedSizes(
     target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(6, this->acceptable_compression_algorithms(), target);
   }
 
+  // optional fixed32 method_id = 7;
+  if (cached_has_bits & 0x00000020u) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteFixed32ToArray(7, this->method_id(), target);
+  }
+
   if (_internal_metadata_.have_unknown_fields()) {
     target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields(), target);
@@ -620,13 +656,14 @@ size_t RpcRequestMeta::ByteSizeLong() const {
       ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
         _internal_metadata_.unknown_fields());
   }
-  // required string method_name = 2;
-  if (has_method_name()) {
-    total_size += 1 +
-      ::google::protobuf::internal::WireFormatLite::StringSize(
-        this->method_name());
-  }
-  if (_has_bits_[0 / 32] & 30u) {
+  if (_has_bits_[0 / 32] & 63u) {
+    // optional string method_name = 2;
+    if (has_method_name()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->method_name());
+    }
+
     // optional bytes tracing_context = 5;
     if (has_tracing_context()) {
       total_size += 1 +
@@ -655,6 +692,11 @@ size_t RpcRequestMeta::ByteSizeLong() const {
           this->acceptable_compression_algorithms());
     }
 
+    // optional fixed32 method_id = 7;
+    if (has_method_id()) {
+      total_size += 1 + 4;
+    }
+
   }
   int cached_size = ::google::protobuf::internal::ToCachedSize(total_size);
   GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
@@ -686,7 +728,7 @@ void RpcRequestMeta::MergeFrom(const RpcRequestMeta& from) {
   (void) cached_has_bits;
 
   cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 31u) {
+  if (cached_has_bits & 63u) {
     if (cached_has_bits & 0x00000001u) {
       set_has_method_name();
       method_name_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.method_name_);
@@ -704,6 +746,9 @@ void RpcRequestMeta::MergeFrom(const RpcRequestMeta& from) {
     if (cached_has_bits & 0x00000010u) {
       acceptable_compression_algorithms_ = from.acceptable_compression_algorithms_;
     }
+    if (cached_has_bits & 0x00000020u) {
+      method_id_ = from.method_id_;
+    }
     _has_bits_[0] |= cached_has_bits;
   }
 }
@@ -723,7 +768,6 @@ void RpcRequestMeta::CopyFrom(const RpcRequestMeta& from) {
 }
 
 bool RpcRequestMeta::IsInitialized() const {
-  if ((_has_bits_[0] & 0x00000001) != 0x00000001) return false;
   return true;
 }
 
@@ -738,6 +782,7 @@ void RpcRequestMeta::InternalSwap(RpcRequestMeta* other) {
   swap(request_id_, other->request_id_);
   swap(timeout_, other->timeout_);
   swap(acceptable_compression_algorithms_, other->acceptable_compression_algorithms_);
+  swap(method_id_, other->method_id_);
   swap(_has_bits_[0], other->_has_bits_[0]);
   _internal_metadata_.Swap(&other->_internal_metadata_);
   swap(_cached_size_, other->_cached_size_);
@@ -751,7 +796,7 @@ void RpcRequestMeta::InternalSwap(RpcRequestMeta* other) {
 #if PROTOBUF_INLINE_NOT_IN_HEADERS
 // RpcRequestMeta
 
-// required string method_name = 2;
+// optional string method_name = 2;
 bool RpcRequestMeta::has_method_name() const {
   return (_has_bits_[0] & 0x00000001u) != 0;
 }
@@ -814,6 +859,30 @@ void RpcRequestMeta::set_allocated_method_name(::std::string* method_name) {
   // @@protoc_insertion_point(field_set_allocated:tinyRPC.rpc.RpcRequestMeta.method_name)
 }
 
+// optional fixed32 method_id = 7;
+bool RpcRequestMeta::has_method_id() const {
+  return (_has_bits_[0] & 0x00000020u) != 0;
+}
+void RpcRequestMeta::set_has_method_id() {
+  _has_bits_[0] |= 0x00000020u;
+}
+void RpcRequestMeta::clear_has_method_id() {
+  _has_bits_[0] &= ~0x00000020u;
+}
+void RpcRequestMeta::clear_method_id() {
+  method_id_ = 0u;
+  clear_has_method_id();
+}
+::google::protobuf::uint32 RpcRequestMeta::method_id() const {
+  // @@protoc_insertion_point(field_get:tinyRPC.rpc.RpcRequestMeta.method_id)
+  return method_id_;
+}
+void RpcRequestMeta::set_method_id(::google::protobuf::uint32 value) {
+  set_has_method_id();
+  method_id_ = value;
+  // @@protoc_insertion_point(field_set:tinyRPC.rpc.RpcRequestMeta.method_id)
+}
+
 // optional uint32 request_id = 3;
 bool RpcRequestMeta::has_request_id() const {
   return (_has_bits_[0] & 0x00000004u) != 0;
@@ -1422,6 +1491,7 @@ const int RpcMeta::kMethodTypeFieldNumber;
 const int RpcMeta::kFlagsFieldNumber;
 const int RpcMeta::kCompressionAlgorithmFieldNumber;
 const int RpcMeta::kAttachmentCompressedFieldNumber;
+const int RpcMeta::kWindowUpdateFieldNumber;
 const int RpcMeta::kRequestMetaFieldNumber;
 const int RpcMeta::kResponseMetaFieldNumber;
 #endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
@@ -1451,16 +1521,16 @@ RpcMeta::RpcMeta(const RpcMeta& from)
     response_meta_ = NULL;
   }
   ::memcpy(&correlation_id_, &from.correlation_id_,
-    static_cast<size_t>(reinterpret_cast<char*>(&attachment_compressed_) -
-    reinterpret_cast<char*>(&correlation_id_)) + sizeof(attachment_compressed_));
+    static_cast<size_t>(reinterpret_cast<char*>(&window_update_) -
+    reinterpret_cast<char*>(&correlation_id_)) + sizeof(window_update_));
   // @@protoc_insertion_point(copy_constructor:tinyRPC.rpc.RpcMeta)
 }
 
 void RpcMeta::SharedCtor() {
   _cached_size_ = 0;
   ::memset(&request_meta_, 0, static_cast<size_t>(
-      reinterpret_cast<char*>(&attachment_compressed_) -
-      reinterpret_cast<char*>(&request_meta_)) + sizeof(attachment_compressed_));
+      reinterpret_cast<char*>(&window_update_) -
+      reinterpret_cast<char*>(&request_meta_)) + sizeof(window_update_));
 }
 
 RpcMeta::~RpcMeta() {
@@ -1513,10 +1583,10 @@ void RpcMeta::Clear() {
       response_meta_->::tinyRPC::rpc::RpcResponseMeta::Clear();
     }
   }
-  if (cached_has_bits & 124u) {
+  if (cached_has_bits & 252u) {
     ::memset(&correlation_id_, 0, static_cast<size_t>(
-        reinterpret_cast<char*>(&attachment_compressed_) -
-        reinterpret_cast<char*>(&correlation_id_)) + sizeof(attachment_compressed_));
+        reinterpret_cast<char*>(&window_update_) -
+        reinterpret_cast<char*>(&correlation_id_)) + sizeof(window_update_));
   }
   _has_bits_.Clear();
   _internal_metadata_.Clear();
@@ -1638,6 +1708,20 @@ bool RpcMeta::MergePartialFromCodedStream(
         break;
       }
 
+      // optional uint32 window_update = 11;
+      case 11: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(88u /* 88 & 0xFF */)) {
+          set_has_window_update();
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint32, ::google::protobuf::internal::WireFormatLite::TYPE_UINT32>(
+                 input, &window_update_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
       default: {
       handle_unusual:
         if (tag == 0) {
@@ -1704,6 +1788,11 @@ void RpcMeta::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteBool(10, this->attachment_compressed(), output);
   }
 
+  // optional uint32 window_update = 11;
+  if (cached_has_bits & 0x00000080u) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt32(11, this->window_update(), output);
+  }
+
   if (_internal_metadata_.have_unknown_fields()) {
     ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
         _internal_metadata_.unknown_fields(), output);
@@ -1760,6 +1849,11 @@ void RpcMeta::SerializeWithCachedSizes(
     target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(10, this->attachment_compressed(), target);
   }
 
+  // optional uint32 window_update = 11;
+  if (cached_has_bits & 0x00000080u) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt32ToArray(11, this->window_update(), target);
+  }
+
   if (_internal_metadata_.have_unknown_fields()) {
     target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields(), target);
@@ -1832,7 +1926,7 @@ size_t RpcMeta::ByteSizeLong() const {
         this->flags());
   }
 
-  if (_has_bits_[0 / 32] & 96u) {
+  if (_has_bits_[0 / 32] & 224u) {
     // optional .tinyRPC.rpc.CompressionAlgorithm compression_algorithm = 9;
     if (has_compression_algorithm()) {
       total_size += 1 +
@@ -1844,6 +1938,13 @@ size_t RpcMeta::ByteSizeLong() const {
       total_size += 1 + 1;
     }
 
+    // optional uint32 window_update = 11;
+    if (has_window_update()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::UInt32Size(
+          this->window_update());
+    }
+
   }
   int cached_size = ::google::protobuf::internal::ToCachedSize(total_size);
   GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
@@ -1875,7 +1976,7 @@ void RpcMeta::MergeFrom(const RpcMeta& from) {
   (void) cached_has_bits;
 
   cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 127u) {
+  if (cached_has_bits & 255u) {
     if (cached_has_bits & 0x00000001u) {
       mutable_request_meta()->::tinyRPC::rpc::RpcRequestMeta::MergeFrom(from.request_meta());
     }
@@ -1897,6 +1998,9 @@ void RpcMeta::MergeFrom(const RpcMeta& from) {
     if (cached_has_bits & 0x00000040u) {
       attachment_compressed_ = from.attachment_compressed_;
     }
+    if (cached_has_bits & 0x00000080u) {
+      window_update_ = from.window_update_;
+    }
     _has_bits_[0] |= cached_has_bits;
   }
 }
@@ -1917,9 +2021,6 @@ void RpcMeta::CopyFrom(const RpcMeta& from) {
 
 bool RpcMeta::IsInitialized() const {
   if ((_has_bits_[0] & 0x00000014) != 0x00000014) return false;
-  if (has_request_meta()) {
-    if (!this->request_meta_->IsInitialized()) return false;
-  }
   if (has_response_meta()) {
     if (!this->response_meta_->IsInitialized()) return false;
   }
@@ -1939,6 +2040,7 @@ void RpcMeta::InternalSwap(RpcMeta* other) {
   swap(method_type_, other->method_type_);
   swap(compression_algorithm_, other->compression_algorithm_);
   swap(attachment_compressed_, other->attachment_compressed_);
+  swap(window_update_, other->window_update_);
   swap(_has_bits_[0], other->_has_bits_[0]);
   _internal_metadata_.Swap(&other->_internal_metadata_);
   swap(_cached_size_, other->_cached_size_);
@@ -2074,6 +2176,30 @@ void RpcMeta::set_attachment_compressed(bool value) {
   // @@protoc_insertion_point(field_set:tinyRPC.rpc.RpcMeta.attachment_compressed)
 }
 
+// optional uint32 window_update = 11;
+bool RpcMeta::has_window_update() const {
+  return (_has_bits_[0] & 0x00000080u) != 0;
+}
+void RpcMeta::set_has_window_update() {
+  _has_bits_[0] |= 0x00000080u;
+}
+void RpcMeta::clear_has_window_update() {
+  _has_bits_[0] &= ~0x00000080u;
+}
+void RpcMeta::clear_window_update() {
+  window_update_ = 0u;
+  clear_has_window_update();
+}
+::google::protobuf::uint32 RpcMeta::window_update() const {
+  // @@protoc_insertion_point(field_get:tinyRPC.rpc.RpcMeta.window_update)
+  return window_update_;
+}
+void RpcMeta::set_window_update(::google::protobuf::uint32 value) {
+  set_has_window_update();
+  window_update_ = value;
+  // @@protoc_insertion_point(field_set:tinyRPC.rpc.RpcMeta.window_update)
+}
+
 // optional .tinyRPC.rpc.RpcRequestMeta request_meta = 5;
 bool RpcMeta::has_request_meta() const {
   return (_has_bits_[0] & 0x00000001u) != 0;
@@ -107,11 +107,12 @@ inline bool Status_Parse(
 }
 enum MethodType {
   METHOD_TYPE_UNKNOWN = 0,
-  METHOD_TYPE_SINGLE = 1
+  METHOD_TYPE_SINGLE = 1,
+  METHOD_TYPE_STREAM = 2
 };
 bool MethodType_IsValid(int value);
 const MethodType MethodType_MIN = METHOD_TYPE_UNKNOWN;
-const MethodType MethodType_MAX = METHOD_TYPE_SINGLE;
+const MethodType MethodType_MAX = METHOD_TYPE_STREAM;
 const int MethodType_ARRAYSIZE = MethodType_MAX + 1;
 
 const ::google::protobuf::EnumDescriptor* MethodType_descriptor();
@@ -126,6 +127,8 @@ inline bool MethodType_Parse(
 }
 enum MessageFlags {
   MESSAGE_FLAGS_UNKNOWN = 0,
+  MESSAGE_FLAGS_START_OF_STREAM = 1,
+  MESSAGE_FLAGS_END_OF_STREAM = 2,
   MESSAGE_FLAGS_NO_PAYLOAD = 4
 };
 bool MessageFlags_IsValid(int value);
@@ -256,7 +259,7 @@ class RpcRequestMeta : public ::google::protobuf::Message /* @@protoc_insertion_
 
   // accessors -------------------------------------------------------
 
-  // required string method_name = 2;
+  // optional string method_name = 2;
   bool has_method_name() const;
   void clear_method_name();
   static const int kMethodNameFieldNumber = 2;
@@ -307,10 +310,19 @@ class RpcRequestMeta : public ::google::protobuf::Message /* @@protoc_insertion_
   ::google::protobuf::uint64 acceptable_compression_algorithms() const;
   void set_acceptable_compression_algorithms(::google::protobuf::uint64 value);
 
+  // optional fixed32 method_id = 7;
+  bool has_method_id() const;
+  void clear_method_id();
+  static const int kMethodIdFieldNumber = 7;
+  ::google::protobuf::uint32 method_id() const;
+  void set_method_id(::google::protobuf::uint32 value);
+
   // @@protoc_insertion_point(class_scope:tinyRPC.rpc.RpcRequestMeta)
  private:
   void set_has_method_name();
   void clear_has_method_name();
+  void set_has_method_id();
+  void clear_has_method_id();
   void set_has_request_id();
   void clear_has_request_id();
   void set_has_timeout();
@@ -328,6 +340,7 @@ class RpcRequestMeta : public ::google::protobuf::Message /* @@protoc_insertion_
   ::google::protobuf::uint32 request_id_;
   ::google::protobuf::uint32 timeout_;
   ::google::protobuf::uint64 acceptable_compression_algorithms_;
+  ::google::protobuf::uint32 method_id_;
   friend struct protobuf_rpc_5fmeta_2eproto::TableStruct;
 };
 // -------------------------------------------------------------------
@@ -609,6 +622,13 @@ class RpcMeta : public ::google::protobuf::Message /* @@protoc_insertion_point(c
   bool attachment_compressed() const;
   void set_attachment_compressed(bool value);
 
+  // optional uint32 window_update = 11;
+  bool has_window_update() const;
+  void clear_window_update();
+  static const int kWindowUpdateFieldNumber = 11;
+  ::google::protobuf::uint32 window_update() const;
+  void set_window_update(::google::protobuf::uint32 value);
+
   // @@protoc_insertion_point(class_scope:tinyRPC.rpc.RpcMeta)
  private:
   void set_has_correlation_id();
@@ -621,6 +641,8 @@ class RpcMeta : public ::google::protobuf::Message /* @@protoc_insertion_point(c
   void clear_has_compression_algorithm();
   void set_has_attachment_compressed();
   void clear_has_attachment_compressed();
+  void set_has_window_update();
+  void clear_has_window_update();
   void set_has_request_meta();
   void clear_has_request_meta();
   void set_has_response_meta();
@@ -639,6 +661,7 @@ class RpcMeta : public ::google::protobuf::Message /* @@protoc_insertion_point(c
   int method_type_;
   int compression_algorithm_;
   bool attachment_compressed_;
+  ::google::protobuf::uint32 window_update_;
   friend struct protobuf_rpc_5fmeta_2eproto::TableStruct;
 };
 // ===================================================================
@@ -653,7 +676,7 @@ class RpcMeta : public ::google::protobuf::Message /* @@protoc_insertion_point(c
 #endif  // __GNUC__
 // RpcRequestMeta
 
-// required string method_name = 2;
+// optional string method_name = 2;
 inline bool RpcRequestMeta::has_method_name() const {
   return (_has_bits_[0] & 0x00000001u) != 0;
 }
@@ -716,6 +739,30 @@ inline void RpcRequestMeta::set_allocated_method_name(::std::string* method_name
   // @@protoc_insertion_point(field_set_allocated:tinyRPC.rpc.RpcRequestMeta.method_name)
 }
 
+// optional fixed32 method_id = 7;
+inline bool RpcRequestMeta::has_method_id() const {
+  return (_has_bits_[0] & 0x00000020u) != 0;
+}
+inline void RpcRequestMeta::set_has_method_id() {
+  _has_bits_[0] |= 0x00000020u;
+}
+inline void RpcRequestMeta::clear_has_method_id() {
+  _has_bits_[0] &= ~0x00000020u;
+}
+inline void RpcRequestMeta::clear_method_id() {
+  method_id_ = 0u;
+  clear_has_method_id();
+}
+inline ::google::protobuf::uint32 RpcRequestMeta::method_id() const {
+  // @@protoc_insertion_point(field_get:tinyRPC.rpc.RpcRequestMeta.method_id)
+  return method_id_;
+}
+inline void RpcRequestMeta::set_method_id(::google::protobuf::uint32 value) {
+  set_has_method_id();
+  method_id_ = value;
+  // @@protoc_insertion_point(field_set:tinyRPC.rpc.RpcRequestMeta.method_id)
+}
+
 // optional uint32 request_id = 3;
 inline bool RpcRequestMeta::has_request_id() const {
   return (_has_bits_[0] & 0x00000004u) != 0;
@@ -1092,6 +1139,30 @@ inline void RpcMeta::set_attachment_compressed(bool value) {
   // @@protoc_insertion_point(field_set:tinyRPC.rpc.RpcMeta.attachment_compressed)
 }
 
+// optional uint32 window_update = 11;
+inline bool RpcMeta::has_window_update() const {
+  return (_has_bits_[0] & 0x00000080u) != 0;
+}
+inline void RpcMeta::set_has_window_update() {
+  _has_bits_[0] |= 0x00000080u;
+}
+inline void RpcMeta::clear_has_window_update() {
+  _has_bits_[0] &= ~0x00000080u;
+}
+inline void RpcMeta::clear_window_update() {
+  window_update_ = 0u;
+  clear_has_window_update();
+}
+inline ::google::protobuf::uint32 RpcMeta::window_update() const {
+  // @@protoc_insertion_point(field_get:tinyRPC.rpc.RpcMeta.window_update)
+  return window_update_;
+}
+inline void RpcMeta::set_window_update(::google::protobuf::uint32 value) {
+  set_has_window_update();
+  window_update_ = value;
+  // @@protoc_insertion_point(field_set:tinyRPC.rpc.RpcMeta.window_update)
+}
+
 // optional .tinyRPC.rpc.RpcRequestMeta request_meta = 5;
 inline bool RpcMeta::has_request_meta() const {
   return (_has_bits_[0] & 0x00000001u) != 0;
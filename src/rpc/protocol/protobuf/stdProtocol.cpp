@@ -1,13 +1,23 @@
 #include "stdProtocol.h"
 #include <cstring>
 
+#include "gflags/gflags.h"
+
 #include "../../../base/Endian.h"
 #include "CallContext.h"
 #include "CallContextFactory.h"
+#include "Compression.h"
 #include "Message.h"
+#include "MethodId.h"
 #include "rpc_meta.pb.h"
 #include "ServiceMethodLocator.h"
 
+DEFINE_int32(flare_rpc_std_protocol_max_decompressed_size, 4 * 1024 * 1024,
+             "Compressed messages whose body and attachment inflate beyond "
+             "this many bytes are dropped. This should be raised along with "
+             "`flare_rpc_server_max_packet_size` / "
+             "`flare_rpc_channel_max_packet_size`.");
+
 namespace tinyRPC::protobuf {
 
 FLARE_RPC_REGISTER_CLIENT_SIDE_STREAM_PROTOCOL_ARG("flare", StdProtocol, false);
@@ -18,12 +28,17 @@ namespace {
 void RegisterMethodCallback(const google::protobuf::MethodDescriptor* method) {
   ServiceMethodLocator::Instance()->RegisterMethod(protocol_ids::standard,
                                                    method, method->full_name());
+  ServiceMethodLocator::Instance()->RegisterMethod(
+      protocol_ids::standard_method_id, method,
+      GetMethodId(method->full_name()));
 }
 
 void DeregisterMethodCallback(
     const google::protobuf::MethodDescriptor* method) {
   ServiceMethodLocator::Instance()->DeregisterMethod(protocol_ids::standard,
                                                      method);
+  ServiceMethodLocator::Instance()->DeregisterMethod(
+      protocol_ids::standard_method_id, method);
 }
 
 }  // namespace
@@ -54,14 +69,78 @@ struct OnWireMessage : public Message {
   Type GetType() const noexcept override {
     return FromWireType(meta->method_type(), meta->flags());
   }
+  std::uint32_t GetStreamWindowUpdate() const noexcept override {
+    return meta->window_update();
+  }
 
   std::shared_ptr<rpc::RpcMeta> meta;
-  std::string body;
-  std::string attach;
+  NoncontiguousBuffer body;
+  NoncontiguousBuffer attach;
 };
 
 StreamProtocol::Characteristics characteristics = {.name = "FlareStd"};
 
+bool DecompressInPlace(rpc::CompressionAlgorithm algorithm,
+                       NoncontiguousBuffer* buffer, std::size_t max_size) {
+  auto decompressed = compression::Decompress(algorithm, *buffer, max_size);
+  if (!decompressed) {
+    return false;
+  }
+  *buffer = std::move(*decompressed);
+  return true;
+}
+
+void WriteHeader(std::uint32_t meta_size, std::uint32_t msg_size,
+                 std::uint32_t att_size, NoncontiguousBufferBuilder& builder) {
+  Header hdr = {.magic = kHeaderMagic,
+                .meta_size = meta_size,
+                .msg_size = msg_size,
+                .att_size = att_size};
+  ToLittleEndian(&hdr.magic);
+  ToLittleEndian(&hdr.meta_size);
+  ToLittleEndian(&hdr.msg_size);
+  ToLittleEndian(&hdr.att_size);
+  builder.Append(&hdr, sizeof(Header));
+}
+
+// Compressed messages can't be written in a single pass, as we don't know
+// their sizes until they're compressed. The body is serialized into a
+// temporary buffer and compressed block by block from there, attachment is
+// compressed directly from where it's.
+void WriteCompressedMessage(const ProtoMessage& msg,
+                            NoncontiguousBuffer& buffer) {
+  auto&& meta = *msg.meta;
+  auto algorithm = meta.compression_algorithm();
+
+  NoncontiguousBuffer body, att;
+  {
+    NoncontiguousBufferBuilder serialized;
+    WriteTo(msg.msg, serialized);
+    NoncontiguousBufferBuilder builder;
+    FLARE_CHECK(
+        compression::Compress(algorithm, serialized.DestructiveGet(), &builder),
+        "Failed to compress message #{}.", meta.correlation_id());
+    body = builder.DestructiveGet();
+  }
+  if (meta.attachment_compressed()) {
+    NoncontiguousBufferBuilder builder;
+    FLARE_CHECK(compression::Compress(algorithm, msg.attachment, &builder),
+                "Failed to compress attachment of message #{}.",
+                meta.correlation_id());
+    att = builder.DestructiveGet();
+  } else {
+    att = msg.attachment;  // Only references are copied.
+  }
+
+  auto meta_size = meta.ByteSizeLong();
+  NoncontiguousBufferBuilder builder;
+  WriteHeader(meta_size, body.ByteSize(), att.ByteSize(), builder);
+  WriteWithCachedSizesTo(meta, meta_size, builder);
+  builder.Append(std::move(body));
+  builder.Append(std::move(att));
+  buffer.Append(builder.DestructiveGet());
+}
+
 }  // namespace
 
 const StreamProtocol::Characteristics& StdProtocol::GetCharacteristics() const {
@@ -77,55 +156,73 @@ const ControllerFactory* StdProtocol::GetControllerFactory() const {
 }
 
 StdProtocol::MessageCutStatus StdProtocol::TryCutMessage(
-    std::string& buffer, std::unique_ptr<Message>* message) {
-  if (buffer.size() < kHeaderSize) {
-    return MessageCutStatus::NotIdentified;
-  }
+    NoncontiguousBuffer& buffer, std::unique_ptr<Message>* message) {
+  while (true) {
+    if (buffer.ByteSize() < kHeaderSize) {
+      return MessageCutStatus::NotIdentified;
+    }
 
-  // Extract the header (and convert the endianness if necessary) first.
-  Header hdr;
-  memcpy(&hdr, buffer.data(), kHeaderSize);
-  FromLittleEndian(&hdr.magic);
-  FromLittleEndian(&hdr.meta_size);
-  FromLittleEndian(&hdr.msg_size);
-  FromLittleEndian(&hdr.att_size);
+    // Extract the header (and convert the endianness if necessary) first. It's
+    // almost always in the first block.
+    Header hdr;
+    if (auto first = buffer.FirstContiguous();
+        FLARE_LIKELY(first.size() >= kHeaderSize)) {
+      memcpy(&hdr, first.data(), kHeaderSize);
+    } else {
+      FlattenToSlow(buffer, &hdr, kHeaderSize);
+    }
+    FromLittleEndian(&hdr.magic);
+    FromLittleEndian(&hdr.meta_size);
+    FromLittleEndian(&hdr.msg_size);
+    FromLittleEndian(&hdr.att_size);
 
-  if (hdr.magic != kHeaderMagic) {
-    return MessageCutStatus::ProtocolMismatch;
-  }
-  if (buffer.size() < static_cast<std::uint64_t>(kHeaderSize) +
-                               hdr.meta_size + hdr.msg_size + hdr.att_size) {
-    return MessageCutStatus::NeedMore;
-  }
+    if (hdr.magic != kHeaderMagic) {
+      return MessageCutStatus::ProtocolMismatch;
+    }
+    if (buffer.ByteSize() < static_cast<std::uint64_t>(kHeaderSize) +
+                                 hdr.meta_size + hdr.msg_size + hdr.att_size) {
+      return MessageCutStatus::NeedMore;
+    }
 
-  // Do basic parse.
-  std::string cut =
-      buffer.substr(kHeaderSize, hdr.meta_size + hdr.msg_size + hdr.att_size);
+    // Do basic parse. Only references to the underlying blocks are moved around,
+    // the bytes themselves are not copied.
+    buffer.Skip(kHeaderSize);
+    auto meta_buffer = buffer.Cut(hdr.meta_size);
 
-  // Parse the meta.
-  auto meta = std::make_shared<rpc::RpcMeta>();
-  bool parsed = false;
+    // Parse the meta.
+    auto meta = std::make_shared<rpc::RpcMeta>();
+    bool parsed = ParseFrom(meta_buffer, meta.get());
 
-  parsed = meta->ParseFromArray(cut.data(), hdr.meta_size);
+    // We need to consume the body / attachment anyway otherwise we would leave
+    // the buffer in non-packet-boundary.
+    auto body_buffer = buffer.Cut(hdr.msg_size);
+    auto attach_buffer = buffer.Cut(hdr.att_size);
 
-  // We need to consume the body / attachment anyway otherwise we would leave
-  // the buffer in non-packet-boundary.
-  auto body_buffer = cut.substr(hdr.meta_size, hdr.msg_size);
-  auto attach_buffer = cut.substr(hdr.meta_size + hdr.msg_size, hdr.att_size);
+    // If parsing meta failed, raise an error now.
+    if (!parsed) {
+      FLARE_LOG_WARNING("Invalid meta received, dropped.");
+      return MessageCutStatus::Error;
+    }
+    // `GetType()` of the message is called before `TryParse`, so don't let an
+    // unknown method type through. The packet is well-formed otherwise, only it
+    // is dropped, and we move on to the next one. (Returning `NeedMore` here
+    // would leave packets already in `buffer` unprocessed until more bytes
+    // arrive.)
+    if (FLARE_UNLIKELY(!TryFromWireType(meta->method_type(), meta->flags()))) {
+      FLARE_LOG_WARNING(
+          "Unexpected method type {} in message (correlation id {}), dropped.",
+          static_cast<int>(meta->method_type()), meta->correlation_id());
+      continue;
+    }
 
-  // If parsing meta failed, raise an error now.
-  if (!parsed) {
-    FLARE_LOG_WARNING("Invalid meta received, dropped.");
-    return MessageCutStatus::Error;
+    // We've cut the message then.
+    auto msg = std::make_unique<OnWireMessage>();
+    msg->meta = std::move(meta);
+    msg->body = std::move(body_buffer);
+    msg->attach = std::move(attach_buffer);
+    *message = std::move(msg);
+    return MessageCutStatus::Cut;
   }
-
-  // We've cut the message then.
-  auto msg = std::make_unique<OnWireMessage>();
-  msg->meta = std::move(meta);
-  msg->body = std::move(body_buffer);
-  msg->attach = std::move(attach_buffer);
-  *message = std::move(msg);
-  return MessageCutStatus::Cut;
 }
 
 bool StdProtocol::TryParse(std::unique_ptr<Message>* message,
@@ -150,13 +247,25 @@ bool StdProtocol::TryParse(std::unique_ptr<Message>* message,
   MaybeOwning<google::protobuf::Message> unpack_to;
 
   if (server_side_) {
-    auto&& method = meta->request_meta().method_name();
-    auto desc = ServiceMethodLocator::Instance()->TryGetMethodDesc(
-        protocol_ids::standard, method);
-    if (!desc) {
+    auto&& req_meta = meta->request_meta();
+    auto locator = ServiceMethodLocator::Instance();
+    const google::protobuf::Message* prototype = nullptr;
+    if (FLARE_LIKELY(!req_meta.has_method_id())) {
+      if (auto desc = locator->TryGetMethodDesc(protocol_ids::standard,
+                                                req_meta.method_name())) {
+        prototype = desc->request_prototype;
+      }
+    } else if (auto desc = locator->TryGetMethodDesc(
+                   protocol_ids::standard_method_id, req_meta.method_id())) {
+      prototype = desc->request_prototype;
+    }
+    if (!prototype) {
       // Instead of dropping the packet, we could produce an `EarlyErrorMessage`
       // of `kMethodNotFound` and let the upper layer return an error more
       // gracefully.
+      auto method = req_meta.has_method_id()
+                        ? fmt::format("#{:08x}", req_meta.method_id())
+                        : req_meta.method_name();
       FLARE_VLOG(1, "Method [{}] is not found.", method);
       *message = std::make_unique<EarlyErrorMessage>(
           meta->correlation_id(), rpc::STATUS_METHOD_NOT_FOUND,
@@ -164,17 +273,34 @@ bool StdProtocol::TryParse(std::unique_ptr<Message>* message,
       return true;
     }
 
-    unpack_to = std::unique_ptr<google::protobuf::Message>(
-        desc->request_prototype->New());
+    unpack_to = std::unique_ptr<google::protobuf::Message>(prototype->New());
   } else {
     FLARE_CHECK(meta->has_response_meta());  // Checked before.
     auto ctx = static_cast<ProactiveCallContext*>(controller);
     unpack_to = ctx->GetOrCreateResponse();
   }
 
+  // Decompress the body (and the attachment) first, if they were compressed.
+  //
+  // They may not inflate beyond
+  // `FLAGS_flare_rpc_std_protocol_max_decompressed_size` in total.
+  if (FLARE_UNLIKELY(compression::IsCompressed(meta->compression_algorithm()))) {
+    std::size_t max_size = FLAGS_flare_rpc_std_protocol_max_decompressed_size;
+    if (!DecompressInPlace(meta->compression_algorithm(), &on_wire->body,
+                           max_size) ||
+        (meta->attachment_compressed() &&
+         !DecompressInPlace(meta->compression_algorithm(), &on_wire->attach,
+                            max_size - on_wire->body.ByteSize()))) {
+      FLARE_LOG_WARNING(
+          "Failed to decompress message (correlation id {}).",
+          meta->correlation_id());
+      return false;
+    }
+  }
+
   if (FLARE_LIKELY(!(meta->flags() & rpc::MESSAGE_FLAGS_NO_PAYLOAD))) {
     if (FLARE_LIKELY(unpack_to)) {
-      if (!unpack_to->ParseFromString(on_wire->body)) {
+      if (!ParseFrom(on_wire->body, unpack_to.Get())) {
         FLARE_LOG_WARNING(
             "Failed to parse message (correlation id {}).",
             meta->correlation_id());
@@ -186,7 +312,7 @@ bool StdProtocol::TryParse(std::unique_ptr<Message>* message,
     }
   }
 
-  if (!on_wire->attach.empty()) {
+  if (!on_wire->attach.Empty()) {
       parsed->attachment = std::move(on_wire->attach);
   }
   *message = std::move(parsed);
@@ -195,47 +321,33 @@ bool StdProtocol::TryParse(std::unique_ptr<Message>* message,
 
 // Serialize `message` into `buffer`.
 void StdProtocol::WriteMessage(const Message& message,
-                               std::string& buffer,
+                               NoncontiguousBuffer& buffer,
                                Controller* controller) {
-  auto old_size = buffer.size();
-  auto msg = static_cast<ProtoMessage*>(const_cast<Message*>(&message));
-  auto meta = *msg->meta;  // Copied, likely to be slow.
+  auto old_size = buffer.ByteSize();
+  auto msg = static_cast<const ProtoMessage*>(&message);
+  auto&& meta = *msg->meta;
   auto&& att = msg->attachment;
 
-  std::string builder;
-
-  Header hdr = {
-      .magic = kHeaderMagic,
-      .meta_size = static_cast<std::uint32_t>(meta.ByteSizeLong()),
-      .msg_size = 0 /* Filled later. */,
-      .att_size = 0 /* Filled later. */};
-
-  {
-    FLARE_CHECK(meta.SerializeToString(&builder));  // Meta.
+  if (FLARE_UNLIKELY(compression::IsCompressed(meta.compression_algorithm()))) {
+    return WriteCompressedMessage(*msg, buffer);
   }
 
-  // Body  
-  hdr.msg_size += tinyRPC::protobuf::WriteTo(msg->msg, builder);
-
-  // Attachment.
-  if (!att.empty()) {
-      builder += att;
-      hdr.att_size += att.size();
+  // Sizes are computed only once. Serialization below uses the cached sizes,
+  // so that everything is written in a single pass, header first.
+  auto meta_size = meta.ByteSizeLong();
+  auto msg_size = GetByteSize(msg->msg);
+
+  NoncontiguousBufferBuilder builder;
+  WriteHeader(meta_size, msg_size, att.ByteSize(), builder);
+  WriteWithCachedSizesTo(meta, meta_size, builder);
+  WriteWithCachedSizesTo(msg->msg, msg_size, builder);
+  if (!att.Empty()) {
+    builder.Append(att);  // Not copied.
   }
 
-  // Fill header.
-  ToLittleEndian(&hdr.magic);
-  ToLittleEndian(&hdr.meta_size);
-  ToLittleEndian(&hdr.msg_size);
-  ToLittleEndian(&hdr.att_size);
-
-  char headerBuffer [sizeof(Header)];
-  memcpy(headerBuffer, &hdr, sizeof(Header));
-  builder = std::string(headerBuffer) + builder;
-
-  buffer += builder;
-  FLARE_CHECK_EQ(buffer.size() - old_size,
-                 kHeaderSize + hdr.meta_size + hdr.msg_size + hdr.att_size);
+  buffer.Append(builder.DestructiveGet());
+  FLARE_CHECK_EQ(buffer.ByteSize() - old_size,
+                 kHeaderSize + meta_size + msg_size + att.ByteSize());
 }
 
 }  // namespace tinyRPC::protobuf
@@ -27,7 +27,7 @@ class StdProtocol : public StreamProtocol {
 
   // Examine `buffer` and extract message.
   // Parse until meta, then leave remains to TryParse in another fiber.
-  MessageCutStatus TryCutMessage(std::string& buffer,
+  MessageCutStatus TryCutMessage(NoncontiguousBuffer& buffer,
                                  std::unique_ptr<Message>* message) override;
 
   // Continue to parse the whole message.
@@ -35,7 +35,7 @@ class StdProtocol : public StreamProtocol {
                 Controller* controller) override;
 
   // Serialize `message` into `buffer`.
-  void WriteMessage(const Message& message, std::string& buffer,
+  void WriteMessage(const Message& message, NoncontiguousBuffer& buffer,
                     Controller* controller) override;
 
  private:
@@ -0,0 +1,79 @@
+#include "stdProtocol.h"
+
+#include <cstring>
+#include <string>
+
+#include "../../../../include/benchmark/benchmark.h"
+#include "../../../base/ZeroCopyStream.h"
+#include "../../../testing/echo_service.pb.h"
+#include "Message.h"
+
+// Serializing a request of `state.range(0)` bytes (payload + an attachment of
+// the same size).
+//
+// Benchmark_WriteMessage: `StdProtocol::WriteMessage`, sizes are computed
+//                         once and everything is written in a single pass.
+// Benchmark_TwoPass:      What we did before: copy the meta, serialize meta
+//                         and body via `SerializeToZeroCopyStream` (which
+//                         computes the sizes again), fill the header last.
+
+namespace tinyRPC::protobuf {
+
+namespace {
+
+ProtoMessage MakeRequest(std::size_t size) {
+  auto meta = std::make_shared<rpc::RpcMeta>();
+  meta->set_correlation_id(12345);
+  meta->set_method_type(rpc::METHOD_TYPE_SINGLE);
+  meta->mutable_request_meta()->set_method_name(
+      "tinyRPC.testing.EchoService.Echo");
+  auto req = std::make_unique<testing::EchoRequest>();
+  req->set_body(std::string(size, 'x'));
+  return ProtoMessage(
+      std::move(meta),
+      std::unique_ptr<const google::protobuf::Message>(std::move(req)),
+      CreateBufferSlow(std::string(size, 'y')));
+}
+
+void Benchmark_WriteMessage(benchmark::State& state) {
+  StdProtocol protocol(false);
+  auto msg = MakeRequest(state.range(0));
+
+  for (auto _ : state) {
+    NoncontiguousBuffer buffer;
+    protocol.WriteMessage(msg, buffer, nullptr);
+    benchmark::DoNotOptimize(buffer);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 2);
+}
+
+BENCHMARK(Benchmark_WriteMessage)->RangeMultiplier(4)->Range(64, 4 << 20);
+
+void Benchmark_TwoPass(benchmark::State& state) {
+  auto msg = MakeRequest(state.range(0));
+
+  for (auto _ : state) {
+    NoncontiguousBuffer buffer;
+    auto meta = *msg.meta;  // Copied.
+    NoncontiguousBufferBuilder builder;
+    auto header = builder.Reserve(16);
+    std::uint32_t hdr[4] = {0, static_cast<std::uint32_t>(meta.ByteSizeLong())};
+    {
+      NoncontiguousBufferOutputStream nbos(&builder);
+      meta.SerializeToZeroCopyStream(&nbos);
+    }
+    hdr[2] = WriteTo(msg.msg, builder);
+    builder.Append(msg.attachment);
+    hdr[3] = msg.attachment.ByteSize();
+    memcpy(header, hdr, sizeof(hdr));
+    buffer.Append(builder.DestructiveGet());
+    benchmark::DoNotOptimize(buffer);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 2);
+}
+
+BENCHMARK(Benchmark_TwoPass)->RangeMultiplier(4)->Range(64, 4 << 20);
+
+}  // namespace
+
+}  // namespace tinyRPC::protobuf
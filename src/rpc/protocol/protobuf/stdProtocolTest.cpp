@@ -0,0 +1,79 @@
+#include "stdProtocol.h"
+
+#include <memory>
+#include <utility>
+
+#include "../../../../include/gtest/gtest.h"
+#include "../../../testing/echo_service.pb.h"
+#include "Message.h"
+
+namespace tinyRPC::protobuf {
+
+namespace {
+
+NoncontiguousBuffer MakePacket(std::uint64_t correlation_id,
+                               rpc::MethodType method_type) {
+  auto meta = std::make_shared<rpc::RpcMeta>();
+  meta->set_correlation_id(correlation_id);
+  meta->set_method_type(method_type);
+  meta->mutable_request_meta()->set_method_name(
+      "tinyRPC.testing.EchoService.Echo");
+  auto req = std::make_unique<testing::EchoRequest>();
+  req->set_body("hello");
+  ProtoMessage msg(
+      std::move(meta),
+      std::unique_ptr<const google::protobuf::Message>(std::move(req)),
+      CreateBufferSlow("world"));
+
+  NoncontiguousBuffer buffer;
+  StdProtocol(false).WriteMessage(msg, buffer, nullptr);
+  return buffer;
+}
+
+}  // namespace
+
+TEST(StdProtocol, CutMessage) {
+  StdProtocol protocol(true);
+  auto buffer = MakePacket(1, rpc::METHOD_TYPE_SINGLE);
+  auto second = MakePacket(2, rpc::METHOD_TYPE_STREAM);
+  auto second_size = second.ByteSize();
+  buffer.Append(std::move(second));
+
+  std::unique_ptr<Message> msg;
+  auto partial = CreateBufferSlow(FlattenSlow(buffer, buffer.ByteSize() - 1));
+  ASSERT_EQ(StreamProtocol::MessageCutStatus::Cut,
+            protocol.TryCutMessage(partial, &msg));
+  EXPECT_EQ(StreamProtocol::MessageCutStatus::NeedMore,
+            protocol.TryCutMessage(partial, &msg));
+
+  ASSERT_EQ(StreamProtocol::MessageCutStatus::Cut,
+            protocol.TryCutMessage(buffer, &msg));
+  EXPECT_EQ(1, msg->GetCorrelationId());
+  EXPECT_EQ(second_size, buffer.ByteSize());
+  ASSERT_EQ(StreamProtocol::MessageCutStatus::Cut,
+            protocol.TryCutMessage(buffer, &msg));
+  EXPECT_EQ(2, msg->GetCorrelationId());
+  EXPECT_TRUE(buffer.Empty());
+}
+
+TEST(StdProtocol, UnknownMethodTypeDropped) {
+  StdProtocol protocol(true);
+  std::unique_ptr<Message> msg;
+
+  // Dropped alone, there's nothing to cut then.
+  auto buffer = MakePacket(1, rpc::METHOD_TYPE_UNKNOWN);
+  EXPECT_EQ(StreamProtocol::MessageCutStatus::NotIdentified,
+            protocol.TryCutMessage(buffer, &msg));
+  EXPECT_TRUE(buffer.Empty());
+
+  // Packets following it are not held up.
+  buffer = MakePacket(1, rpc::METHOD_TYPE_UNKNOWN);
+  buffer.Append(MakePacket(2, rpc::METHOD_TYPE_UNKNOWN));
+  buffer.Append(MakePacket(3, rpc::METHOD_TYPE_SINGLE));
+  ASSERT_EQ(StreamProtocol::MessageCutStatus::Cut,
+            protocol.TryCutMessage(buffer, &msg));
+  EXPECT_EQ(3, msg->GetCorrelationId());
+  EXPECT_TRUE(buffer.Empty());
+}
+
+}  // namespace tinyRPC::protobuf